@@ -0,0 +1,157 @@
+/*
+ * Braggi - Sampling Allocation Profiler
+ *
+ * "Ya don't weigh every steer to know the herd's gettin' fat -
+ * ya weigh one in a hundred and do the arithmetic!" - Texan Cattle Buyer Wisdom
+ *
+ * Records about one allocation in every N into a fixed ring, along with
+ * its label and call site, and keeps running byte totals per label and
+ * per region. The gap between samples is drawn from a geometric
+ * distribution with mean N, so allocation patterns that repeat every N
+ * allocations can't hide from the sampler or swamp it.
+ *
+ * Each thread counts down to its own next sample, so the hook touches no
+ * shared state until a sample is taken; recording a sample takes a lock.
+ * While disabled the hook only bumps two thread-local counters, then
+ * costs a single load and branch.
+ */
+
+#ifndef BRAGGI_ALLOC_PROFILE_H
+#define BRAGGI_ALLOC_PROFILE_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+// Number of samples kept in the ring; older samples are overwritten
+#define BRAGGI_ALLOC_PROFILE_RING_SIZE 4096
+
+// Default mean sampling interval used when 0 is passed to enable
+#define BRAGGI_ALLOC_PROFILE_DEFAULT_RATE 100
+
+// Region key for allocations made with malloc rather than in a region.
+// Region ids start at 0, so heap samples can't use it.
+#define BRAGGI_ALLOC_PROFILE_HEAP_KEY UINTPTR_MAX
+
+// One sampled allocation
+typedef struct AllocSample {
+    uint64_t sequence;     // Index of the allocation among those its thread made
+    uintptr_t region_key;  // Region id or handle the allocation came from
+    uint32_t label_atom;   // Interned label, see braggi_alloc_profile_atom_name
+    uint32_t region_atom;  // Interned region name, 0 if the region had none
+    uint32_t line;         // Call site line, 0 if unknown
+    uint32_t column;       // Call site column, 0 if unknown
+    size_t size;           // Requested size in bytes
+} AllocSample;
+
+// Mean sampling interval; 0 means the profiler is off
+extern _Atomic uint32_t braggi_alloc_profile_rate;
+
+// Allocations this thread makes before its next sample, 0 until armed
+extern _Thread_local uint32_t braggi_alloc_profile_countdown;
+
+// Every allocation this thread has passed through the hook, and their
+// bytes. Counted whether or not sampling is on and never reset, so
+// callers measure a stretch of work by the difference.
+extern _Thread_local uint64_t braggi_alloc_profile_thread_count;
+extern _Thread_local uint64_t braggi_alloc_profile_thread_bytes;
+
+/**
+ * Turn sampling on
+ *
+ * @param rate Mean number of allocations between samples, 0 for the default
+ */
+void braggi_alloc_profile_enable(uint32_t rate);
+
+/**
+ * Turn sampling off. Collected data is kept until reset.
+ */
+void braggi_alloc_profile_disable(void);
+
+/**
+ * Check whether sampling is on
+ *
+ * @return true if allocations are being sampled
+ */
+bool braggi_alloc_profile_is_enabled(void);
+
+/**
+ * Drop all samples, totals and interned names
+ */
+void braggi_alloc_profile_reset(void);
+
+/**
+ * Get the number of samples taken since the last reset
+ *
+ * @return Sample count across all threads
+ */
+uint64_t braggi_alloc_profile_sample_count(void);
+
+/**
+ * Record a sample unconditionally. Allocators should call
+ * braggi_alloc_profile_note instead.
+ *
+ * @param region_key Region id or handle
+ * @param region_name Region name, can be NULL
+ * @param size Allocation size in bytes
+ * @param line Call site line
+ * @param column Call site column
+ * @param label Allocation label, can be NULL
+ */
+void braggi_alloc_profile_sample(uintptr_t region_key, const char* region_name, size_t size,
+                                 uint32_t line, uint32_t column, const char* label);
+
+/**
+ * Slow path of braggi_alloc_profile_note: arms this thread's countdown,
+ * or takes the sample it ran down to and draws the next interval.
+ */
+void braggi_alloc_profile_tick(uintptr_t region_key, const char* region_name, size_t size,
+                               uint32_t line, uint32_t column, const char* label);
+
+/**
+ * Allocation hook. Cheap enough to leave in every allocator.
+ */
+static inline void braggi_alloc_profile_note(uintptr_t region_key, const char* region_name,
+                                             size_t size, uint32_t line, uint32_t column,
+                                             const char* label) {
+    braggi_alloc_profile_thread_count++;
+    braggi_alloc_profile_thread_bytes += size;
+    if (atomic_load_explicit(&braggi_alloc_profile_rate, memory_order_relaxed) == 0) return;
+    if (braggi_alloc_profile_countdown > 1) {
+        braggi_alloc_profile_countdown--;
+        return;
+    }
+    braggi_alloc_profile_tick(region_key, region_name, size, line, column, label);
+}
+
+/**
+ * Copy the text behind an interned label or region name. A reset frees
+ * the interned names, so they are copied out rather than handed back.
+ *
+ * @param atom The atom
+ * @param dest Destination buffer, "(unlabeled)" for atom 0
+ * @param size Capacity of dest; longer names are truncated
+ * @return Length of the full name
+ */
+size_t braggi_alloc_profile_atom_name(uint32_t atom, char* dest, size_t size);
+
+/**
+ * Copy the most recent samples, newest first
+ *
+ * @param out Destination array
+ * @param max Capacity of out
+ * @return Number of samples copied
+ */
+size_t braggi_alloc_profile_recent(AllocSample* out, size_t max);
+
+/**
+ * Print estimated bytes by label and by region, largest first
+ *
+ * @param stream Destination stream
+ * @param top Maximum rows per table, 0 for all
+ */
+void braggi_alloc_profile_print(FILE* stream, size_t top);
+
+#endif /* BRAGGI_ALLOC_PROFILE_H */
@@ -297,16 +297,17 @@ const Error* braggi_context_get_error(BraggiContext* context, size_t index);
 bool braggi_context_has_errors(BraggiContext* context);
 
 /**
- * Report an error
+ * Report an error. Nothing is formatted until the diagnostic is shown.
  * 
  * @param context The context
  * @param category The error category
  * @param severity The error severity
- * @param line The line number
- * @param column The column number
- * @param filename The filename
- * @param message The error message
- * @param details The error details
+ * @param line The line number, unused
+ * @param column The column number, unused
+ * @param filename The filename, unused
+ * @param message The error message; kept by reference, so it must
+ *                outlive the context, e.g. a string literal
+ * @param details The error details, unused
  */
 void braggi_context_report_error(BraggiContext* context, ErrorCategory category, 
                                ErrorSeverity severity, uint32_t line, uint32_t column,
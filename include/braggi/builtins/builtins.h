@@ -27,6 +27,11 @@ typedef struct BuiltinFunction {
 // Define the proper builtin function type
 typedef BraggiValue* (*BraggiBuiltinFunc)(BraggiValue** args, size_t arg_count, void* context);
 
+// Dense builtin ID - an index into the registry's function table.
+// IDs are handed out in registration order and never reused.
+typedef uint32_t BraggiBuiltinId;
+#define BRAGGI_BUILTIN_INVALID UINT32_MAX
+
 /**
  * Look up a builtin function by name
  * 
@@ -37,6 +42,63 @@ typedef BraggiValue* (*BraggiBuiltinFunc)(BraggiValue** args, size_t arg_count,
  */
 BraggiBuiltinFunc braggi_builtin_registry_lookup(BraggiBuiltinRegistry* registry, const char* name, void** out_context);
 
+/**
+ * Register a boxed builtin. Registering an existing name replaces its
+ * function and keeps its ID.
+ *
+ * @param registry The registry to add to
+ * @param name The name of the builtin function
+ * @param func The function
+ * @param context Passed back to func on every call
+ */
+void braggi_builtin_registry_register(BraggiBuiltinRegistry* registry, const char* name,
+                                      BraggiBuiltinFunc func, void* context);
+
+/**
+ * Resolve a builtin name to its ID. Do this once - when the call is
+ * compiled - and call through the ID afterwards.
+ *
+ * @param registry The registry to search
+ * @param name The name of the builtin function
+ * @return The builtin's ID, or BRAGGI_BUILTIN_INVALID if it isn't registered
+ */
+BraggiBuiltinId braggi_builtin_registry_resolve(const BraggiBuiltinRegistry* registry, const char* name);
+
+/**
+ * Get a boxed builtin from the function table
+ *
+ * @param registry The registry
+ * @param id An ID from braggi_builtin_registry_resolve
+ * @param out_context If not NULL, receives the builtin's context pointer
+ * @return Function pointer, NULL if id is out of range or the builtin is native
+ */
+BraggiBuiltinFunc braggi_builtin_registry_func_at(const BraggiBuiltinRegistry* registry,
+                                                  BraggiBuiltinId id, void** out_context);
+
+/**
+ * Get the name a builtin was registered under
+ *
+ * @param registry The registry
+ * @param id A builtin ID
+ * @return The name, or NULL if id is out of range
+ */
+const char* braggi_builtin_registry_name(const BraggiBuiltinRegistry* registry, BraggiBuiltinId id);
+
+/**
+ * Get the number of registered builtins; valid IDs are below this
+ *
+ * @param registry The registry
+ * @return The number of builtins
+ */
+size_t braggi_builtin_registry_count(const BraggiBuiltinRegistry* registry);
+
+/**
+ * Register the core builtins ("print" and "exit")
+ *
+ * @param registry The registry to add to
+ */
+void braggi_builtins_register_core(BraggiBuiltinRegistry* registry);
+
 /**
  * Initialize the builtin function registry
  * 
@@ -20,6 +20,7 @@ typedef struct CodeGenerator {
     const char* name;             /* Name of the code generator */
     const char* description;      /* Description of the code generator */
     void* arch_data;              /* Architecture-specific data */
+    struct BraggiBuiltinRegistry* builtins; /* Builtins calls resolve against, set before generate */
     
     /* Initialize the code generator */
     bool (*init)(struct CodeGenerator* generator, ErrorHandler* error_handler);
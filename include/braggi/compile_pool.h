@@ -0,0 +1,153 @@
+/*
+ * Braggi - Compile Worker Pool
+ *
+ * "Ya saddle the whole remuda at sunup, then swap riders all day -
+ * nobody waits on a horse to be caught twice." - Big Bend Wrangler
+ *
+ * A fixed set of worker processes that compile one job after another.
+ * The caller sets up whatever global state the compiler needs, then
+ * creates the pool; workers are forked from it, so they start with
+ * that state already built and never pay for it again. Jobs go to idle
+ * workers over pipes, and each worker sends back an exit status.
+ *
+ * Workers are processes rather than threads because a compile changes
+ * global state (the pattern periscope, ECS worlds, entropy bookkeeping,
+ * the SIGSEGV cleanup guard) that isn't safe to share. Whatever the
+ * parent initialized is shared copy-on-write and read-only in effect.
+ * A worker that dies takes only its current job with it; the pool
+ * reports that job as crashed and forks a replacement.
+ *
+ * Workers ignore SIGINT and SIGTERM. A Ctrl-C reaches the whole process
+ * group, and the parent decides what becomes of running jobs; it stops
+ * workers by closing their job pipes. A worker forked later inherits
+ * whatever fds the parent has opened since, so the parent can set a
+ * hook that runs in each new worker to close them.
+ *
+ * Jobs are written with SIGPIPE blocked on the calling thread, so
+ * handing one to a dead worker fails instead of ending the process.
+ * The process's SIGPIPE disposition is left alone.
+ */
+
+#ifndef BRAGGI_COMPILE_POOL_H
+#define BRAGGI_COMPILE_POOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <poll.h>
+
+// Status reported for a job whose worker died before answering
+#define BRAGGI_COMPILE_POOL_CRASHED (-1)
+
+typedef struct BraggiCompilePool BraggiCompilePool;
+
+// One compilation. Strings are copied when the job is submitted.
+typedef struct BraggiCompileJob {
+    uint32_t id;              // Chosen by the caller, echoed in the result
+    const char* input;        // Source file
+    const char* output;       // Output file
+    int optimize_level;       // -O level to compile with
+} BraggiCompileJob;
+
+/**
+ * Compile one job. Runs in a worker process.
+ *
+ * @param job The job
+ * @param user_data Passed to braggi_compile_pool_create
+ * @return 0 on success, anything else on failure
+ */
+typedef int (*BraggiCompileFn)(const BraggiCompileJob* job, void* user_data);
+
+/**
+ * Run in a worker process right after it's forked
+ *
+ * @param user_data Passed to braggi_compile_pool_set_fork_hook
+ */
+typedef void (*BraggiWorkerForkFn)(void* user_data);
+
+/**
+ * Fork the workers
+ *
+ * @param workers Number of worker processes, at least 1
+ * @param compile Run by the workers for each job
+ * @param user_data Passed to compile
+ * @return The pool, or NULL if no worker could be started
+ */
+BraggiCompilePool* braggi_compile_pool_create(size_t workers, BraggiCompileFn compile, void* user_data);
+
+/**
+ * Stop the workers once they finish their current jobs, and free the
+ * pool. Jobs still queued are dropped.
+ */
+void braggi_compile_pool_destroy(BraggiCompilePool* pool);
+
+/**
+ * Set the hook run in workers forked from now on, replacing any earlier
+ * one. Workers that are already running don't run it.
+ *
+ * @param pool The pool
+ * @param hook The hook, or NULL for none
+ * @param user_data Passed to hook
+ */
+void braggi_compile_pool_set_fork_hook(BraggiCompilePool* pool, BraggiWorkerForkFn hook, void* user_data);
+
+/**
+ * Choose whether a worker that dies is replaced straight away. While
+ * off, a slot is only refilled when a queued job needs it, so a pool
+ * that is winding down doesn't fork workers nobody will use.
+ *
+ * @param pool The pool
+ * @param respawn true to replace dead workers, the default
+ */
+void braggi_compile_pool_set_respawn(BraggiCompilePool* pool, bool respawn);
+
+/**
+ * Queue a job. It's handed to a worker as soon as one is idle.
+ *
+ * @param pool The pool
+ * @param job The job; its strings are copied
+ * @return false if out of memory
+ */
+bool braggi_compile_pool_submit(BraggiCompilePool* pool, const BraggiCompileJob* job);
+
+/**
+ * Wait for a job to finish
+ *
+ * @param pool The pool
+ * @param id Receives the job's ID
+ * @param status Receives the compile function's result, or
+ *               BRAGGI_COMPILE_POOL_CRASHED
+ * @return false if no jobs are queued or running
+ */
+bool braggi_compile_pool_wait(BraggiCompilePool* pool, uint32_t* id, int* status);
+
+/**
+ * Like braggi_compile_pool_wait, but give up after a while
+ *
+ * @param pool The pool
+ * @param id Receives the job's ID
+ * @param status Receives the job's status
+ * @param timeout_ms How long to wait; 0 only checks, -1 waits forever
+ * @return false if nothing finished in time or nothing is pending
+ */
+bool braggi_compile_pool_wait_timeout(BraggiCompilePool* pool, uint32_t* id, int* status, int timeout_ms);
+
+/**
+ * Describe the fds that become readable when a job finishes, so the
+ * pool can share an event loop with other fds. When one is ready, call
+ * braggi_compile_pool_wait_timeout with a timeout of 0.
+ *
+ * @param pool The pool
+ * @param fds Filled with up to max entries polling for POLLIN
+ * @param max Room in fds; braggi_compile_pool_workers is always enough
+ * @return Number of entries filled
+ */
+size_t braggi_compile_pool_poll_fds(const BraggiCompilePool* pool, struct pollfd* fds, size_t max);
+
+// Jobs queued or running
+size_t braggi_compile_pool_pending(const BraggiCompilePool* pool);
+
+// Number of workers
+size_t braggi_compile_pool_workers(const BraggiCompilePool* pool);
+
+#endif /* BRAGGI_COMPILE_POOL_H */
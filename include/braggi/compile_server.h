@@ -0,0 +1,84 @@
+/*
+ * Braggi - Compile Server
+ *
+ * "A cook who keeps the fire banked all night has biscuits out
+ * before the hands have their boots on." - Chuckwagon Cookie, Llano Estacado
+ *
+ * Serves compile requests on a local Unix socket so builds skip the
+ * compiler's cold start. The server runs jobs on a compile pool that
+ * was built with the backends and pattern tables already set up, and
+ * keeps a cache of finished compilations. When neither the source nor
+ * the output has changed since the last successful compile with the
+ * same options, it answers without compiling.
+ *
+ * The cache looks only at the named source file. A build that pulls in
+ * other files has to send its own requests for them.
+ *
+ * The protocol is one line per request and one line per reply, with
+ * fields separated by tabs:
+ *
+ *   compile <TAB> OPTIMIZE <TAB> INPUT <TAB> OUTPUT
+ *       -> "ok compiled", "ok cached", "failed STATUS" or "error MESSAGE"
+ *   shutdown
+ *       -> "ok shutdown"; jobs already running are finished first
+ *
+ * Paths must be absolute, since the server's working directory has
+ * nothing to do with the client's. A connection may send many requests;
+ * each gets its reply before the next one is read.
+ *
+ * Only one job writes an output at a time. A request for the same
+ * input, output and optimization level as a running job, with the
+ * input unchanged since that job started, waits for it and gets the
+ * same reply. Any other request for that output gets "error busy".
+ */
+
+#ifndef BRAGGI_COMPILE_SERVER_H
+#define BRAGGI_COMPILE_SERVER_H
+
+#include "braggi/compile_pool.h"
+#include <stdbool.h>
+
+// Replies from braggi_compile_server_request
+typedef enum BraggiServerReply {
+    BRAGGI_SERVER_COMPILED,      // Compiled successfully
+    BRAGGI_SERVER_CACHED,        // Unchanged since the last compile
+    BRAGGI_SERVER_FAILED,        // The compile failed
+    BRAGGI_SERVER_ERROR          // Bad request, or the server couldn't be reached
+} BraggiServerReply;
+
+/**
+ * Serve requests until a shutdown request, SIGINT or SIGTERM. Jobs
+ * already running finish and are answered first; workers ignore those
+ * signals, so a Ctrl-C to the whole process group doesn't cut them short.
+ * While it runs the server holds the pool's fork hook.
+ *
+ * @param socket_path Where to listen. A stale socket file is replaced;
+ *                    a live server on the same path is an error.
+ * @param pool Runs the compiles; still owned by the caller
+ * @return 0 after a clean shutdown, 1 if the server couldn't start
+ */
+int braggi_compile_server_run(const char* socket_path, BraggiCompilePool* pool);
+
+/**
+ * Ask a server to compile a file and wait for the answer
+ *
+ * @param socket_path The server's socket
+ * @param job What to compile; relative paths are made absolute here
+ * @param message Receives the server's explanation for
+ *                BRAGGI_SERVER_ERROR or the status for
+ *                BRAGGI_SERVER_FAILED; may be NULL
+ * @param message_size Size of message
+ * @return The server's reply
+ */
+BraggiServerReply braggi_compile_server_request(const char* socket_path, const BraggiCompileJob* job,
+                                                char* message, size_t message_size);
+
+/**
+ * Ask a server to exit once its running jobs finish
+ *
+ * @param socket_path The server's socket
+ * @return false if the server couldn't be reached
+ */
+bool braggi_compile_server_shutdown(const char* socket_path);
+
+#endif /* BRAGGI_COMPILE_SERVER_H */
@@ -0,0 +1,239 @@
+/*
+ * Braggi - Diagnostics Engine
+ *
+ * "When the whole herd's bawlin', ya don't holler about every calf -
+ * ya count 'em, sort 'em, and tell the boss once at sundown."
+ * - Texan Trail Foreman
+ *
+ * Diagnostics are collected rather than printed where they're reported.
+ * Each one is copied into an arena owned by the engine. A report with the
+ * same severity, code, file, position and message as one already pending
+ * is folded into it, and only its repeat count goes up. Once the limit is
+ * reached, further reports are only counted. Fatal diagnostics are always
+ * kept.
+ *
+ * Flushing sorts pending diagnostics by file, line and column, hands
+ * them to every sink, then reports how many were left out. The engine
+ * never prints on its own and never ends the process; whoever owns it
+ * decides when to flush and what a fatal diagnostic means.
+ *
+ * Hot paths report structured records instead of text: a message ID
+ * and a few typed arguments, copied as plain data. Their text and
+ * line/column are worked out only when a flush has a sink to render
+ * them, so reports that get folded, dropped or never shown cost no
+ * formatting at all.
+ *
+ * Reporting and flushing may happen from several threads.
+ */
+
+#ifndef BRAGGI_DIAGNOSTICS_H
+#define BRAGGI_DIAGNOSTICS_H
+
+#include "braggi/error.h"
+#include "braggi/source_position.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+// Distinct diagnostics kept between flushes unless changed
+#define BRAGGI_DIAGNOSTICS_DEFAULT_LIMIT 200
+
+// Sinks an engine can feed at once
+#define BRAGGI_DIAGNOSTICS_MAX_SINKS 4
+
+typedef struct BraggiDiagnostics BraggiDiagnostics;
+
+// Messages a structured record can carry. Numbers are stable once
+// released; add new ones before BRAGGI_DIAG_ID_COUNT.
+typedef enum BraggiDiagId {
+    BRAGGI_DIAG_NONE,
+    BRAGGI_DIAG_NO_TOKENS,            // No tokens to initialize field
+    BRAGGI_DIAG_FIELD_FAILED,         // Failed to create entropy field
+    BRAGGI_DIAG_CELL_FAILED,          // {0}: token
+    BRAGGI_DIAG_STATE_FAILED,         // {0}: token, {1}: cell
+    BRAGGI_DIAG_CONSTRAINT_FAILED,    // {0}: text kind, {1}: cell, {2}: cell
+    BRAGGI_DIAG_CONSTRAINTS_FAILED,   // Failed to create syntax or semantic constraints
+    BRAGGI_DIAG_CONTRADICTION,        // {0}: cell
+    BRAGGI_DIAG_COLLAPSE_FAILED,      // Wave function collapse failed
+    BRAGGI_DIAG_OUT_OF_MEMORY,        // {0}: text, what was being built
+    BRAGGI_DIAG_CONTEXT_FAILED,       // {0}: text, the compile step that failed
+    BRAGGI_DIAG_ID_COUNT
+} BraggiDiagId;
+
+typedef enum BraggiDiagArgKind {
+    BRAGGI_DIAG_ARG_NONE,
+    BRAGGI_DIAG_ARG_INT,
+    BRAGGI_DIAG_ARG_CELL,
+    BRAGGI_DIAG_ARG_STATE,
+    BRAGGI_DIAG_ARG_LOC,
+    BRAGGI_DIAG_ARG_TOKEN,            // Token type and where it starts
+    BRAGGI_DIAG_ARG_TEXT              // String that outlives the engine, e.g. a literal
+} BraggiDiagArgKind;
+
+#define BRAGGI_DIAG_MAX_ARGS 4
+
+typedef struct BraggiDiagArg {
+    BraggiDiagArgKind kind;
+    union {
+        int64_t i;
+        uint32_t id;                  // Cell or state ID
+        BraggiSourceLoc loc;
+        struct {
+            uint32_t type;            // TokenType
+            BraggiSourceLoc loc;
+        } token;
+        const char* text;
+    } as;
+} BraggiDiagArg;
+
+#define BRAGGI_DIAG_INT(v)     ((BraggiDiagArg){.kind = BRAGGI_DIAG_ARG_INT, .as.i = (v)})
+#define BRAGGI_DIAG_CELL(v)    ((BraggiDiagArg){.kind = BRAGGI_DIAG_ARG_CELL, .as.id = (v)})
+#define BRAGGI_DIAG_STATE(v)   ((BraggiDiagArg){.kind = BRAGGI_DIAG_ARG_STATE, .as.id = (v)})
+#define BRAGGI_DIAG_LOC(v)     ((BraggiDiagArg){.kind = BRAGGI_DIAG_ARG_LOC, .as.loc = (v)})
+#define BRAGGI_DIAG_TOKEN(t)   ((BraggiDiagArg){.kind = BRAGGI_DIAG_ARG_TOKEN, \
+                                .as.token = {(uint32_t)(t)->type, (t)->loc}})
+#define BRAGGI_DIAG_TEXT(v)    ((BraggiDiagArg){.kind = BRAGGI_DIAG_ARG_TEXT, .as.text = (v)})
+
+// A diagnostic before it's rendered. Plain data: copy it, don't free it.
+typedef struct BraggiDiagRecord {
+    BraggiDiagId id;
+    ErrorCategory category;
+    ErrorSeverity severity;
+    BraggiSourceLoc loc;              // BRAGGI_SOURCE_LOC_INVALID if unknown
+    BraggiDiagArg args[BRAGGI_DIAG_MAX_ARGS];
+} BraggiDiagRecord;
+
+// A collected diagnostic, as sinks see it. It and its strings are
+// only valid during the sink call.
+typedef struct BraggiDiagnostic {
+    uint32_t code;
+    ErrorCategory category;
+    ErrorSeverity severity;
+    SourcePosition position;
+    const char* filename;    // NULL if unknown
+    const char* message;
+    const char* detail;      // NULL if none
+    uint32_t sequence;       // Order of the first report
+    uint32_t repeats;        // Identical reports folded into this one
+    const BraggiDiagRecord* record; // Structured form, NULL for text reports;
+                                    // code is then the message ID
+} BraggiDiagnostic;
+
+// Where flushed diagnostics go. emit is called once per diagnostic in
+// sorted order; summary, if set, once per flush that dropped reports.
+typedef struct BraggiDiagnosticSink {
+    void (*emit)(const BraggiDiagnostic* diagnostic, void* user_data);
+    void (*summary)(size_t suppressed, void* user_data);
+    void* user_data;
+} BraggiDiagnosticSink;
+
+BraggiDiagnostics* braggi_diagnostics_create(void);
+
+// Destroy an engine. Pending diagnostics are dropped, not flushed.
+void braggi_diagnostics_destroy(BraggiDiagnostics* diagnostics);
+
+/**
+ * Set how many distinct diagnostics are kept between flushes
+ *
+ * @param diagnostics The engine
+ * @param limit Most diagnostics to keep, or 0 for no limit
+ */
+void braggi_diagnostics_set_limit(BraggiDiagnostics* diagnostics, size_t limit);
+
+/**
+ * Add a sink
+ *
+ * @param diagnostics The engine
+ * @param sink The sink; emit must be set
+ * @return false if the engine already has BRAGGI_DIAGNOSTICS_MAX_SINKS
+ */
+bool braggi_diagnostics_add_sink(BraggiDiagnostics* diagnostics, BraggiDiagnosticSink sink);
+
+void braggi_diagnostics_clear_sinks(BraggiDiagnostics* diagnostics);
+
+/**
+ * Report a diagnostic
+ *
+ * @param diagnostics The engine
+ * @param code Diagnostic code, 0 if none
+ * @param category The category
+ * @param severity The severity
+ * @param position Where it happened
+ * @param filename File name, or NULL
+ * @param message The message, copied
+ * @param detail Longer explanation, or NULL; copied
+ * @return true if it was kept as a new diagnostic, false if it was
+ *         folded into an earlier one or dropped over the limit
+ */
+bool braggi_diagnostics_report(BraggiDiagnostics* diagnostics, uint32_t code,
+                               ErrorCategory category, ErrorSeverity severity,
+                               SourcePosition position, const char* filename,
+                               const char* message, const char* detail);
+
+/**
+ * Report a structured diagnostic. Nothing is formatted here.
+ *
+ * @param diagnostics The engine
+ * @param record The record, copied
+ * @return true if it was kept as a new diagnostic
+ */
+bool braggi_diagnostics_report_record(BraggiDiagnostics* diagnostics, const BraggiDiagRecord* record);
+
+/**
+ * Render a record's message
+ *
+ * @param record The record
+ * @param buffer Receives the text, always terminated if size > 0
+ * @param size Size of buffer
+ * @return Length of the full message, like snprintf
+ */
+size_t braggi_diag_format(const BraggiDiagRecord* record, char* buffer, size_t size);
+
+/**
+ * Send pending diagnostics to the sinks in source order and start over
+ *
+ * @param diagnostics The engine
+ * @return Number of diagnostics emitted
+ */
+size_t braggi_diagnostics_flush(BraggiDiagnostics* diagnostics);
+
+// Drop pending diagnostics without emitting them and zero the counts
+void braggi_diagnostics_clear(BraggiDiagnostics* diagnostics);
+
+// Diagnostics waiting for a flush
+size_t braggi_diagnostics_pending(const BraggiDiagnostics* diagnostics);
+
+// Reports dropped over the limit since the last flush
+size_t braggi_diagnostics_suppressed(const BraggiDiagnostics* diagnostics);
+
+/**
+ * Count reports at or above a severity, including folded and dropped
+ * ones, since the engine was created or last cleared
+ *
+ * @param diagnostics The engine
+ * @param min_severity Lowest severity counted
+ * @return The count
+ */
+size_t braggi_diagnostics_count(const BraggiDiagnostics* diagnostics, ErrorSeverity min_severity);
+
+/**
+ * Sink that writes one line per diagnostic, as
+ * "[category:severity] file:line:column: message", with the detail
+ * indented on the next line
+ *
+ * @param stream Where to write
+ * @return The sink
+ */
+BraggiDiagnosticSink braggi_diagnostic_sink_text(FILE* stream);
+
+/**
+ * Sink that writes one JSON object per line, and a final
+ * {"suppressed": N} object when reports were dropped
+ *
+ * @param stream Where to write
+ * @return The sink
+ */
+BraggiDiagnosticSink braggi_diagnostic_sink_json(FILE* stream);
+
+#endif /* BRAGGI_DIAGNOSTICS_H */
@@ -14,6 +14,7 @@
 #include <stddef.h>
 #include "braggi/source.h"
 #include "braggi/error.h"
+#include "braggi/diagnostics.h"
 #include "braggi/util/vector.h"
 
 // Forward declarations
@@ -88,8 +89,13 @@ struct EntropyField {
     uint32_t contradiction_cell_id; // ID of cell with contradiction
     uint32_t source_id;       // ID of source file
     void* error_handler;      // Error handler
+    uint32_t* token_cells;    // Cell of each token by token index, owned
+    size_t token_count;       // Entries in token_cells
 };
 
+// No cell for this token: it was NULL, or the field has no token map
+#define ENTROPY_NO_CELL UINT32_MAX
+
 // Rule represents a pattern-based rule for entropy propagation
 struct EntropyRule {
     uint32_t id;                  // Unique identifier for this rule
@@ -130,11 +136,36 @@ void braggi_entropy_field_destroy(EntropyField* field);
 EntropyCell* braggi_entropy_field_add_cell(EntropyField* field, uint32_t position);
 EntropyCell* braggi_entropy_field_get_cell(EntropyField* field, uint32_t cell_id);
 EntropyCell* braggi_entropy_field_get_cell_at(EntropyField* field, uint32_t x, uint32_t y);
+
+/**
+ * Give the field its token-index to cell-ID map
+ *
+ * @param field The field, which takes ownership of token_cells
+ * @param token_cells Cell ID of each token, ENTROPY_NO_CELL for none
+ * @param token_count Number of entries
+ */
+void braggi_entropy_field_set_token_cells(EntropyField* field, uint32_t* token_cells, size_t token_count);
+
+// Cell ID of the token at token_index in the vector the field was built
+// from, or ENTROPY_NO_CELL
+static inline uint32_t braggi_entropy_field_token_cell(const EntropyField* field, size_t token_index) {
+    return token_index < field->token_count ? field->token_cells[token_index] : ENTROPY_NO_CELL;
+}
 bool braggi_entropy_field_add_constraint(EntropyField* field, EntropyConstraint* constraint);
 bool braggi_entropy_field_add_rule(EntropyField* field, EntropyRule* rule);
 bool braggi_entropy_field_is_fully_collapsed(EntropyField* field);
 bool braggi_entropy_field_has_contradiction(EntropyField* field);
 bool braggi_entropy_field_get_contradiction_info(EntropyField* field, void* position, char** message);
+
+/**
+ * Describe the first cell left with no states as a diagnostic record.
+ * Nothing is formatted; the text is only built if the record is shown.
+ *
+ * @param field The field
+ * @param record Receives a BRAGGI_DIAG_CONTRADICTION record
+ * @return true if the field has a contradiction
+ */
+bool braggi_entropy_field_get_contradiction_record(EntropyField* field, BraggiDiagRecord* record);
 EntropyCell* braggi_entropy_field_find_lowest_entropy_cell(EntropyField* field);
 bool braggi_entropy_field_collapse_cell(EntropyField* field, uint32_t cell_id, uint32_t state_index);
 bool braggi_entropy_field_propagate_constraints(EntropyField* field, uint32_t cell_id);
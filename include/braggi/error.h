@@ -61,6 +61,9 @@ typedef struct ErrorHandler {
     
     // Reset error state (optional)
     void (*reset)(struct ErrorHandler* handler);
+    
+    // Collects reports for deferred output (NULL: keep errors only)
+    struct BraggiDiagnostics* diagnostics;
 } ErrorHandler;
 
 // Extended error information
@@ -10,6 +10,7 @@
 #define BRAGGI_ERROR_HANDLER_H
 
 #include "braggi/error.h"
+#include "braggi/diagnostics.h"
 #include <stdio.h>
 
 /*
@@ -32,6 +33,25 @@ const Error* braggi_error_handler_get_error(const ErrorHandler* handler, size_t
 /* Clear all errors from the handler */
 void braggi_error_handler_clear(ErrorHandler* handler);
 
+/*
+ * Get the diagnostics engine behind a handler. A new handler's engine
+ * writes text to stderr; add or replace sinks to send it elsewhere.
+ */
+BraggiDiagnostics* braggi_error_handler_get_diagnostics(ErrorHandler* handler);
+
+/*
+ * Report a structured diagnostic. It goes to the diagnostics engine
+ * only: no Error is built, so nothing is formatted unless a flush
+ * renders it. Counted by braggi_error_handler_has_errors.
+ */
+void braggi_error_report_record(ErrorHandler* handler, const BraggiDiagRecord* record);
+
+/*
+ * Emit the handler's pending diagnostics in source order. Also done
+ * when the handler is destroyed. Returns the number emitted.
+ */
+size_t braggi_error_handler_flush(ErrorHandler* handler);
+
 /* Get the error handler associated with a context (e.g., parser, compiler) */
 ErrorHandler* braggi_error_handler_get_handler(void* context);
 
@@ -0,0 +1,64 @@
+/*
+ * Braggi - Numeric Kernels
+ *
+ * "When ya got a thousand fence posts to set, ya don't dig one hole
+ * at a time - ya bring the auger with four bits!" - Texan Fencin' Wisdom
+ *
+ * Element-wise and reduction loops over contiguous int64_t and double
+ * buffers. They back the array forms of the math builtins and are
+ * written so the compiler turns them into SIMD code. Output buffers may
+ * not overlap inputs.
+ */
+
+#ifndef BRAGGI_MATH_KERNELS_H
+#define BRAGGI_MATH_KERNELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Element-wise double kernels: out[i] = a[i] op b[i]
+void braggi_kernel_add_f64(double* out, const double* a, const double* b, size_t n);
+void braggi_kernel_sub_f64(double* out, const double* a, const double* b, size_t n);
+void braggi_kernel_mul_f64(double* out, const double* a, const double* b, size_t n);
+void braggi_kernel_div_f64(double* out, const double* a, const double* b, size_t n);
+
+// out[i] = a[i] * b[i] + c[i]
+void braggi_kernel_fma_f64(double* out, const double* a, const double* b, const double* c, size_t n);
+
+// Broadcast double kernels: out[i] = a[i] op s
+void braggi_kernel_add_scalar_f64(double* out, const double* a, double s, size_t n);
+void braggi_kernel_mul_scalar_f64(double* out, const double* a, double s, size_t n);
+void braggi_kernel_div_scalar_f64(double* out, const double* a, double s, size_t n);
+
+// out[i] = s - a[i] and out[i] = s / a[i]
+void braggi_kernel_rsub_scalar_f64(double* out, const double* a, double s, size_t n);
+void braggi_kernel_rdiv_scalar_f64(double* out, const double* a, double s, size_t n);
+
+// Double reductions. min and max of an empty buffer are 0.
+double braggi_kernel_dot_f64(const double* a, const double* b, size_t n);
+double braggi_kernel_sum_f64(const double* a, size_t n);
+double braggi_kernel_min_f64(const double* a, size_t n);
+double braggi_kernel_max_f64(const double* a, size_t n);
+
+// Element-wise integer kernels, wrapping on overflow
+void braggi_kernel_add_i64(int64_t* out, const int64_t* a, const int64_t* b, size_t n);
+void braggi_kernel_sub_i64(int64_t* out, const int64_t* a, const int64_t* b, size_t n);
+void braggi_kernel_mul_i64(int64_t* out, const int64_t* a, const int64_t* b, size_t n);
+
+// Broadcast integer kernels, wrapping on overflow
+void braggi_kernel_add_scalar_i64(int64_t* out, const int64_t* a, int64_t s, size_t n);
+void braggi_kernel_mul_scalar_i64(int64_t* out, const int64_t* a, int64_t s, size_t n);
+
+// out[i] = s - a[i], wrapping on overflow
+void braggi_kernel_rsub_scalar_i64(int64_t* out, const int64_t* a, int64_t s, size_t n);
+
+// Integer reductions, wrapping on overflow
+int64_t braggi_kernel_dot_i64(const int64_t* a, const int64_t* b, size_t n);
+int64_t braggi_kernel_sum_i64(const int64_t* a, size_t n);
+int64_t braggi_kernel_min_i64(const int64_t* a, size_t n);
+int64_t braggi_kernel_max_i64(const int64_t* a, size_t n);
+
+// Widen an integer buffer to doubles
+void braggi_kernel_i64_to_f64(double* out, const int64_t* a, size_t n);
+
+#endif /* BRAGGI_MATH_KERNELS_H */
@@ -0,0 +1,141 @@
+/*
+ * Braggi - Module Cache
+ *
+ * "Ya brand a calf once - after that ya just read the brand!"
+ * - Texan Roundup Wisdom
+ *
+ * A module is compiled once into an artifact holding its interface
+ * (exported names and imports) and its token stream. Artifacts are
+ * written to a cache directory and mapped read-only when a module is
+ * first imported. They are rebuilt only when the source file's size or
+ * modification time changes.
+ *
+ * The cache directory is $BRAGGI_MODULE_CACHE, else
+ * $XDG_CACHE_HOME/braggi/modules, else ~/.cache/braggi/modules. If none
+ * can be created, the artifact is built in memory for the session.
+ */
+
+#ifndef BRAGGI_MODULE_CACHE_H
+#define BRAGGI_MODULE_CACHE_H
+
+#include "braggi/token.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Environment variable naming the artifact directory
+#define BRAGGI_MODULE_CACHE_ENV "BRAGGI_MODULE_CACHE"
+
+// Bump when the artifact layout changes; older artifacts get rebuilt
+#define BRAGGI_MODULE_FORMAT_VERSION 1
+
+typedef struct BraggiModule BraggiModule;
+
+// What a top-level declaration introduces
+typedef enum BraggiExportKind {
+    BRAGGI_EXPORT_FUNCTION,
+    BRAGGI_EXPORT_CONSTANT,
+    BRAGGI_EXPORT_VARIABLE,
+    BRAGGI_EXPORT_TYPE,
+    BRAGGI_EXPORT_REGION
+} BraggiExportKind;
+
+// A name the module declares at top level
+typedef struct BraggiModuleExport {
+    const char* name;        // Points into the mapped artifact
+    BraggiExportKind kind;
+    uint32_t token_index;    // Token that starts the declaration
+    uint32_t line;
+} BraggiModuleExport;
+
+// One token of the module's code
+typedef struct BraggiModuleToken {
+    TokenType type;
+    const char* text;        // Points into the mapped artifact
+    uint32_t line;
+    uint32_t column;
+} BraggiModuleToken;
+
+/**
+ * Load a module by name, compiling it if its artifact is missing or
+ * stale. Modules are looked up with braggi_stdlib_find_file as
+ * "<name>.bg". Later calls return the module already loaded.
+ *
+ * @param name The module name, e.g. "collections"
+ * @return The module, or NULL if it can't be found or compiled
+ */
+const BraggiModule* braggi_module_load(const char* name);
+
+/**
+ * Get a module loaded earlier without loading it
+ *
+ * @param name The module name
+ * @return The module, or NULL if it hasn't been loaded
+ */
+const BraggiModule* braggi_module_find_loaded(const char* name);
+
+/**
+ * Unmap every loaded module. Pointers from earlier lookups become
+ * invalid.
+ */
+void braggi_module_unload_all(void);
+
+const char* braggi_module_name(const BraggiModule* module);
+const char* braggi_module_source_path(const BraggiModule* module);
+
+/**
+ * Check whether the module came from an up-to-date artifact rather
+ * than being compiled by this load
+ *
+ * @param module The module
+ * @return true on a cache hit
+ */
+bool braggi_module_from_cache(const BraggiModule* module);
+
+size_t braggi_module_export_count(const BraggiModule* module);
+
+/**
+ * Get an exported name
+ *
+ * @param module The module
+ * @param index Export index
+ * @param out Receives the export
+ * @return false if index is out of range
+ */
+bool braggi_module_export_at(const BraggiModule* module, size_t index, BraggiModuleExport* out);
+
+/**
+ * Find an exported name
+ *
+ * @param module The module
+ * @param name The name to look for
+ * @param out If not NULL, receives the export
+ * @return true if the module exports name
+ */
+bool braggi_module_find_export(const BraggiModule* module, const char* name, BraggiModuleExport* out);
+
+size_t braggi_module_import_count(const BraggiModule* module);
+
+/**
+ * Get the name of a module this one imports. Imports aren't loaded
+ * until someone asks for them.
+ *
+ * @param module The module
+ * @param index Import index
+ * @return The imported module's name, or NULL if index is out of range
+ */
+const char* braggi_module_import_at(const BraggiModule* module, size_t index);
+
+size_t braggi_module_token_count(const BraggiModule* module);
+
+/**
+ * Get one token of the module's code
+ *
+ * @param module The module
+ * @param index Token index
+ * @param out Receives the token
+ * @return false if index is out of range
+ */
+bool braggi_module_token_at(const BraggiModule* module, size_t index, BraggiModuleToken* out);
+
+#endif /* BRAGGI_MODULE_CACHE_H */
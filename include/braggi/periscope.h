@@ -20,6 +20,29 @@ typedef struct Periscope Periscope;
 typedef struct PeriscopeView PeriscopeView;
 typedef struct RegionLifetimeContract RegionLifetimeContract;
 
+// Index of a contract in its periscope. Stable for the periscope's lifetime.
+typedef uint32_t PeriscopeContractId;
+#define PERISCOPE_CONTRACT_INVALID UINT32_MAX
+
+/*
+ * Region lifetime contracts, one array per field. Validation looks at
+ * every contract on each pass, so the fields it reads sit packed next
+ * to each other instead of behind a pointer per contract. Validity and
+ * violations are bitmaps: bit i of word i / 64 is contract i.
+ */
+typedef struct PeriscopeContracts {
+    EntityID* region_entities;        // Region each contract guards
+    EntityID* validator_entities;     // Validator each contract serves
+    uint32_t* guarantee_flags;        // Guarantees each contract makes
+    uint64_t* valid_bits;             // Set while a contract is in force
+    uint64_t* violation_bits;         // Set by the last batched validation
+    size_t count;
+    size_t capacity;
+    size_t violation_count;           // Bits set in violation_bits
+    uint32_t validated_flags;         // Required flags of the last validation
+    bool dirty;                       // Changed since the last validation
+} PeriscopeContracts;
+
 // Periscope system tracks token-to-cell mappings and region lifetime contracts
 struct Periscope {
     ECSWorld* ecs_world;             // Reference to the ECS world
@@ -27,7 +50,7 @@ struct Periscope {
     ComponentTypeID cell_component;   // Component type for cells
     ComponentTypeID validator_component; // Component type for validators
     Vector* token_to_cell_mappings;  // Mapping from tokens to cell entities
-    Vector* active_contracts;        // Active region lifetime contracts
+    PeriscopeContracts contracts;    // Region lifetime contracts
     bool (*validator)(struct EntropyConstraint*, struct EntropyField*);  // Validator function
 };
 
@@ -39,7 +62,9 @@ struct PeriscopeView {
     Vector* cells_in_view;           // Cells visible in this view
 };
 
-// Contract ensuring region lifetime guarantees for validators
+// Contract ensuring region lifetime guarantees for validators. This is
+// the unpacked form for passing one contract in or out; the periscope
+// stores them as PeriscopeContracts.
 struct RegionLifetimeContract {
     EntityID region_entity;           // Entity representing the region
     EntityID validator_entity;        // Entity representing the validator
@@ -71,13 +96,54 @@ PeriscopeView* braggi_periscope_create_view(Periscope* periscope, EntityID regio
 // Destroy a periscope view
 void braggi_periscope_destroy_view(PeriscopeView* view);
 
-// Create a contract for a validator to ensure region lifetime guarantees
-RegionLifetimeContract* braggi_periscope_create_contract(
+// Create a contract for a validator to ensure region lifetime guarantees.
+// Returns PERISCOPE_CONTRACT_INVALID if it couldn't be stored.
+PeriscopeContractId braggi_periscope_create_contract(
     Periscope* periscope,
     EntityID region_entity,
     EntityID validator_entity,
     uint32_t guarantee_flags);
 
+/**
+ * Copy a contract out of the periscope
+ *
+ * @param periscope The periscope
+ * @param id The contract
+ * @param out Receives the contract
+ * @return false if there is no such contract
+ */
+bool braggi_periscope_get_contract(const Periscope* periscope, PeriscopeContractId id,
+                                   RegionLifetimeContract* out);
+
+// Put a contract in or out of force
+bool braggi_periscope_set_contract_valid(Periscope* periscope, PeriscopeContractId id, bool is_valid);
+
+// Number of contracts, valid or not
+size_t braggi_periscope_contract_count(const Periscope* periscope);
+
+/**
+ * Check every contract in one pass. A contract is violated when it is
+ * out of force or lacks one of required_flags; the entities it names
+ * aren't checked, so a contract still being wired up to its region or
+ * validator counts as long as it is in force. The result is kept in
+ * periscope->contracts.violation_bits until contracts change, so asking
+ * again with the same flags costs nothing.
+ *
+ * @param periscope The periscope
+ * @param required_flags Guarantees every contract must make, 0 for none
+ * @return Number of violated contracts
+ */
+size_t braggi_periscope_validate_contracts(Periscope* periscope, uint32_t required_flags);
+
+// Contracts that pass braggi_periscope_validate_contracts with no required flags
+size_t braggi_periscope_valid_contract_count(Periscope* periscope);
+
+// Whether the last batched validation found contract id violated; id
+// must be below braggi_periscope_contract_count
+static inline bool braggi_periscope_contract_violated(const Periscope* periscope, PeriscopeContractId id) {
+    return (periscope->contracts.violation_bits[id / 64] >> (id % 64)) & 1u;
+}
+
 // Validate constraints against region lifetime contracts
 bool braggi_periscope_validate_constraints(
     Periscope* periscope,
@@ -99,7 +165,7 @@ bool braggi_periscope_check_validator(
 // ECS system update function for periscope updates
 void braggi_periscope_system_update(ECSWorld* world, System* system, float delta_time);
 
-// Register a contract with the periscope
-bool braggi_periscope_register_contract(Periscope* periscope, void* contract);
+// Register a contract with the periscope. The contract is copied.
+bool braggi_periscope_register_contract(Periscope* periscope, const RegionLifetimeContract* contract);
 
 #endif /* BRAGGI_PERISCOPE_H */ 
\ No newline at end of file
@@ -0,0 +1,126 @@
+/*
+ * Braggi - Compiler Phase Report
+ *
+ * "Ya can't fix a slow trail drive till ya know which river
+ * crossin' is holdin' up the herd!" - Texan Trail Boss Wisdom
+ */
+
+#ifndef BRAGGI_PHASE_REPORT_H
+#define BRAGGI_PHASE_REPORT_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Forward declarations
+typedef struct RegionManager RegionManager;
+
+// Compiler phases, in pipeline order
+typedef enum PhaseId {
+    PHASE_SOURCE_LOAD = 0,
+    PHASE_SETUP,
+    PHASE_TOKENIZE,
+    PHASE_FIELD_INIT,
+    PHASE_CONSTRAINTS,
+    PHASE_PROPAGATE,
+    PHASE_ECS_SYNC,
+    PHASE_CODEGEN,
+    PHASE_EMIT,
+    PHASE_COUNT
+} PhaseId;
+
+// Measurements for a single phase
+typedef struct PhaseStats {
+    bool ran;                  // Whether the phase was entered at all
+    uint64_t wall_ns;          // Wall clock time
+    uint64_t cpu_ns;           // Process CPU time
+    int64_t heap_delta;        // Change in bytes held by the C heap
+    size_t heap_in_use;        // Bytes held by the C heap when the phase ended
+    uint64_t alloc_count;      // Allocations through the profiler hook
+    uint64_t alloc_bytes;      // Bytes in those allocations
+    size_t arena_in_use;       // Bytes held by all regions when the phase ended
+    size_t arena_peak;         // Most bytes all regions held during the phase
+} PhaseStats;
+
+// Per-phase report for one compilation
+typedef struct PhaseReport {
+    PhaseStats phases[PHASE_COUNT];
+    PhaseId current;           // Phase being measured, PHASE_COUNT when idle
+    RegionManager* regions;    // Optional, listed after the memory table
+
+    // Snapshot taken when the current phase began
+    uint64_t start_wall_ns;
+    uint64_t start_cpu_ns;
+    size_t start_heap;
+    uint64_t start_alloc_count;
+    uint64_t start_alloc_bytes;
+} PhaseReport;
+
+/**
+ * Reset a report so every phase reads zero
+ *
+ * @param report The report to initialize
+ */
+void braggi_phase_report_init(PhaseReport* report);
+
+/**
+ * Set the region manager whose regions the memory report lists
+ *
+ * @param report The report
+ * @param regions The region manager, can be NULL
+ */
+void braggi_phase_report_set_regions(PhaseReport* report, RegionManager* regions);
+
+/**
+ * Start measuring a phase. Any phase still open is ended first.
+ *
+ * @param report The report
+ * @param phase The phase that is starting
+ */
+void braggi_phase_report_begin(PhaseReport* report, PhaseId phase);
+
+/**
+ * Stop measuring the current phase. Time spent in a phase that is
+ * entered more than once is added up.
+ *
+ * @param report The report
+ */
+void braggi_phase_report_end(PhaseReport* report);
+
+/**
+ * Get the display name of a phase
+ *
+ * @param phase The phase
+ * @return A static string such as "tokenize"
+ */
+const char* braggi_phase_name(PhaseId phase);
+
+/**
+ * Print the timing columns as a table
+ *
+ * @param report The report
+ * @param stream Destination stream
+ */
+void braggi_phase_report_print_time(const PhaseReport* report, FILE* stream);
+
+/**
+ * Print the memory columns as a table, followed by the per-region usage
+ *
+ * @param report The report
+ * @param stream Destination stream
+ */
+void braggi_phase_report_print_mem(const PhaseReport* report, FILE* stream);
+
+/**
+ * Write the report as a JSON object
+ *
+ * @param report The report
+ * @param stream Destination stream
+ * @param include_time Whether to write the timing fields
+ * @param include_mem Whether to write the memory fields
+ */
+void braggi_phase_report_write_json(const PhaseReport* report, FILE* stream,
+                                    bool include_time, bool include_mem);
+
+#endif /* BRAGGI_PHASE_REPORT_H */
@@ -43,6 +43,11 @@ const char* braggi_named_region_name(Region* region);
 RegionId braggi_named_region_id(Region* region);
 RegionId braggi_named_region_parent(Region* region);
 
+// Bytes held by all live regions together, and the most they have held
+// since the last braggi_named_region_reset_peak; either may be NULL
+void braggi_named_region_totals(size_t* in_use, size_t* peak);
+void braggi_named_region_reset_peak(void);
+
 // Region tree operations
 void braggi_named_region_add_child(Region* parent, Region* child);
 void braggi_named_region_remove_child(Region* parent, Region* child);
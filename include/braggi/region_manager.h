@@ -9,6 +9,7 @@
 #define BRAGGI_REGION_MANAGER_H
 
 #include <stddef.h>
+#include <stdio.h>
 #include "braggi/region.h"
 
 // Forward declaration
@@ -55,4 +56,12 @@ Region* braggi_region_manager_get_global(RegionManager* manager);
  */
 void braggi_region_manager_get_stats(RegionManager* manager, size_t* total, size_t* peak);
 
+/**
+ * Print the usage of every managed region, then the total
+ * 
+ * @param manager The region manager
+ * @param stream Destination stream
+ */
+void braggi_region_manager_print_stats(RegionManager* manager, FILE* stream);
+
 #endif /* BRAGGI_REGION_MANAGER_H */ 
\ No newline at end of file
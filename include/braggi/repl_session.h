@@ -0,0 +1,120 @@
+/*
+ * Braggi - REPL Session Engine
+ *
+ * "A good bartender remembers what ya ordered last round -
+ * a good REPL remembers what ya defined last line!" - Irish Pub Wisdom
+ */
+
+#ifndef BRAGGI_REPL_SESSION_H
+#define BRAGGI_REPL_SESSION_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Forward declarations
+typedef struct ReplSession ReplSession;
+typedef struct BraggiModule BraggiModule;
+
+// Kinds of values the session evaluator can hold
+typedef enum ReplValueKind {
+    REPL_VALUE_NONE = 0,
+    REPL_VALUE_INT,
+    REPL_VALUE_FLOAT,
+    REPL_VALUE_BOOL,
+    REPL_VALUE_STRING
+} ReplValueKind;
+
+// A value produced by the in-process evaluator
+typedef struct ReplValue {
+    ReplValueKind kind;
+    union {
+        int64_t int_value;
+        double float_value;
+        bool bool_value;
+        const char* string_value;  // Interned in the session, never freed by callers
+    };
+} ReplValue;
+
+/**
+ * Create a new REPL session
+ *
+ * @return A new session, or NULL on failure
+ */
+ReplSession* braggi_repl_session_create(void);
+
+/**
+ * Destroy a REPL session and everything defined in it
+ *
+ * @param session The session to destroy
+ */
+void braggi_repl_session_destroy(ReplSession* session);
+
+/**
+ * Feed one line of input to the session. Only the new line is tokenized;
+ * earlier definitions and tokens are kept. Statements run
+ * as soon as a complete input (balanced braces) is available.
+ *
+ * @param session The session
+ * @param line The input line
+ * @param out Stream for results and error messages
+ * @return false if the input had an error, true otherwise
+ */
+bool braggi_repl_session_eval(ReplSession* session, const char* line, FILE* out);
+
+/**
+ * Define a cached module's top-level functions, constants and variables
+ * in the session. The module's token stream is appended to the
+ * session's as is, so nothing is re-tokenized. Declarations the
+ * evaluator can't run are reported to out and skipped.
+ *
+ * @param session The session
+ * @param module A module from braggi_module_load
+ * @param out Stream for error messages
+ * @return Number of declarations defined
+ */
+size_t braggi_repl_session_import(ReplSession* session, const BraggiModule* module, FILE* out);
+
+/**
+ * Check whether the session is waiting for the rest of a multi-line input
+ *
+ * @param session The session
+ * @return true if an open block is still pending
+ */
+bool braggi_repl_session_needs_more(ReplSession* session);
+
+/**
+ * Look up a global variable by name
+ *
+ * @param session The session
+ * @param name The variable name
+ * @param out_value Receives the value if found
+ * @return true if the variable exists
+ */
+bool braggi_repl_session_get_value(ReplSession* session, const char* name, ReplValue* out_value);
+
+/**
+ * Print the globals and functions defined so far
+ *
+ * @param session The session
+ * @param out Destination stream
+ */
+void braggi_repl_session_print_symbols(ReplSession* session, FILE* out);
+
+/**
+ * Get the number of tokens accumulated across all inputs
+ *
+ * @param session The session
+ * @return Token count
+ */
+size_t braggi_repl_session_token_count(ReplSession* session);
+
+/**
+ * Drop all definitions and start fresh
+ *
+ * @param session The session
+ */
+void braggi_repl_session_reset(ReplSession* session);
+
+#endif /* BRAGGI_REPL_SESSION_H */
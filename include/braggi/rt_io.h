@@ -0,0 +1,181 @@
+/*
+ * Braggi - Runtime I/O
+ *
+ * "Ya don't ride to town for every egg - ya fill the basket first,
+ * then make one trip!" - Texan Henhouse Wisdom
+ *
+ * Output goes through per-thread buffers written straight to a file
+ * descriptor. Small writes are copied into the buffer; a write too big
+ * for it goes out in the same writev call as what was buffered. Buffers
+ * flush when full, on braggi_io_flush, when their thread exits and,
+ * for the main thread, at exit. Numbers are formatted without stdio.
+ *
+ * Each buffer flushes its stdio stream before writing, which keeps
+ * printf output that came first ahead of ours. The other direction
+ * needs the stdio side to call braggi_io_sync before it writes.
+ *
+ * Input comes from a buffered line reader or from a whole-file mmap.
+ */
+
+#ifndef BRAGGI_RT_IO_H
+#define BRAGGI_RT_IO_H
+
+#include "braggi/value.h"
+#include "braggi/rt_string.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Bytes held per output buffer before it is written out
+#define BRAGGI_IO_BUFFER_SIZE 16384
+
+// Bytes read at a time by a BraggiReader
+#define BRAGGI_IO_READ_SIZE 65536
+
+// Longest text braggi_io_format_i64 and braggi_io_format_f64 produce
+#define BRAGGI_IO_NUMBER_MAX 32
+
+typedef struct BraggiOutput BraggiOutput;
+
+/**
+ * Get this thread's buffer for standard output
+ *
+ * @return The buffer, or NULL if it couldn't be allocated
+ */
+BraggiOutput* braggi_io_stdout(void);
+
+/**
+ * Get this thread's buffer for standard error
+ *
+ * @return The buffer, or NULL if it couldn't be allocated
+ */
+BraggiOutput* braggi_io_stderr(void);
+
+/**
+ * Point this thread's standard output or error buffer somewhere else.
+ * Whatever is buffered is flushed to the old destination first.
+ *
+ * @param out A buffer from braggi_io_stdout or braggi_io_stderr
+ * @param stream The stdio stream to write to; it is flushed before
+ *               each of our writes
+ */
+void braggi_io_redirect(BraggiOutput* out, FILE* stream);
+
+/**
+ * Append bytes to a buffer
+ *
+ * @param out The buffer
+ * @param data The bytes
+ * @param length Number of bytes
+ * @return false if a write to the descriptor failed
+ */
+bool braggi_io_write(BraggiOutput* out, const void* data, size_t length);
+
+bool braggi_io_write_char(BraggiOutput* out, char c);
+bool braggi_io_write_cstr(BraggiOutput* out, const char* text);
+bool braggi_io_write_i64(BraggiOutput* out, int64_t value);
+bool braggi_io_write_f64(BraggiOutput* out, double value);
+bool braggi_io_write_str(BraggiOutput* out, const BraggiStr* s);
+
+/**
+ * Append a value the way io.print shows it
+ *
+ * @param out The buffer
+ * @param value The value
+ * @return false if a write to the descriptor failed
+ */
+bool braggi_io_write_val(BraggiOutput* out, BraggiVal value);
+
+/**
+ * Write out everything buffered
+ *
+ * @param out The buffer
+ * @return false if the write failed
+ */
+bool braggi_io_flush(BraggiOutput* out);
+
+/**
+ * Flush this thread's standard output and error buffers
+ */
+void braggi_io_flush_all(void);
+
+/**
+ * Flush this thread's buffers that write to a stdio stream. Call it
+ * before writing to the stream directly so that output comes out after
+ * whatever the runtime buffered.
+ *
+ * @param stream The stdio stream about to be written
+ */
+void braggi_io_sync(FILE* stream);
+
+/**
+ * Format an integer in decimal
+ *
+ * @param value The integer
+ * @param dest At least BRAGGI_IO_NUMBER_MAX bytes
+ * @return Number of characters written, not counting the terminator
+ */
+size_t braggi_io_format_i64(int64_t value, char* dest);
+
+/**
+ * Format a double using the fewest significant digits that read back
+ * as the same value
+ *
+ * @param value The double
+ * @param dest At least BRAGGI_IO_NUMBER_MAX bytes
+ * @return Number of characters written, not counting the terminator
+ */
+size_t braggi_io_format_f64(double value, char* dest);
+
+// Buffered file reader
+typedef struct BraggiReader BraggiReader;
+
+/**
+ * Open a file for buffered reading
+ *
+ * @param path The file
+ * @return The reader, or NULL if the file can't be opened
+ */
+BraggiReader* braggi_io_reader_open(const char* path);
+
+/**
+ * Read the next line. The returned bytes stay valid until the next
+ * call and don't include the newline.
+ *
+ * @param reader The reader
+ * @param out_length Receives the line's length
+ * @return The line, or NULL at end of file or on error
+ */
+const char* braggi_io_reader_line(BraggiReader* reader, size_t* out_length);
+
+/**
+ * Read up to length bytes
+ *
+ * @param reader The reader
+ * @param dest Destination buffer
+ * @param length Most bytes to read
+ * @return Bytes read, 0 at end of file or on error
+ */
+size_t braggi_io_reader_read(BraggiReader* reader, void* dest, size_t length);
+
+void braggi_io_reader_close(BraggiReader* reader);
+
+// Read-only mapping of a whole file
+typedef struct BraggiMappedFile {
+    const char* data;
+    size_t size;
+} BraggiMappedFile;
+
+/**
+ * Map a file into memory
+ *
+ * @param path The file
+ * @param out Receives the mapping; an empty file maps to NULL data
+ * @return false if the file can't be opened or mapped
+ */
+bool braggi_io_map_file(const char* path, BraggiMappedFile* out);
+
+void braggi_io_unmap_file(BraggiMappedFile* file);
+
+#endif /* BRAGGI_RT_IO_H */
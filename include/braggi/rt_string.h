@@ -0,0 +1,228 @@
+/*
+ * Braggi - Runtime Strings
+ *
+ * "A short rope fits in yer pocket, a long one goes on the saddle,
+ * and when ya need a longer one ya just tie two together!"
+ * - Texan Lariat Wisdom
+ *
+ * BraggiStr is a 16-byte string handle passed by value. Strings of up to
+ * BRAGGI_STR_SMALL_MAX bytes live inline. Longer strings point at bytes
+ * owned by a region: a flat copy, a zero-copy slice of another string's
+ * bytes, or a rope node joining two strings so repeated concatenation
+ * doesn't recopy. Everything is allocated with braggi_rt_region_alloc,
+ * so it follows the region's regime and goes when the region does. A
+ * slice or rope must not outlive the regions its parts live in.
+ */
+
+#ifndef BRAGGI_RT_STRING_H
+#define BRAGGI_RT_STRING_H
+
+#include "braggi/runtime.h"
+#include "braggi/value.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdarg.h>
+
+// Longest string kept inline
+#define BRAGGI_STR_SMALL_MAX 15
+
+// Ropes deeper than this are flattened when concatenated onto
+#define BRAGGI_STR_ROPE_MAX_DEPTH 32
+
+// Concatenations shorter than this are copied flat instead of roped
+#define BRAGGI_STR_ROPE_MIN_LENGTH 64
+
+// Representation, kept in the last byte of a large string
+typedef enum BraggiStrKind {
+    BRAGGI_STR_SMALL = 0,  // Bytes inline
+    BRAGGI_STR_FLAT,       // NUL-terminated bytes in a region
+    BRAGGI_STR_SLICE,      // Bytes borrowed from another string, not terminated
+    BRAGGI_STR_ROPE        // Rope node in a region
+} BraggiStrKind;
+
+typedef struct BraggiStrRope BraggiStrRope;
+
+/*
+ * String handle. The last byte tells small strings from large ones:
+ * for a small string it is BRAGGI_STR_SMALL_MAX minus the length, which
+ * is 0 - a terminator - when the string is full. Large strings set the
+ * high bit and keep their kind in the low bits.
+ */
+typedef struct BraggiStr {
+    union {
+        struct {
+            char bytes[BRAGGI_STR_SMALL_MAX];
+            uint8_t remaining;
+        } small;
+        struct {
+            union {
+                const char* bytes;   // FLAT and SLICE
+                BraggiStrRope* rope; // ROPE
+            };
+            uint32_t length;
+            uint8_t reserved[3];
+            uint8_t tag;             // 0x80 | BraggiStrKind
+        } large;
+    };
+} BraggiStr;
+
+_Static_assert(sizeof(BraggiStr) == 16, "BraggiStr must stay two words");
+
+// Rope node; flat caches the joined bytes once someone asks for them
+struct BraggiStrRope {
+    BraggiStr left;
+    BraggiStr right;
+    uint32_t length;
+    uint32_t depth;
+    const char* flat;
+};
+
+#define BRAGGI_STR_LARGE_FLAG 0x80
+
+static inline BraggiStrKind braggi_str_kind(const BraggiStr* s) {
+    uint8_t tag = s->small.remaining;
+    return (tag & BRAGGI_STR_LARGE_FLAG) ? (BraggiStrKind)(tag & 0x7F) : BRAGGI_STR_SMALL;
+}
+
+static inline size_t braggi_str_length(const BraggiStr* s) {
+    if (s->small.remaining & BRAGGI_STR_LARGE_FLAG) return s->large.length;
+    return BRAGGI_STR_SMALL_MAX - s->small.remaining;
+}
+
+static inline BraggiStr braggi_str_empty(void) {
+    BraggiStr s = { .small = { { 0 }, BRAGGI_STR_SMALL_MAX } };
+    return s;
+}
+
+/**
+ * Make a string from bytes. Short strings are stored inline and the
+ * rest are copied into region.
+ *
+ * @param region Owner of the copy; may be NULL if length fits inline
+ * @param text The bytes, need not be NUL-terminated
+ * @param length Number of bytes
+ * @param out Receives the string
+ * @return false if region is missing or full
+ */
+bool braggi_str_from(BraggiRegionHandle region, const char* text, size_t length, BraggiStr* out);
+
+/**
+ * Wrap bytes that outlive the string, such as a literal, without copying
+ *
+ * @param text The bytes
+ * @param length Number of bytes
+ * @return The string
+ */
+BraggiStr braggi_str_borrow(const char* text, size_t length);
+
+/**
+ * Join two strings. Short results are copied; long ones become a rope
+ * node pointing at both halves.
+ *
+ * @param region Where the copy or node goes
+ * @param a Left string
+ * @param b Right string
+ * @param out Receives the joined string
+ * @return false if the region is full or the result is too long
+ */
+bool braggi_str_concat(BraggiRegionHandle region, const BraggiStr* a, const BraggiStr* b, BraggiStr* out);
+
+/**
+ * Take bytes [start, end) of a string. Slices of large strings share
+ * the parent's bytes; ropes are flattened into region first.
+ *
+ * @param region Used only when s is a rope that hasn't been flattened
+ * @param s The string
+ * @param start First byte
+ * @param end One past the last byte, clamped to the length
+ * @param out Receives the slice
+ * @return false if start > end or flattening failed
+ */
+bool braggi_str_slice(BraggiRegionHandle region, const BraggiStr* s, size_t start, size_t end, BraggiStr* out);
+
+/**
+ * Format into a new string, like snprintf
+ *
+ * @param region Owner of the result when it doesn't fit inline
+ * @param out Receives the string
+ * @param format printf-style format
+ * @return false on a format error or if the region is full
+ */
+bool braggi_str_format(BraggiRegionHandle region, BraggiStr* out, const char* format, ...)
+#if defined(__GNUC__)
+    __attribute__((format(printf, 3, 4)))
+#endif
+    ;
+
+/**
+ * As braggi_str_format, taking a va_list
+ */
+bool braggi_str_vformat(BraggiRegionHandle region, BraggiStr* out, const char* format, va_list args);
+
+/**
+ * Get contiguous bytes for a string. Small, flat and slice strings
+ * answer in place; ropes are joined into region once and remember it.
+ *
+ * @param region Used to flatten a rope
+ * @param s The string; must stay put while the pointer is in use
+ * @return The bytes, or NULL if a rope couldn't be flattened. Only
+ *         small and flat strings are guaranteed NUL-terminated.
+ */
+const char* braggi_str_data(BraggiRegionHandle region, BraggiStr* s);
+
+/**
+ * Copy bytes out of a string without flattening it
+ *
+ * @param s The string
+ * @param offset First byte to copy
+ * @param dest Destination buffer
+ * @param count Most bytes to copy
+ * @return Bytes copied
+ */
+size_t braggi_str_copy(const BraggiStr* s, size_t offset, char* dest, size_t count);
+
+/**
+ * Get one byte of a string
+ *
+ * @param s The string
+ * @param index Byte index
+ * @return The byte, or -1 when out of range
+ */
+int braggi_str_byte_at(const BraggiStr* s, size_t index);
+
+/**
+ * Compare two strings byte by byte, whatever their representation
+ *
+ * @return true if the strings hold the same bytes
+ */
+bool braggi_str_equals(const BraggiStr* a, const BraggiStr* b);
+
+/**
+ * Write a string to a stream
+ *
+ * @param s The string
+ * @param stream Destination stream
+ */
+void braggi_str_print(const BraggiStr* s, FILE* stream);
+
+/**
+ * View a string value as a BraggiStr without copying
+ *
+ * @param value A string value
+ * @return The string; empty if value isn't a string
+ */
+BraggiStr braggi_str_from_val(BraggiVal value);
+
+/**
+ * Turn a string into a string value. Flat and slice strings are shared;
+ * small strings and ropes are copied into region.
+ *
+ * @param region Owner of any copy
+ * @param s The string
+ * @return A string value, or an error value if the region is full
+ */
+BraggiVal braggi_str_to_val(BraggiRegionHandle region, const BraggiStr* s);
+
+#endif /* BRAGGI_RT_STRING_H */
@@ -0,0 +1,111 @@
+/*
+ * Braggi - Runtime Superpositions
+ *
+ * "Don't pick yer trail 'til ya reach the fork - but keep all the
+ * maps in one saddlebag!" - Texan Trail Boss Wisdom
+ *
+ * A superposition is a weighted set of alternative values living in a
+ * region. Arithmetic on it doesn't pick an alternative; it produces a
+ * new superposition by applying the operation to every alternative at
+ * once. Numeric alternatives are kept in a typed buffer, so that pass
+ * runs through the vectorized math kernels. Only observing a
+ * superposition picks one alternative. The choice is made once, at
+ * random by weight, and every later observation returns the same
+ * value.
+ *
+ * Superpositions are immutable after creation, so results of an
+ * operation can share the weight buffer of their operand.
+ */
+
+#ifndef BRAGGI_RT_SUPERPOSITION_H
+#define BRAGGI_RT_SUPERPOSITION_H
+
+#include "braggi/value.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Most alternatives a superposition may hold; combining two
+// superpositions multiplies their counts
+#define BRAGGI_SUPER_MAX_ALTERNATIVES 4096
+
+// Operations that broadcast across alternatives
+typedef enum BraggiSuperOp {
+    BRAGGI_SUPER_ADD,
+    BRAGGI_SUPER_SUB,
+    BRAGGI_SUPER_MUL,
+    BRAGGI_SUPER_DIV
+} BraggiSuperOp;
+
+struct BraggiSuperposition {
+    BraggiValArray* alternatives; // I64 or F64 when every alternative is a number
+    const double* weights;        // One per alternative, never negative
+    double total;                 // Sum of the weights
+    int64_t observed;             // Index of the chosen alternative, -1 until observed
+};
+
+/**
+ * Create a superposition in a region
+ *
+ * @param region The owning region
+ * @param alternatives The possible values
+ * @param weights One non-negative weight per alternative, or NULL for
+ *                equal weights
+ * @param count Number of alternatives, 1 to BRAGGI_SUPER_MAX_ALTERNATIVES
+ * @return A superposition value, or an error value
+ */
+BraggiVal braggi_super_create(BraggiRegionHandle region, const BraggiVal* alternatives,
+                              const double* weights, size_t count);
+
+/**
+ * Apply an arithmetic operation across alternatives. Either operand
+ * may be a plain number. Two superpositions combine every pair of
+ * alternatives, with weights multiplied. An operand that has already
+ * been observed acts as its outcome. Division always gives floats.
+ *
+ * @param region Region for the result
+ * @param op The operation
+ * @param a Left operand
+ * @param b Right operand
+ * @return A superposition, a number if neither operand is still
+ *         undecided, or an error value
+ */
+BraggiVal braggi_super_apply(BraggiRegionHandle region, BraggiSuperOp op, BraggiVal a, BraggiVal b);
+
+/**
+ * Observe a superposition, choosing an alternative on the first call
+ *
+ * @param value A superposition; any other value is returned as is
+ * @return The chosen alternative
+ */
+BraggiVal braggi_super_observe(BraggiVal value);
+
+/**
+ * Get the weighted mean of a numeric superposition without observing it
+ *
+ * @param value A superposition of numbers, or a number
+ * @param out Receives the mean; the outcome if already observed
+ * @return false if some alternative isn't a number
+ */
+bool braggi_super_expect(BraggiVal value, double* out);
+
+size_t braggi_super_count(BraggiVal value);
+
+/**
+ * Get one alternative
+ *
+ * @param value A superposition
+ * @param index Alternative index
+ * @param probability If not NULL, receives its normalized weight
+ * @return The alternative, or null when out of range
+ */
+BraggiVal braggi_super_at(BraggiVal value, size_t index, double* probability);
+
+/**
+ * Seed the calling thread's generator used to choose alternatives
+ *
+ * @param seed Any value; the same seed gives the same choices
+ */
+void braggi_super_seed(uint64_t seed);
+
+#endif /* BRAGGI_RT_SUPERPOSITION_H */
@@ -46,13 +46,30 @@ typedef enum BraggiRuntimeError {
     BRAGGI_RT_ERROR_INVALID_ACCESS,
     BRAGGI_RT_ERROR_REGION_FULL,
     BRAGGI_RT_ERROR_INVALID_ALLOCATION,
-    BRAGGI_RT_ERROR_DANGLING_REFERENCE
+    BRAGGI_RT_ERROR_DANGLING_REFERENCE,
+    BRAGGI_RT_ERROR_COUNT   // Number of codes above, not an error itself
 } BraggiRuntimeError;
 
 // Region management functions
 BraggiRegionHandle braggi_rt_region_create(size_t size, BraggiRegimeType regime);
 void braggi_rt_region_destroy(BraggiRegionHandle region);
 
+/*
+ * Shared regions can be allocated from by many threads at once without
+ * a lock. SEQ, FIFO and FILO regions bump one atomic cursor; RAND
+ * regions give each thread its own chunk of the pool to bump through.
+ * Shared allocations are rounded up to BRAGGI_RT_SHARED_ALIGN, keep no
+ * per-allocation records and aren't seen by the allocation profiler.
+ * Freeing a single allocation is a no-op - everything goes with the
+ * region. Creating and destroying the region and its periscopes are
+ * not thread-safe.
+ */
+#define BRAGGI_RT_SHARED_ALIGN 16
+#define BRAGGI_RT_SUBARENA_MAX 65536
+
+BraggiRegionHandle braggi_rt_region_create_shared(size_t size, BraggiRegimeType regime);
+bool braggi_rt_region_is_shared(BraggiRegionHandle region);
+
 // Memory allocation functions
 void* braggi_rt_region_alloc(BraggiRegionHandle region, size_t size, uint32_t source_pos, const char* label);
 void braggi_rt_region_free(BraggiRegionHandle region, void* ptr);
@@ -64,10 +81,124 @@ BraggiRuntimeError braggi_rt_region_create_periscope(BraggiRegionHandle source,
                                                BraggiPeriscopeDirection direction);
 void braggi_rt_region_destroy_periscope(BraggiPeriscopeHandle periscope);
 
+/**
+ * Find the periscope created from one region to another
+ *
+ * @param source The region the periscope was created from
+ * @param target The region it points to
+ * @return The periscope, or NULL if there isn't one
+ */
+BraggiPeriscopeHandle braggi_rt_region_find_periscope(BraggiRegionHandle source,
+                                                      BraggiRegionHandle target);
+
+/*
+ * Periscope transfers move data from whichever end of a periscope it
+ * lives in to the other end. OUT periscopes carry data from source to
+ * target, IN periscopes from target to source, and bidirectional ones
+ * both ways where the regimes allow. Whether a direction is allowed is
+ * decided when the periscope is created, so a transfer only checks
+ * that its bytes lie inside one allocation in one of the two regions.
+ * Shared regions keep no allocation records; there the bytes only have
+ * to lie inside the region's pool.
+ */
+
+// Payloads at least this big are copied with streaming stores
+#define BRAGGI_RT_STREAM_THRESHOLD (256 * 1024)
+
+// A read-only view lent across a periscope
+typedef struct BraggiBorrow {
+    const void* data;
+    size_t size;
+    BraggiPeriscopeHandle periscope;
+} BraggiBorrow;
+
+/**
+ * Copy bytes into a new allocation at the other end of a periscope
+ *
+ * @param periscope The periscope to send through
+ * @param ptr Start of the bytes, inside one allocation in one of the
+ *            periscope's regions
+ * @param size Number of bytes
+ * @return The copy, or NULL (see braggi_rt_last_error)
+ */
+void* braggi_rt_periscope_copy(BraggiPeriscopeHandle periscope, const void* ptr, size_t size);
+
+/**
+ * Move an allocation to the other end of a periscope. The sending
+ * region gives the allocation up; the receiver owns the new one.
+ *
+ * @param periscope The periscope to send through
+ * @param ptr Start of an allocation in one of the periscope's regions
+ * @param size The allocation's full size; partial moves are refused
+ * @return The moved allocation, or NULL (see braggi_rt_last_error)
+ */
+void* braggi_rt_periscope_move(BraggiPeriscopeHandle periscope, void* ptr, size_t size);
+
+/**
+ * Lend bytes to the other end of a periscope without copying them.
+ * The periscope can't be destroyed while views are outstanding.
+ *
+ * @param periscope The periscope to lend through
+ * @param ptr Start of the bytes, inside one allocation in one of the
+ *            periscope's regions
+ * @param size Number of bytes
+ * @param out Receives the view
+ * @return false if the bytes can't cross this periscope
+ */
+bool braggi_rt_periscope_borrow(BraggiPeriscopeHandle periscope, const void* ptr,
+                                size_t size, BraggiBorrow* out);
+
+void braggi_rt_periscope_release(BraggiBorrow* borrow);
+
 // Runtime statistics
 size_t braggi_rt_region_get_used_memory(BraggiRegionHandle region);
 size_t braggi_rt_region_get_free_memory(BraggiRegionHandle region);
 size_t braggi_rt_region_get_allocation_count(BraggiRegionHandle region);
 const char* braggi_rt_error_string(BraggiRuntimeError error);
 
+/*
+ * Usage counters every region keeps, in debug and release builds alike.
+ * They cost a few plain stores per allocation, or relaxed atomic adds
+ * in shared regions. Bytes freed count only what a free gave back to
+ * the region's records; shared regions free nothing until destroyed.
+ */
+typedef struct BraggiRegionStats {
+    BraggiRegionHandle region;
+    BraggiRegimeType regime;
+    bool shared;
+    size_t size;                 // Pool size in bytes
+    uint64_t allocs;             // Successful allocations
+    uint64_t frees;              // Successful frees
+    uint64_t bytes_allocated;    // Bytes handed out, ever
+    uint64_t bytes_freed;        // Bytes given back, ever
+    uint64_t bytes_in_use;       // Bytes of the pool in use now
+    uint64_t high_water;         // Most bytes ever in use at once
+    uint64_t transfers_out;      // Periscope copies, moves and borrows sent
+    uint64_t transfers_in;       // Periscope copies, moves and borrows received
+    uint64_t failures[BRAGGI_RT_ERROR_COUNT]; // Failed allocations by error code
+} BraggiRegionStats;
+
+/**
+ * Read a region's usage counters
+ *
+ * @param region The region
+ * @param out Receives the counters
+ * @return false if region or out is NULL
+ */
+bool braggi_rt_region_get_stats(BraggiRegionHandle region, BraggiRegionStats* out);
+
+/**
+ * Read the counters of every region that hasn't been destroyed. The
+ * counters of each region are read without stopping its allocations,
+ * so a busy region's numbers may be a moment apart from each other.
+ *
+ * @param out Array to fill, may be NULL if capacity is 0
+ * @param capacity Entries out can hold
+ * @return Number of live regions, which may be more than capacity
+ */
+size_t braggi_rt_region_snapshot(BraggiRegionStats* out, size_t capacity);
+
+// Error left by the calling thread's last runtime call
+BraggiRuntimeError braggi_rt_last_error(void);
+
 #endif /* BRAGGI_RUNTIME_H */ 
\ No newline at end of file
@@ -25,6 +25,7 @@ typedef struct Source {
     unsigned int num_lines; // Number of lines
     bool is_file;          // Whether this source is from a file or a string
     uint32_t file_id;      // Unique ID for this file in the source position system
+    BraggiSourceLoc loc_base; // Location of the first byte, or BRAGGI_SOURCE_LOC_INVALID
     
     // Map of entity IDs to source positions for ECS integration
     uint64_t* position_entities; // Array of entity IDs
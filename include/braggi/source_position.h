@@ -38,6 +38,88 @@ typedef struct SourceFile {
     uint32_t file_id;         // Unique ID for this file
 } SourceFile;
 
+/*
+ * A compact source location: one 32-bit number in an address space
+ * shared by every registered file. Each file gets a range of IDs, one
+ * per byte plus one for its end, so a location is the file's base plus
+ * a byte offset. Locations in the same file order like their offsets,
+ * and comparing two is a single integer compare. Line and column are
+ * worked out only when a location is decoded. 0 means "unknown".
+ */
+typedef uint32_t BraggiSourceLoc;
+
+#define BRAGGI_SOURCE_LOC_INVALID ((BraggiSourceLoc)0)
+
+/*
+ * Register a file in the location address space. Registering the same
+ * file ID again returns its existing base.
+ *
+ * @param file_id The file's ID
+ * @param filename Name shown for the file, copied
+ * @param line_map Offset of the start of each line, ascending; copied
+ * @param line_count Number of lines
+ * @param length Length of the file in bytes
+ * @return Location of the file's first byte, or BRAGGI_SOURCE_LOC_INVALID
+ *         if the address space is full
+ */
+BraggiSourceLoc braggi_source_loc_add_file(uint32_t file_id, const char* filename,
+                                           const uint32_t* line_map, size_t line_count,
+                                           uint32_t length);
+
+/*
+ * Drop a file from the location address space. Its locations become
+ * unknown. Only the newest file's range is handed out again, so older
+ * locations never come to mean a different file.
+ *
+ * @param file_id The file's ID; unknown IDs are ignored
+ */
+void braggi_source_loc_remove_file(uint32_t file_id);
+
+/*
+ * Drop every registered file and start the address space over. Every
+ * location handed out before becomes unknown or, once new files are
+ * added, may point into them. Meant for a process that compiles one
+ * job after another, between jobs.
+ */
+void braggi_source_loc_reset(void);
+
+/*
+ * Get the location of a byte in a registered file
+ *
+ * @param file_id The file's ID
+ * @param offset Byte offset; the file's length means its end
+ * @return The location, or BRAGGI_SOURCE_LOC_INVALID if unknown
+ */
+BraggiSourceLoc braggi_source_loc_get(uint32_t file_id, uint32_t offset);
+
+/*
+ * Encode a position. The offset is used if set, else line and column.
+ *
+ * @param position The position
+ * @return The location, or BRAGGI_SOURCE_LOC_INVALID if its file isn't
+ *         registered or it lies outside the file
+ */
+BraggiSourceLoc braggi_source_loc_from_position(const SourcePosition* position);
+
+/*
+ * Decode a location into file ID, line, column and offset. Length is
+ * left at 0.
+ *
+ * @param loc The location
+ * @param position Receives the position; zeroed if loc is unknown
+ * @return false if loc doesn't belong to a registered file
+ */
+bool braggi_source_loc_decode(BraggiSourceLoc loc, SourcePosition* position);
+
+/*
+ * Get the name of the file a location is in
+ *
+ * @param loc The location
+ * @return The filename, or NULL if loc is unknown. It stays valid until
+ *         the file is removed or the address space is reset.
+ */
+const char* braggi_source_loc_filename(BraggiSourceLoc loc);
+
 /*
  * Create a source position from line and column
  * 
@@ -18,6 +18,8 @@
 
 #include "braggi/braggi_context.h"  // Include the complete context definition
 #include "braggi/braggi.h"
+#include "braggi/value.h"
+#include "braggi/builtins/builtins.h"
 #include <stdbool.h>
 #include <stddef.h>
 
@@ -29,10 +31,30 @@ typedef struct BraggiBuiltinRegistry BraggiBuiltinRegistry;
 // Builtin function type - make sure it's consistent with builtins.h
 typedef BraggiValue* (*BraggiBuiltinFunc)(BraggiValue** args, size_t arg_count, void* context);
 
-// Module loading functions
+/**
+ * Load a module. math, string, io and system are built in; any other
+ * name is compiled once into the module cache and mapped on first use.
+ *
+ * @param context The Braggi context
+ * @param module_name The module name
+ * @return true if the module is available
+ */
 bool braggi_stdlib_load_module(BraggiContext* context, const char* module_name);
+
+/**
+ * Find a file on the library search path. Results, including misses,
+ * are remembered until BRAGGI_LIB_PATH changes or the cache is reset.
+ *
+ * @param name The file name, e.g. "collections.bg"
+ * @return The path, to be freed by the caller, or NULL if not found
+ */
 char* braggi_stdlib_find_file(const char* name);
 
+/**
+ * Forget every remembered library path lookup
+ */
+void braggi_stdlib_reset_path_cache(void);
+
 // Standard library initialization/cleanup
 bool braggi_stdlib_initialize(BraggiContext* context);
 void braggi_stdlib_cleanup(BraggiContext* context);
@@ -49,4 +71,70 @@ void braggi_stdlib_debug_paths(void);
  */
 BraggiBuiltinFunc braggi_stdlib_lookup_builtin(BraggiContext* context, const char* name);
 
+/**
+ * Look up a builtin that uses the by-value calling convention. Callers
+ * pass arguments in their own BraggiVal array, so arithmetic on
+ * immediates never allocates.
+ *
+ * @param context The Braggi context
+ * @param name The name of the builtin function, e.g. "math.add"
+ * @param out_context If not NULL, receives the builtin's context pointer
+ * @return Function pointer if found, NULL otherwise
+ */
+BraggiNativeFunc braggi_stdlib_lookup_native(BraggiContext* context, const char* name, void** out_context);
+
+/**
+ * Get the registry shared by the compiler and runtime
+ *
+ * @param context Used to initialize the stdlib on first use; may be NULL
+ *                once the stdlib is initialized
+ * @return The registry, or NULL if it isn't initialized and can't be
+ */
+BraggiBuiltinRegistry* braggi_stdlib_get_registry(BraggiContext* context);
+
+/**
+ * Resolve a builtin name to its ID in the shared registry
+ *
+ * @param context As for braggi_stdlib_get_registry
+ * @param name The name of the builtin function, e.g. "math.add"
+ * @return The builtin's ID, or BRAGGI_BUILTIN_INVALID
+ */
+BraggiBuiltinId braggi_stdlib_resolve(BraggiContext* context, const char* name);
+
+/**
+ * Get a by-value builtin from the function table
+ *
+ * @param registry The registry
+ * @param id An ID from braggi_builtin_registry_resolve
+ * @param out_context If not NULL, receives the builtin's context pointer
+ * @return Function pointer, NULL if id is out of range or the builtin is boxed
+ */
+BraggiNativeFunc braggi_builtin_registry_native_at(const BraggiBuiltinRegistry* registry,
+                                                   BraggiBuiltinId id, void** out_context);
+
+/**
+ * Call a by-value builtin through the function table
+ *
+ * @param registry The registry
+ * @param id An ID from braggi_builtin_registry_resolve
+ * @param args Argument span
+ * @param arg_count Number of arguments
+ * @param region Region for any strings or arrays the builtin returns
+ * @return The result, or an error value if id is unknown or boxed
+ */
+BraggiVal braggi_builtin_registry_call(const BraggiBuiltinRegistry* registry, BraggiBuiltinId id,
+                                       const BraggiVal* args, size_t arg_count,
+                                       BraggiRegionHandle region);
+
+/**
+ * Look up a by-value builtin in a specific registry
+ *
+ * @param registry The registry to search
+ * @param name The name of the builtin function
+ * @param out_context If not NULL, receives the builtin's context pointer
+ * @return Function pointer if found, NULL otherwise
+ */
+BraggiNativeFunc braggi_builtin_registry_lookup_native(BraggiBuiltinRegistry* registry,
+                                                      const char* name, void** out_context);
+
 #endif /* BRAGGI_STDLIB_H */ 
\ No newline at end of file
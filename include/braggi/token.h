@@ -36,7 +36,7 @@ typedef enum {
  */
 typedef struct {
     TokenType type;             /* Type of the token */
-    SourcePosition position;    /* Position in the source file */
+    BraggiSourceLoc loc;        /* Where the token starts; decode with braggi_token_get_position */
     char* text;                 /* Text representation of the token */
     size_t length;              /* Length of the token text */
     
@@ -95,9 +95,13 @@ bool braggi_tokenizer_expect_operator(Tokenizer* tokenizer, const char* op);
 // Convert a token type to string for debugging
 const char* braggi_token_type_string(TokenType type);
 
-// Create a new token
+// Create a new token; position is encoded into the token's location
 Token* braggi_token_create(TokenType type, char* text, SourcePosition position);
 
+// Decode a token's location. The length is the token's length; a
+// token with no known location gives a zeroed position.
+SourcePosition braggi_token_get_position(const Token* token);
+
 // Destroy a token and free all resources
 void braggi_token_destroy(Token* token);
 
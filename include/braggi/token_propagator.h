@@ -18,6 +18,7 @@
 typedef struct BraggiContext BraggiContext;
 typedef struct TokenPropagator TokenPropagator;
 typedef struct Pattern Pattern;
+typedef struct ErrorHandler ErrorHandler;
 
 // Create a new token propagator
 TokenPropagator* braggi_token_propagator_create(void);
@@ -31,6 +32,12 @@ bool braggi_token_propagator_add_token(TokenPropagator* propagator, Token* token
 // Add a pattern to the propagator
 bool braggi_token_propagator_add_pattern(TokenPropagator* propagator, Pattern* pattern);
 
+// Set the ID of the source being propagated, used to locate diagnostics
+void braggi_token_propagator_set_source_file_id(TokenPropagator* propagator, uint32_t source_file_id);
+
+// Set where propagation failures are reported; without one they go to stderr
+void braggi_token_propagator_set_error_handler(TokenPropagator* propagator, ErrorHandler* error_handler);
+
 // Initialize the entropy field from tokens
 bool braggi_token_propagator_initialize_field(TokenPropagator* propagator);
 
@@ -0,0 +1,159 @@
+/*
+ * Braggi - Typed Vectors
+ *
+ * "A saddlebag cut for one kind o' gear packs tighter than a sack
+ * ya have to rummage through." - Hill Country Packer
+ *
+ * Macros that stamp out a vector for one element type. Unlike Vector,
+ * elements are stored as T, accessors are inline, and no element size
+ * is multiplied at run time. Both kinds of vector live by value, on the
+ * stack or inside another struct, so creating one allocates nothing.
+ *
+ *   BRAGGI_VEC_DECLARE(CellIdVec, cell_id_vec, uint32_t)
+ *
+ * declares the type CellIdVec and cell_id_vec_init, _free, _reserve,
+ * _push, _pop, _at, _ptr, _clear, _size and _data.
+ *
+ *   BRAGGI_SMALL_VEC_DECLARE(CellIdList, cell_id_list, uint32_t, 16)
+ *
+ * declares the same functions for a vector whose first 16 elements sit
+ * in the struct itself. Nothing is allocated until a 17th is pushed,
+ * so short temporaries on the stack never touch the heap. A small
+ * vector points into itself: don't copy one by assignment.
+ *
+ * _at checks the index with assert only. Callers check index < size
+ * first, as they would for an array.
+ */
+
+#ifndef BRAGGI_UTIL_TYPED_VECTOR_H
+#define BRAGGI_UTIL_TYPED_VECTOR_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+// Shared body of both kinds. inline_data is NULL for heap-only vectors.
+#define BRAGGI_VEC_DEFINE_COMMON_(Name, prefix, T, inline_data)                 \
+    static inline bool prefix##_reserve(Name* vec, size_t capacity) {           \
+        if (capacity <= vec->capacity) {                                        \
+            return true;                                                        \
+        }                                                                       \
+        size_t grown = vec->capacity ? vec->capacity * 2 : 8;                   \
+        if (grown < capacity) {                                                 \
+            grown = capacity;                                                   \
+        }                                                                       \
+        T* data;                                                                \
+        if (vec->data == (inline_data)) {                                       \
+            data = (T*)malloc(grown * sizeof(T));                               \
+            if (data && vec->size > 0) {                                        \
+                memcpy(data, vec->data, vec->size * sizeof(T));                 \
+            }                                                                   \
+        } else {                                                                \
+            data = (T*)realloc(vec->data, grown * sizeof(T));                   \
+        }                                                                       \
+        if (!data) {                                                            \
+            return false;                                                       \
+        }                                                                       \
+        vec->data = data;                                                       \
+        vec->capacity = grown;                                                  \
+        return true;                                                            \
+    }                                                                           \
+                                                                                \
+    static inline bool prefix##_push(Name* vec, T value) {                      \
+        if (vec->size == vec->capacity && !prefix##_reserve(vec, vec->size + 1)) { \
+            return false;                                                       \
+        }                                                                       \
+        vec->data[vec->size++] = value;                                         \
+        return true;                                                            \
+    }                                                                           \
+                                                                                \
+    static inline bool prefix##_pop(Name* vec, T* out) {                        \
+        if (vec->size == 0) {                                                   \
+            return false;                                                       \
+        }                                                                       \
+        vec->size--;                                                            \
+        if (out) {                                                              \
+            *out = vec->data[vec->size];                                        \
+        }                                                                       \
+        return true;                                                            \
+    }                                                                           \
+                                                                                \
+    static inline T prefix##_at(const Name* vec, size_t index) {                \
+        assert(index < vec->size);                                              \
+        return vec->data[index];                                                \
+    }                                                                           \
+                                                                                \
+    static inline T* prefix##_ptr(Name* vec, size_t index) {                    \
+        assert(index < vec->size);                                              \
+        return &vec->data[index];                                               \
+    }                                                                           \
+                                                                                \
+    static inline void prefix##_clear(Name* vec) {                              \
+        vec->size = 0;                                                          \
+    }                                                                           \
+                                                                                \
+    static inline size_t prefix##_size(const Name* vec) {                       \
+        return vec->size;                                                       \
+    }                                                                           \
+                                                                                \
+    static inline T* prefix##_data(Name* vec) {                                 \
+        return vec->data;                                                       \
+    }
+
+/*
+ * A heap-backed vector of T. Zero-initialized is the same as init.
+ */
+#define BRAGGI_VEC_DECLARE(Name, prefix, T)                                     \
+    typedef struct Name {                                                       \
+        T* data;                                                                \
+        size_t size;                                                            \
+        size_t capacity;                                                        \
+    } Name;                                                                     \
+                                                                                \
+    static inline void prefix##_init(Name* vec) {                               \
+        vec->data = NULL;                                                       \
+        vec->size = 0;                                                          \
+        vec->capacity = 0;                                                      \
+    }                                                                           \
+                                                                                \
+    static inline void prefix##_free(Name* vec) {                               \
+        free(vec->data);                                                        \
+        prefix##_init(vec);                                                     \
+    }                                                                           \
+                                                                                \
+    BRAGGI_VEC_DEFINE_COMMON_(Name, prefix, T, (T*)NULL)
+
+/*
+ * A vector of T holding its first N elements inline. Must be set up
+ * with init before use.
+ */
+#define BRAGGI_SMALL_VEC_DECLARE(Name, prefix, T, N)                            \
+    typedef struct Name {                                                       \
+        T* data;                                                                \
+        size_t size;                                                            \
+        size_t capacity;                                                        \
+        T inline_data[N];                                                       \
+    } Name;                                                                     \
+                                                                                \
+    static inline void prefix##_init(Name* vec) {                               \
+        vec->data = vec->inline_data;                                           \
+        vec->size = 0;                                                          \
+        vec->capacity = (N);                                                    \
+    }                                                                           \
+                                                                                \
+    static inline void prefix##_free(Name* vec) {                               \
+        if (vec->data != vec->inline_data) {                                    \
+            free(vec->data);                                                    \
+        }                                                                       \
+        prefix##_init(vec);                                                     \
+    }                                                                           \
+                                                                                \
+    static inline bool prefix##_is_inline(const Name* vec) {                    \
+        return vec->data == vec->inline_data;                                   \
+    }                                                                           \
+                                                                                \
+    BRAGGI_VEC_DEFINE_COMMON_(Name, prefix, T, vec->inline_data)
+
+#endif /* BRAGGI_UTIL_TYPED_VECTOR_H */
@@ -11,11 +11,9 @@
 #include <stddef.h>
 #include <stdbool.h>
 #include <sys/types.h>  // For ssize_t
-#include "braggi/mem/region.h"
 
-// Forward declaration - will be included by implementation
-struct MemoryRegion;
-typedef struct MemoryRegion MemoryRegion;
+// Regions from braggi/region.h; a vector only holds a pointer to one
+typedef struct Region Region;
 
 /**
  * Callback type definitions for vector operations
@@ -33,6 +31,7 @@ typedef struct Vector {
     size_t elem_size;    /* Size of each element in bytes */
     size_t capacity;     /* Current capacity in elements */
     size_t size;         /* Current number of elements */
+    Region* region;      /* Region backing data, or NULL for the heap */
 } Vector;
 
 /* Function prototypes */
@@ -57,7 +56,12 @@ Vector* braggi_vector_create_with_capacity(size_t elem_size, size_t initial_capa
 /**
  * Create a new vector using a memory region
  * 
- * @param region The memory region to allocate from
+ * The vector keeps growing inside the region. A region can't free, so
+ * each time the data outgrows its block a bigger one is carved out and
+ * the old one is left behind until the region goes; reserve up front
+ * when the final size is known.
+ * 
+ * @param region The memory region to allocate from, or NULL for the heap
  * @param elem_size Size of each element in bytes
  * @return A new vector allocated from the region, or NULL if allocation fails
  */
@@ -155,6 +159,39 @@ bool braggi_vector_set(Vector* vector, size_t index, const void* elem);
  */
 bool braggi_vector_insert(Vector* vector, size_t index, const void* elem);
 
+/**
+ * Append count elements in one copy
+ * 
+ * @param vector The vector
+ * @param elems Packed elements of the vector's element size; may point
+ *              into the vector itself
+ * @param count Number of elements
+ * @return true if successful, false if allocation fails
+ */
+bool braggi_vector_append_n(Vector* vector, const void* elems, size_t count);
+
+/**
+ * Append every element of another vector
+ * 
+ * @param dst The vector to append to
+ * @param src The vector to copy from; may be dst
+ * @return true if successful, false if the element sizes differ or
+ *         allocation fails
+ */
+bool braggi_vector_extend_from(Vector* dst, const Vector* src);
+
+/**
+ * Insert count elements at a position, shifting the rest up once
+ * 
+ * @param vector The vector
+ * @param index The index to insert at, at most the size
+ * @param elems Packed elements of the vector's element size; must not
+ *              point into the vector
+ * @param count Number of elements
+ * @return true if successful, false if allocation fails or index is out of bounds
+ */
+bool braggi_vector_insert_range(Vector* vector, size_t index, const void* elems, size_t count);
+
 /**
  * Clear all elements from the vector
  */
@@ -210,6 +247,13 @@ bool braggi_vector_remove(Vector* vector, const void* elem);
  */
 bool braggi_vector_erase(Vector* vector, size_t index);
 
+/*
+ * Element at index as a value of type, without a call or bounds check.
+ * For loops that already keep index < size. Element types known at
+ * compile time are better served by typed_vector.h.
+ */
+#define braggi_vector_at(vector, type, index) (((type*)(vector)->data)[(index)])
+
 // Convenience function to get the last element
 static inline void* braggi_vector_back(const Vector* vector) {
     if (!vector || vector->size == 0) return NULL;
@@ -0,0 +1,221 @@
+/*
+ * Braggi - Immediate Values
+ *
+ * "Ya don't saddle a whole horse to carry a single horseshoe -
+ * small things ride in yer pocket!" - Texan Packin' Wisdom
+ *
+ * BraggiVal is a 16-byte tagged value passed and returned by value.
+ * Ints, floats, bools and null live inline; strings and arrays point at
+ * payloads allocated in the region that owns them, so a value is freed
+ * when its region is.
+ */
+
+#ifndef BRAGGI_VALUE_H
+#define BRAGGI_VALUE_H
+
+#include "braggi/runtime.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Value tags
+typedef enum BraggiValTag {
+    BRAGGI_VAL_NULL = 0,
+    BRAGGI_VAL_BOOL,
+    BRAGGI_VAL_INT,
+    BRAGGI_VAL_FLOAT,
+    BRAGGI_VAL_STRING,   // as.string points at length bytes, possibly shared with a longer string
+    BRAGGI_VAL_ARRAY,    // as.array points at a region-allocated BraggiValArray
+    BRAGGI_VAL_ERROR,    // as.string is a static message, nothing to free
+    BRAGGI_VAL_SUPERPOSITION // as.superposition points at a region-allocated BraggiSuperposition
+} BraggiValTag;
+
+typedef struct BraggiValArray BraggiValArray;
+typedef struct BraggiSuperposition BraggiSuperposition;
+
+// Element storage of an array. Typed arrays keep raw numbers in one
+// contiguous buffer so the math kernels can stream over them.
+typedef enum BraggiElemKind {
+    BRAGGI_ELEM_ANY = 0,  // BraggiVal items, any mix of tags
+    BRAGGI_ELEM_I64,      // int64_t items
+    BRAGGI_ELEM_F64       // double items
+} BraggiElemKind;
+
+// Compact tagged value
+typedef struct BraggiVal {
+    uint32_t tag;        // BraggiValTag
+    uint32_t length;     // String length in bytes, 0 for everything else
+    union {
+        bool boolean;
+        int64_t integer;
+        double number;
+        const char* string;
+        BraggiValArray* array;
+        BraggiSuperposition* superposition;
+    } as;
+} BraggiVal;
+
+_Static_assert(sizeof(BraggiVal) == 16, "BraggiVal must stay two words");
+
+// Array payload; grows by reallocating inside the same region
+struct BraggiValArray {
+    BraggiRegionHandle region;
+    BraggiElemKind kind;
+    size_t length;
+    size_t capacity;
+    union {
+        BraggiVal* items;  // BRAGGI_ELEM_ANY
+        int64_t* i64;      // BRAGGI_ELEM_I64
+        double* f64;       // BRAGGI_ELEM_F64
+    };
+};
+
+/*
+ * Native builtin calling convention. Arguments arrive as a span owned
+ * by the caller; the result comes back by value. Builtins that produce
+ * strings or arrays allocate them in region. Errors are reported as a
+ * BRAGGI_VAL_ERROR result rather than through a side channel.
+ */
+typedef BraggiVal (*BraggiNativeFunc)(const BraggiVal* args, size_t arg_count,
+                                      BraggiRegionHandle region, void* context);
+
+// Inline constructors for immediates - none of these allocate
+static inline BraggiVal braggi_val_null(void) {
+    BraggiVal value = { BRAGGI_VAL_NULL, 0, { .integer = 0 } };
+    return value;
+}
+
+static inline BraggiVal braggi_val_bool(bool b) {
+    BraggiVal value = { BRAGGI_VAL_BOOL, 0, { .integer = 0 } };
+    value.as.boolean = b;
+    return value;
+}
+
+static inline BraggiVal braggi_val_int(int64_t i) {
+    BraggiVal value = { BRAGGI_VAL_INT, 0, { .integer = i } };
+    return value;
+}
+
+static inline BraggiVal braggi_val_float(double f) {
+    BraggiVal value = { BRAGGI_VAL_FLOAT, 0, { .number = f } };
+    return value;
+}
+
+static inline BraggiVal braggi_val_error(const char* message) {
+    BraggiVal value = { BRAGGI_VAL_ERROR, 0, { .string = message } };
+    return value;
+}
+
+static inline bool braggi_val_is_error(BraggiVal value) {
+    return value.tag == BRAGGI_VAL_ERROR;
+}
+
+static inline bool braggi_val_is_number(BraggiVal value) {
+    return value.tag == BRAGGI_VAL_INT || value.tag == BRAGGI_VAL_FLOAT;
+}
+
+/**
+ * Read a number as a double
+ *
+ * @param value An int or float value
+ * @return The number, or 0.0 for any other tag
+ */
+static inline double braggi_val_as_double(BraggiVal value) {
+    if (value.tag == BRAGGI_VAL_FLOAT) return value.as.number;
+    if (value.tag == BRAGGI_VAL_INT) return (double)value.as.integer;
+    return 0.0;
+}
+
+/**
+ * Copy a string into a region
+ *
+ * @param region The owning region
+ * @param text The bytes to copy, need not be NUL-terminated
+ * @param length Number of bytes
+ * @return A string value, or an error value if the region is full
+ */
+BraggiVal braggi_val_string(BraggiRegionHandle region, const char* text, size_t length);
+
+/**
+ * Create an empty array in a region
+ *
+ * @param region The owning region
+ * @param capacity Initial capacity
+ * @return An array value, or an error value if the region is full
+ */
+BraggiVal braggi_val_array(BraggiRegionHandle region, size_t capacity);
+
+/**
+ * Create an empty typed array in a region
+ *
+ * @param region The owning region
+ * @param kind Element storage
+ * @param capacity Initial capacity
+ * @return An array value, or an error value if the region is full
+ */
+BraggiVal braggi_val_typed_array(BraggiRegionHandle region, BraggiElemKind kind, size_t capacity);
+
+/**
+ * Append to an array, growing it inside its region when full. An
+ * i64 array only takes ints; an f64 array takes ints and floats.
+ *
+ * @param array An array value
+ * @param item The value to append
+ * @return false if the region ran out of room, array isn't an array
+ *         or item doesn't fit the element kind
+ */
+bool braggi_val_array_push(BraggiVal array, BraggiVal item);
+
+/**
+ * Get the number of elements in an array
+ *
+ * @param array An array value
+ * @return The length, 0 if array isn't an array
+ */
+size_t braggi_val_array_length(BraggiVal array);
+
+/**
+ * Get an array element
+ *
+ * @param array An array value
+ * @param index Element index
+ * @return The element, or null when out of range
+ */
+BraggiVal braggi_val_array_get(BraggiVal array, size_t index);
+
+/**
+ * Compare two values. Ints and floats compare by numeric value,
+ * strings by content and arrays element by element. A superposition
+ * is only equal to itself.
+ *
+ * @return true if the values are equal
+ */
+bool braggi_val_equals(BraggiVal a, BraggiVal b);
+
+/**
+ * Check whether a value counts as true in a condition
+ *
+ * @param value The value
+ * @return false for null, false, 0, 0.0, "" and errors. A
+ *         superposition is observed and its outcome tested.
+ */
+bool braggi_val_truthy(BraggiVal value);
+
+/**
+ * Get the name of a value's type
+ *
+ * @param value The value
+ * @return A static string such as "int"
+ */
+const char* braggi_val_type_name(BraggiVal value);
+
+/**
+ * Print a value the way the io builtins show it
+ *
+ * @param value The value
+ * @param stream Destination stream
+ */
+void braggi_val_print(BraggiVal value, FILE* stream);
+
+#endif /* BRAGGI_VALUE_H */
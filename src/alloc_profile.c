@@ -0,0 +1,352 @@
+/*
+ * Braggi - Sampling Allocation Profiler Implementation
+ *
+ * "A good brand book don't list every calf - just enough to
+ * tell whose cattle are eatin' all the grass!" - Irish-Texan Ranch Wisdom
+ */
+
+#include "braggi/alloc_profile.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+// Interned names - labels and region names share one table
+#define ATOM_CAPACITY 1024
+#define ATOM_SLOTS (ATOM_CAPACITY * 2)
+
+// Regions tracked separately; extra regions fold into the last slot
+#define REGION_SLOTS 512
+
+// Running totals for one label or region
+typedef struct SampleTotal {
+    uint64_t samples;
+    uint64_t bytes;
+} SampleTotal;
+
+typedef struct RegionTotal {
+    bool used;
+    uintptr_t key;
+    uint32_t name_atom;
+    SampleTotal total;
+} RegionTotal;
+
+_Atomic uint32_t braggi_alloc_profile_rate = 0;
+_Thread_local uint32_t braggi_alloc_profile_countdown = 0;
+_Thread_local uint64_t braggi_alloc_profile_thread_count = 0;
+_Thread_local uint64_t braggi_alloc_profile_thread_bytes = 0;
+
+// Per-thread sampler state: a private generator, and the index the
+// thread's next sample will carry
+static _Thread_local uint64_t thread_rng = 0;
+static _Thread_local uint64_t thread_sequence = 0;
+static _Atomic uint64_t thread_seeds = 0;
+
+// Everything below is shared and guarded by profile_lock
+static pthread_mutex_t profile_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Rate of the last enable, kept after disabling for the report
+static uint32_t sample_rate = 0;
+static uint64_t sampled_allocations = 0;
+
+static AllocSample ring[BRAGGI_ALLOC_PROFILE_RING_SIZE];
+static size_t ring_next = 0;
+static size_t ring_count = 0;
+
+// Atom 0 is reserved for "(unlabeled)"; atom_count doubles as the next atom
+static char* atom_names[ATOM_CAPACITY];
+static uint32_t atom_hashes[ATOM_CAPACITY];
+static uint32_t atom_slots[ATOM_SLOTS];
+static uint32_t atom_count = 1;
+
+static SampleTotal label_totals[ATOM_CAPACITY];
+static RegionTotal region_totals[REGION_SLOTS];
+
+static uint32_t hash_string(const char* text) {
+    uint32_t hash = 2166136261u;
+    while (*text) {
+        hash ^= (unsigned char)*text++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Intern a name; once the table is full new names map to atom 0
+static uint32_t intern(const char* name) {
+    if (!name || !*name) return 0;
+
+    uint32_t hash = hash_string(name);
+    size_t slot = hash & (ATOM_SLOTS - 1);
+
+    while (atom_slots[slot] != 0) {
+        uint32_t atom = atom_slots[slot];
+        if (atom_hashes[atom] == hash && strcmp(atom_names[atom], name) == 0) {
+            return atom;
+        }
+        slot = (slot + 1) & (ATOM_SLOTS - 1);
+    }
+
+    if (atom_count >= ATOM_CAPACITY) return 0;
+
+    char* copy = strdup(name);
+    if (!copy) return 0;
+
+    uint32_t atom = atom_count++;
+    atom_names[atom] = copy;
+    atom_hashes[atom] = hash;
+    atom_slots[slot] = atom;
+    return atom;
+}
+
+static RegionTotal* region_total(uintptr_t key) {
+    size_t slot = (size_t)((key ^ (key >> 17)) * 2654435761u) & (REGION_SLOTS - 1);
+
+    for (size_t probe = 0; probe < REGION_SLOTS; probe++) {
+        RegionTotal* total = &region_totals[slot];
+        if (!total->used) {
+            total->used = true;
+            total->key = key;
+            return total;
+        }
+        if (total->key == key) return total;
+        slot = (slot + 1) & (REGION_SLOTS - 1);
+    }
+
+    // Table is full - lump the rest together rather than drop them
+    return &region_totals[REGION_SLOTS - 1];
+}
+
+// xorshift64*, seeded per thread from a shared counter
+static uint64_t rng_next(void) {
+    if (thread_rng == 0) {
+        uint64_t seed = atomic_fetch_add_explicit(&thread_seeds, 1, memory_order_relaxed) + 1;
+        thread_rng = (seed * 0x9E3779B97F4A7C15ULL) ^ (uint64_t)(uintptr_t)&thread_rng;
+        if (thread_rng == 0) thread_rng = 0x9E3779B97F4A7C15ULL;
+    }
+    thread_rng ^= thread_rng >> 12;
+    thread_rng ^= thread_rng << 25;
+    thread_rng ^= thread_rng >> 27;
+    return thread_rng * 0x2545F4914F6CDD1DULL;
+}
+
+// Allocations until the next sample, geometric with the given mean
+static uint32_t next_interval(uint32_t rate) {
+    if (rate <= 1) return 1;
+
+    // Uniform in (0, 1]
+    double u = (double)((rng_next() >> 11) + 1) * (1.0 / 9007199254740992.0);
+    double interval = 1.0 + floor(log(u) / log1p(-1.0 / (double)rate));
+    if (interval >= (double)UINT32_MAX) return UINT32_MAX;
+    return (uint32_t)interval;
+}
+
+static void arm_thread(uint32_t rate) {
+    braggi_alloc_profile_countdown = next_interval(rate);
+    thread_sequence += braggi_alloc_profile_countdown;
+}
+
+void braggi_alloc_profile_enable(uint32_t rate) {
+    rate = rate ? rate : BRAGGI_ALLOC_PROFILE_DEFAULT_RATE;
+
+    pthread_mutex_lock(&profile_lock);
+    sample_rate = rate;
+    pthread_mutex_unlock(&profile_lock);
+
+    // Other threads arm themselves on their next allocation
+    arm_thread(rate);
+    atomic_store_explicit(&braggi_alloc_profile_rate, rate, memory_order_relaxed);
+}
+
+void braggi_alloc_profile_disable(void) {
+    atomic_store_explicit(&braggi_alloc_profile_rate, 0, memory_order_relaxed);
+}
+
+bool braggi_alloc_profile_is_enabled(void) {
+    return atomic_load_explicit(&braggi_alloc_profile_rate, memory_order_relaxed) != 0;
+}
+
+uint64_t braggi_alloc_profile_sample_count(void) {
+    pthread_mutex_lock(&profile_lock);
+    uint64_t count = sampled_allocations;
+    pthread_mutex_unlock(&profile_lock);
+    return count;
+}
+
+void braggi_alloc_profile_reset(void) {
+    pthread_mutex_lock(&profile_lock);
+
+    for (uint32_t i = 1; i < atom_count; i++) {
+        free(atom_names[i]);
+        atom_names[i] = NULL;
+    }
+    atom_count = 1;
+    memset(atom_slots, 0, sizeof(atom_slots));
+    memset(label_totals, 0, sizeof(label_totals));
+    memset(region_totals, 0, sizeof(region_totals));
+
+    ring_next = 0;
+    ring_count = 0;
+    sampled_allocations = 0;
+    pthread_mutex_unlock(&profile_lock);
+}
+
+void braggi_alloc_profile_tick(uintptr_t region_key, const char* region_name, size_t size,
+                               uint32_t line, uint32_t column, const char* label) {
+    uint32_t rate = atomic_load_explicit(&braggi_alloc_profile_rate, memory_order_relaxed);
+    if (rate == 0) return;
+
+    // A thread's first allocation since profiling began only arms it
+    if (braggi_alloc_profile_countdown == 0) {
+        arm_thread(rate);
+        if (--braggi_alloc_profile_countdown != 0) return;
+    }
+
+    braggi_alloc_profile_sample(region_key, region_name, size, line, column, label);
+    arm_thread(rate);
+}
+
+void braggi_alloc_profile_sample(uintptr_t region_key, const char* region_name, size_t size,
+                                 uint32_t line, uint32_t column, const char* label) {
+    pthread_mutex_lock(&profile_lock);
+
+    AllocSample* sample = &ring[ring_next];
+    sampled_allocations++;
+    sample->sequence = thread_sequence;
+    sample->region_key = region_key;
+    sample->label_atom = intern(label);
+    sample->line = line;
+    sample->column = column;
+    sample->size = size;
+
+    ring_next = (ring_next + 1) % BRAGGI_ALLOC_PROFILE_RING_SIZE;
+    if (ring_count < BRAGGI_ALLOC_PROFILE_RING_SIZE) ring_count++;
+
+    label_totals[sample->label_atom].samples++;
+    label_totals[sample->label_atom].bytes += size;
+
+    RegionTotal* region = region_total(region_key);
+    if (region->name_atom == 0) {
+        region->name_atom = intern(region_name);
+    }
+    region->total.samples++;
+    region->total.bytes += size;
+    sample->region_atom = region->name_atom;
+
+    pthread_mutex_unlock(&profile_lock);
+}
+
+static const char* atom_name_locked(uint32_t atom) {
+    if (atom == 0 || atom >= atom_count) return "(unlabeled)";
+    return atom_names[atom];
+}
+
+size_t braggi_alloc_profile_atom_name(uint32_t atom, char* dest, size_t size) {
+    pthread_mutex_lock(&profile_lock);
+    const char* name = atom_name_locked(atom);
+    size_t length = strlen(name);
+    if (dest && size > 0) {
+        size_t copied = length < size ? length : size - 1;
+        memcpy(dest, name, copied);
+        dest[copied] = '\0';
+    }
+    pthread_mutex_unlock(&profile_lock);
+    return length;
+}
+
+static size_t recent_locked(AllocSample* out, size_t max) {
+    size_t count = ring_count < max ? ring_count : max;
+    size_t index = ring_next;
+    for (size_t i = 0; i < count; i++) {
+        index = (index + BRAGGI_ALLOC_PROFILE_RING_SIZE - 1) % BRAGGI_ALLOC_PROFILE_RING_SIZE;
+        out[i] = ring[index];
+    }
+    return count;
+}
+
+size_t braggi_alloc_profile_recent(AllocSample* out, size_t max) {
+    if (!out) return 0;
+
+    pthread_mutex_lock(&profile_lock);
+    size_t count = recent_locked(out, max);
+    pthread_mutex_unlock(&profile_lock);
+    return count;
+}
+
+// Sort helpers - largest byte total first
+static int compare_labels(const void* a, const void* b) {
+    uint64_t bytes_a = label_totals[*(const uint32_t*)a].bytes;
+    uint64_t bytes_b = label_totals[*(const uint32_t*)b].bytes;
+    return (bytes_a < bytes_b) - (bytes_a > bytes_b);
+}
+
+static int compare_regions(const void* a, const void* b) {
+    uint64_t bytes_a = (*(const RegionTotal* const*)a)->total.bytes;
+    uint64_t bytes_b = (*(const RegionTotal* const*)b)->total.bytes;
+    return (bytes_a < bytes_b) - (bytes_a > bytes_b);
+}
+
+void braggi_alloc_profile_print(FILE* stream, size_t top) {
+    if (!stream) return;
+
+    pthread_mutex_lock(&profile_lock);
+
+    uint64_t rate = sample_rate ? sample_rate : BRAGGI_ALLOC_PROFILE_DEFAULT_RATE;
+
+    fprintf(stream, "===== ALLOCATION PROFILE (1 in %llu) =====\n", (unsigned long long)rate);
+    fprintf(stream, "Samples: %llu, estimated allocations: %llu\n",
+            (unsigned long long)sampled_allocations,
+            (unsigned long long)(sampled_allocations * rate));
+
+    uint32_t labels[ATOM_CAPACITY];
+    size_t label_count = 0;
+    for (uint32_t atom = 0; atom < atom_count; atom++) {
+        if (label_totals[atom].samples > 0) labels[label_count++] = atom;
+    }
+    qsort(labels, label_count, sizeof(uint32_t), compare_labels);
+
+    fprintf(stream, "\n%-32s %10s %14s\n", "Label", "Samples", "Est. bytes");
+    for (size_t i = 0; i < label_count && (top == 0 || i < top); i++) {
+        const SampleTotal* total = &label_totals[labels[i]];
+        fprintf(stream, "%-32s %10llu %14llu\n", atom_name_locked(labels[i]),
+                (unsigned long long)total->samples, (unsigned long long)(total->bytes * rate));
+    }
+
+    RegionTotal* regions[REGION_SLOTS];
+    size_t region_count = 0;
+    for (size_t i = 0; i < REGION_SLOTS; i++) {
+        if (region_totals[i].used) regions[region_count++] = &region_totals[i];
+    }
+    qsort(regions, region_count, sizeof(RegionTotal*), compare_regions);
+
+    fprintf(stream, "\n%-32s %10s %14s\n", "Region", "Samples", "Est. bytes");
+    for (size_t i = 0; i < region_count && (top == 0 || i < top); i++) {
+        const RegionTotal* region = regions[i];
+        char name[64];
+        if (region->name_atom) {
+            snprintf(name, sizeof(name), "%s", atom_name_locked(region->name_atom));
+        } else if (region->key <= UINT32_MAX) {
+            snprintf(name, sizeof(name), "#%llu", (unsigned long long)region->key);
+        } else {
+            // Runtime regions are keyed by handle
+            snprintf(name, sizeof(name), "%p", (void*)region->key);
+        }
+        fprintf(stream, "%-32s %10llu %14llu\n", name,
+                (unsigned long long)region->total.samples,
+                (unsigned long long)(region->total.bytes * rate));
+    }
+
+    // Call sites of the newest samples help pin down the hot spot
+    AllocSample recent[8];
+    size_t recent_count = recent_locked(recent, 8);
+    if (recent_count > 0) {
+        fprintf(stream, "\nMost recent samples:\n");
+        for (size_t i = 0; i < recent_count; i++) {
+            fprintf(stream, "  %-30s %8zu bytes at %u:%u\n",
+                    atom_name_locked(recent[i].label_atom),
+                    recent[i].size, recent[i].line, recent[i].column);
+        }
+    }
+
+    pthread_mutex_unlock(&profile_lock);
+}
@@ -9,6 +9,7 @@
 #include "braggi/region.h"
 #include "braggi/region_types.h"
 #include "braggi/error.h"
+#include "braggi/alloc_profile.h"
 // Temporarily comment out hashmap until it's available
 // #include "braggi/util/hashmap.h"  /* Include hashmap for allocation tracking */
 #include "braggi/util/region.h"   /* Include for low-level region allocator */
@@ -142,6 +143,11 @@ void braggi_mem_allocation_shutdown(void) {
 /* Track a new allocation */
 bool braggi_mem_allocation_track(void* ptr, size_t size, RegionId region_id, 
                                SourcePosition source_pos, const char* label) {
+    // Sampling works even while full tracking is disabled
+    if (ptr) {
+        braggi_alloc_profile_note(region_id, NULL, size, source_pos.line, source_pos.column, label);
+    }
+    
     // Disabled until hashmap is available
     // if (!ptr || !global_allocations) {
     //     return false;
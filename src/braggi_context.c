@@ -44,6 +44,9 @@
 #include "braggi/codegen.h"
 #include "braggi/entropy_ecs.h"
 
+// Runtime output buffers follow the context's stdout and stderr
+#include "braggi/rt_io.h"
+
 // Use the BraggiContext defined in the header, don't redefine it
 // Just implement the functions here
 
@@ -357,30 +360,23 @@ ErrorHandler* braggi_context_get_error_handler(BraggiContext* context) {
 void braggi_context_report_error(BraggiContext* context, ErrorCategory category,
                             ErrorSeverity severity, uint32_t line, uint32_t column,
                             const char* file, const char* message, const char* hint) {
-    if (!context || !context->error_handler) return;
-    
-    /* 
-     * The ACTUAL declaration from error.h is:
-     * void braggi_error_add(ErrorHandler* handler, 
-     *                        ErrorSeverity severity, 
-     *                        const char* message,
-     *                        const char* file, 
-     *                        uint32_t line, 
-     *                        uint32_t column);
-     */
-    
-    /* Call with the CORRECT parameter order according to the declaration */
-    braggi_error_add(
-        context->error_handler,  /* handler */
-        severity,                /* severity (not category) */
-        message,                 /* message comes THIRD */
-        file,                    /* file comes FOURTH */
-        line,                    /* line comes FIFTH */
-        column                   /* column comes SIXTH */
-    );
-    
-    /* Category and hint parameters are ignored in this implementation */
-    (void)category;
+    if (!context || !context->error_handler || !message) return;
+    
+    // The message is kept by reference and only rendered if the
+    // diagnostic is shown. There is no source file for these, so the
+    // position and file name are dropped; the hint never was shown.
+    BraggiDiagRecord record = {
+        .id = BRAGGI_DIAG_CONTEXT_FAILED,
+        .category = category,
+        .severity = severity,
+        .loc = BRAGGI_SOURCE_LOC_INVALID,
+        .args = {BRAGGI_DIAG_TEXT(message)},
+    };
+    braggi_error_report_record(context->error_handler, &record);
+    
+    (void)line;
+    (void)column;
+    (void)file;
     (void)hint;
 }
 
@@ -517,8 +513,11 @@ bool braggi_context_compile(BraggiContext* context) {
         Token* token = braggi_token_create(
             current->type,
             current->text ? strdup(current->text) : NULL,
-            current->position
+            (SourcePosition){0}
         );
+        if (token) {
+            token->loc = current->loc;  // Already encoded; no need to decode and re-encode
+        }
         
         if (!token) {
             fprintf(stderr, "DEBUG: Failed to create token #%d\n", token_count);
@@ -611,6 +610,10 @@ bool braggi_context_compile(BraggiContext* context) {
     
     fprintf(stderr, "DEBUG: Created token propagator at %p\n", (void*)context->propagator);
     
+    // Propagation failures are reported against this source
+    braggi_token_propagator_set_source_file_id(context->propagator, source->file_id);
+    braggi_token_propagator_set_error_handler(context->propagator, context->error_handler);
+    
     // Add tokens to propagator
     for (size_t i = 0; i < braggi_vector_size(tokens); i++) {
         Token** token_ptr = (Token**)braggi_vector_get(tokens, i);
@@ -729,6 +732,9 @@ void braggi_context_set_stdout(BraggiContext* context, FILE* handle) {
         return;
     }
     context->stdout_handle = handle;
+    
+    // Runtime output is buffered separately; send it to the same place
+    braggi_io_redirect(braggi_io_stdout(), handle);
 }
 
 void braggi_context_set_stderr(BraggiContext* context, FILE* handle) {
@@ -736,6 +742,7 @@ void braggi_context_set_stderr(BraggiContext* context, FILE* handle) {
         return;
     }
     context->stderr_handle = handle;
+    braggi_io_redirect(braggi_io_stderr(), handle);
 }
 
 void braggi_context_set_stdin(BraggiContext* context, FILE* handle) {
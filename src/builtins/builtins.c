@@ -21,7 +21,7 @@ struct BraggiValue {
 #define BRAGGI_VALUE_DEFINED
 #endif
 
-// Structure for the builtin registry is defined in stdlib.h
+// Structure for the builtin registry is defined in stdlib.c
 // Avoid duplicating the registry functions here
 
 // Static function implementations for builtins
@@ -45,24 +45,14 @@ static BraggiValue* builtin_exit(BraggiValue** args, size_t arg_count, void* con
     return NULL;
 }
 
-// Lookup implementation that matches the declaration
-BraggiBuiltinFunc braggi_builtin_registry_lookup(BraggiBuiltinRegistry* registry, const char* name, void** out_context) {
-    if (!registry || !name) {
-        return NULL;
+// Name lookup lives with the registry in stdlib.c; these just get registered
+void braggi_builtins_register_core(BraggiBuiltinRegistry* registry) {
+    if (!registry) {
+        return;
     }
     
-    // Simple stub implementation - in a real implementation we'd search the registry
-    if (strcmp(name, "print") == 0) {
-        if (out_context) *out_context = NULL;
-        return builtin_print;
-    }
-    else if (strcmp(name, "exit") == 0) {
-        if (out_context) *out_context = NULL;
-        return builtin_exit;
-    }
-    
-    // Not found
-    return NULL;
+    braggi_builtin_registry_register(registry, "print", builtin_print, NULL);
+    braggi_builtin_registry_register(registry, "exit", builtin_exit, NULL);
 }
 
 /**
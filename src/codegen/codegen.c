@@ -9,6 +9,7 @@
 #include "braggi/braggi_context.h"
 #include "braggi/token_propagator.h"
 #include "braggi/codegen_arch.h"
+#include "braggi/stdlib.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -64,19 +65,13 @@ bool braggi_codegen_init(CodeGenContext* ctx, BraggiContext* braggi_ctx, CodeGen
                     braggi_vector_clear(braggi_ctx->tokens);
                 }
                 
-                // Copy tokens from propagator to context with careful error checking
+                // Copy tokens from propagator to context in one go; the
+                // propagator leaves NULL tokens out of its output
                 size_t tokens_transferred = 0;
-                for (size_t i = 0; i < token_count; i++) {
-                    Token** token_ptr = (Token**)braggi_vector_get(output_tokens, i);
-                    if (token_ptr && *token_ptr) {
-                        if (braggi_vector_push_back(braggi_ctx->tokens, token_ptr)) {
-                            tokens_transferred++;
-                        } else {
-                            fprintf(stderr, "WARNING: Failed to transfer token %zu to context\n", i);
-                        }
-                    } else {
-                        fprintf(stderr, "WARNING: NULL token at index %zu in propagator output\n", i);
-                    }
+                if (braggi_vector_extend_from(braggi_ctx->tokens, output_tokens)) {
+                    tokens_transferred = braggi_vector_size(output_tokens);
+                } else {
+                    fprintf(stderr, "WARNING: Failed to transfer tokens to context\n");
                 }
                 
                 fprintf(stderr, "DEBUG: Transferred %zu of %zu tokens from propagator to context\n", 
@@ -176,6 +171,9 @@ bool braggi_codegen_generate(CodeGenContext* ctx) {
     // Set the entropy field in the code generator options
     ctx->options.entropy_field = field;
     
+    // Hand the backend the builtin registry so calls resolve to IDs now
+    ctx->generator->builtins = braggi_stdlib_get_registry(ctx->braggi_ctx);
+    
     // Call the backend's generate function
     fprintf(stderr, "DEBUG: Calling backend's generate function\n");
     if (!ctx->generator->generate(ctx->generator, field)) {
@@ -226,7 +224,7 @@ static bool braggi_codegen_generate_file(CodeGenContext* ctx, Source* source, co
     }
     
     for (size_t i = 0; i < braggi_vector_size(tokens); i++) {
-        Token* token = (Token*)braggi_vector_get(tokens, i);
+        Token* token = *(Token**)braggi_vector_get(tokens, i);
         if (!braggi_token_propagator_add_token(propagator, token)) {
             fprintf(stderr, "ERROR: Failed to add token to propagator\n");
             braggi_vector_destroy(tokens);
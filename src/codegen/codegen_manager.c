@@ -70,7 +70,7 @@ bool braggi_codegen_manager_init(void) {
     }
     
     // Create error handler
-    manager->error_handler = (ErrorHandler*)malloc(sizeof(ErrorHandler));
+    manager->error_handler = (ErrorHandler*)calloc(1, sizeof(ErrorHandler));
     if (!manager->error_handler) {
         DEBUG_PRINT("Failed to allocate memory for error handler");
         free(manager);
@@ -216,6 +216,27 @@ bool braggi_codegen_manager_register_backend(CodeGenerator* backend) {
     return true;
 }
 
+// braggi_codegen_cleanup destroys a backend's per-compile data, not the
+// generator, which stays registered until the manager is cleaned up; its
+// init builds that data again. Put such backends back in service so one
+// process can compile more than once.
+static void revive_backends(void) {
+    for (int i = 0; i < manager->num_backends; i++) {
+        ManagedGenerator* backend = &manager->backends[i];
+        if (backend->status == GENERATOR_STATUS_DESTROYED && backend->owned_by_manager &&
+            backend->generator && !backend->generator->arch_data) {
+            DEBUG_PRINT("Reviving backend at index %d for another compilation", i);
+            backend->status = GENERATOR_STATUS_ACTIVE;
+            
+            // Registration makes x86_64 the default, so restore that first
+            if (!manager->default_backend || (backend->generator->name &&
+                                              strcmp(backend->generator->name, "x86_64") == 0)) {
+                manager->default_backend = backend;
+            }
+        }
+    }
+}
+
 // Get a code generator for the specified architecture
 CodeGenerator* braggi_codegen_manager_get_backend(TargetArch arch) {
     if (!manager) {
@@ -223,6 +244,8 @@ CodeGenerator* braggi_codegen_manager_get_backend(TargetArch arch) {
         return NULL;
     }
     
+    revive_backends();
+    
     // Look for a backend that supports the requested architecture
     const char* arch_name = braggi_codegen_arch_to_string(arch);
     DEBUG_PRINT("Looking for backend for architecture: %s", arch_name);
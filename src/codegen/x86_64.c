@@ -10,6 +10,7 @@
 #include "braggi/region.h"
 #include "braggi/token.h"
 #include "braggi/entropy.h"
+#include "braggi/builtins/builtins.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -24,6 +25,15 @@ typedef struct {
     size_t asm_size;
     size_t asm_capacity;
     
+    // Next string literal label; per compilation, so labels don't
+    // depend on what this process compiled before
+    int string_counter;
+    
+    // Which builtin IDs this compilation called, so a thunk is emitted
+    // for each; sized to the registry
+    bool* builtins_called;
+    size_t builtin_count;
+    
     // Add a flag to track initialization
     bool initialized;
     
@@ -34,11 +44,14 @@ typedef struct {
 // Forward declarations for helper functions
 static void x86_64_generate_function_declaration(X86_64Data* data, Token* token);
 static void x86_64_generate_identifier_usage(X86_64Data* data, Token* token);
+static size_t x86_64_generate_builtin_call(X86_64Data* data, BraggiBuiltinRegistry* builtins,
+                                           EntropyField* field, size_t index);
 static void x86_64_generate_numeric_literal(X86_64Data* data, Token* token);
 static void x86_64_generate_string_literal(X86_64Data* data, Token* token);
 static void x86_64_generate_keyword(X86_64Data* data, Token* token);
 static void x86_64_generate_operator(X86_64Data* data, Token* token);
 static void x86_64_generate_punctuation(X86_64Data* data, Token* token);
+static bool x86_64_generate_builtin_thunks(X86_64Data* data, BraggiBuiltinRegistry* builtins);
 
 // Magic number to verify the data structure is valid
 #define X86_64_MAGIC 0xC0DEC0DE
@@ -139,6 +152,9 @@ static void x86_64_destroy(CodeGenerator* generator) {
         DEBUG_PRINT("No assembly buffer to free");
     }
     
+    free(data->builtins_called);
+    data->builtins_called = NULL;
+    
     // Invalidate the data structure before freeing
     DEBUG_PRINT("Invalidating data structure");
     data->initialized = false;
@@ -160,6 +176,27 @@ static void x86_64_destroy(CodeGenerator* generator) {
     DEBUG_PRINT("Successfully destroyed x86_64 backend - generator is no longer valid");
 }
 
+// Get the token a cell collapsed to, NULL if it hasn't collapsed
+static Token* x86_64_cell_token(EntropyField* field, size_t index) {
+    if (index >= field->cell_count) return NULL;
+    
+    EntropyCell* cell = field->cells[index];
+    if (!cell) return NULL;
+    
+    // Skip cells that have no collapsed state
+    if (!braggi_entropy_cell_is_collapsed(cell)) return NULL;
+    
+    // Find the non-eliminated state (the collapsed one)
+    for (size_t j = 0; j < cell->state_count; j++) {
+        if (cell->states[j] && cell->states[j]->probability > 0) {
+            // Extract the token from the state
+            return (Token*)cell->states[j]->data;
+        }
+    }
+    
+    return NULL;
+}
+
 // Code generation function
 static bool x86_64_generate(CodeGenerator* generator, EntropyField* field) {
     DEBUG_PRINT("Generating x86_64 code");
@@ -187,6 +224,14 @@ static bool x86_64_generate(CodeGenerator* generator, EntropyField* field) {
     }
     data->asm_size = 0;
     
+    free(data->builtins_called);
+    data->builtin_count = generator->builtins ? braggi_builtin_registry_count(generator->builtins) : 0;
+    data->builtins_called = data->builtin_count ? (bool*)calloc(data->builtin_count, sizeof(bool)) : NULL;
+    if (data->builtin_count && !data->builtins_called) {
+        DEBUG_PRINT("ERROR: Failed to allocate builtin call table");
+        return false;
+    }
+    
     // Add standard assembly header
     const char* header =
         "# Generated by Braggi Compiler\n"
@@ -220,25 +265,7 @@ static bool x86_64_generate(CodeGenerator* generator, EntropyField* field) {
     for (size_t i = 0; i < cell_count; i++) {
         if (i >= field->cell_count) break; // Safety check
         
-        EntropyCell* cell = field->cells[i];
-        if (!cell) continue;
-        
-        // Skip cells that have no collapsed state
-        if (!braggi_entropy_cell_is_collapsed(cell)) continue;
-        
-        // Find the non-eliminated state (the collapsed one)
-        EntropyState* state = NULL;
-        for (size_t j = 0; j < cell->state_count; j++) {
-            if (cell->states[j] && cell->states[j]->probability > 0) {
-                state = cell->states[j];
-                break;
-            }
-        }
-        
-        if (!state) continue;
-        
-        // Extract the token from the state
-        Token* token = (Token*)state->data;
+        Token* token = x86_64_cell_token(field, i);
         if (!token) continue;
         
         // Generate code based on token type
@@ -247,14 +274,28 @@ static bool x86_64_generate(CodeGenerator* generator, EntropyField* field) {
                 if (strcmp(token->text, "func") == 0 || strcmp(token->text, "fn") == 0) {
                     x86_64_generate_function_declaration(data, token);
                 } else {
-                    x86_64_generate_keyword(data, token);
+                    // Some builtins, like print, are also keywords
+                    size_t consumed = x86_64_generate_builtin_call(data, generator->builtins, field, i);
+                    if (consumed > 0) {
+                        i += consumed - 1;
+                    } else {
+                        x86_64_generate_keyword(data, token);
+                    }
                 }
                 break;
                 
-            case TOKEN_IDENTIFIER:
+            case TOKEN_IDENTIFIER: {
+                // Builtin calls are resolved to their ID here, once
+                size_t consumed = x86_64_generate_builtin_call(data, generator->builtins, field, i);
+                if (consumed > 0) {
+                    i += consumed - 1;
+                    break;
+                }
+                
                 // Handle identifiers in context (variables, function calls, etc.)
                 x86_64_generate_identifier_usage(data, token);
                 break;
+            }
                 
             case TOKEN_LITERAL_INT:
             case TOKEN_LITERAL_FLOAT:
@@ -312,6 +353,10 @@ static bool x86_64_generate(CodeGenerator* generator, EntropyField* field) {
         data->asm_buffer[data->asm_size] = '\0';
     }
     
+    if (!x86_64_generate_builtin_thunks(data, generator->builtins)) {
+        return false;
+    }
+    
     DEBUG_PRINT("Code generation completed successfully (%zu bytes)", data->asm_size);
     return true;
 }
@@ -380,6 +425,138 @@ static void x86_64_generate_identifier_usage(X86_64Data* data, Token* token) {
     data->asm_buffer[data->asm_size] = '\0';
 }
 
+// Emit a direct call when the identifier at index starts a call to a
+// registered builtin, e.g. `print(` or `math.add(`. The name is resolved
+// to its dense ID now so nothing is looked up by name at run time.
+// Returns how many tokens make up the name, 0 if this isn't a builtin call.
+static size_t x86_64_generate_builtin_call(X86_64Data* data, BraggiBuiltinRegistry* builtins,
+                                           EntropyField* field, size_t index) {
+    if (!builtins) return 0;
+    
+    Token* token = x86_64_cell_token(field, index);
+    if (!token || !token->text) return 0;
+    
+    // Join dotted names; builtins are registered as "module.name"
+    char name[256];
+    int length = snprintf(name, sizeof(name), "%s", token->text);
+    if (length < 0 || (size_t)length >= sizeof(name)) return 0;
+    
+    size_t next = index + 1;
+    for (;;) {
+        Token* dot = x86_64_cell_token(field, next);
+        Token* part = x86_64_cell_token(field, next + 1);
+        if (!dot || dot->type != TOKEN_OPERATOR || !dot->text || strcmp(dot->text, ".") != 0 ||
+            !part || part->type != TOKEN_IDENTIFIER || !part->text) {
+            break;
+        }
+        
+        int added = snprintf(name + length, sizeof(name) - (size_t)length, ".%s", part->text);
+        if (added < 0 || (size_t)(length + added) >= sizeof(name)) return 0;
+        length += added;
+        next += 2;
+    }
+    
+    // Only a call if an opening parenthesis follows
+    Token* paren = x86_64_cell_token(field, next);
+    if (!paren || paren->type != TOKEN_PUNCTUATION || !paren->text || strcmp(paren->text, "(") != 0) {
+        return 0;
+    }
+    
+    BraggiBuiltinId id = braggi_builtin_registry_resolve(builtins, name);
+    if (id == BRAGGI_BUILTIN_INVALID || id >= data->builtin_count) return 0;
+    data->builtins_called[id] = true;
+    
+    char call[320];
+    snprintf(call, sizeof(call), "    call __braggi_builtin_%u    # %s\n", (unsigned)id, name);
+    
+    // Append to the assembly buffer
+    size_t call_len = strlen(call);
+    if (data->asm_size + call_len + 1 > data->asm_capacity) {
+        // Resize the buffer if needed
+        char* new_buffer = (char*)realloc(data->asm_buffer, data->asm_size + call_len + 8192);
+        if (!new_buffer) {
+            DEBUG_PRINT("ERROR: Failed to resize asm_buffer for builtin call");
+            return 0;
+        }
+        data->asm_buffer = new_buffer;
+        data->asm_capacity = data->asm_size + call_len + 8192;
+    }
+    
+    memcpy(data->asm_buffer + data->asm_size, call, call_len);
+    data->asm_size += call_len;
+    data->asm_buffer[data->asm_size] = '\0';
+    
+    return next - index;
+}
+
+// Append text to the assembly buffer
+static bool x86_64_append(X86_64Data* data, const char* text, size_t length) {
+    if (data->asm_size + length + 1 > data->asm_capacity) {
+        char* new_buffer = (char*)realloc(data->asm_buffer, data->asm_size + length + 8192);
+        if (!new_buffer) {
+            DEBUG_PRINT("ERROR: Failed to resize asm_buffer");
+            return false;
+        }
+        data->asm_buffer = new_buffer;
+        data->asm_capacity = data->asm_size + length + 8192;
+    }
+    
+    memcpy(data->asm_buffer + data->asm_size, text, length);
+    data->asm_size += length;
+    data->asm_buffer[data->asm_size] = '\0';
+    return true;
+}
+
+// Define the __braggi_builtin_<id> symbols the calls above jump to. Each
+// thunk jumps through __braggi_builtin_table, one slot per registered
+// builtin. The table is weak so a runtime linked alongside can supply
+// the real entry points; until then every slot holds a stub that
+// returns 0, and the output links on its own.
+static bool x86_64_generate_builtin_thunks(X86_64Data* data, BraggiBuiltinRegistry* builtins) {
+    bool any = false;
+    for (size_t id = 0; id < data->builtin_count; id++) {
+        if (data->builtins_called[id]) any = true;
+    }
+    
+    char line[320];
+    int length;
+    if (any) {
+        const char* text =
+            "\n.section .text\n"
+            "__braggi_builtin_unbound:\n"
+            "    xor eax, eax\n"
+            "    ret\n";
+        if (!x86_64_append(data, text, strlen(text))) return false;
+        
+        for (size_t id = 0; id < data->builtin_count; id++) {
+            if (!data->builtins_called[id]) continue;
+            const char* name = braggi_builtin_registry_name(builtins, (BraggiBuiltinId)id);
+            length = snprintf(line, sizeof(line),
+                              "__braggi_builtin_%zu:    # %s\n"
+                              "    jmp [rip + __braggi_builtin_table + %zu]\n",
+                              id, name ? name : "?", id * 8);
+            if (length < 0 || (size_t)length >= sizeof(line)) return false;
+            if (!x86_64_append(data, line, (size_t)length)) return false;
+        }
+        
+        text =
+            "\n.section .data\n"
+            ".weak __braggi_builtin_table\n"
+            ".balign 8\n"
+            "__braggi_builtin_table:\n";
+        if (!x86_64_append(data, text, strlen(text))) return false;
+        
+        for (size_t id = 0; id < data->builtin_count; id++) {
+            const char* slot = "    .quad __braggi_builtin_unbound\n";
+            if (!x86_64_append(data, slot, strlen(slot))) return false;
+        }
+    }
+    
+    // Generated code never needs an executable stack
+    const char* note = "\n.section .note.GNU-stack,\"\",@progbits\n";
+    return x86_64_append(data, note, strlen(note));
+}
+
 static void x86_64_generate_numeric_literal(X86_64Data* data, Token* token) {
     // Implementation for numeric literals
     if (!token || !token->text) return;
@@ -440,9 +617,8 @@ static void x86_64_generate_string_literal(X86_64Data* data, Token* token) {
     }
     
     // Generate a unique label for the string
-    static int string_counter = 0;
     char label[64];
-    snprintf(label, sizeof(label), "str_%d", string_counter++);
+    snprintf(label, sizeof(label), "str_%d", data->string_counter++);
     
     // Format the string definition
     char string_def[2048];
@@ -0,0 +1,489 @@
+/*
+ * Braggi - Compile Worker Pool Implementation
+ *
+ * "Keep the kettle on the hob and ye'll never wait on the water."
+ * - Connemara Grandmother
+ */
+
+#include "braggi/compile_pool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+// Sent to a worker ahead of the two strings, which follow unterminated
+typedef struct JobHeader {
+    uint32_t id;
+    uint32_t input_len;
+    uint32_t output_len;
+    int32_t optimize_level;
+} JobHeader;
+
+// Sent back when the job is done
+typedef struct JobResult {
+    uint32_t id;
+    int32_t status;
+} JobResult;
+
+typedef struct PoolWorker {
+    pid_t pid;                // 0 if not running
+    int job_fd;               // Parent writes jobs here
+    int result_fd;            // Parent reads results here
+    bool busy;
+    uint32_t job_id;          // Job in flight when busy
+} PoolWorker;
+
+typedef struct QueuedJob {
+    uint32_t id;
+    char* input;
+    char* output;
+    int optimize_level;
+} QueuedJob;
+
+struct BraggiCompilePool {
+    PoolWorker* workers;
+    size_t worker_count;
+    size_t running;           // Workers with a job in flight
+
+    QueuedJob* queue;         // Waiting for a worker, oldest at queue_head
+    size_t queue_head;
+    size_t queue_size;
+    size_t queue_capacity;
+
+    BraggiCompileFn compile;
+    void* user_data;
+
+    BraggiWorkerForkFn fork_hook;  // Run in each new worker, can be NULL
+    void* fork_hook_data;
+    bool respawn;                  // Replace a dead worker as soon as it's seen
+};
+
+// Read exactly size bytes. False on EOF or error.
+static bool read_full(int fd, void* buffer, size_t size) {
+    char* p = buffer;
+    while (size > 0) {
+        ssize_t n = read(fd, p, size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        size -= (size_t)n;
+    }
+    return true;
+}
+
+static bool write_full(int fd, const void* buffer, size_t size) {
+    const char* p = buffer;
+    while (size > 0) {
+        ssize_t n = write(fd, p, size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        size -= (size_t)n;
+    }
+    return true;
+}
+
+static char* read_string(int fd, uint32_t length) {
+    char* s = malloc((size_t)length + 1);
+    if (!s) {
+        return NULL;
+    }
+    if (!read_full(fd, s, length)) {
+        free(s);
+        return NULL;
+    }
+    s[length] = '\0';
+    return s;
+}
+
+// Body of a worker process. Never returns.
+static void worker_main(int job_fd, int result_fd, BraggiCompileFn compile, void* user_data) {
+    // The parent decides when we stop, by closing the job pipe
+    signal(SIGINT, SIG_IGN);
+    signal(SIGTERM, SIG_IGN);
+
+    JobHeader header;
+    while (read_full(job_fd, &header, sizeof(header))) {
+        char* input = read_string(job_fd, header.input_len);
+        char* output = input ? read_string(job_fd, header.output_len) : NULL;
+        if (!input || !output) {
+            free(input);
+            break;
+        }
+
+        BraggiCompileJob job = {header.id, input, output, header.optimize_level};
+        JobResult result = {header.id, compile(&job, user_data)};
+
+        free(input);
+        free(output);
+
+        // Get this job's output out before the parent hears it's done
+        fflush(stdout);
+        fflush(stderr);
+        if (!write_full(result_fd, &result, sizeof(result))) {
+            break;
+        }
+    }
+
+    fflush(stdout);
+    fflush(stderr);
+    _exit(0);
+}
+
+// Fork the worker in slot index. Its old fds must already be closed.
+static bool spawn_worker(BraggiCompilePool* pool, size_t index) {
+    int job_pipe[2];
+    int result_pipe[2];
+
+    if (pipe(job_pipe) != 0) {
+        fprintf(stderr, "ERROR: Failed to create job pipe for compile worker: %s\n", strerror(errno));
+        return false;
+    }
+    if (pipe(result_pipe) != 0) {
+        fprintf(stderr, "ERROR: Failed to create result pipe for compile worker: %s\n", strerror(errno));
+        close(job_pipe[0]);
+        close(job_pipe[1]);
+        return false;
+    }
+
+    // Anything still buffered would otherwise be printed by both processes
+    fflush(stdout);
+    fflush(stderr);
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        fprintf(stderr, "ERROR: Failed to fork compile worker: %s\n", strerror(errno));
+        close(job_pipe[0]);
+        close(job_pipe[1]);
+        close(result_pipe[0]);
+        close(result_pipe[1]);
+        return false;
+    }
+
+    if (pid == 0) {
+        // Holding another worker's job pipe open would keep it from ever
+        // seeing EOF, so drop every parent-side fd this process inherited
+        for (size_t i = 0; i < pool->worker_count; i++) {
+            if (pool->workers[i].pid > 0) {
+                close(pool->workers[i].job_fd);
+                close(pool->workers[i].result_fd);
+            }
+        }
+        close(job_pipe[1]);
+        close(result_pipe[0]);
+        if (pool->fork_hook) {
+            pool->fork_hook(pool->fork_hook_data);
+        }
+        worker_main(job_pipe[0], result_pipe[1], pool->compile, pool->user_data);
+    }
+
+    close(job_pipe[0]);
+    close(result_pipe[1]);
+
+    PoolWorker* worker = &pool->workers[index];
+    worker->pid = pid;
+    worker->job_fd = job_pipe[1];
+    worker->result_fd = result_pipe[0];
+    worker->busy = false;
+    worker->job_id = 0;
+    return true;
+}
+
+// Close a worker's pipes and reap it
+static void retire_worker(PoolWorker* worker) {
+    if (worker->pid <= 0) {
+        return;
+    }
+
+    close(worker->job_fd);
+    close(worker->result_fd);
+
+    int status;
+    while (waitpid(worker->pid, &status, 0) < 0 && errno == EINTR) {
+    }
+
+    worker->pid = 0;
+    worker->job_fd = -1;
+    worker->result_fd = -1;
+    worker->busy = false;
+}
+
+// Write a job to a worker with SIGPIPE blocked on this thread, so a
+// dead worker makes the write fail with EPIPE instead of ending the
+// process. A SIGPIPE the write raises is taken back off the pending
+// set unless one was already pending before; the caller's signal
+// disposition is never touched.
+static bool send_job(PoolWorker* worker, const QueuedJob* job) {
+    JobHeader header = {
+        job->id,
+        (uint32_t)strlen(job->input),
+        (uint32_t)strlen(job->output),
+        job->optimize_level
+    };
+
+    sigset_t pipe_set, old_mask, pending;
+    sigemptyset(&pipe_set);
+    sigaddset(&pipe_set, SIGPIPE);
+    sigpending(&pending);
+    bool already_pending = sigismember(&pending, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &pipe_set, &old_mask);
+
+    bool sent = write_full(worker->job_fd, &header, sizeof(header)) &&
+                write_full(worker->job_fd, job->input, header.input_len) &&
+                write_full(worker->job_fd, job->output, header.output_len);
+
+    if (!sent && errno == EPIPE && !already_pending) {
+        const struct timespec now = {0, 0};
+        while (sigtimedwait(&pipe_set, NULL, &now) < 0 && errno == EINTR) {
+        }
+    }
+    pthread_sigmask(SIG_SETMASK, &old_mask, NULL);
+
+    if (!sent) {
+        return false;
+    }
+
+    worker->busy = true;
+    worker->job_id = job->id;
+    return true;
+}
+
+// Hand queued jobs to idle workers. A worker that can't take its job
+// is replaced and the job offered to the replacement.
+static void dispatch(BraggiCompilePool* pool) {
+    for (size_t i = 0; i < pool->worker_count && pool->queue_size > 0; i++) {
+        PoolWorker* worker = &pool->workers[i];
+        if (worker->busy) {
+            continue;
+        }
+        if (worker->pid <= 0 && !spawn_worker(pool, i)) {
+            continue;
+        }
+
+        QueuedJob* job = &pool->queue[pool->queue_head];
+        if (!send_job(worker, job)) {
+            fprintf(stderr, "WARNING: Compile worker %d went away, starting another\n", (int)worker->pid);
+            retire_worker(worker);
+            if (!spawn_worker(pool, i) || !send_job(worker, job)) {
+                continue;
+            }
+        }
+
+        free(job->input);
+        free(job->output);
+        pool->queue_head++;
+        pool->queue_size--;
+        pool->running++;
+    }
+
+    if (pool->queue_size == 0) {
+        pool->queue_head = 0;
+    }
+}
+
+BraggiCompilePool* braggi_compile_pool_create(size_t workers, BraggiCompileFn compile, void* user_data) {
+    if (workers == 0 || !compile) {
+        return NULL;
+    }
+
+    BraggiCompilePool* pool = calloc(1, sizeof(BraggiCompilePool));
+    if (!pool) {
+        return NULL;
+    }
+
+    pool->workers = calloc(workers, sizeof(PoolWorker));
+    if (!pool->workers) {
+        free(pool);
+        return NULL;
+    }
+    pool->worker_count = workers;
+    pool->compile = compile;
+    pool->user_data = user_data;
+    pool->respawn = true;
+
+    size_t started = 0;
+    for (size_t i = 0; i < workers; i++) {
+        pool->workers[i].job_fd = -1;
+        pool->workers[i].result_fd = -1;
+        if (spawn_worker(pool, i)) {
+            started++;
+        }
+    }
+
+    if (started == 0) {
+        free(pool->workers);
+        free(pool);
+        return NULL;
+    }
+
+    return pool;
+}
+
+void braggi_compile_pool_destroy(BraggiCompilePool* pool) {
+    if (!pool) {
+        return;
+    }
+
+    // Closing the job pipe is the signal to stop
+    for (size_t i = 0; i < pool->worker_count; i++) {
+        retire_worker(&pool->workers[i]);
+    }
+
+    for (size_t i = 0; i < pool->queue_size; i++) {
+        free(pool->queue[pool->queue_head + i].input);
+        free(pool->queue[pool->queue_head + i].output);
+    }
+
+    free(pool->queue);
+    free(pool->workers);
+    free(pool);
+}
+
+void braggi_compile_pool_set_fork_hook(BraggiCompilePool* pool, BraggiWorkerForkFn hook, void* user_data) {
+    if (!pool) {
+        return;
+    }
+    pool->fork_hook = hook;
+    pool->fork_hook_data = user_data;
+}
+
+void braggi_compile_pool_set_respawn(BraggiCompilePool* pool, bool respawn) {
+    if (pool) {
+        pool->respawn = respawn;
+    }
+}
+
+bool braggi_compile_pool_submit(BraggiCompilePool* pool, const BraggiCompileJob* job) {
+    if (!pool || !job || !job->input || !job->output) {
+        return false;
+    }
+
+    // Slide the live part of the queue down before growing it
+    if (pool->queue_head + pool->queue_size == pool->queue_capacity && pool->queue_head > 0) {
+        memmove(pool->queue, pool->queue + pool->queue_head, pool->queue_size * sizeof(QueuedJob));
+        pool->queue_head = 0;
+    }
+    if (pool->queue_size == pool->queue_capacity) {
+        size_t capacity = pool->queue_capacity ? pool->queue_capacity * 2 : 16;
+        QueuedJob* queue = realloc(pool->queue, capacity * sizeof(QueuedJob));
+        if (!queue) {
+            return false;
+        }
+        pool->queue = queue;
+        pool->queue_capacity = capacity;
+    }
+
+    QueuedJob queued = {job->id, strdup(job->input), strdup(job->output), job->optimize_level};
+    if (!queued.input || !queued.output) {
+        free(queued.input);
+        free(queued.output);
+        return false;
+    }
+
+    pool->queue[pool->queue_head + pool->queue_size++] = queued;
+    dispatch(pool);
+    return true;
+}
+
+bool braggi_compile_pool_wait(BraggiCompilePool* pool, uint32_t* id, int* status) {
+    return braggi_compile_pool_wait_timeout(pool, id, status, -1);
+}
+
+bool braggi_compile_pool_wait_timeout(BraggiCompilePool* pool, uint32_t* id, int* status, int timeout_ms) {
+    if (!pool) {
+        return false;
+    }
+
+    struct pollfd fds[pool->worker_count];
+    size_t slots[pool->worker_count];
+
+    while (pool->running > 0) {
+        nfds_t count = 0;
+        for (size_t i = 0; i < pool->worker_count; i++) {
+            if (pool->workers[i].busy) {
+                fds[count].fd = pool->workers[i].result_fd;
+                fds[count].events = POLLIN;
+                fds[count].revents = 0;
+                slots[count++] = i;
+            }
+        }
+
+        int ready = poll(fds, count, timeout_ms);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            fprintf(stderr, "ERROR: Failed to wait for compile workers: %s\n", strerror(errno));
+            return false;
+        }
+        if (ready == 0) {
+            return false;
+        }
+
+        for (nfds_t k = 0; k < count; k++) {
+            if (!fds[k].revents) {
+                continue;
+            }
+
+            PoolWorker* worker = &pool->workers[slots[k]];
+            JobResult result;
+
+            if (read_full(worker->result_fd, &result, sizeof(result))) {
+                worker->busy = false;
+                if (id) *id = result.id;
+                if (status) *status = result.status;
+            } else {
+                // The worker died mid-job; a replacement takes its slot
+                fprintf(stderr, "WARNING: Compile worker %d died during job %u\n",
+                        (int)worker->pid, worker->job_id);
+                if (id) *id = worker->job_id;
+                if (status) *status = BRAGGI_COMPILE_POOL_CRASHED;
+                retire_worker(worker);
+                if (pool->respawn) {
+                    spawn_worker(pool, slots[k]);
+                }
+            }
+
+            pool->running--;
+            dispatch(pool);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+size_t braggi_compile_pool_poll_fds(const BraggiCompilePool* pool, struct pollfd* fds, size_t max) {
+    size_t count = 0;
+    for (size_t i = 0; pool && i < pool->worker_count && count < max; i++) {
+        if (pool->workers[i].busy) {
+            fds[count].fd = pool->workers[i].result_fd;
+            fds[count].events = POLLIN;
+            fds[count].revents = 0;
+            count++;
+        }
+    }
+    return count;
+}
+
+size_t braggi_compile_pool_pending(const BraggiCompilePool* pool) {
+    return pool ? pool->running + pool->queue_size : 0;
+}
+
+size_t braggi_compile_pool_workers(const BraggiCompilePool* pool) {
+    return pool ? pool->worker_count : 0;
+}
@@ -0,0 +1,717 @@
+/*
+ * Braggi - Compile Server Implementation
+ *
+ * "The door's never locked and the pot's never cold - come in and
+ * say what ye're after." - Doolin Innkeeper
+ */
+
+#include "braggi/compile_server.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+// Longest request line, tabs and paths included
+#define SERVER_LINE_MAX (2 * PATH_MAX + 64)
+
+// Connections the kernel holds before they're accepted
+#define SERVER_BACKLOG 64
+
+// A finished compile, and the files as they were when it finished
+typedef struct CacheEntry {
+    char* input;
+    char* output;
+    int optimize_level;
+    struct timespec input_mtime;
+    off_t input_size;
+    ino_t input_ino;
+    struct timespec output_mtime;
+    off_t output_size;
+} CacheEntry;
+
+typedef struct ServerClient {
+    int fd;                   // -1 once the connection is closed
+    char buffer[SERVER_LINE_MAX];
+    size_t length;
+    bool waiting;             // Has a job running; its reply comes first
+    bool shared;              // The job is another client's; only it caches
+    uint32_t job_id;
+    CacheEntry pending;       // Cached if the job succeeds; empty when shared
+} ServerClient;
+
+typedef struct CompileServer {
+    int listen_fd;
+    BraggiCompilePool* pool;
+    bool stopping;            // No new requests; finish running jobs
+
+    ServerClient** clients;
+    size_t client_count;
+    size_t client_capacity;
+
+    CacheEntry* cache;
+    size_t cache_count;
+    size_t cache_capacity;
+
+    uint32_t next_job_id;
+    size_t compiled;
+    size_t cached;
+    size_t failed;
+} CompileServer;
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void request_stop(int sig) {
+    (void)sig;
+    stop_requested = 1;
+}
+
+// Run in each worker the pool forks while we serve: it has no use for
+// the listener or the clients, and holding them would keep sockets open
+// after we close them
+static void close_server_fds(void* user_data) {
+    CompileServer* server = user_data;
+    close(server->listen_fd);
+    for (size_t i = 0; i < server->client_count; i++) {
+        if (server->clients[i]->fd >= 0) {
+            close(server->clients[i]->fd);
+        }
+    }
+}
+
+static bool send_all(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        size -= (size_t)n;
+    }
+    return true;
+}
+
+static void reply(ServerClient* client, const char* text) {
+    if (client->fd < 0) {
+        return;
+    }
+    char line[256];
+    int length = snprintf(line, sizeof(line), "%s\n", text);
+    if (length > 0 && (size_t)length < sizeof(line)) {
+        send_all(client->fd, line, (size_t)length);
+    }
+}
+
+static bool same_time(struct timespec a, struct timespec b) {
+    return a.tv_sec == b.tv_sec && a.tv_nsec == b.tv_nsec;
+}
+
+static void free_entry(CacheEntry* entry) {
+    free(entry->input);
+    free(entry->output);
+    entry->input = NULL;
+    entry->output = NULL;
+}
+
+static CacheEntry* cache_find(CompileServer* server, const char* input, const char* output, int optimize_level) {
+    for (size_t i = 0; i < server->cache_count; i++) {
+        CacheEntry* entry = &server->cache[i];
+        if (entry->optimize_level == optimize_level &&
+            strcmp(entry->input, input) == 0 && strcmp(entry->output, output) == 0) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+// True if neither file changed since the entry was made
+static bool cache_fresh(const CacheEntry* entry, const struct stat* input) {
+    struct stat output;
+    if (stat(entry->output, &output) != 0) {
+        return false;
+    }
+    return same_time(entry->input_mtime, input->st_mtim) &&
+           entry->input_size == input->st_size &&
+           entry->input_ino == input->st_ino &&
+           same_time(entry->output_mtime, output.st_mtim) &&
+           entry->output_size == output.st_size;
+}
+
+// Remember a successful compile. Takes the entry's strings.
+static void cache_store(CompileServer* server, CacheEntry* entry) {
+    struct stat output;
+    if (stat(entry->output, &output) != 0) {
+        free_entry(entry);
+        return;
+    }
+    entry->output_mtime = output.st_mtim;
+    entry->output_size = output.st_size;
+
+    CacheEntry* existing = cache_find(server, entry->input, entry->output, entry->optimize_level);
+    if (existing) {
+        free_entry(existing);
+        *existing = *entry;
+    } else {
+        if (server->cache_count == server->cache_capacity) {
+            size_t capacity = server->cache_capacity ? server->cache_capacity * 2 : 64;
+            CacheEntry* cache = realloc(server->cache, capacity * sizeof(CacheEntry));
+            if (!cache) {
+                free_entry(entry);
+                return;
+            }
+            server->cache = cache;
+            server->cache_capacity = capacity;
+        }
+        server->cache[server->cache_count++] = *entry;
+    }
+
+    // The cache owns the strings now
+    entry->input = NULL;
+    entry->output = NULL;
+}
+
+static void cache_forget(CompileServer* server, const CacheEntry* entry) {
+    CacheEntry* existing = cache_find(server, entry->input, entry->output, entry->optimize_level);
+    if (existing) {
+        free_entry(existing);
+        *existing = server->cache[--server->cache_count];
+    }
+}
+
+// The client whose running job writes output, if any
+static ServerClient* find_running(CompileServer* server, const char* output) {
+    for (size_t i = 0; i < server->client_count; i++) {
+        ServerClient* client = server->clients[i];
+        if (client->waiting && !client->shared && strcmp(client->pending.output, output) == 0) {
+            return client;
+        }
+    }
+    return NULL;
+}
+
+// Answer from the cache, wait on the same compile already running, or
+// hand the job to the pool
+static void handle_compile(CompileServer* server, ServerClient* client,
+                           const char* optimize, const char* input, const char* output) {
+    char* end = NULL;
+    long level = strtol(optimize, &end, 10);
+    if (*optimize == '\0' || *end != '\0' || level < 0 || level > 9) {
+        reply(client, "error bad optimization level");
+        return;
+    }
+    if (input[0] != '/' || output[0] != '/') {
+        reply(client, "error paths must be absolute");
+        return;
+    }
+
+    struct stat input_stat;
+    if (stat(input, &input_stat) != 0) {
+        reply(client, "error can't read input");
+        return;
+    }
+
+    // Two jobs must never write one output at once, and the cache can't
+    // vouch for an output that's being written. The same compile of the
+    // same source shares the running job's reply; anything else aimed at
+    // that output is turned away until it's done.
+    ServerClient* running = find_running(server, output);
+    if (running) {
+        const CacheEntry* job = &running->pending;
+        if (job->optimize_level == (int)level && strcmp(job->input, input) == 0 &&
+            same_time(job->input_mtime, input_stat.st_mtim) &&
+            job->input_size == input_stat.st_size && job->input_ino == input_stat.st_ino) {
+            client->job_id = running->job_id;
+            client->shared = true;
+            client->waiting = true;
+        } else {
+            reply(client, "error busy");
+        }
+        return;
+    }
+
+    CacheEntry* entry = cache_find(server, input, output, (int)level);
+    if (entry && cache_fresh(entry, &input_stat)) {
+        server->cached++;
+        reply(client, "ok cached");
+        return;
+    }
+
+    CacheEntry pending = {
+        .input = strdup(input),
+        .output = strdup(output),
+        .optimize_level = (int)level,
+        .input_mtime = input_stat.st_mtim,
+        .input_size = input_stat.st_size,
+        .input_ino = input_stat.st_ino
+    };
+    BraggiCompileJob job = {server->next_job_id++, input, output, (int)level};
+
+    if (!pending.input || !pending.output || !braggi_compile_pool_submit(server->pool, &job)) {
+        free_entry(&pending);
+        reply(client, "error out of memory");
+        return;
+    }
+
+    client->pending = pending;
+    client->job_id = job.id;
+    client->waiting = true;
+}
+
+static void handle_line(CompileServer* server, ServerClient* client, char* line) {
+    char* fields[4] = {line, NULL, NULL, NULL};
+    size_t count = 1;
+    for (char* p = line; *p && count < 4; p++) {
+        if (*p == '\t') {
+            *p = '\0';
+            fields[count++] = p + 1;
+        }
+    }
+
+    if (strcmp(fields[0], "compile") == 0 && count == 4 && !strchr(fields[3], '\t')) {
+        handle_compile(server, client, fields[1], fields[2], fields[3]);
+    } else if (strcmp(fields[0], "shutdown") == 0 && count == 1) {
+        server->stopping = true;
+        reply(client, "ok shutdown");
+    } else {
+        reply(client, "error unknown request");
+    }
+}
+
+// Handle complete lines until one starts a job
+static void process_buffer(CompileServer* server, ServerClient* client) {
+    while (client->fd >= 0 && !client->waiting && !server->stopping) {
+        char* newline = memchr(client->buffer, '\n', client->length);
+        if (!newline) {
+            return;
+        }
+
+        *newline = '\0';
+        if (newline > client->buffer && newline[-1] == '\r') {
+            newline[-1] = '\0';
+        }
+        handle_line(server, client, client->buffer);
+
+        size_t used = (size_t)(newline - client->buffer) + 1;
+        memmove(client->buffer, client->buffer + used, client->length - used);
+        client->length -= used;
+    }
+}
+
+static void close_client(ServerClient* client) {
+    if (client->fd >= 0) {
+        close(client->fd);
+        client->fd = -1;
+    }
+}
+
+static void read_client(CompileServer* server, ServerClient* client) {
+    ssize_t n = recv(client->fd, client->buffer + client->length,
+                     sizeof(client->buffer) - client->length, 0);
+    if (n < 0 && errno == EINTR) {
+        return;
+    }
+    if (n <= 0) {
+        close_client(client);
+        return;
+    }
+
+    client->length += (size_t)n;
+    process_buffer(server, client);
+
+    if (client->length == sizeof(client->buffer)) {
+        reply(client, "error request too long");
+        close_client(client);
+    }
+}
+
+static void accept_client(CompileServer* server) {
+    int fd = accept(server->listen_fd, NULL, NULL);
+    if (fd < 0) {
+        if (errno != EINTR && errno != EAGAIN && errno != ECONNABORTED) {
+            fprintf(stderr, "WARNING: Compile server failed to accept a connection: %s\n", strerror(errno));
+        }
+        return;
+    }
+
+    if (server->client_count == server->client_capacity) {
+        size_t capacity = server->client_capacity ? server->client_capacity * 2 : 16;
+        ServerClient** clients = realloc(server->clients, capacity * sizeof(ServerClient*));
+        if (!clients) {
+            close(fd);
+            return;
+        }
+        server->clients = clients;
+        server->client_capacity = capacity;
+    }
+
+    ServerClient* client = calloc(1, sizeof(ServerClient));
+    if (!client) {
+        close(fd);
+        return;
+    }
+    client->fd = fd;
+    server->clients[server->client_count++] = client;
+}
+
+// Reply to the client that started the job and every client sharing it
+static void finish_job(CompileServer* server, uint32_t id, int status) {
+    char text[64];
+    if (status == 0) {
+        snprintf(text, sizeof(text), "ok compiled");
+    } else {
+        snprintf(text, sizeof(text), "failed %d", status);
+    }
+
+    for (size_t i = 0; i < server->client_count; i++) {
+        ServerClient* client = server->clients[i];
+        if (!client->waiting || client->job_id != id) {
+            continue;
+        }
+
+        client->waiting = false;
+        if (client->shared) {
+            client->shared = false;
+        } else if (status == 0) {
+            server->compiled++;
+            cache_store(server, &client->pending);
+        } else {
+            server->failed++;
+            cache_forget(server, &client->pending);
+            free_entry(&client->pending);
+        }
+        reply(client, text);
+
+        // The client may have sent its next request already
+        process_buffer(server, client);
+    }
+}
+
+// Free clients that have hung up and have nothing running
+static void sweep_clients(CompileServer* server) {
+    size_t kept = 0;
+    for (size_t i = 0; i < server->client_count; i++) {
+        ServerClient* client = server->clients[i];
+        if (client->fd < 0 && !client->waiting) {
+            free(client);
+        } else {
+            server->clients[kept++] = client;
+        }
+    }
+    server->client_count = kept;
+}
+
+static bool fill_address(struct sockaddr_un* address, const char* socket_path) {
+    memset(address, 0, sizeof(*address));
+    address->sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(address->sun_path)) {
+        fprintf(stderr, "ERROR: Socket path is too long: %s\n", socket_path);
+        return false;
+    }
+    strcpy(address->sun_path, socket_path);
+    return true;
+}
+
+static int connect_to(const char* socket_path) {
+    struct sockaddr_un address;
+    if (!fill_address(&address, socket_path)) {
+        return -1;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    if (connect(fd, (struct sockaddr*)&address, sizeof(address)) != 0) {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return -1;
+    }
+    return fd;
+}
+
+static int open_listener(const char* socket_path) {
+    struct sockaddr_un address;
+    if (!fill_address(&address, socket_path)) {
+        return -1;
+    }
+
+    // Replace a socket left behind by a server that's gone, but never a
+    // live server or a file that isn't a socket
+    struct stat existing;
+    if (lstat(socket_path, &existing) == 0) {
+        if (!S_ISSOCK(existing.st_mode)) {
+            fprintf(stderr, "ERROR: %s exists and is not a socket\n", socket_path);
+            return -1;
+        }
+        int live = connect_to(socket_path);
+        if (live >= 0) {
+            close(live);
+            fprintf(stderr, "ERROR: A compile server is already listening on %s\n", socket_path);
+            return -1;
+        }
+        unlink(socket_path);
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        fprintf(stderr, "ERROR: Failed to create server socket: %s\n", strerror(errno));
+        return -1;
+    }
+    if (bind(fd, (struct sockaddr*)&address, sizeof(address)) != 0 ||
+        listen(fd, SERVER_BACKLOG) != 0) {
+        fprintf(stderr, "ERROR: Failed to listen on %s: %s\n", socket_path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int braggi_compile_server_run(const char* socket_path, BraggiCompilePool* pool) {
+    if (!socket_path || !pool) {
+        return 1;
+    }
+
+    CompileServer server;
+    memset(&server, 0, sizeof(server));
+    server.pool = pool;
+    server.listen_fd = open_listener(socket_path);
+    if (server.listen_fd < 0) {
+        return 1;
+    }
+
+    // No SA_RESTART: the signal has to break the server out of poll
+    struct sigaction stop_action, old_int, old_term;
+    memset(&stop_action, 0, sizeof(stop_action));
+    stop_action.sa_handler = request_stop;
+    sigemptyset(&stop_action.sa_mask);
+    stop_requested = 0;
+    sigaction(SIGINT, &stop_action, &old_int);
+    sigaction(SIGTERM, &stop_action, &old_term);
+    braggi_compile_pool_set_fork_hook(pool, close_server_fds, &server);
+
+    size_t workers = braggi_compile_pool_workers(pool);
+    fprintf(stderr, "Compile server listening on %s with %zu workers\n", socket_path, workers);
+
+    while (true) {
+        if (stop_requested) {
+            server.stopping = true;
+        }
+        if (server.stopping) {
+            // A worker lost now needn't be replaced just to be stopped
+            braggi_compile_pool_set_respawn(pool, false);
+        }
+        if (server.stopping && braggi_compile_pool_pending(pool) == 0) {
+            break;
+        }
+
+        size_t capacity = 1 + server.client_count + workers;
+        struct pollfd* fds = malloc(capacity * sizeof(struct pollfd));
+        ServerClient** polled = malloc(capacity * sizeof(ServerClient*));
+        if (!fds || !polled) {
+            free(fds);
+            free(polled);
+            fprintf(stderr, "ERROR: Compile server is out of memory\n");
+            server.stopping = true;
+
+            // Without a poll set, block on the pool to finish what's running
+            uint32_t id;
+            int status;
+            if (braggi_compile_pool_wait(pool, &id, &status)) {
+                finish_job(&server, id, status);
+            }
+            continue;
+        }
+
+        nfds_t count = 0;
+        if (!server.stopping) {
+            fds[count].fd = server.listen_fd;
+            fds[count].events = POLLIN;
+            fds[count].revents = 0;
+            polled[count++] = NULL;
+
+            for (size_t i = 0; i < server.client_count; i++) {
+                ServerClient* client = server.clients[i];
+                if (client->fd >= 0 && !client->waiting) {
+                    fds[count].fd = client->fd;
+                    fds[count].events = POLLIN;
+                    fds[count].revents = 0;
+                    polled[count++] = client;
+                }
+            }
+        }
+        nfds_t client_end = count;
+        count += braggi_compile_pool_poll_fds(pool, fds + count, workers);
+
+        int ready = poll(fds, count, -1);
+        if (ready < 0) {
+            free(fds);
+            free(polled);
+            if (errno != EINTR) {
+                fprintf(stderr, "ERROR: Compile server poll failed: %s\n", strerror(errno));
+                server.stopping = true;
+            }
+            continue;
+        }
+
+        bool job_done = false;
+        for (nfds_t k = 0; k < count; k++) {
+            if (!fds[k].revents) {
+                continue;
+            }
+            if (k >= client_end) {
+                job_done = true;
+            } else if (polled[k]) {
+                read_client(&server, polled[k]);
+            } else {
+                accept_client(&server);
+            }
+        }
+        free(fds);
+        free(polled);
+
+        uint32_t id;
+        int status;
+        while (job_done && braggi_compile_pool_wait_timeout(pool, &id, &status, 0)) {
+            finish_job(&server, id, status);
+        }
+
+        sweep_clients(&server);
+    }
+
+    fprintf(stderr, "Compile server on %s shutting down: %zu compiled, %zu cached, %zu failed\n",
+            socket_path, server.compiled, server.cached, server.failed);
+
+    sigaction(SIGINT, &old_int, NULL);
+    sigaction(SIGTERM, &old_term, NULL);
+    braggi_compile_pool_set_fork_hook(pool, NULL, NULL);
+    braggi_compile_pool_set_respawn(pool, true);
+
+    close(server.listen_fd);
+    unlink(socket_path);
+
+    for (size_t i = 0; i < server.client_count; i++) {
+        close_client(server.clients[i]);
+        free_entry(&server.clients[i]->pending);
+        free(server.clients[i]);
+    }
+    free(server.clients);
+
+    for (size_t i = 0; i < server.cache_count; i++) {
+        free_entry(&server.cache[i]);
+    }
+    free(server.cache);
+
+    return 0;
+}
+
+// Send one request line and read back one reply line
+static bool exchange(const char* socket_path, const char* request, char* response, size_t size) {
+    int fd = connect_to(socket_path);
+    if (fd < 0) {
+        snprintf(response, size, "can't connect to %s: %s", socket_path, strerror(errno));
+        return false;
+    }
+
+    if (!send_all(fd, request, strlen(request))) {
+        snprintf(response, size, "lost connection to %s", socket_path);
+        close(fd);
+        return false;
+    }
+
+    size_t length = 0;
+    while (length + 1 < size) {
+        ssize_t n = recv(fd, response + length, size - length - 1, 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        length += (size_t)n;
+        if (memchr(response, '\n', length)) {
+            break;
+        }
+    }
+    close(fd);
+
+    response[length] = '\0';
+    char* newline = strchr(response, '\n');
+    if (!newline) {
+        snprintf(response, size, "no reply from %s", socket_path);
+        return false;
+    }
+    *newline = '\0';
+    return true;
+}
+
+// Make a path absolute against this process's working directory
+static bool absolute_path(const char* path, char* buffer, size_t size) {
+    if (path[0] == '/') {
+        return (size_t)snprintf(buffer, size, "%s", path) < size;
+    }
+
+    char cwd[PATH_MAX];
+    if (!getcwd(cwd, sizeof(cwd))) {
+        return false;
+    }
+    return (size_t)snprintf(buffer, size, "%s/%s", cwd, path) < size;
+}
+
+BraggiServerReply braggi_compile_server_request(const char* socket_path, const BraggiCompileJob* job,
+                                                char* message, size_t message_size) {
+    char input[PATH_MAX];
+    char output[PATH_MAX];
+    char response[512];
+
+    if (!socket_path || !job || !job->input || !job->output) {
+        snprintf(response, sizeof(response), "bad request");
+    } else if (!realpath(job->input, input)) {
+        snprintf(response, sizeof(response), "can't find %s", job->input);
+    } else if (!absolute_path(job->output, output, sizeof(output)) ||
+               strchr(input, '\t') || strchr(input, '\n') ||
+               strchr(output, '\t') || strchr(output, '\n')) {
+        snprintf(response, sizeof(response), "can't send output path %s", job->output);
+    } else {
+        char request[SERVER_LINE_MAX];
+        snprintf(request, sizeof(request), "compile\t%d\t%s\t%s\n", job->optimize_level, input, output);
+
+        if (exchange(socket_path, request, response, sizeof(response))) {
+            if (strcmp(response, "ok compiled") == 0) {
+                return BRAGGI_SERVER_COMPILED;
+            }
+            if (strcmp(response, "ok cached") == 0) {
+                return BRAGGI_SERVER_CACHED;
+            }
+            if (strncmp(response, "failed ", 7) == 0) {
+                if (message && message_size > 0) {
+                    snprintf(message, message_size, "%s", response + 7);
+                }
+                return BRAGGI_SERVER_FAILED;
+            }
+            if (strncmp(response, "error ", 6) == 0) {
+                memmove(response, response + 6, strlen(response + 6) + 1);
+            }
+        }
+    }
+
+    if (message && message_size > 0) {
+        snprintf(message, message_size, "%s", response);
+    }
+    return BRAGGI_SERVER_ERROR;
+}
+
+bool braggi_compile_server_shutdown(const char* socket_path) {
+    char response[512];
+    return socket_path && exchange(socket_path, "shutdown\n", response, sizeof(response)) &&
+           strcmp(response, "ok shutdown") == 0;
+}
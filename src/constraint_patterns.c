@@ -23,6 +23,7 @@ static Periscope* g_periscope = NULL;
 
 // Forward declarations for all functions
 static uint32_t braggi_entropy_field_get_cell_id_for_token(EntropyField* field, Token* token);
+static uint32_t pattern_cell_id(EntropyField* field, Vector* tokens, size_t index, Token* token);
 static bool variable_pattern_impl(EntropyField* field, Vector* tokens, void* data);
 static bool function_pattern_impl(EntropyField* field, Vector* tokens, void* data);
 static bool type_pattern_impl(EntropyField* field, Vector* tokens, void* data);
@@ -338,10 +339,10 @@ static bool is_valid_token_pointer(Token* token) {
     }
     
     // Check if position fields look reasonable
-    if (token->position.line < 0 || token->position.line > 100000 ||
-        token->position.column < 0 || token->position.column > 10000) {
+    SourcePosition position = braggi_token_get_position(token);
+    if (position.line > 100000 || position.column > 10000) {
         fprintf(stderr, "WARNING: Token has suspicious position (line %d, column %d) at address 0x%lx\n", 
-                token->position.line, token->position.column, token_addr);
+                position.line, position.column, token_addr);
         return false;
     }
     
@@ -460,34 +461,12 @@ bool adjacency_pattern(EntropyField* field, Vector* tokens, void* data) {
             continue;
         }
         
-        // Get cell IDs safely - first try periscope if available
-        uint32_t current_id = 0;
-        uint32_t next_id = 0;
-        
-        // Get the global periscope if available
-        extern Periscope* braggi_constraint_patterns_get_periscope(void);
-        Periscope* periscope = braggi_constraint_patterns_get_periscope();
-        
-        if (periscope) {
-            fprintf(stderr, "DEBUG: Using periscope to get cell IDs\n");
-            current_id = braggi_periscope_get_cell_id_for_token(periscope, current, field);
-            next_id = braggi_periscope_get_cell_id_for_token(periscope, next, field);
-        } else {
-            // Fallback to direct field lookup
-            fprintf(stderr, "DEBUG: No periscope available, using fallback method\n");
-            current_id = braggi_entropy_field_get_cell_id_for_token(field, current);
-            next_id = braggi_entropy_field_get_cell_id_for_token(field, next);
-        }
+        // Get cell IDs from the field's token map
+        uint32_t current_id = pattern_cell_id(field, tokens, i, current);
+        uint32_t next_id = pattern_cell_id(field, tokens, i + 1, next);
         
         fprintf(stderr, "DEBUG: Got cell IDs: current_id=%u, next_id=%u\n", current_id, next_id);
         
-        // Normalize cell IDs to make sure they're within bounds
-        current_id = braggi_normalize_field_cell_id(field, current_id);
-        next_id = braggi_normalize_field_cell_id(field, next_id);
-        
-        fprintf(stderr, "DEBUG: Normalized cell IDs: current_id=%u, next_id=%u\n", 
-                current_id, next_id);
-        
         // Add cells to the constraint
         braggi_constraint_add_cell(constraint, current_id);
         braggi_constraint_add_cell(constraint, next_id);
@@ -605,39 +584,14 @@ bool sequence_pattern(EntropyField* field, Vector* tokens, void* data) {
             continue;
         }
         
-        // Get cell IDs safely - first try periscope if available
-        uint32_t first_id = 0;
-        uint32_t second_id = 0;
-        uint32_t third_id = 0;
-        
-        // Get the global periscope if available
-        extern Periscope* braggi_constraint_patterns_get_periscope(void);
-        Periscope* periscope = braggi_constraint_patterns_get_periscope();
-        
-        if (periscope) {
-            fprintf(stderr, "DEBUG: Using periscope to get cell IDs\n");
-            first_id = braggi_periscope_get_cell_id_for_token(periscope, first, field);
-            second_id = braggi_periscope_get_cell_id_for_token(periscope, second, field);
-            third_id = braggi_periscope_get_cell_id_for_token(periscope, third, field);
-        } else {
-            // Fallback to direct field lookup
-            fprintf(stderr, "DEBUG: No periscope available, using fallback method\n");
-            first_id = braggi_entropy_field_get_cell_id_for_token(field, first);
-            second_id = braggi_entropy_field_get_cell_id_for_token(field, second);
-            third_id = braggi_entropy_field_get_cell_id_for_token(field, third);
-        }
+        // Get cell IDs from the field's token map
+        uint32_t first_id = pattern_cell_id(field, tokens, i, first);
+        uint32_t second_id = pattern_cell_id(field, tokens, i + 1, second);
+        uint32_t third_id = pattern_cell_id(field, tokens, i + 2, third);
         
         fprintf(stderr, "DEBUG: Got cell IDs: first_id=%u, second_id=%u, third_id=%u\n", 
                 first_id, second_id, third_id);
         
-        // Normalize cell IDs to make sure they're within bounds
-        first_id = braggi_normalize_field_cell_id(field, first_id);
-        second_id = braggi_normalize_field_cell_id(field, second_id);
-        third_id = braggi_normalize_field_cell_id(field, third_id);
-        
-        fprintf(stderr, "DEBUG: Normalized cell IDs: first_id=%u, second_id=%u, third_id=%u\n", 
-                first_id, second_id, third_id);
-        
         // Create sequence constraint
         EntropyConstraint* constraint = braggi_constraint_create(
             CONSTRAINT_SYNTAX,      // Sequence is a syntax constraint
@@ -807,27 +761,11 @@ bool grammar_pattern(EntropyField* field, Vector* tokens, void* data) {
                         next_token->text ? next_token->text : "(null)");
                 
                 // Check if tokens are directly adjacent in source
-                bool are_adjacent = token->position.offset + strlen(token->text) == next_token->position.offset;
+                bool are_adjacent = token->loc + strlen(token->text) == next_token->loc;
                 
                 if (are_adjacent) {
-                    // Get the global periscope if available for cell IDs
-                    extern Periscope* braggi_constraint_patterns_get_periscope(void);
-                    Periscope* periscope = braggi_constraint_patterns_get_periscope();
-                    
-                    uint32_t token_id = 0;
-                    uint32_t next_id = 0;
-                    
-                    if (periscope) {
-                        token_id = braggi_periscope_get_cell_id_for_token(periscope, token, field);
-                        next_id = braggi_periscope_get_cell_id_for_token(periscope, next_token, field);
-                    } else {
-                        token_id = braggi_entropy_field_get_cell_id_for_token(field, token);
-                        next_id = braggi_entropy_field_get_cell_id_for_token(field, next_token);
-                    }
-                    
-                    // Normalize IDs
-                    token_id = braggi_normalize_field_cell_id(field, token_id);
-                    next_id = braggi_normalize_field_cell_id(field, next_id);
+                    uint32_t token_id = pattern_cell_id(field, tokens, i, token);
+                    uint32_t next_id = pattern_cell_id(field, tokens, i + 1, next_token);
                     
                     // Create a special grammar constraint for compound operators
                     EntropyConstraint* compound_constraint = braggi_constraint_create(
@@ -857,29 +795,11 @@ bool grammar_pattern(EntropyField* field, Vector* tokens, void* data) {
             }
         }
         
-        // Get cell ID safely - first try periscope if available
-        uint32_t token_id = 0;
-        
-        // Get the global periscope if available
-        extern Periscope* braggi_constraint_patterns_get_periscope(void);
-        Periscope* periscope = braggi_constraint_patterns_get_periscope();
-        
-        if (periscope) {
-            fprintf(stderr, "DEBUG: Using periscope to get cell ID\n");
-            token_id = braggi_periscope_get_cell_id_for_token(periscope, token, field);
-        } else {
-            // Fallback to direct field lookup
-            fprintf(stderr, "DEBUG: No periscope available, using fallback method\n");
-            token_id = braggi_entropy_field_get_cell_id_for_token(field, token);
-        }
+        // Get cell ID from the field's token map
+        uint32_t token_id = pattern_cell_id(field, tokens, i, token);
         
         fprintf(stderr, "DEBUG: Got cell ID: token_id=%u\n", token_id);
         
-        // Normalize cell ID to make sure it's within bounds
-        token_id = braggi_normalize_field_cell_id(field, token_id);
-        
-        fprintf(stderr, "DEBUG: Normalized cell ID: token_id=%u\n", token_id);
-        
         // Look ahead for other tokens to relate to this one
         bool found_relation = false;
         
@@ -971,25 +891,11 @@ bool grammar_pattern(EntropyField* field, Vector* tokens, void* data) {
                 continue;
             }
             
-            // Get next token's cell ID - first try periscope if available
-            uint32_t next_id = 0;
-            
-            if (periscope) {
-                fprintf(stderr, "DEBUG: Using periscope to get cell ID for related token\n");
-                next_id = braggi_periscope_get_cell_id_for_token(periscope, next, field);
-            } else {
-                // Fallback to direct field lookup
-                fprintf(stderr, "DEBUG: No periscope available, using fallback method\n");
-                next_id = braggi_entropy_field_get_cell_id_for_token(field, next);
-            }
+            // Get next token's cell ID from the field's token map
+            uint32_t next_id = pattern_cell_id(field, tokens, j, next);
             
             fprintf(stderr, "DEBUG: Got related token cell ID: next_id=%u\n", next_id);
             
-            // Normalize cell ID to make sure it's within bounds
-            next_id = braggi_normalize_field_cell_id(field, next_id);
-            
-            fprintf(stderr, "DEBUG: Normalized related token cell ID: next_id=%u\n", next_id);
-            
             // Create grammar constraint between these tokens
             EntropyConstraint* constraint = braggi_constraint_create(
                 CONSTRAINT_SYNTAX,         // Grammar is a syntax constraint
@@ -1098,8 +1004,8 @@ static bool variable_pattern_impl(EntropyField* field, Vector* tokens, void* dat
             continue;
         }
         
-        // Get cell ID safely
-        uint32_t token_id = braggi_entropy_field_get_cell_id_for_token(field, token);
+        // Get cell ID from the field's token map
+        uint32_t token_id = pattern_cell_id(field, tokens, i, token);
         
         // A sophisticated implementation would identify variable declarations and usages
         // and create constraints between them. For this simplified version, we'll just
@@ -1168,8 +1074,8 @@ static bool function_pattern_impl(EntropyField* field, Vector* tokens, void* dat
             continue;
         }
         
-        // Get cell ID safely
-        uint32_t token_id = braggi_entropy_field_get_cell_id_for_token(field, token);
+        // Get cell ID from the field's token map
+        uint32_t token_id = pattern_cell_id(field, tokens, i, token);
         
         // A sophisticated implementation would identify function declarations and calls
         // and create constraints between them. For this simplified version, we'll just
@@ -1239,8 +1145,8 @@ static bool type_pattern_impl(EntropyField* field, Vector* tokens, void* data) {
             continue;
         }
         
-        // Get cell ID safely
-        uint32_t token_id = braggi_entropy_field_get_cell_id_for_token(field, token);
+        // Get cell ID from the field's token map
+        uint32_t token_id = pattern_cell_id(field, tokens, i, token);
         
         // A sophisticated implementation would identify type declarations and usages
         // and create constraints between them. For this simplified version, we'll just
@@ -1310,8 +1216,8 @@ static bool control_flow_pattern_impl(EntropyField* field, Vector* tokens, void*
             continue;
         }
         
-        // Get cell ID safely
-        uint32_t token_id = braggi_entropy_field_get_cell_id_for_token(field, token);
+        // Get cell ID from the field's token map
+        uint32_t token_id = pattern_cell_id(field, tokens, i, token);
         
         // A sophisticated implementation would identify control flow tokens (if, else, for, while, etc.)
         // and create constraints for their related blocks. For this simplified version, we'll just
@@ -1340,6 +1246,26 @@ static bool control_flow_pattern_impl(EntropyField* field, Vector* tokens, void*
     return success;
 }
 
+/*
+ * Cell ID of the token at index in tokens. Pattern functions are handed
+ * the same token vector the field was built from, so the field's token
+ * map answers directly and the ID needs no normalizing. Fields built
+ * some other way, without a map for this vector, fall back to searching.
+ */
+static uint32_t pattern_cell_id(EntropyField* field, Vector* tokens, size_t index, Token* token) {
+    if (field->token_count == braggi_vector_size(tokens)) {
+        uint32_t cell_id = braggi_entropy_field_token_cell(field, index);
+        if (cell_id != ENTROPY_NO_CELL) {
+            return cell_id;
+        }
+    }
+    
+    uint32_t cell_id = g_periscope
+        ? braggi_periscope_get_cell_id_for_token(g_periscope, token, field)
+        : braggi_entropy_field_get_cell_id_for_token(field, token);
+    return braggi_normalize_field_cell_id(field, cell_id);
+}
+
 // Function to get cell ID for a token, leveraging periscope if available
 uint32_t braggi_entropy_field_get_cell_id_for_token(EntropyField* field, Token* token) {
     if (!field || !token) {
@@ -1364,8 +1290,9 @@ uint32_t braggi_entropy_field_get_cell_id_for_token(EntropyField* field, Token*
     
     // Fallback: use the token's line number as the cell ID
     // This assumes that cells are mapped to lines in a 1:1 fashion
-    if (token->position.line > 0) {
-        uint32_t cell_id = token->position.line - 1; // Convert 1-based to 0-based
+    SourcePosition position = braggi_token_get_position(token);
+    if (position.line > 0) {
+        uint32_t cell_id = position.line - 1; // Convert 1-based to 0-based
         
         // Make sure it's within the valid range
         if (cell_id < field->cell_count) {
@@ -1562,8 +1489,10 @@ bool braggi_default_adjacency_validator(EntropyConstraint* constraint, EntropyFi
             size_t token1_length = token1->text ? strlen(token1->text) : 0;
             
             // Check position compatibility with larger tolerance for certain tokens
-            if (token1->position.offset + token1_length <= token2->position.offset) {
-                size_t gap = token2->position.offset - (token1->position.offset + token1_length);
+            // Locations in one file are offsets from a common base, so
+            // their difference is the gap in bytes
+            if (token1->loc + token1_length <= token2->loc) {
+                size_t gap = token2->loc - (token1->loc + token1_length);
                 size_t max_allowed_gap = (is_special_token1 || is_special_token2) ? 
                                         SPECIAL_MAX_GAP : NORMAL_MAX_GAP;
                 
@@ -1579,9 +1508,10 @@ bool braggi_default_adjacency_validator(EntropyConstraint* constraint, EntropyFi
         // If this state has no compatible next state, log it but be lenient
         if (!has_compatible_next) {
             // Log the issue but don't eliminate the state in all cases
+            SourcePosition position1 = braggi_token_get_position(token1);
             fprintf(stderr, "Debug: Token '%s' at position %d:%d has no compatible next token\n", 
                    token1->text ? token1->text : "(null)", 
-                   token1->position.line, token1->position.column);
+                   position1.line, position1.column);
             
             // Only eliminate if not at end of file
             // Tokens at the end of a file might legitimately have no "next" token
@@ -1594,7 +1524,7 @@ bool braggi_default_adjacency_validator(EntropyConstraint* constraint, EntropyFi
                 if (!token2) continue;
                 
                 // If any token2 has a higher line number, token1 is not the last token
-                if (token2->position.line > token1->position.line) {
+                if (braggi_token_get_position(token2).line > position1.line) {
                     is_last_token = false;
                     break;
                 }
@@ -1684,25 +1614,24 @@ bool braggi_default_sequence_validator(EntropyConstraint* constraint, EntropyFie
         }
         
         // Check if the tokens are in the correct order
-        if (first_token->position.offset >= middle_token->position.offset ||
-            middle_token->position.offset >= last_token->position.offset) {
+        if (first_token->loc >= middle_token->loc ||
+            middle_token->loc >= last_token->loc) {
+            SourcePosition first = braggi_token_get_position(first_token);
+            SourcePosition middle = braggi_token_get_position(middle_token);
+            SourcePosition last = braggi_token_get_position(last_token);
             fprintf(stderr, "Warning: Tokens are out of order in sequence constraint\n");
             fprintf(stderr, "  First token: %s at position %d:%d (offset %u)\n",
                     first_token->text ? first_token->text : "(null)",
-                    first_token->position.line, first_token->position.column,
-                    first_token->position.offset);
+                    first.line, first.column, first.offset);
             fprintf(stderr, "  Middle token: %s at position %d:%d (offset %u)\n",
                     middle_token->text ? middle_token->text : "(null)",
-                    middle_token->position.line, middle_token->position.column,
-                    middle_token->position.offset);
+                    middle.line, middle.column, middle.offset);
             fprintf(stderr, "  Last token: %s at position %d:%d (offset %u)\n",
                     last_token->text ? last_token->text : "(null)",
-                    last_token->position.line, last_token->position.column,
-                    last_token->position.offset);
+                    last.line, last.column, last.offset);
             
             // Be more lenient - only enforce line-based ordering, not absolute offset
-            if (first_token->position.line > middle_token->position.line ||
-                middle_token->position.line > last_token->position.line) {
+            if (first.line > middle.line || middle.line > last.line) {
                 // This is a serious error - lines are out of order
                 return false;
             }
@@ -1732,9 +1661,7 @@ bool braggi_default_sequence_validator(EntropyConstraint* constraint, EntropyFie
             if (!middle_token) continue;
             
             // Check if first and middle tokens are in order
-            if (first_token->position.line > middle_token->position.line) continue;
-            if (first_token->position.line == middle_token->position.line && 
-                first_token->position.offset >= middle_token->position.offset) continue;
+            if (first_token->loc >= middle_token->loc) continue;
             
             for (size_t k = 0; k < last_cell->state_count; k++) {
                 EntropyState* last_state = last_cell->states[k];
@@ -1744,9 +1671,7 @@ bool braggi_default_sequence_validator(EntropyConstraint* constraint, EntropyFie
                 if (!last_token) continue;
                 
                 // Check if middle and last tokens are in order
-                if (middle_token->position.line > last_token->position.line) continue;
-                if (middle_token->position.line == last_token->position.line && 
-                    middle_token->position.offset >= last_token->position.offset) continue;
+                if (middle_token->loc >= last_token->loc) continue;
                 
                 // Found a valid sequence!
                 found_valid_sequence = true;
@@ -0,0 +1,690 @@
+/*
+ * Braggi - Diagnostics Engine Implementation
+ *
+ * "A hundred men yellin' the same thing is still just one thing said."
+ * - Old Galway Publican
+ */
+
+#include "braggi/diagnostics.h"
+#include "braggi/token.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+// Arena chunks are at least this big; larger strings get their own chunk
+#define DIAG_CHUNK_SIZE 16384
+
+typedef struct DiagChunk {
+    struct DiagChunk* next;
+    size_t used;
+    size_t capacity;
+    char data[];
+} DiagChunk;
+
+// A pending diagnostic. Structured ones get their position, filename
+// and message filled in only when a flush renders them.
+typedef struct PendingDiag {
+    BraggiDiagnostic diagnostic;
+    BraggiDiagRecord record;
+    bool structured;
+} PendingDiag;
+
+static const char* const message_templates[BRAGGI_DIAG_ID_COUNT] = {
+    [BRAGGI_DIAG_NONE]               = "Unknown diagnostic",
+    [BRAGGI_DIAG_NO_TOKENS]          = "No tokens to initialize field",
+    [BRAGGI_DIAG_FIELD_FAILED]       = "Failed to create entropy field",
+    [BRAGGI_DIAG_CELL_FAILED]        = "Failed to add a cell for {0}",
+    [BRAGGI_DIAG_STATE_FAILED]       = "Failed to add {0} as a state of {1}",
+    [BRAGGI_DIAG_CONSTRAINT_FAILED]  = "Failed to create {0} constraint between {1} and {2}",
+    [BRAGGI_DIAG_CONSTRAINTS_FAILED] = "Failed to create syntax or semantic constraints",
+    [BRAGGI_DIAG_CONTRADICTION]      = "Contradiction in {0}: no possible states remain",
+    [BRAGGI_DIAG_COLLAPSE_FAILED]    = "Wave function collapse failed",
+    [BRAGGI_DIAG_OUT_OF_MEMORY]      = "Out of memory building {0}",
+    [BRAGGI_DIAG_CONTEXT_FAILED]     = "{0}",
+};
+
+struct BraggiDiagnostics {
+    pthread_mutex_t lock;
+
+    DiagChunk* chunks;              // Newest first; strings are bump-allocated here
+    PendingDiag* pending;
+    size_t pending_count;
+    size_t pending_capacity;
+
+    uint32_t* slots;                // Open addressing, pending index + 1, 0 = empty
+    size_t slot_count;              // Power of two
+
+    size_t limit;
+    size_t suppressed;
+    uint32_t next_sequence;
+    size_t counts[ERROR_SEVERITY_FATAL + 1];
+
+    BraggiDiagnosticSink sinks[BRAGGI_DIAGNOSTICS_MAX_SINKS];
+    size_t sink_count;
+};
+
+static const char* arena_strdup(BraggiDiagnostics* diagnostics, const char* text) {
+    if (!text) {
+        return NULL;
+    }
+
+    size_t size = strlen(text) + 1;
+    DiagChunk* chunk = diagnostics->chunks;
+    if (!chunk || chunk->capacity - chunk->used < size) {
+        size_t capacity = size > DIAG_CHUNK_SIZE ? size : DIAG_CHUNK_SIZE;
+        chunk = (DiagChunk*)malloc(sizeof(DiagChunk) + capacity);
+        if (!chunk) {
+            return NULL;
+        }
+        chunk->next = diagnostics->chunks;
+        chunk->used = 0;
+        chunk->capacity = capacity;
+        diagnostics->chunks = chunk;
+    }
+
+    char* copy = chunk->data + chunk->used;
+    memcpy(copy, text, size);
+    chunk->used += size;
+    return copy;
+}
+
+// Keep one chunk so steady reporting doesn't go back to malloc
+static void arena_reset(BraggiDiagnostics* diagnostics) {
+    DiagChunk* chunk = diagnostics->chunks;
+    if (!chunk) {
+        return;
+    }
+
+    DiagChunk* rest = chunk->next;
+    while (rest) {
+        DiagChunk* next = rest->next;
+        free(rest);
+        rest = next;
+    }
+    chunk->next = NULL;
+    chunk->used = 0;
+}
+
+static uint64_t hash_bytes(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static uint64_t hash_string(uint64_t hash, const char* text) {
+    return text ? hash_bytes(hash, text, strlen(text)) : hash_bytes(hash, "", 1);
+}
+
+// Length isn't part of identity; the same message at the same spot
+// is the same diagnostic however much of the line it underlines
+static uint64_t diagnostic_hash(uint32_t code, ErrorSeverity severity, const SourcePosition* position,
+                                const char* filename, const char* message) {
+    uint64_t hash = 14695981039346656037ULL;
+    uint32_t fields[6] = {code, (uint32_t)severity, position->file_id,
+                          position->line, position->column, position->offset};
+    hash = hash_bytes(hash, fields, sizeof(fields));
+    hash = hash_string(hash, filename);
+    return hash_string(hash, message);
+}
+
+static bool same_string(const char* a, const char* b) {
+    if (!a || !b) {
+        return a == b;
+    }
+    return strcmp(a, b) == 0;
+}
+
+static bool diagnostic_matches(const BraggiDiagnostic* diagnostic, uint32_t code, ErrorSeverity severity,
+                               const SourcePosition* position, const char* filename, const char* message) {
+    return diagnostic->code == code &&
+           diagnostic->severity == severity &&
+           diagnostic->position.file_id == position->file_id &&
+           diagnostic->position.line == position->line &&
+           diagnostic->position.column == position->column &&
+           diagnostic->position.offset == position->offset &&
+           same_string(diagnostic->filename, filename) &&
+           same_string(diagnostic->message, message);
+}
+
+// An argument's value as one number. Text hashes by content.
+static uint64_t arg_bits(const BraggiDiagArg* arg) {
+    switch (arg->kind) {
+        case BRAGGI_DIAG_ARG_INT:   return (uint64_t)arg->as.i;
+        case BRAGGI_DIAG_ARG_CELL:
+        case BRAGGI_DIAG_ARG_STATE: return arg->as.id;
+        case BRAGGI_DIAG_ARG_LOC:   return arg->as.loc;
+        case BRAGGI_DIAG_ARG_TOKEN: return ((uint64_t)arg->as.token.type << 32) | arg->as.token.loc;
+        case BRAGGI_DIAG_ARG_TEXT:  return hash_string(14695981039346656037ULL, arg->as.text);
+        default:                    return 0;
+    }
+}
+
+// Field by field, so padding in the caller's copy doesn't matter
+static uint64_t record_hash(const BraggiDiagRecord* record) {
+    uint64_t hash = 1469598103934665603ULL;
+    uint32_t fields[3] = {(uint32_t)record->id, (uint32_t)record->severity, record->loc};
+    hash = hash_bytes(hash, fields, sizeof(fields));
+    for (int i = 0; i < BRAGGI_DIAG_MAX_ARGS; i++) {
+        uint64_t bits[2] = {(uint64_t)record->args[i].kind, arg_bits(&record->args[i])};
+        hash = hash_bytes(hash, bits, sizeof(bits));
+    }
+    return hash;
+}
+
+static bool record_matches(const BraggiDiagRecord* a, const BraggiDiagRecord* b) {
+    if (a->id != b->id || a->severity != b->severity || a->loc != b->loc) {
+        return false;
+    }
+    for (int i = 0; i < BRAGGI_DIAG_MAX_ARGS; i++) {
+        const BraggiDiagArg* left = &a->args[i];
+        const BraggiDiagArg* right = &b->args[i];
+        if (left->kind != right->kind) {
+            return false;
+        }
+        if (left->kind == BRAGGI_DIAG_ARG_TEXT ? !same_string(left->as.text, right->as.text)
+                                               : arg_bits(left) != arg_bits(right)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static uint64_t pending_hash(const PendingDiag* pending) {
+    if (pending->structured) {
+        return record_hash(&pending->record);
+    }
+    const BraggiDiagnostic* diagnostic = &pending->diagnostic;
+    return diagnostic_hash(diagnostic->code, diagnostic->severity, &diagnostic->position,
+                           diagnostic->filename, diagnostic->message);
+}
+
+// Grow the slot table to keep it under half full
+static bool slots_reserve(BraggiDiagnostics* diagnostics, size_t entries) {
+    if (entries * 2 <= diagnostics->slot_count) {
+        return true;
+    }
+
+    size_t slot_count = diagnostics->slot_count ? diagnostics->slot_count : 64;
+    while (entries * 2 > slot_count) {
+        slot_count *= 2;
+    }
+
+    uint32_t* slots = (uint32_t*)calloc(slot_count, sizeof(uint32_t));
+    if (!slots) {
+        return false;
+    }
+
+    for (size_t i = 0; i < diagnostics->pending_count; i++) {
+        size_t slot = pending_hash(&diagnostics->pending[i]) & (slot_count - 1);
+        while (slots[slot]) {
+            slot = (slot + 1) & (slot_count - 1);
+        }
+        slots[slot] = (uint32_t)i + 1;
+    }
+
+    free(diagnostics->slots);
+    diagnostics->slots = slots;
+    diagnostics->slot_count = slot_count;
+    return true;
+}
+
+BraggiDiagnostics* braggi_diagnostics_create(void) {
+    BraggiDiagnostics* diagnostics = (BraggiDiagnostics*)calloc(1, sizeof(BraggiDiagnostics));
+    if (!diagnostics) {
+        return NULL;
+    }
+
+    pthread_mutex_init(&diagnostics->lock, NULL);
+    diagnostics->limit = BRAGGI_DIAGNOSTICS_DEFAULT_LIMIT;
+    return diagnostics;
+}
+
+void braggi_diagnostics_destroy(BraggiDiagnostics* diagnostics) {
+    if (!diagnostics) {
+        return;
+    }
+
+    arena_reset(diagnostics);
+    free(diagnostics->chunks);
+    free(diagnostics->pending);
+    free(diagnostics->slots);
+    pthread_mutex_destroy(&diagnostics->lock);
+    free(diagnostics);
+}
+
+void braggi_diagnostics_set_limit(BraggiDiagnostics* diagnostics, size_t limit) {
+    if (!diagnostics) {
+        return;
+    }
+
+    pthread_mutex_lock(&diagnostics->lock);
+    diagnostics->limit = limit;
+    pthread_mutex_unlock(&diagnostics->lock);
+}
+
+bool braggi_diagnostics_add_sink(BraggiDiagnostics* diagnostics, BraggiDiagnosticSink sink) {
+    if (!diagnostics || !sink.emit) {
+        return false;
+    }
+
+    pthread_mutex_lock(&diagnostics->lock);
+    bool added = diagnostics->sink_count < BRAGGI_DIAGNOSTICS_MAX_SINKS;
+    if (added) {
+        diagnostics->sinks[diagnostics->sink_count++] = sink;
+    }
+    pthread_mutex_unlock(&diagnostics->lock);
+    return added;
+}
+
+void braggi_diagnostics_clear_sinks(BraggiDiagnostics* diagnostics) {
+    if (!diagnostics) {
+        return;
+    }
+
+    pthread_mutex_lock(&diagnostics->lock);
+    diagnostics->sink_count = 0;
+    pthread_mutex_unlock(&diagnostics->lock);
+}
+
+// Find a pending diagnostic identical to probe
+static PendingDiag* find_pending(BraggiDiagnostics* diagnostics, uint64_t hash, const PendingDiag* probe) {
+    if (diagnostics->slot_count == 0) {
+        return NULL;
+    }
+
+    size_t slot = hash & (diagnostics->slot_count - 1);
+    while (diagnostics->slots[slot]) {
+        PendingDiag* existing = &diagnostics->pending[diagnostics->slots[slot] - 1];
+        if (existing->structured == probe->structured) {
+            const BraggiDiagnostic* d = &probe->diagnostic;
+            if (probe->structured ? record_matches(&existing->record, &probe->record)
+                                  : diagnostic_matches(&existing->diagnostic, d->code, d->severity,
+                                                       &d->position, d->filename, d->message)) {
+                return existing;
+            }
+        }
+        slot = (slot + 1) & (diagnostics->slot_count - 1);
+    }
+    return NULL;
+}
+
+// Count a report and fold or store it. Called with the lock held;
+// strings in probe are copied into the arena.
+static bool report_locked(BraggiDiagnostics* diagnostics, const PendingDiag* probe) {
+    ErrorSeverity severity = probe->diagnostic.severity;
+    if ((size_t)severity <= ERROR_SEVERITY_FATAL) {
+        diagnostics->counts[severity]++;
+    }
+
+    uint64_t hash = pending_hash(probe);
+    PendingDiag* existing = find_pending(diagnostics, hash, probe);
+    if (existing) {
+        existing->diagnostic.repeats++;
+        return false;
+    }
+
+    // Over the limit only fatal diagnostics get through
+    if (diagnostics->limit > 0 && diagnostics->pending_count >= diagnostics->limit &&
+        severity < ERROR_SEVERITY_FATAL) {
+        diagnostics->suppressed++;
+        return false;
+    }
+
+    if (diagnostics->pending_count == diagnostics->pending_capacity) {
+        size_t capacity = diagnostics->pending_capacity ? diagnostics->pending_capacity * 2 : 32;
+        PendingDiag* pending = (PendingDiag*)realloc(diagnostics->pending, capacity * sizeof(PendingDiag));
+        if (!pending) {
+            diagnostics->suppressed++;
+            return false;
+        }
+        diagnostics->pending = pending;
+        diagnostics->pending_capacity = capacity;
+    }
+
+    if (!slots_reserve(diagnostics, diagnostics->pending_count + 1)) {
+        diagnostics->suppressed++;
+        return false;
+    }
+
+    PendingDiag* entry = &diagnostics->pending[diagnostics->pending_count];
+    *entry = *probe;
+    if (!probe->structured) {
+        entry->diagnostic.filename = arena_strdup(diagnostics, probe->diagnostic.filename);
+        entry->diagnostic.message = arena_strdup(diagnostics, probe->diagnostic.message);
+        entry->diagnostic.detail = arena_strdup(diagnostics, probe->diagnostic.detail);
+        if (!entry->diagnostic.message) {
+            diagnostics->suppressed++;
+            return false;
+        }
+    }
+    entry->diagnostic.sequence = diagnostics->next_sequence++;
+    entry->diagnostic.repeats = 0;
+
+    size_t slot = hash & (diagnostics->slot_count - 1);
+    while (diagnostics->slots[slot]) {
+        slot = (slot + 1) & (diagnostics->slot_count - 1);
+    }
+    diagnostics->slots[slot] = (uint32_t)++diagnostics->pending_count;
+    return true;
+}
+
+bool braggi_diagnostics_report(BraggiDiagnostics* diagnostics, uint32_t code,
+                               ErrorCategory category, ErrorSeverity severity,
+                               SourcePosition position, const char* filename,
+                               const char* message, const char* detail) {
+    if (!diagnostics || !message) {
+        return false;
+    }
+
+    PendingDiag probe;
+    memset(&probe, 0, sizeof(probe));
+    probe.diagnostic.code = code;
+    probe.diagnostic.category = category;
+    probe.diagnostic.severity = severity;
+    probe.diagnostic.position = position;
+    probe.diagnostic.filename = filename;
+    probe.diagnostic.message = message;
+    probe.diagnostic.detail = detail;
+
+    pthread_mutex_lock(&diagnostics->lock);
+    bool kept = report_locked(diagnostics, &probe);
+    pthread_mutex_unlock(&diagnostics->lock);
+    return kept;
+}
+
+bool braggi_diagnostics_report_record(BraggiDiagnostics* diagnostics, const BraggiDiagRecord* record) {
+    if (!diagnostics || !record) {
+        return false;
+    }
+
+    PendingDiag probe;
+    memset(&probe, 0, sizeof(probe));
+    probe.structured = true;
+    probe.record = *record;
+    probe.diagnostic.code = (uint32_t)record->id;
+    probe.diagnostic.category = record->category;
+    probe.diagnostic.severity = record->severity;
+
+    pthread_mutex_lock(&diagnostics->lock);
+    bool kept = report_locked(diagnostics, &probe);
+    pthread_mutex_unlock(&diagnostics->lock);
+    return kept;
+}
+
+static size_t format_arg(const BraggiDiagArg* arg, char* buffer, size_t size) {
+    SourcePosition position;
+    int written = 0;
+    switch (arg->kind) {
+        case BRAGGI_DIAG_ARG_INT:
+            written = snprintf(buffer, size, "%lld", (long long)arg->as.i);
+            break;
+        case BRAGGI_DIAG_ARG_CELL:
+            written = snprintf(buffer, size, "cell %u", arg->as.id);
+            break;
+        case BRAGGI_DIAG_ARG_STATE:
+            written = snprintf(buffer, size, "state %u", arg->as.id);
+            break;
+        case BRAGGI_DIAG_ARG_LOC:
+            braggi_source_loc_decode(arg->as.loc, &position);
+            written = snprintf(buffer, size, "%u:%u", position.line, position.column);
+            break;
+        case BRAGGI_DIAG_ARG_TOKEN:
+            braggi_source_loc_decode(arg->as.token.loc, &position);
+            written = snprintf(buffer, size, "%s at %u:%u",
+                               braggi_token_type_string((TokenType)arg->as.token.type),
+                               position.line, position.column);
+            break;
+        case BRAGGI_DIAG_ARG_TEXT:
+            written = snprintf(buffer, size, "%s", arg->as.text ? arg->as.text : "");
+            break;
+        default:
+            written = snprintf(buffer, size, "?");
+            break;
+    }
+    return written > 0 ? (size_t)written : 0;
+}
+
+size_t braggi_diag_format(const BraggiDiagRecord* record, char* buffer, size_t size) {
+    if (!record) {
+        return 0;
+    }
+
+    const char* template = (record->id < BRAGGI_DIAG_ID_COUNT && message_templates[record->id])
+                           ? message_templates[record->id] : message_templates[BRAGGI_DIAG_NONE];
+    size_t length = 0;
+    for (const char* c = template; *c; c++) {
+        size_t room = length < size ? size - length : 0;
+        if (c[0] == '{' && c[1] >= '0' && c[1] < '0' + BRAGGI_DIAG_MAX_ARGS && c[2] == '}') {
+            length += format_arg(&record->args[c[1] - '0'], room ? buffer + length : NULL, room);
+            c += 2;
+        } else {
+            if (room > 1) {
+                buffer[length] = *c;
+            }
+            length++;
+        }
+    }
+    if (size > 0) {
+        buffer[length < size ? length : size - 1] = '\0';
+    }
+    return length;
+}
+
+// Give structured diagnostics what a sink expects to read
+static void render_pending(BraggiDiagnostics* diagnostics, PendingDiag* pending) {
+    if (!pending->structured) {
+        return;
+    }
+
+    BraggiDiagnostic* diagnostic = &pending->diagnostic;
+    braggi_source_loc_decode(pending->record.loc, &diagnostic->position);
+    diagnostic->filename = braggi_source_loc_filename(pending->record.loc);
+
+    char buffer[512];
+    braggi_diag_format(&pending->record, buffer, sizeof(buffer));
+    diagnostic->message = arena_strdup(diagnostics, buffer);
+    if (!diagnostic->message) {
+        diagnostic->message = message_templates[pending->record.id];
+    }
+}
+
+// Unnamed files sort first, then by name, line, column and report order
+static int compare_diagnostics(const void* a, const void* b) {
+    const BraggiDiagnostic* left = &((const PendingDiag*)a)->diagnostic;
+    const BraggiDiagnostic* right = &((const PendingDiag*)b)->diagnostic;
+
+    if (left->filename != right->filename) {
+        if (!left->filename) return -1;
+        if (!right->filename) return 1;
+        int order = strcmp(left->filename, right->filename);
+        if (order != 0) return order;
+    }
+    if (left->position.line != right->position.line) {
+        return left->position.line < right->position.line ? -1 : 1;
+    }
+    if (left->position.column != right->position.column) {
+        return left->position.column < right->position.column ? -1 : 1;
+    }
+    return left->sequence < right->sequence ? -1 : (left->sequence > right->sequence ? 1 : 0);
+}
+
+static void clear_locked(BraggiDiagnostics* diagnostics) {
+    diagnostics->pending_count = 0;
+    diagnostics->suppressed = 0;
+    if (diagnostics->slots) {
+        memset(diagnostics->slots, 0, diagnostics->slot_count * sizeof(uint32_t));
+    }
+    arena_reset(diagnostics);
+}
+
+size_t braggi_diagnostics_flush(BraggiDiagnostics* diagnostics) {
+    if (!diagnostics) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&diagnostics->lock);
+
+    // With nobody to show them to, there's nothing to render or sort
+    size_t count = diagnostics->pending_count;
+    if (diagnostics->sink_count > 0) {
+        for (size_t i = 0; i < count; i++) {
+            render_pending(diagnostics, &diagnostics->pending[i]);
+        }
+        qsort(diagnostics->pending, count, sizeof(PendingDiag), compare_diagnostics);
+
+        for (size_t i = 0; i < count; i++) {
+            PendingDiag* pending = &diagnostics->pending[i];
+            pending->diagnostic.record = pending->structured ? &pending->record : NULL;
+        }
+    }
+
+    for (size_t s = 0; s < diagnostics->sink_count; s++) {
+        BraggiDiagnosticSink* sink = &diagnostics->sinks[s];
+        for (size_t i = 0; i < count; i++) {
+            sink->emit(&diagnostics->pending[i].diagnostic, sink->user_data);
+        }
+        if (diagnostics->suppressed > 0 && sink->summary) {
+            sink->summary(diagnostics->suppressed, sink->user_data);
+        }
+    }
+
+    clear_locked(diagnostics);
+    pthread_mutex_unlock(&diagnostics->lock);
+    return count;
+}
+
+void braggi_diagnostics_clear(BraggiDiagnostics* diagnostics) {
+    if (!diagnostics) {
+        return;
+    }
+
+    // Flushing keeps the counts; clearing forgets the reports ever happened
+    pthread_mutex_lock(&diagnostics->lock);
+    clear_locked(diagnostics);
+    memset(diagnostics->counts, 0, sizeof(diagnostics->counts));
+    pthread_mutex_unlock(&diagnostics->lock);
+}
+
+size_t braggi_diagnostics_pending(const BraggiDiagnostics* diagnostics) {
+    if (!diagnostics) {
+        return 0;
+    }
+
+    BraggiDiagnostics* locked = (BraggiDiagnostics*)diagnostics;
+    pthread_mutex_lock(&locked->lock);
+    size_t count = locked->pending_count;
+    pthread_mutex_unlock(&locked->lock);
+    return count;
+}
+
+size_t braggi_diagnostics_suppressed(const BraggiDiagnostics* diagnostics) {
+    if (!diagnostics) {
+        return 0;
+    }
+
+    BraggiDiagnostics* locked = (BraggiDiagnostics*)diagnostics;
+    pthread_mutex_lock(&locked->lock);
+    size_t count = locked->suppressed;
+    pthread_mutex_unlock(&locked->lock);
+    return count;
+}
+
+size_t braggi_diagnostics_count(const BraggiDiagnostics* diagnostics, ErrorSeverity min_severity) {
+    if (!diagnostics) {
+        return 0;
+    }
+
+    BraggiDiagnostics* locked = (BraggiDiagnostics*)diagnostics;
+    pthread_mutex_lock(&locked->lock);
+    size_t count = 0;
+    for (int severity = (int)min_severity; severity <= ERROR_SEVERITY_FATAL; severity++) {
+        count += locked->counts[severity];
+    }
+    pthread_mutex_unlock(&locked->lock);
+    return count;
+}
+
+/*
+ * Sinks
+ */
+
+static void text_emit(const BraggiDiagnostic* diagnostic, void* user_data) {
+    FILE* stream = (FILE*)user_data;
+    fprintf(stream, "[%s:%s] %s:%u:%u: %s",
+            braggi_error_category_to_string(diagnostic->category),
+            braggi_error_severity_to_string(diagnostic->severity),
+            diagnostic->filename ? diagnostic->filename : "<unknown>",
+            diagnostic->position.line,
+            diagnostic->position.column,
+            diagnostic->message);
+    if (diagnostic->repeats > 0) {
+        fprintf(stream, " (repeated %u more times)", diagnostic->repeats);
+    }
+    fputc('\n', stream);
+    if (diagnostic->detail) {
+        fprintf(stream, "  %s\n", diagnostic->detail);
+    }
+}
+
+static void text_summary(size_t suppressed, void* user_data) {
+    fprintf((FILE*)user_data, "%zu more %s not shown\n", suppressed,
+            suppressed == 1 ? "diagnostic" : "diagnostics");
+}
+
+BraggiDiagnosticSink braggi_diagnostic_sink_text(FILE* stream) {
+    BraggiDiagnosticSink sink = {text_emit, text_summary, stream};
+    return sink;
+}
+
+static void json_string(FILE* stream, const char* text) {
+    if (!text) {
+        fputs("null", stream);
+        return;
+    }
+
+    fputc('"', stream);
+    for (const unsigned char* c = (const unsigned char*)text; *c; c++) {
+        switch (*c) {
+            case '"':  fputs("\\\"", stream); break;
+            case '\\': fputs("\\\\", stream); break;
+            case '\n': fputs("\\n", stream); break;
+            case '\r': fputs("\\r", stream); break;
+            case '\t': fputs("\\t", stream); break;
+            default:
+                if (*c < 0x20) {
+                    fprintf(stream, "\\u%04x", *c);
+                } else {
+                    fputc(*c, stream);
+                }
+        }
+    }
+    fputc('"', stream);
+}
+
+static void json_emit(const BraggiDiagnostic* diagnostic, void* user_data) {
+    FILE* stream = (FILE*)user_data;
+    fprintf(stream, "{\"severity\":\"%s\",\"category\":\"%s\",\"code\":%u,\"file\":",
+            braggi_error_severity_to_string(diagnostic->severity),
+            braggi_error_category_to_string(diagnostic->category),
+            diagnostic->code);
+    json_string(stream, diagnostic->filename);
+    fprintf(stream, ",\"line\":%u,\"column\":%u,\"offset\":%u,\"length\":%u,\"message\":",
+            diagnostic->position.line, diagnostic->position.column,
+            diagnostic->position.offset, diagnostic->position.length);
+    json_string(stream, diagnostic->message);
+    fputs(",\"detail\":", stream);
+    json_string(stream, diagnostic->detail);
+    fprintf(stream, ",\"repeats\":%u}\n", diagnostic->repeats);
+}
+
+static void json_summary(size_t suppressed, void* user_data) {
+    fprintf((FILE*)user_data, "{\"suppressed\":%zu}\n", suppressed);
+}
+
+BraggiDiagnosticSink braggi_diagnostic_sink_json(FILE* stream) {
+    BraggiDiagnosticSink sink = {json_emit, json_summary, stream};
+    return sink;
+}
@@ -1044,11 +1044,13 @@ void* braggi_ecs_add_component(ECSWorld* world, EntityID entity, ComponentTypeID
     
     // Add the component to the array
     braggi_component_array_add(world->component_arrays[component_type], entity, component_data);
+    free(component_data);
     
     // Update the entity's component mask
     braggi_ecs_mask_set(&world->entity_component_masks[entity], component_type);
     
-    return component_data;
+    // Hand back the packed slot itself so writes land in the array, not in a stray copy
+    return braggi_ecs_get_component(world, entity, component_type);
 }
 
 /*
@@ -1088,6 +1090,7 @@ ComponentArray* braggi_component_array_create(size_t capacity, size_t component_
     array->size = 0;
     array->capacity = capacity;
     array->component_size = component_size;
+    array->destructor = NULL;
     
     return array;
 }
@@ -8,7 +8,9 @@
 
 #include "braggi/entropy.h"
 #include "braggi/allocation.h"
+#include "braggi/alloc_profile.h"
 #include "braggi/util/vector.h"
+#include "braggi/util/typed_vector.h"
 #include "braggi/token.h"  // Add token.h for Token structure
 #include "braggi/pattern.h" // Add pattern.h for Pattern structure
 #include <stdlib.h>
@@ -18,6 +20,9 @@
 #include <float.h>
 #include <time.h>  // For time() function used in random seed
 
+// Cell ID lists for propagation; most fit inline and never allocate
+BRAGGI_SMALL_VEC_DECLARE(CellIdList, cell_id_list, uint32_t, 32)
+
 // External declaration for ECS field reference clearing function
 extern void braggi_entropy_ecs_clear_field_reference(void* world);
 
@@ -69,6 +74,7 @@ EntropyState* braggi_entropy_state_create(uint32_t id, uint32_t type, const char
     if (!state) {
         return NULL;
     }
+    braggi_alloc_profile_note(BRAGGI_ALLOC_PROFILE_HEAP_KEY, "heap", sizeof(EntropyState), 0, 0, "entropy state");
     
     state->id = id;
     state->type = type;
@@ -285,6 +291,8 @@ EntropyField* braggi_entropy_field_create(uint32_t source_id, void* error_handle
     field->contradiction_cell_id = 0;
     field->source_id = source_id;
     field->error_handler = error_handler;
+    field->token_cells = NULL;
+    field->token_count = 0;
     
     return field;
 }
@@ -401,6 +409,10 @@ void braggi_entropy_field_destroy(EntropyField* field) {
         fprintf(stderr, "DEBUG: Field had NULL constraints array\n");
     }
     
+    free(field->token_cells);
+    field->token_cells = NULL;
+    field->token_count = 0;
+    
     // Finally free the field itself
     fprintf(stderr, "DEBUG: Freeing field structure\n");
     free(field);
@@ -438,12 +450,30 @@ EntropyCell* braggi_entropy_field_add_cell(EntropyField* field, uint32_t positio
     return cell;
 }
 
+// Give the field its token-to-cell map
+void braggi_entropy_field_set_token_cells(EntropyField* field, uint32_t* token_cells, size_t token_count) {
+    if (!field) {
+        free(token_cells);
+        return;
+    }
+    
+    free(field->token_cells);
+    field->token_cells = token_cells;
+    field->token_count = token_cells ? token_count : 0;
+}
+
 // Get a cell from an entropy field by ID
 EntropyCell* braggi_entropy_field_get_cell(EntropyField* field, uint32_t cell_id) {
     if (!field || !field->cells || cell_id >= field->cell_count) {
         return NULL;
     }
     
+    // Cells are numbered in the order they're added, so the ID is
+    // normally the index
+    if (field->cells[cell_id] && field->cells[cell_id]->id == cell_id) {
+        return field->cells[cell_id];
+    }
+    
     // Find the cell with the given ID
     for (size_t i = 0; i < field->cell_count; i++) {
         if (field->cells[i] && field->cells[i]->id == cell_id) {
@@ -679,38 +709,31 @@ bool braggi_entropy_field_propagate_constraints(EntropyField* field, uint32_t ce
     EntropyCell* cell = field->cells[cell_id];
     if (!cell) return false;
     
-    // Queue for cells that need constraint propagation
-    // Start with the current cell
-    Vector* propagation_queue = braggi_vector_create(sizeof(uint32_t));
-    if (!propagation_queue) return false;
+    // Queue for cells that need constraint propagation, consumed from
+    // queue_head rather than shifted. Every cell ever queued stays in it,
+    // so it doubles as the set of enqueued cells.
+    CellIdList propagation_queue;
+    cell_id_list_init(&propagation_queue);
+    size_t queue_head = 0;
     
-    // Set to track cells already in the queue to avoid duplicates
-    Vector* enqueued_cells = braggi_vector_create(sizeof(uint32_t));
-    if (!enqueued_cells) {
-        braggi_vector_destroy(propagation_queue);
-        return false;
-    }
+    // Cells touched by the constraints of the cell being processed
+    CellIdList affected_cells;
+    cell_id_list_init(&affected_cells);
     
-    // Add initial cell to queue
-    braggi_vector_push_back(propagation_queue, &cell_id);
-    braggi_vector_push_back(enqueued_cells, &cell_id);
+    // Start with the current cell
+    cell_id_list_push(&propagation_queue, cell_id);
     
     bool any_changes = false;
     
     // Process queue until empty
-    while (braggi_vector_size(propagation_queue) > 0) {
+    while (queue_head < cell_id_list_size(&propagation_queue)) {
         // Get next cell from queue
-        uint32_t current_cell_id = *(uint32_t*)braggi_vector_get(propagation_queue, 0);
+        uint32_t current_cell_id = cell_id_list_at(&propagation_queue, queue_head++);
         EntropyCell* current_cell = field->cells[current_cell_id];
         
-        // Remove from front of queue (simulating pop_front)
-        braggi_vector_erase(propagation_queue, 0);
-        
         if (!current_cell) continue;
         
-        // Track cells affected by changes to this cell
-        Vector* affected_cells = braggi_vector_create(sizeof(uint32_t));
-        if (!affected_cells) continue;
+        cell_id_list_clear(&affected_cells);
         
         // Find constraints that affect this cell
         bool cell_changed = false;
@@ -743,7 +766,7 @@ bool braggi_entropy_field_propagate_constraints(EntropyField* field, uint32_t ce
                     if (affected_cell_id == current_cell_id) continue;
                     
                     // Add to set of affected cells
-                    braggi_vector_push_back(affected_cells, &affected_cell_id);
+                    cell_id_list_push(&affected_cells, affected_cell_id);
                 }
             }
         }
@@ -753,32 +776,28 @@ bool braggi_entropy_field_propagate_constraints(EntropyField* field, uint32_t ce
             any_changes = true;
             
             // Add all affected cells to the queue (avoiding duplicates)
-            for (size_t i = 0; i < braggi_vector_size(affected_cells); i++) {
-                uint32_t affected_cell_id = *(uint32_t*)braggi_vector_get(affected_cells, i);
+            for (size_t i = 0; i < cell_id_list_size(&affected_cells); i++) {
+                uint32_t affected_cell_id = cell_id_list_at(&affected_cells, i);
                 
                 // Check if already in queue
                 bool already_enqueued = false;
-                for (size_t j = 0; j < braggi_vector_size(enqueued_cells); j++) {
-                    uint32_t enqueued_id = *(uint32_t*)braggi_vector_get(enqueued_cells, j);
-                    if (enqueued_id == affected_cell_id) {
+                for (size_t j = 0; j < cell_id_list_size(&propagation_queue); j++) {
+                    if (cell_id_list_at(&propagation_queue, j) == affected_cell_id) {
                         already_enqueued = true;
                         break;
                     }
                 }
                 
                 if (!already_enqueued) {
-                    braggi_vector_push_back(propagation_queue, &affected_cell_id);
-                    braggi_vector_push_back(enqueued_cells, &affected_cell_id);
+                    cell_id_list_push(&propagation_queue, affected_cell_id);
                 }
             }
         }
-        
-        braggi_vector_destroy(affected_cells);
     }
     
     // Clean up
-    braggi_vector_destroy(propagation_queue);
-    braggi_vector_destroy(enqueued_cells);
+    cell_id_list_free(&affected_cells);
+    cell_id_list_free(&propagation_queue);
     
     return any_changes;
 }
@@ -787,10 +806,13 @@ bool braggi_entropy_field_propagate_constraints(EntropyField* field, uint32_t ce
 bool braggi_entropy_field_has_contradiction(EntropyField* field) {
     if (!field) return false;
     
-    // Check if any cell has zero possible states
+    // Check if any cell has zero possible states, and remember which
+    // one so the failure can be reported against it
     for (uint32_t i = 0; i < field->cell_count; i++) {
         EntropyCell* cell = field->cells[i];
         if (cell && cell->state_count == 0) {
+            field->has_contradiction = true;
+            field->contradiction_cell_id = cell->id;
             return true;
         }
     }
@@ -798,45 +820,63 @@ bool braggi_entropy_field_has_contradiction(EntropyField* field) {
     return false;
 }
 
-// Get detailed information about a contradiction in the field
-bool braggi_entropy_field_get_contradiction_info(EntropyField* field, void* position_ptr, char** message) {
-    if (!field || !message) return false;
-    
-    // Check if any cell has zero possible states
+// The first cell left with no possible states, NULL if there is none
+static EntropyCell* find_contradiction(EntropyField* field) {
     for (uint32_t i = 0; i < field->cell_count; i++) {
         EntropyCell* cell = field->cells[i];
         if (cell && cell->state_count == 0) {
-            // We found a contradiction
-            
-            // Set position information if provided
-            if (position_ptr) {
-                SourcePosition* position = (SourcePosition*)position_ptr;
-                position->file_id = field->source_id;
-                position->line = cell->position_line;
-                position->column = cell->position_column;
-                position->offset = cell->position_offset;
-                position->length = 1; // Default length
-            }
-            
-            // Set message
-            char* msg = malloc(256);
-            if (msg) {
-                snprintf(msg, 256, "Contradiction in cell %u: No possible states remain", cell->id);
-                *message = msg;
-            } else {
-                *message = NULL;
-            }
-            
-            return true;
+            return cell;
         }
     }
+    return NULL;
+}
+
+// Describe a contradiction as a record; the message is only rendered if shown
+bool braggi_entropy_field_get_contradiction_record(EntropyField* field, BraggiDiagRecord* record) {
+    if (!field || !record) return false;
     
-    // No contradiction found
-    if (message) {
-        *message = NULL;
+    EntropyCell* cell = find_contradiction(field);
+    if (!cell) return false;
+    
+    memset(record, 0, sizeof(*record));
+    record->id = BRAGGI_DIAG_CONTRADICTION;
+    record->category = ERROR_CATEGORY_SEMANTIC;
+    record->severity = ERROR_SEVERITY_ERROR;
+    record->loc = braggi_source_loc_get(field->source_id, cell->position_offset);
+    record->args[0] = BRAGGI_DIAG_CELL(cell->id);
+    return true;
+}
+
+// Get detailed information about a contradiction in the field. Callers
+// that report it should take the record instead; this renders the text.
+bool braggi_entropy_field_get_contradiction_info(EntropyField* field, void* position_ptr, char** message) {
+    if (!field || !message) return false;
+    *message = NULL;
+    
+    BraggiDiagRecord record;
+    if (!braggi_entropy_field_get_contradiction_record(field, &record)) {
+        return false;
     }
     
-    return false;
+    // Set position information if provided
+    if (position_ptr) {
+        EntropyCell* cell = find_contradiction(field);
+        SourcePosition* position = (SourcePosition*)position_ptr;
+        position->file_id = field->source_id;
+        position->line = cell->position_line;
+        position->column = cell->position_column;
+        position->offset = cell->position_offset;
+        position->length = 1; // Default length
+    }
+    
+    size_t length = braggi_diag_format(&record, NULL, 0);
+    char* msg = malloc(length + 1);
+    if (msg) {
+        braggi_diag_format(&record, msg, length + 1);
+        *message = msg;
+    }
+    
+    return true;
 }
 
 // Add a state to a cell (using correct struct types)
@@ -1583,6 +1623,7 @@ bool braggi_entropy_field_apply_wave_function_collapse(EntropyField* field) {
 EntropyCell* braggi_entropy_cell_create(uint32_t id) {
     EntropyCell* cell = (EntropyCell*)calloc(1, sizeof(EntropyCell));
     if (!cell) return NULL;
+    braggi_alloc_profile_note(BRAGGI_ALLOC_PROFILE_HEAP_KEY, "heap", sizeof(EntropyCell), 0, 0, "entropy cell");
     
     cell->id = id;
     cell->states = NULL;
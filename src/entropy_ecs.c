@@ -417,7 +417,7 @@ EntityID braggi_entropy_create_state_entity(ECSWorld* world, EntropyState* state
             token_component->token_id = 0;  // Tokens don't have IDs in the Token struct
             token_component->type = token->type;
             token_component->text = token->text ? strdup(token->text) : NULL;
-            token_component->position = token->position;
+            token_component->position = braggi_token_get_position(token);
             token_component->state_id = state->id;
         }
     }
@@ -14,13 +14,14 @@
 // Global error handler instance
 static ErrorHandler* global_error_handler = NULL;
 
-// Forward declaration of function from error_handler.h
+// Forward declarations of functions from error_handler.h
 void braggi_error_handler_clear(ErrorHandler* handler);
+size_t braggi_error_handler_flush(ErrorHandler* handler);
 
-// Initialize the error system
+// Initialize the error system. Anything the old handler still holds is
+// printed, not dropped - destroying a handler flushes it.
 void braggi_error_init(void) {
     if (global_error_handler) {
-        braggi_error_clear();
         braggi_error_handler_destroy(global_error_handler);
     }
     
@@ -55,6 +56,12 @@ void braggi_error_report(ErrorHandler* handler, uint32_t code, ErrorCategory cat
                                       const char* message, const char* details);
     
     braggi_error_report_impl(handler, code, category, severity, pos, filename, message, details);
+    
+    // Nothing drives the global handler or flushes it at the end of a
+    // phase, so its reports are printed as they come
+    if (handler == global_error_handler) {
+        braggi_error_handler_flush(handler);
+    }
 }
 
 // Report an error with source context (simplified version using global handler)
@@ -7,6 +7,7 @@
 
 #include "braggi/error.h"
 #include "braggi/error_handler.h"
+#include "braggi/diagnostics.h"
 #include "braggi/allocation.h"
 
 #include <stdlib.h>
@@ -45,9 +46,22 @@ ErrorHandler* braggi_error_handler_create(void) {
     
     // Initialize with defaults
     handler->user_data = NULL;
-    
-    // We'll use the global region for simplicity
-    Region* region = braggi_named_region_get_global();
+    handler->context = NULL;
+    handler->error = NULL;
+    handler->warning = NULL;
+    handler->set_source = NULL;
+    handler->get_last_error = NULL;
+    handler->get_error_count = NULL;
+    handler->reset = NULL;
+    
+    // Reports are rendered to stderr when the handler is flushed
+    handler->diagnostics = braggi_diagnostics_create();
+    if (!handler->diagnostics) {
+        braggi_vector_destroy(handler->errors);
+        free(handler);
+        return NULL;
+    }
+    braggi_diagnostics_add_sink(handler->diagnostics, braggi_diagnostic_sink_text(stderr));
     
     return handler;
 }
@@ -60,6 +74,12 @@ void braggi_error_handler_destroy(ErrorHandler* handler) {
         return;
     }
     
+    // Anything still pending gets its say before the handler goes
+    if (handler->diagnostics) {
+        braggi_diagnostics_flush(handler->diagnostics);
+        braggi_diagnostics_destroy(handler->diagnostics);
+    }
+    
     // Free the errors vector and all errors it contains
     if (handler->errors) {
         for (size_t i = 0; i < braggi_vector_size(handler->errors); i++) {
@@ -89,28 +109,23 @@ void braggi_error_report_impl(ErrorHandler* handler, uint32_t code, ErrorCategor
         return;
     }
     
+    // Repeats and reports over the limit are only counted, so they
+    // don't get an Error of their own either
+    if (handler->diagnostics &&
+        !braggi_diagnostics_report(handler->diagnostics, code, category, severity,
+                                   pos, filename, message, details)) {
+        return;
+    }
+    
     // Create an error
     Error* error = braggi_error_create(code, category, severity, pos, filename, message, details);
     if (!error) {
         return;
     }
     
-    // Add to the errors vector
+    // Add to the errors vector. Fatal errors don't end the process any
+    // more; callers check braggi_error_has_fatal and unwind.
     braggi_vector_push(handler->errors, &error);
-    
-    // Report to stderr
-    fprintf(stderr, "[%s:%s] %s:%u:%u: %s\n",
-            braggi_error_category_to_string(category),
-            braggi_error_severity_to_string(severity),
-            filename ? filename : "<unknown>",
-            pos.line,
-            pos.column,
-            message);
-    
-    // Check if we should exit based on severity
-    if (severity >= ERROR_SEVERITY_FATAL) {
-        exit(EXIT_FAILURE);
-    }
 }
 
 /*
@@ -168,6 +183,32 @@ void braggi_error_handler_clear(ErrorHandler* handler) {
         }
         braggi_vector_clear(handler->errors);
     }
+    
+    if (handler->diagnostics) {
+        braggi_diagnostics_clear(handler->diagnostics);
+    }
+}
+
+void braggi_error_report_record(ErrorHandler* handler, const BraggiDiagRecord* record) {
+    if (!handler || !record) {
+        return;
+    }
+    
+    if (handler->diagnostics) {
+        braggi_diagnostics_report_record(handler->diagnostics, record);
+    }
+}
+
+BraggiDiagnostics* braggi_error_handler_get_diagnostics(ErrorHandler* handler) {
+    return handler ? handler->diagnostics : NULL;
+}
+
+size_t braggi_error_handler_flush(ErrorHandler* handler) {
+    if (!handler || !handler->diagnostics) {
+        return 0;
+    }
+    
+    return braggi_diagnostics_flush(handler->diagnostics);
 }
 
 /* Get the error handler function accessor */
@@ -187,5 +228,7 @@ bool braggi_error_handler_has_errors(const ErrorHandler* handler) {
         return false;
     }
     
-    return braggi_error_handler_get_error_count(handler) > 0;
+    // Structured reports are only in the diagnostics engine
+    return braggi_error_handler_get_error_count(handler) > 0 ||
+           braggi_diagnostics_count(handler->diagnostics, ERROR_SEVERITY_NOTE) > 0;
 } 
\ No newline at end of file
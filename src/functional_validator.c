@@ -159,8 +159,9 @@ static uint32_t get_cell_id_for_token(FunctionalContext* ctx, Token* token) {
     
     // Fallback based on token source position
     // Use line as an approximation for cell ID if valid
-    if (token->position.line > 0 && ctx->field && ctx->field->cell_count > 0) {
-        uint32_t cell_id = token->position.line - 1; // Convert 1-based to 0-based
+    SourcePosition position = braggi_token_get_position(token);
+    if (position.line > 0 && ctx->field && ctx->field->cell_count > 0) {
+        uint32_t cell_id = position.line - 1; // Convert 1-based to 0-based
         if (cell_id < ctx->field->cell_count) {
             return cell_id;
         }
@@ -165,6 +165,10 @@ const char* braggi_lsp_compile_and_get_diagnostics(const char* source_text, cons
         return result;
     }
     
+    // Diagnostics go back to the client as JSON, not to our stderr
+    braggi_diagnostics_clear_sinks(
+        braggi_error_handler_get_diagnostics(braggi_context_get_error_handler(context)));
+    
     // Load the source text into the Braggi context
     if (!braggi_context_load_string(context, source_text, file_path)) {
         // Add a diagnostic for failed source loading
@@ -22,12 +22,33 @@
 #include "braggi/token_propagator.h"
 #include "braggi/grammar_patterns.h"
 #include "braggi/codegen.h"
+#include "braggi/phase_report.h"
+#include "braggi/alloc_profile.h"
+#include "braggi/compile_pool.h"
+#include "braggi/compile_server.h"
 
 // Command line options
 char* input_file = NULL;
 char* output_file = NULL;
 int optimize_level = 0;
 bool verbose = false;
+bool time_report = false;
+bool mem_report = false;
+bool report_json = false;
+char* report_file = NULL;
+uint32_t alloc_profile_rate = 0;
+bool batch_mode = false;
+long batch_workers = 0;      // 0 means one per CPU
+char* server_socket = NULL;  // --server: serve compiles on this socket
+char* connect_socket = NULL; // --connect: have this server compile
+bool server_shutdown = false;
+
+// Positional arguments, and jobs read from @FILE response files
+static Vector* positional_args = NULL;
+static Vector* batch_jobs = NULL;
+
+// Per-phase measurements for --time-report / --mem-report
+static PhaseReport phase_report;
 
 // Signal handling for segmentation faults
 static jmp_buf cleanup_env;
@@ -39,10 +60,17 @@ static void segfault_handler(int sig) {
     longjmp(cleanup_env, 1);
 }
 
+// constraint_patterns.h clashes with grammar_patterns.h over PatternType
+extern bool braggi_constraint_patterns_initialize(void);
+
 // Forward declarations
 void print_usage(const char* program_name);
 int parse_args(int argc, char** argv);
-int compile_file();
+int compile_file(const char* input, const char* output);
+static int finish_compile(BraggiContext* context, int result);
+static int run_batch(void);
+static int run_server(void);
+static int run_client(void);
 
 // Safe wrapper around context destruction to prevent segmentation faults
 static void safely_destroy_context(BraggiContext* context) {
@@ -95,6 +123,26 @@ int main(int argc, char** argv) {
         return 1;
     }
     
+    // The environment can switch on sampling without touching the command
+    // line. Read it before batch and server mode fork their workers.
+    const char* profile_env = getenv("BRAGGI_ALLOC_PROFILE");
+    if (profile_env && alloc_profile_rate == 0) {
+        alloc_profile_rate = (uint32_t)strtoul(profile_env, NULL, 10);
+    }
+    if (alloc_profile_rate) {
+        braggi_alloc_profile_enable(alloc_profile_rate);
+    }
+    
+    if (server_socket) {
+        return run_server();
+    }
+    if (connect_socket) {
+        return run_client();
+    }
+    if (batch_mode) {
+        return run_batch();
+    }
+    
     // Check if input file was specified
     if (input_file == NULL) {
         fprintf(stderr, "Error: No input file specified\n");
@@ -111,7 +159,7 @@ int main(int argc, char** argv) {
     }
     
     // Compile the input file
-    int result = compile_file();
+    int result = compile_file(input_file, output_file);
     
     if (verbose) {
         if (result == 0) {
@@ -124,6 +172,84 @@ int main(int argc, char** argv) {
     return result;
 }
 
+// Queue a batch job. Without an output, the input's extension is
+// dropped, or ".out" added if it has none.
+static bool add_batch_job(const char* input, const char* output) {
+    if (!batch_jobs) {
+        batch_jobs = braggi_vector_create(sizeof(BraggiCompileJob));
+        if (!batch_jobs) {
+            fprintf(stderr, "Error: Out of memory reading batch jobs\n");
+            return false;
+        }
+    }
+    
+    char* job_output;
+    if (output && *output) {
+        job_output = strdup(output);
+    } else {
+        const char* slash = strrchr(input, '/');
+        const char* dot = strrchr(input, '.');
+        bool has_extension = dot && dot > (slash ? slash + 1 : input);
+        size_t stem = has_extension ? (size_t)(dot - input) : strlen(input);
+        
+        job_output = malloc(stem + 5);
+        if (job_output) {
+            memcpy(job_output, input, stem);
+            strcpy(job_output + stem, has_extension ? "" : ".out");
+        }
+    }
+    
+    BraggiCompileJob job = {
+        (uint32_t)braggi_vector_size(batch_jobs),
+        strdup(input),
+        job_output,
+        0
+    };
+    
+    if (!job.input || !job.output || !braggi_vector_push(batch_jobs, &job)) {
+        fprintf(stderr, "Error: Out of memory reading batch jobs\n");
+        free((char*)job.input);
+        free((char*)job.output);
+        return false;
+    }
+    
+    return true;
+}
+
+// Read "INPUT [OUTPUT]" lines; blank lines and # comments are skipped
+static bool read_response_file(const char* path) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "Error: Failed to open response file: %s\n", path);
+        return false;
+    }
+    
+    char line[4096];
+    unsigned int line_number = 0;
+    bool ok = true;
+    
+    while (ok && fgets(line, sizeof(line), file)) {
+        line_number++;
+        
+        char* save = NULL;
+        char* input = strtok_r(line, " \t\r\n", &save);
+        if (!input || input[0] == '#') {
+            continue;
+        }
+        char* output = strtok_r(NULL, " \t\r\n", &save);
+        
+        if (strtok_r(NULL, " \t\r\n", &save)) {
+            fprintf(stderr, "Error: %s:%u: expected INPUT [OUTPUT]\n", path, line_number);
+            ok = false;
+        } else {
+            ok = add_batch_job(input, output);
+        }
+    }
+    
+    fclose(file);
+    return ok;
+}
+
 // Parse command line arguments
 int parse_args(int argc, char** argv) {
     for (int i = 1; i < argc; i++) {
@@ -141,21 +267,102 @@ int parse_args(int argc, char** argv) {
                 fprintf(stderr, "Error: -o option requires an output filename\n");
                 return 1;
             }
+        } else if (strcmp(argv[i], "--time-report") == 0 || strcmp(argv[i], "--time-report=json") == 0) {
+            time_report = true;
+            if (argv[i][13] == '=') report_json = true;
+        } else if (strcmp(argv[i], "--mem-report") == 0 || strcmp(argv[i], "--mem-report=json") == 0) {
+            mem_report = true;
+            if (argv[i][12] == '=') report_json = true;
+        } else if (strcmp(argv[i], "--alloc-profile") == 0) {
+            alloc_profile_rate = BRAGGI_ALLOC_PROFILE_DEFAULT_RATE;
+        } else if (strncmp(argv[i], "--alloc-profile=", 16) == 0) {
+            alloc_profile_rate = (uint32_t)strtoul(argv[i] + 16, NULL, 10);
+            if (alloc_profile_rate == 0) {
+                fprintf(stderr, "Error: --alloc-profile rate must be at least 1\n");
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--report-file=", 14) == 0) {
+            report_file = argv[i] + 14;
         } else if (strncmp(argv[i], "-O", 2) == 0 && argv[i][2] >= '0' && argv[i][2] <= '9') {
             optimize_level = argv[i][2] - '0';
+        } else if (strncmp(argv[i], "--server=", 9) == 0 && argv[i][9]) {
+            server_socket = argv[i] + 9;
+        } else if (strncmp(argv[i], "--connect=", 10) == 0 && argv[i][10]) {
+            connect_socket = argv[i] + 10;
+        } else if (strcmp(argv[i], "--shutdown") == 0) {
+            server_shutdown = true;
+        } else if (strcmp(argv[i], "--batch") == 0) {
+            batch_mode = true;
+        } else if (strncmp(argv[i], "-j", 2) == 0 || strncmp(argv[i], "--jobs=", 7) == 0) {
+            // -j N, -jN or --jobs=N
+            const char* count = argv[i] + 7;
+            if (argv[i][1] == 'j') {
+                count = argv[i][2] ? argv[i] + 2 : (i + 1 < argc ? argv[++i] : NULL);
+            }
+            char* end = NULL;
+            batch_workers = count ? strtol(count, &end, 10) : 0;
+            if (!count || *end != '\0' || batch_workers < 1) {
+                fprintf(stderr, "Error: -j/--jobs needs a worker count of at least 1\n");
+                return 1;
+            }
+        } else if (argv[i][0] == '@') {
+            // A response file implies batch mode
+            if (!read_response_file(argv[i] + 1)) {
+                return 1;
+            }
+            batch_mode = true;
         } else if (argv[i][0] == '-') {
             fprintf(stderr, "Unknown option: %s\n", argv[i]);
             return 1;
         } else {
-            // Assume it's the input file
-            if (input_file != NULL) {
-                fprintf(stderr, "Multiple input files not supported\n");
+            if (!positional_args) {
+                positional_args = braggi_vector_create(sizeof(char*));
+            }
+            if (!positional_args || !braggi_vector_push(positional_args, &argv[i])) {
+                fprintf(stderr, "Error: Out of memory reading arguments\n");
                 return 1;
             }
-            input_file = argv[i];
         }
     }
     
+    size_t positional_count = positional_args ? braggi_vector_size(positional_args) : 0;
+    
+    if ((server_socket != NULL) + (connect_socket != NULL) + batch_mode > 1) {
+        fprintf(stderr, "Error: --server, --connect and --batch can't be combined\n");
+        return 1;
+    }
+    if (server_shutdown && !connect_socket) {
+        fprintf(stderr, "Error: --shutdown needs --connect=SOCKET\n");
+        return 1;
+    }
+    if (server_socket && positional_count > 0) {
+        fprintf(stderr, "Error: --server takes no input files; clients send them\n");
+        return 1;
+    }
+    
+    if (batch_mode) {
+        // Positional arguments are INPUT or INPUT=OUTPUT jobs
+        for (size_t i = 0; i < positional_count; i++) {
+            char* arg = *(char**)braggi_vector_get(positional_args, i);
+            char* equals = strchr(arg, '=');
+            if (equals) {
+                *equals = '\0';
+            }
+            bool added = add_batch_job(arg, equals ? equals + 1 : NULL);
+            if (equals) {
+                *equals = '=';
+            }
+            if (!added) {
+                return 1;
+            }
+        }
+    } else if (positional_count > 1) {
+        fprintf(stderr, "Multiple input files not supported (use --batch)\n");
+        return 1;
+    } else if (positional_count == 1) {
+        input_file = *(char**)braggi_vector_get(positional_args, 0);
+    }
+    
     return 0;
 }
 
@@ -168,16 +375,65 @@ void print_usage(const char* program_name) {
     fprintf(stderr, "  --output=FILE           Specify output file\n");
     fprintf(stderr, "  -o FILE                 Specify output file (alternative syntax)\n");
     fprintf(stderr, "  -O0, -O1, -O2, -O3      Set optimization level\n");
+    fprintf(stderr, "  --time-report[=json]    Report wall and CPU time for each compiler phase\n");
+    fprintf(stderr, "  --mem-report[=json]     Report allocations, heap and region usage for each phase\n");
+    fprintf(stderr, "  --alloc-profile[=N]     Sample about one allocation in N (default 100) by label and region\n");
+    fprintf(stderr, "  --report-file=FILE      Write the reports to FILE instead of stderr\n");
+    fprintf(stderr, "  --batch                 Compile every input; each is INPUT or INPUT=OUTPUT\n");
+    fprintf(stderr, "  @FILE                   Read batch jobs from FILE, one \"INPUT [OUTPUT]\" per line\n");
+    fprintf(stderr, "  -j N, -jN, --jobs=N    Use N worker processes in batch mode (default: one per CPU)\n");
+    fprintf(stderr, "  --server=SOCKET         Serve compile requests on a Unix socket (-j sets workers)\n");
+    fprintf(stderr, "  --connect=SOCKET        Have the server on SOCKET compile input_file\n");
+    fprintf(stderr, "  --shutdown              With --connect, stop the server instead\n");
+    fprintf(stderr, "\nSetting BRAGGI_ALLOC_PROFILE=N in the environment also turns on sampling.\n");
+    fprintf(stderr, "In batch mode an input without an output is written next to it, minus its extension.\n");
+}
+
+// Print the requested reports, then tear down the context
+static int finish_compile(BraggiContext* context, int result) {
+    braggi_phase_report_end(&phase_report);
+    
+    if (time_report || mem_report || alloc_profile_rate) {
+        FILE* stream = stderr;
+        if (report_file) {
+            stream = fopen(report_file, "w");
+            if (!stream) {
+                fprintf(stderr, "Error: Failed to open report file: %s\n", report_file);
+                stream = stderr;
+            }
+        }
+        
+        if (report_json) {
+            braggi_phase_report_write_json(&phase_report, stream, time_report, mem_report);
+        } else {
+            if (time_report) braggi_phase_report_print_time(&phase_report, stream);
+            if (mem_report) braggi_phase_report_print_mem(&phase_report, stream);
+        }
+        // The profile is text only, so keep it out of a JSON report file
+        if (alloc_profile_rate) {
+            braggi_alloc_profile_print(report_json ? stderr : stream, 20);
+        }
+        
+        if (stream != stderr) fclose(stream);
+    }
+    
+    // The region manager goes away with the context
+    braggi_phase_report_set_regions(&phase_report, NULL);
+    safely_destroy_context(context);
+    return result;
 }
 
 // Main compilation function
-int compile_file() {
+int compile_file(const char* input, const char* output) {
     // This is an actual implementation using Braggi's quantum compiler approach
     if (verbose) {
-        printf("Reading file: %s\n", input_file);
+        printf("Reading file: %s\n", input);
     }
     
-    fprintf(stderr, "DEBUG: Starting compilation of %s\n", input_file);
+    fprintf(stderr, "DEBUG: Starting compilation of %s\n", input);
+    
+    braggi_phase_report_init(&phase_report);
+    braggi_phase_report_begin(&phase_report, PHASE_SOURCE_LOAD);
     
     // Create a Braggi context for compilation
     BraggiContext* context = braggi_context_create();
@@ -185,17 +441,17 @@ int compile_file() {
         fprintf(stderr, "Error: Failed to create Braggi context\n");
         return 1;
     }
+    braggi_phase_report_set_regions(&phase_report, context->region_manager);
     
     fprintf(stderr, "DEBUG: Context created successfully\n");
     
     // Load the input file into the context
-    if (!braggi_context_load_file(context, input_file)) {
-        fprintf(stderr, "Error: Failed to load input file: %s\n", input_file);
-        safely_destroy_context(context);
-        return 1;
+    if (!braggi_context_load_file(context, input)) {
+        fprintf(stderr, "Error: Failed to load input file: %s\n", input);
+        return finish_compile(context, 1);
     }
     
-    fprintf(stderr, "DEBUG: Successfully loaded source file '%s'\n", input_file);
+    fprintf(stderr, "DEBUG: Successfully loaded source file '%s'\n", input);
     fprintf(stderr, "DEBUG: Source has %u lines\n", braggi_source_file_get_line_count(context->source));
     
     // Print some sample lines for debugging
@@ -205,16 +461,17 @@ int compile_file() {
     }
     
     if (verbose) {
-        printf("Successfully loaded source file '%s'\n", input_file);
+        printf("Successfully loaded source file '%s'\n", input);
         printf("Beginning token processing...\n");
     }
     
+    braggi_phase_report_begin(&phase_report, PHASE_SETUP);
+    
     // Create a token propagator
     TokenPropagator* propagator = braggi_token_propagator_create();
     if (!propagator) {
         fprintf(stderr, "ERROR: Failed to create token propagator\n");
-        braggi_context_destroy(context);
-        return 1;
+        return finish_compile(context, 1);
     }
     
     fprintf(stderr, "DEBUG: Propagator created at %p\n", (void*)propagator);
@@ -224,28 +481,27 @@ int compile_file() {
     if (!ecs_world) {
         fprintf(stderr, "ERROR: Failed to create ECS world for periscope\n");
         braggi_token_propagator_destroy(propagator);
-        braggi_context_destroy(context);
-        return 1;
+        return finish_compile(context, 1);
     }
     
     if (!braggi_token_propagator_init_periscope(propagator, ecs_world)) {
         fprintf(stderr, "ERROR: Failed to initialize periscope for token propagator\n");
         braggi_ecs_destroy_world(ecs_world);
         braggi_token_propagator_destroy(propagator);
-        braggi_context_destroy(context);
-        return 1;
+        return finish_compile(context, 1);
     }
     
     // Set the propagator in the context so it's available for code generation
     context->propagator = propagator;
     fprintf(stderr, "DEBUG: Set propagator in context: context->propagator = %p\n", (void*)context->propagator);
     
+    braggi_phase_report_begin(&phase_report, PHASE_TOKENIZE);
+    
     // Create a tokenizer for the source
     Tokenizer* tokenizer = braggi_tokenizer_create(context->source);
     if (!tokenizer) {
         fprintf(stderr, "DEBUG: Failed to create tokenizer\n");
-        safely_destroy_context(context);
-        return 1;
+        return finish_compile(context, 1);
     }
     
     fprintf(stderr, "DEBUG: Successfully created tokenizer\n");
@@ -274,8 +530,7 @@ int compile_file() {
     tokenizer = braggi_tokenizer_create(context->source);
     if (!tokenizer) {
         fprintf(stderr, "DEBUG: Failed to recreate tokenizer after peek\n");
-        safely_destroy_context(context);
-        return 1;
+        return finish_compile(context, 1);
     }
     
     // Now process tokens
@@ -309,8 +564,11 @@ int compile_file() {
         Token* token = braggi_token_create(
             current->type,
             current->text ? strdup(current->text) : NULL,
-            current->position
+            (SourcePosition){0}
         );
+        if (token) {
+            token->loc = current->loc;  // Already encoded; no need to decode and re-encode
+        }
         
         if (!token) {
             fprintf(stderr, "DEBUG: Failed to create token #%d\n", token_count);
@@ -342,28 +600,32 @@ int compile_file() {
         printf("Initializing entropy field...\n");
     }
     
+    braggi_phase_report_begin(&phase_report, PHASE_FIELD_INIT);
+    
     // Initialize the entropy field from the tokens
     if (!braggi_token_propagator_initialize_field(propagator)) {
         fprintf(stderr, "Error: Failed to initialize entropy field\n");
-        safely_destroy_context(context);
-        return 1;
+        return finish_compile(context, 1);
     }
     
     if (verbose) {
         printf("Creating constraints...\n");
     }
     
+    braggi_phase_report_begin(&phase_report, PHASE_CONSTRAINTS);
+    
     // Create constraints from patterns
     if (!braggi_token_propagator_create_constraints(propagator)) {
         fprintf(stderr, "Error: Failed to create constraints\n");
-        safely_destroy_context(context);
-        return 1;
+        return finish_compile(context, 1);
     }
     
     if (verbose) {
         printf("Applying wave function collapse...\n");
     }
     
+    braggi_phase_report_begin(&phase_report, PHASE_PROPAGATE);
+    
     // Perform the wave function collapse
     if (!braggi_token_propagator_run_with_wfc(propagator)) {
         fprintf(stderr, "Error: Wave function collapse failed - see errors below\n");
@@ -379,10 +641,11 @@ int compile_file() {
             }
         }
         
-        safely_destroy_context(context);
-        return 1;
+        return finish_compile(context, 1);
     }
     
+    braggi_phase_report_begin(&phase_report, PHASE_ECS_SYNC);
+    
     // Copy output tokens from propagator to context for code generation
     Vector* output_tokens = braggi_token_propagator_get_output_tokens(propagator);
     if (output_tokens && braggi_vector_size(output_tokens) > 0) {
@@ -397,12 +660,10 @@ int compile_file() {
             context->tokens = braggi_vector_create(sizeof(Token*));
         }
         
-        // Copy tokens from propagator output to context
-        for (size_t i = 0; i < braggi_vector_size(output_tokens); i++) {
-            Token** token_ptr = (Token**)braggi_vector_get(output_tokens, i);
-            if (token_ptr && *token_ptr) {
-                braggi_vector_push_back(context->tokens, token_ptr);
-            }
+        // Copy tokens from propagator output to context. The propagator
+        // never outputs NULL tokens, so this is one copy.
+        if (context->tokens && !braggi_vector_extend_from(context->tokens, output_tokens)) {
+            fprintf(stderr, "WARNING: Failed to copy propagator output tokens to context\n");
         }
         
         fprintf(stderr, "DEBUG: Copied %zu tokens from propagator output to context\n", 
@@ -416,53 +677,234 @@ int compile_file() {
         printf("Generating output code...\n");
     }
     
+    braggi_phase_report_begin(&phase_report, PHASE_CODEGEN);
+    
     // Set up code generation options
     CodeGenOptions codegen_options = braggi_codegen_get_default_options(ARCH_X86_64);
     codegen_options.format = FORMAT_EXECUTABLE;
     codegen_options.optimize = optimize_level > 0;
     codegen_options.optimization_level = optimize_level;
     codegen_options.emit_debug_info = true;
-    codegen_options.output_file = (char*)output_file;
+    codegen_options.output_file = (char*)output;
     
     // Create and initialize the code generator
     CodeGenContext codegen_ctx;
     if (!braggi_codegen_init(&codegen_ctx, context, codegen_options)) {
         fprintf(stderr, "Error: Failed to initialize code generator\n");
-        safely_destroy_context(context);
-        return 1;
+        return finish_compile(context, 1);
     }
     
     // Generate code
     if (!braggi_codegen_generate(&codegen_ctx)) {
         fprintf(stderr, "Error: Code generation failed\n");
         braggi_codegen_cleanup(&codegen_ctx);
-        safely_destroy_context(context);
-        return 1;
+        return finish_compile(context, 1);
     }
     
     // Determine the output file path
-    const char* actual_output_file = output_file ? output_file : "a.out";
+    const char* actual_output_file = output ? output : "a.out";
     if (verbose) {
         printf("Writing output to: %s\n", actual_output_file);
     }
     
+    braggi_phase_report_begin(&phase_report, PHASE_EMIT);
+    
     // Write the generated code to the output file
     if (!braggi_codegen_write_output(&codegen_ctx, actual_output_file)) {
         fprintf(stderr, "Error: Failed to write output file: %s\n", actual_output_file);
         braggi_codegen_cleanup(&codegen_ctx);
-        safely_destroy_context(context);
-        return 1;
+        return finish_compile(context, 1);
     }
     
     // Clean up
     braggi_codegen_cleanup(&codegen_ctx);
     
+    if (verbose) {
+        printf("Compilation successful!\n");
+    }
+    
     // Use our safe wrapper for context cleanup
-    safely_destroy_context(context);
+    return finish_compile(context, 0);
+} 
+
+// Runs in a batch worker, which forks once and then compiles job after job
+static int batch_compile_job(const BraggiCompileJob* job, void* user_data) {
+    (void)user_data;
     
     if (verbose) {
-        printf("Compilation successful!\n");
+        printf("[%d] Compiling %s -> %s\n", (int)getpid(), job->input, job->output);
     }
     
-    return 0;
-} 
\ No newline at end of file
+    // Workers are separate processes, so the option globals are theirs to set
+    optimize_level = job->optimize_level;
+    
+    // Nothing from the last job's files is looked at again
+    braggi_source_loc_reset();
+    return compile_file(job->input, job->output);
+}
+
+// Set up the shared tables once, then fork -j workers (one per CPU by
+// default, never more than max_jobs) that inherit them
+static BraggiCompilePool* start_workers(size_t max_jobs) {
+    size_t workers = (size_t)batch_workers;
+    if (workers == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = cpus > 0 ? (size_t)cpus : 1;
+    }
+    if (max_jobs > 0 && workers > max_jobs) {
+        workers = max_jobs;
+    }
+    
+    braggi_constraint_patterns_initialize();
+    braggi_codegen_manager_init();
+    
+    BraggiCompilePool* pool = braggi_compile_pool_create(workers, batch_compile_job, NULL);
+    if (!pool) {
+        fprintf(stderr, "Error: Failed to start compile workers\n");
+    }
+    return pool;
+}
+
+// Free the batch's jobs and the argument list they were read from
+static void free_batch_args(void) {
+    size_t job_count = batch_jobs ? braggi_vector_size(batch_jobs) : 0;
+    for (size_t i = 0; i < job_count; i++) {
+        BraggiCompileJob* job = braggi_vector_get(batch_jobs, i);
+        free((char*)job->input);
+        free((char*)job->output);
+    }
+    braggi_vector_destroy(batch_jobs);
+    batch_jobs = NULL;
+    braggi_vector_destroy(positional_args);
+    positional_args = NULL;
+}
+
+// Compile the batch across a pool of worker processes
+static int compile_batch(void) {
+    size_t job_count = batch_jobs ? braggi_vector_size(batch_jobs) : 0;
+    if (job_count == 0) {
+        fprintf(stderr, "Error: No input files given for --batch\n");
+        return 1;
+    }
+    
+    // Every job names its own output, and one report file can't hold them all
+    if (output_file || report_file) {
+        fprintf(stderr, "Error: -o/--output and --report-file can't be used in batch mode\n");
+        return 1;
+    }
+    
+    BraggiCompilePool* pool = start_workers(job_count);
+    if (!pool) {
+        return 1;
+    }
+    
+    if (verbose) {
+        printf("===== BRAGGI BATCH =====\n");
+        printf("Jobs: %zu, workers: %zu\n", job_count, braggi_compile_pool_workers(pool));
+    }
+    
+    int* statuses = malloc(job_count * sizeof(int));
+    if (!statuses) {
+        fprintf(stderr, "Error: Out of memory starting batch\n");
+        braggi_compile_pool_destroy(pool);
+        return 1;
+    }
+    
+    for (size_t i = 0; i < job_count; i++) {
+        BraggiCompileJob* job = braggi_vector_get(batch_jobs, i);
+        
+        // -O may come after the response files on the command line
+        job->optimize_level = optimize_level;
+        statuses[i] = BRAGGI_COMPILE_POOL_CRASHED;
+        if (!braggi_compile_pool_submit(pool, job)) {
+            fprintf(stderr, "Error: Failed to queue %s\n", job->input);
+        }
+    }
+    
+    uint32_t id;
+    int status;
+    while (braggi_compile_pool_wait(pool, &id, &status)) {
+        if (id < job_count) {
+            statuses[id] = status;
+        }
+    }
+    
+    braggi_compile_pool_destroy(pool);
+    
+    size_t failed = 0;
+    for (size_t i = 0; i < job_count; i++) {
+        if (statuses[i] != 0) {
+            BraggiCompileJob* job = braggi_vector_get(batch_jobs, i);
+            fprintf(stderr, "FAILED: %s%s\n", job->input,
+                    statuses[i] == BRAGGI_COMPILE_POOL_CRASHED ? " (worker crashed)" : "");
+            failed++;
+        }
+    }
+    
+    printf("Batch: %zu compiled, %zu failed\n", job_count - failed, failed);
+    
+    free(statuses);
+    return failed == 0 ? 0 : 1;
+}
+
+// The batch's arguments are freed however it ends
+static int run_batch(void) {
+    int result = compile_batch();
+    free_batch_args();
+    return result;
+}
+
+// Serve compiles until told to stop. The pool stays up between
+// requests, so each one skips the compiler's start-up.
+static int run_server(void) {
+    if (output_file || report_file) {
+        fprintf(stderr, "Error: -o/--output and --report-file can't be used with --server\n");
+        return 1;
+    }
+    
+    BraggiCompilePool* pool = start_workers(0);
+    if (!pool) {
+        return 1;
+    }
+    
+    int result = braggi_compile_server_run(server_socket, pool);
+    braggi_compile_pool_destroy(pool);
+    return result;
+}
+
+// Send input_file to the server on connect_socket, or ask it to stop
+static int run_client(void) {
+    if (server_shutdown) {
+        if (!braggi_compile_server_shutdown(connect_socket)) {
+            fprintf(stderr, "Error: No compile server answered on %s\n", connect_socket);
+            return 1;
+        }
+        return 0;
+    }
+    
+    if (input_file == NULL) {
+        fprintf(stderr, "Error: No input file specified\n");
+        return 1;
+    }
+    
+    // Same default as compiling in-process
+    BraggiCompileJob job = {0, input_file, output_file ? output_file : "a.out", optimize_level};
+    char message[512] = "";
+    
+    switch (braggi_compile_server_request(connect_socket, &job, message, sizeof(message))) {
+        case BRAGGI_SERVER_COMPILED:
+            if (verbose) printf("Compiled %s -> %s\n", job.input, job.output);
+            return 0;
+        case BRAGGI_SERVER_CACHED:
+            if (verbose) printf("Up to date: %s -> %s\n", job.input, job.output);
+            return 0;
+        case BRAGGI_SERVER_FAILED:
+            fprintf(stderr, "Error: Compilation of %s failed (status %s); see the server's log\n",
+                    job.input, message);
+            return 1;
+        case BRAGGI_SERVER_ERROR:
+        default:
+            fprintf(stderr, "Error: Compile server: %s\n", message);
+            return 1;
+    }
+}
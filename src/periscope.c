@@ -40,6 +40,10 @@ typedef struct {
 
 // Forward declarations for internal functions
 static bool periscope_register_components(Periscope* periscope);
+static PeriscopeContractId contracts_add(PeriscopeContracts* contracts, EntityID region_entity,
+                                         EntityID validator_entity, uint32_t guarantee_flags,
+                                         bool is_valid);
+static void contracts_free(PeriscopeContracts* contracts);
 static void periscope_token_system_update(ECSWorld* world, System* system, float delta_time);
 static bool token_cell_mapping_compare(const void* a, const void* b);
 
@@ -70,13 +74,7 @@ Periscope* braggi_periscope_create(ECSWorld* ecs_world) {
         return NULL;
     }
     
-    periscope->active_contracts = braggi_vector_create(sizeof(void*));
-    if (!periscope->active_contracts) {
-        ERROR("Failed to create active_contracts vector");
-        braggi_vector_destroy(periscope->token_to_cell_mappings);
-        free(periscope);
-        return NULL;
-    }
+    // Contract arrays start empty (memset above) and grow on first use
     
     DEBUG("Created periscope at %p with ECS world %p", periscope, ecs_world);
     return periscope;
@@ -109,12 +107,8 @@ void braggi_periscope_destroy(Periscope* periscope) {
         periscope->token_to_cell_mappings = NULL;
     }
     
-    if (periscope->active_contracts) {
-        fprintf(stderr, "DEBUG: Destroying active_contracts vector at %p\n", 
-                (void*)periscope->active_contracts);
-        braggi_vector_destroy(periscope->active_contracts);
-        periscope->active_contracts = NULL;
-    }
+    fprintf(stderr, "DEBUG: Freeing %zu periscope contracts\n", periscope->contracts.count);
+    contracts_free(&periscope->contracts);
     
     // Null out other pointers defensively
     periscope->ecs_world = NULL;
@@ -337,9 +331,10 @@ uint32_t braggi_periscope_get_cell_id_for_token(Periscope* periscope, void* toke
     
     // If token is a Braggi token, use its line number as fallback
     Token* braggi_token = (Token*)token;
-    if (braggi_token && braggi_token->position.line > 0) {
-        fallback_cell_id = braggi_token->position.line;
-        DEBUG("Using token line %u as cell ID %u", braggi_token->position.line, fallback_cell_id);
+    SourcePosition position = braggi_token_get_position(braggi_token);
+    if (braggi_token && position.line > 0) {
+        fallback_cell_id = position.line;
+        DEBUG("Using token line %u as cell ID %u", position.line, fallback_cell_id);
         
         // Register this mapping so we don't have to calculate it again
         if (field && fallback_cell_id < field->cell_count) {
@@ -420,8 +415,104 @@ void braggi_periscope_destroy_view(PeriscopeView* view) {
     free(view);
 }
 
+/*
+ * Contract storage
+ *
+ * "Ya don't check a herd brand by brand through the barn door - ya
+ * line 'em up in the chute and read the whole row at once."
+ * - Panhandle Brand Inspector
+ */
+
+#define CONTRACT_WORD_BITS 64
+
+static size_t contract_words(size_t count) {
+    return (count + CONTRACT_WORD_BITS - 1) / CONTRACT_WORD_BITS;
+}
+
+static size_t count_bits(uint64_t word) {
+    size_t bits = 0;
+    while (word) {
+        word &= word - 1;
+        bits++;
+    }
+    return bits;
+}
+
+// Grow every field array together, zeroing the new bitmap words
+static bool contracts_reserve(PeriscopeContracts* contracts, size_t capacity) {
+    if (capacity <= contracts->capacity) {
+        return true;
+    }
+    
+    size_t new_capacity = contracts->capacity ? contracts->capacity * 2 : CONTRACT_WORD_BITS;
+    while (new_capacity < capacity) {
+        new_capacity *= 2;
+    }
+    
+    EntityID* regions = realloc(contracts->region_entities, new_capacity * sizeof(EntityID));
+    if (!regions) return false;
+    contracts->region_entities = regions;
+    
+    EntityID* validators = realloc(contracts->validator_entities, new_capacity * sizeof(EntityID));
+    if (!validators) return false;
+    contracts->validator_entities = validators;
+    
+    uint32_t* flags = realloc(contracts->guarantee_flags, new_capacity * sizeof(uint32_t));
+    if (!flags) return false;
+    contracts->guarantee_flags = flags;
+    
+    size_t old_words = contract_words(contracts->capacity);
+    size_t new_words = contract_words(new_capacity);
+    
+    uint64_t* valid_bits = realloc(contracts->valid_bits, new_words * sizeof(uint64_t));
+    if (!valid_bits) return false;
+    memset(valid_bits + old_words, 0, (new_words - old_words) * sizeof(uint64_t));
+    contracts->valid_bits = valid_bits;
+    
+    uint64_t* violation_bits = realloc(contracts->violation_bits, new_words * sizeof(uint64_t));
+    if (!violation_bits) return false;
+    memset(violation_bits + old_words, 0, (new_words - old_words) * sizeof(uint64_t));
+    contracts->violation_bits = violation_bits;
+    
+    contracts->capacity = new_capacity;
+    return true;
+}
+
+static PeriscopeContractId contracts_add(PeriscopeContracts* contracts, EntityID region_entity,
+                                         EntityID validator_entity, uint32_t guarantee_flags,
+                                         bool is_valid) {
+    if (contracts->count >= PERISCOPE_CONTRACT_INVALID ||
+        !contracts_reserve(contracts, contracts->count + 1)) {
+        return PERISCOPE_CONTRACT_INVALID;
+    }
+    
+    PeriscopeContractId id = (PeriscopeContractId)contracts->count++;
+    contracts->region_entities[id] = region_entity;
+    contracts->validator_entities[id] = validator_entity;
+    contracts->guarantee_flags[id] = guarantee_flags;
+    
+    uint64_t bit = (uint64_t)1 << (id % CONTRACT_WORD_BITS);
+    if (is_valid) {
+        contracts->valid_bits[id / CONTRACT_WORD_BITS] |= bit;
+    } else {
+        contracts->valid_bits[id / CONTRACT_WORD_BITS] &= ~bit;
+    }
+    
+    contracts->dirty = true;
+    return id;
+}
+
+static void contracts_free(PeriscopeContracts* contracts) {
+    free(contracts->region_entities);
+    free(contracts->validator_entities);
+    free(contracts->guarantee_flags);
+    free(contracts->valid_bits);
+    free(contracts->violation_bits);
+    memset(contracts, 0, sizeof(*contracts));
+}
+
 // Create a contract for a validator to ensure region lifetime guarantees
-RegionLifetimeContract* braggi_periscope_create_contract(
+PeriscopeContractId braggi_periscope_create_contract(
     Periscope* periscope,
     EntityID region_entity,
     EntityID validator_entity,
@@ -429,22 +520,7 @@ RegionLifetimeContract* braggi_periscope_create_contract(
 {
     if (!periscope) {
         fprintf(stderr, "ERROR: NULL periscope in create_contract\n");
-        return NULL;
-    }
-    
-    // Enhanced safety check
-    if (!periscope->active_contracts) {
-        fprintf(stderr, "ERROR: active_contracts vector is NULL in periscope at %p\n", (void*)periscope);
-        
-        // Try to recover by creating the vector
-        periscope->active_contracts = braggi_vector_create(sizeof(RegionLifetimeContract*));
-        if (!periscope->active_contracts) {
-            fprintf(stderr, "ERROR: Failed to create active_contracts vector in recovery\n");
-            return NULL;
-        }
-        
-        fprintf(stderr, "DEBUG: Created active_contracts vector as recovery at %p\n", 
-                (void*)periscope->active_contracts);
+        return PERISCOPE_CONTRACT_INVALID;
     }
     
     // Check region entity
@@ -452,36 +528,102 @@ RegionLifetimeContract* braggi_periscope_create_contract(
         fprintf(stderr, "WARNING: Invalid region entity ID 0 in create_contract\n");
         // We'll still create the contract, but mark as suspicious
     }
+    
+    // Contracts start out in force until proven otherwise
+    PeriscopeContractId id = contracts_add(&periscope->contracts, region_entity,
+                                           validator_entity, guarantee_flags, true);
+    if (id == PERISCOPE_CONTRACT_INVALID) {
+        fprintf(stderr, "ERROR: Failed to store contract in periscope\n");
+        return PERISCOPE_CONTRACT_INVALID;
+    }
+    
+    fprintf(stderr, "DEBUG: Created contract %u: region=%u, validator=%u, flags=%u\n",
+            id, region_entity, validator_entity, guarantee_flags);
+    fprintf(stderr, "DEBUG: Periscope now has %zu active contracts\n", periscope->contracts.count);
+    
+    return id;
+}
 
-    // Create a new contract
-    RegionLifetimeContract* contract = malloc(sizeof(RegionLifetimeContract));
-    if (!contract) {
-        fprintf(stderr, "ERROR: Failed to allocate memory for contract\n");
-        return NULL;
+// Copy a contract out of the periscope
+bool braggi_periscope_get_contract(const Periscope* periscope, PeriscopeContractId id,
+                                   RegionLifetimeContract* out) {
+    if (!periscope || !out || id >= periscope->contracts.count) {
+        return false;
     }
     
-    // Initialize contract
-    contract->region_entity = region_entity;
-    contract->validator_entity = validator_entity;
-    contract->guarantee_flags = guarantee_flags;
-    contract->is_valid = true;  // Assume valid until proven otherwise
+    const PeriscopeContracts* contracts = &periscope->contracts;
+    out->region_entity = contracts->region_entities[id];
+    out->validator_entity = contracts->validator_entities[id];
+    out->guarantee_flags = contracts->guarantee_flags[id];
+    out->is_valid = (contracts->valid_bits[id / CONTRACT_WORD_BITS] >> (id % CONTRACT_WORD_BITS)) & 1u;
+    return true;
+}
+
+// Put a contract in or out of force
+bool braggi_periscope_set_contract_valid(Periscope* periscope, PeriscopeContractId id, bool is_valid) {
+    if (!periscope || id >= periscope->contracts.count) {
+        return false;
+    }
     
-    // Add to the list of active contracts
-    if (!braggi_vector_push_back(periscope->active_contracts, &contract)) {
-        fprintf(stderr, "ERROR: Failed to add contract to active contracts vector\n");
-        free(contract);
-        return NULL;
+    uint64_t* word = &periscope->contracts.valid_bits[id / CONTRACT_WORD_BITS];
+    uint64_t bit = (uint64_t)1 << (id % CONTRACT_WORD_BITS);
+    *word = is_valid ? (*word | bit) : (*word & ~bit);
+    periscope->contracts.dirty = true;
+    return true;
+}
+
+// Number of contracts, valid or not
+size_t braggi_periscope_contract_count(const Periscope* periscope) {
+    return periscope ? periscope->contracts.count : 0;
+}
+
+// Check every contract, 64 at a time. The inner loop only compares
+// packed flags and ORs bits into one word, with no branches or
+// pointer chasing, so the compiler can vectorize it.
+size_t braggi_periscope_validate_contracts(Periscope* periscope, uint32_t required_flags) {
+    if (!periscope) {
+        return 0;
     }
     
-    fprintf(stderr, "DEBUG: Created contract %p: region=%u, validator=%u, flags=%u\n",
-            (void*)contract, contract->region_entity, contract->validator_entity, 
-            contract->guarantee_flags);
+    PeriscopeContracts* contracts = &periscope->contracts;
+    if (!contracts->dirty && contracts->validated_flags == required_flags) {
+        return contracts->violation_count;
+    }
+    
+    size_t violations = 0;
+    for (size_t base = 0; base < contracts->count; base += CONTRACT_WORD_BITS) {
+        size_t remaining = contracts->count - base;
+        size_t n = remaining < CONTRACT_WORD_BITS ? remaining : CONTRACT_WORD_BITS;
+        
+        const uint32_t* flags = contracts->guarantee_flags + base;
+        
+        uint64_t word = 0;
+        for (size_t j = 0; j < n; j++) {
+            uint64_t broken = (uint64_t)((flags[j] & required_flags) != required_flags);
+            word |= broken << j;
+        }
+        
+        uint64_t in_use = n == CONTRACT_WORD_BITS ? ~(uint64_t)0 : (((uint64_t)1 << n) - 1);
+        word |= ~contracts->valid_bits[base / CONTRACT_WORD_BITS] & in_use;
+        
+        contracts->violation_bits[base / CONTRACT_WORD_BITS] = word;
+        violations += count_bits(word);
+    }
     
-    // Print contract count for better tracking
-    size_t contract_count = braggi_vector_size(periscope->active_contracts);
-    fprintf(stderr, "DEBUG: Periscope now has %zu active contracts\n", contract_count);
+    contracts->violation_count = violations;
+    contracts->validated_flags = required_flags;
+    contracts->dirty = false;
+    return violations;
+}
+
+// Contracts that pass validation with no required flags
+size_t braggi_periscope_valid_contract_count(Periscope* periscope) {
+    if (!periscope) {
+        return 0;
+    }
     
-    return contract;
+    size_t violations = braggi_periscope_validate_contracts(periscope, 0);
+    return periscope->contracts.count - violations;
 }
 
 // Validate constraints against region lifetime contracts
@@ -505,54 +647,10 @@ bool braggi_periscope_validate_constraints(Periscope* periscope, EntropyConstrai
             constraint->type, 
             constraint->description ? constraint->description : "unnamed");
 
-    // Enhanced contract checking - add more diagnostics
-    if (!periscope->active_contracts) {
-        fprintf(stderr, "WARNING: No active_contracts vector in periscope at %p - creating one\n", (void*)periscope);
-        
-        // Recovery: create the vector
-        periscope->active_contracts = braggi_vector_create(sizeof(RegionLifetimeContract*));
-        if (!periscope->active_contracts) {
-            fprintf(stderr, "ERROR: Failed to create active_contracts vector in recovery\n");
-            goto fallback_validation;
-        }
-        
-        // Recovery: create a fallback contract
-        RegionLifetimeContract* contract = malloc(sizeof(RegionLifetimeContract));
-        if (!contract) {
-            fprintf(stderr, "ERROR: Failed to allocate memory for fallback contract\n");
-            goto fallback_validation;
-        }
-        
-        // Initialize the fallback contract
-        contract->region_entity = 1;  // Default region ID 
-        contract->validator_entity = 1;  // Default validator ID
-        contract->guarantee_flags = 1;  // Basic guarantee flag
-        contract->is_valid = true;
-        
-        if (!braggi_vector_push_back(periscope->active_contracts, &contract)) {
-            fprintf(stderr, "ERROR: Failed to add fallback contract to active contracts\n");
-            free(contract);
-            goto fallback_validation;
-        }
-        
-        fprintf(stderr, "DEBUG: Created fallback contract as recovery at %p\n", (void*)contract);
-    }
-    
-    size_t contract_count = braggi_vector_size(periscope->active_contracts);
-    
-    // Don't just check if there are any contracts, check if they're valid
-    size_t valid_contracts = 0;
-    for (size_t i = 0; i < contract_count; i++) {
-        RegionLifetimeContract** contract_ptr = braggi_vector_get(periscope->active_contracts, i);
-        if (contract_ptr && *contract_ptr && (*contract_ptr)->is_valid) {
-            valid_contracts++;
-            
-            // Print details of valid contracts for debugging
-            fprintf(stderr, "DEBUG: Valid contract at %p, region=%u, validator=%u, flags=%u\n",
-                   (void*)*contract_ptr, (*contract_ptr)->region_entity, 
-                   (*contract_ptr)->validator_entity, (*contract_ptr)->guarantee_flags);
-        }
-    }
+    // One batched pass checks the contracts, and only after they change;
+    // every other constraint reuses the cached result
+    size_t contract_count = braggi_periscope_contract_count(periscope);
+    size_t valid_contracts = braggi_periscope_valid_contract_count(periscope);
     
     fprintf(stderr, "DEBUG: Periscope has %zu total contracts, %zu valid\n", 
             contract_count, valid_contracts);
@@ -561,34 +659,14 @@ bool braggi_periscope_validate_constraints(Periscope* periscope, EntropyConstrai
     if (valid_contracts == 0) {
         fprintf(stderr, "WARNING: No active valid contracts, creating one as last resort\n");
         
-        // Last resort: create an emergency contract 
-        RegionLifetimeContract* emergency_contract = malloc(sizeof(RegionLifetimeContract));
-        if (emergency_contract) {
-            // Initialize the emergency contract
-            emergency_contract->region_entity = 1;
-            emergency_contract->validator_entity = 1;
-            emergency_contract->guarantee_flags = 1;
-            emergency_contract->is_valid = true;
-            
-            if (braggi_vector_push_back(periscope->active_contracts, &emergency_contract)) {
-                fprintf(stderr, "DEBUG: Created emergency contract at %p\n", 
-                        (void*)emergency_contract);
-                valid_contracts = 1;
-            } else {
-                fprintf(stderr, "ERROR: Failed to add emergency contract\n");
-                free(emergency_contract);
-                goto fallback_validation;
-            }
+        if (braggi_periscope_create_contract(periscope, 1, 1, 1) == PERISCOPE_CONTRACT_INVALID) {
+            fprintf(stderr, "ERROR: Failed to add emergency contract\n");
+            goto fallback_validation;
         }
+        valid_contracts = 1;
     }
     
-    // If we still have valid contracts, use them for validation
-    if (valid_contracts > 0) {
-        fprintf(stderr, "DEBUG: Has active contracts, using periscope validator\n");
-    } else {
-        fprintf(stderr, "DEBUG: No active valid contracts, using validator directly\n");
-        goto fallback_validation;
-    }
+    fprintf(stderr, "DEBUG: Has active contracts, using periscope validator\n");
 
     // Check constraint type and apply appropriate validation
     switch (constraint->type) {
@@ -596,43 +674,12 @@ bool braggi_periscope_validate_constraints(Periscope* periscope, EntropyConstrai
             fprintf(stderr, "DEBUG: Processing syntax constraint with validator: %p\n", 
                     (void*)periscope->validator);
             
-            // For syntax constraints, check if they're allowed by any active contract
-            bool validated = false;
-            for (size_t i = 0; i < contract_count; i++) {
-                RegionLifetimeContract** contract_ptr = braggi_vector_get(periscope->active_contracts, i);
-                if (!contract_ptr || !*contract_ptr) continue;
-                
-                RegionLifetimeContract* contract = *contract_ptr;
-                if (!contract->is_valid) {
-                    fprintf(stderr, "DEBUG: Skipping invalid contract at index %zu\n", i);
-                    continue;
-                }
-                
-                fprintf(stderr, "DEBUG: Contract %zu: region=%u, validator=%u, flags=%u\n",
-                        i, contract->region_entity, contract->validator_entity, 
-                        contract->guarantee_flags);
-                
-                // This is where we'd check contract-specific validation logic
-                // For now we just count valid contracts
-                validated = true;
+            // At least one contract is in force, so it allows this
+            // constraint; the validator is still the final authority
+            if (periscope->validator) {
+                return periscope->validator(constraint, field);
             }
-            
-            if (validated) {
-                // We've checked and at least one contract allows this constraint
-                fprintf(stderr, "DEBUG: At least one contract validates this constraint\n");
-                
-                // We still use the validator as the final authority if we have one
-                if (periscope->validator) {
-                    return periscope->validator(constraint, field);
-                } else {
-                    return true; // Allow if we have a valid contract but no validator
-                }
-            } else {
-                fprintf(stderr, "DEBUG: No contracts validated this constraint\n");
-            }
-            
-            // Fallback to direct validation if no contracts validated
-            goto fallback_validation;
+            return true; // Allow if we have a valid contract but no validator
         }
         
         case CONSTRAINT_SEMANTIC:
@@ -693,7 +740,7 @@ static bool token_cell_mapping_compare(const void* a, const void* b) {
 }
 
 // Register a contract with the periscope
-bool braggi_periscope_register_contract(Periscope* periscope, void* contract) {
+bool braggi_periscope_register_contract(Periscope* periscope, const RegionLifetimeContract* contract) {
     if (!periscope) {
         DEBUG("Cannot register contract with NULL periscope");
         return false;
@@ -704,10 +751,16 @@ bool braggi_periscope_register_contract(Periscope* periscope, void* contract) {
         return false;
     }
     
-    // Store the contract in the vector
-    braggi_vector_push(periscope->active_contracts, contract);
+    // Copy the contract into the periscope's arrays
+    PeriscopeContractId id = contracts_add(&periscope->contracts, contract->region_entity,
+                                           contract->validator_entity, contract->guarantee_flags,
+                                           contract->is_valid);
+    if (id == PERISCOPE_CONTRACT_INVALID) {
+        ERROR("Failed to store contract %p in periscope", (const void*)contract);
+        return false;
+    }
     
-    DEBUG("Registered contract %p with periscope", contract);
+    DEBUG("Registered contract %p with periscope as %u", (const void*)contract, id);
     return true;
 }
 
@@ -732,8 +785,9 @@ bool braggi_periscope_register_tokens_batch(Periscope* periscope, Vector* tokens
         uint32_t cell_id = (uint32_t)i;  // Default to index in token stream
         
         // If the token has a valid position, use the line number
-        if (token->position.line > 0) {
-            cell_id = token->position.line;
+        SourcePosition position = braggi_token_get_position(token);
+        if (position.line > 0) {
+            cell_id = position.line;
         }
         
         if (braggi_periscope_register_token(periscope, token, cell_id)) {
@@ -0,0 +1,189 @@
+/*
+ * Braggi - Compiler Phase Report Implementation
+ *
+ * "Every minute on the trail gets wrote in the log book -
+ * that's how ya find out where the day went!" - Irish-Texan Drover Wisdom
+ */
+
+#include "braggi/phase_report.h"
+#include "braggi/region_manager.h"
+#include "braggi/region.h"
+#include "braggi/alloc_profile.h"
+
+#include <string.h>
+#include <time.h>
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define BRAGGI_HAVE_MALLINFO2 1
+#endif
+
+static const char* phase_names[PHASE_COUNT] = {
+    "source load",
+    "setup",
+    "tokenize",
+    "field init",
+    "constraints",
+    "propagate",
+    "ecs sync",
+    "codegen",
+    "emit"
+};
+
+static uint64_t clock_ns(clockid_t clock) {
+    struct timespec ts;
+    if (clock_gettime(clock, &ts) != 0) {
+        return 0;
+    }
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Bytes currently held by the C heap, 0 where the libc can't tell us
+static size_t heap_in_use(void) {
+#ifdef BRAGGI_HAVE_MALLINFO2
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+void braggi_phase_report_init(PhaseReport* report) {
+    if (!report) return;
+
+    memset(report, 0, sizeof(PhaseReport));
+    report->current = PHASE_COUNT;
+}
+
+void braggi_phase_report_set_regions(PhaseReport* report, RegionManager* regions) {
+    if (!report) return;
+    report->regions = regions;
+}
+
+void braggi_phase_report_begin(PhaseReport* report, PhaseId phase) {
+    if (!report || phase >= PHASE_COUNT) return;
+
+    if (report->current != PHASE_COUNT) {
+        braggi_phase_report_end(report);
+    }
+
+    report->current = phase;
+    report->start_heap = heap_in_use();
+    report->start_alloc_count = braggi_alloc_profile_thread_count;
+    report->start_alloc_bytes = braggi_alloc_profile_thread_bytes;
+    braggi_named_region_reset_peak();
+
+    // Read the clocks last so the sampling above isn't billed to the phase
+    report->start_cpu_ns = clock_ns(CLOCK_PROCESS_CPUTIME_ID);
+    report->start_wall_ns = clock_ns(CLOCK_MONOTONIC);
+}
+
+void braggi_phase_report_end(PhaseReport* report) {
+    if (!report || report->current == PHASE_COUNT) return;
+
+    uint64_t wall = clock_ns(CLOCK_MONOTONIC);
+    uint64_t cpu = clock_ns(CLOCK_PROCESS_CPUTIME_ID);
+
+    PhaseStats* stats = &report->phases[report->current];
+    stats->ran = true;
+    stats->wall_ns += wall - report->start_wall_ns;
+    stats->cpu_ns += cpu - report->start_cpu_ns;
+
+    size_t heap = heap_in_use();
+    stats->heap_delta += (int64_t)heap - (int64_t)report->start_heap;
+    stats->heap_in_use = heap;
+
+    // The compiler runs on one thread, so its allocations are this thread's
+    stats->alloc_count += braggi_alloc_profile_thread_count - report->start_alloc_count;
+    stats->alloc_bytes += braggi_alloc_profile_thread_bytes - report->start_alloc_bytes;
+
+    size_t arena_peak = 0;
+    braggi_named_region_totals(&stats->arena_in_use, &arena_peak);
+    if (arena_peak > stats->arena_peak) {
+        stats->arena_peak = arena_peak;
+    }
+
+    report->current = PHASE_COUNT;
+}
+
+const char* braggi_phase_name(PhaseId phase) {
+    if (phase >= PHASE_COUNT) return "unknown";
+    return phase_names[phase];
+}
+
+void braggi_phase_report_print_time(const PhaseReport* report, FILE* stream) {
+    if (!report || !stream) return;
+
+    uint64_t total_wall = 0;
+    uint64_t total_cpu = 0;
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        total_wall += report->phases[i].wall_ns;
+        total_cpu += report->phases[i].cpu_ns;
+    }
+
+    fprintf(stream, "===== TIME REPORT =====\n");
+    fprintf(stream, "%-14s %12s %12s %8s\n", "Phase", "Wall (ms)", "CPU (ms)", "Wall %");
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        const PhaseStats* stats = &report->phases[i];
+        if (!stats->ran) continue;
+
+        double share = total_wall ? 100.0 * (double)stats->wall_ns / (double)total_wall : 0.0;
+        fprintf(stream, "%-14s %12.3f %12.3f %7.1f%%\n",
+                phase_names[i], stats->wall_ns / 1e6, stats->cpu_ns / 1e6, share);
+    }
+    fprintf(stream, "%-14s %12.3f %12.3f\n", "total", total_wall / 1e6, total_cpu / 1e6);
+}
+
+void braggi_phase_report_print_mem(const PhaseReport* report, FILE* stream) {
+    if (!report || !stream) return;
+
+    fprintf(stream, "===== MEMORY REPORT =====\n");
+    fprintf(stream, "%-14s %10s %12s %12s %12s %12s %12s\n", "Phase", "Allocs", "Alloc bytes",
+            "Heap delta", "Heap", "Arena", "Arena peak");
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        const PhaseStats* stats = &report->phases[i];
+        if (!stats->ran) continue;
+
+        fprintf(stream, "%-14s %10llu %12llu %+12lld %12zu %12zu %12zu\n", phase_names[i],
+                (unsigned long long)stats->alloc_count, (unsigned long long)stats->alloc_bytes,
+                (long long)stats->heap_delta, stats->heap_in_use,
+                stats->arena_in_use, stats->arena_peak);
+    }
+#ifndef BRAGGI_HAVE_MALLINFO2
+    fprintf(stream, "(heap figures unavailable on this platform)\n");
+#endif
+
+    if (report->regions) {
+        fprintf(stream, "\n");
+        braggi_region_manager_print_stats(report->regions, stream);
+    }
+}
+
+void braggi_phase_report_write_json(const PhaseReport* report, FILE* stream,
+                                    bool include_time, bool include_mem) {
+    if (!report || !stream) return;
+
+    fprintf(stream, "{\n  \"phases\": [");
+    bool first = true;
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        const PhaseStats* stats = &report->phases[i];
+        if (!stats->ran) continue;
+
+        fprintf(stream, "%s\n    {\"name\": \"%s\"", first ? "" : ",", phase_names[i]);
+        if (include_time) {
+            fprintf(stream, ", \"wall_ns\": %llu, \"cpu_ns\": %llu",
+                    (unsigned long long)stats->wall_ns, (unsigned long long)stats->cpu_ns);
+        }
+        if (include_mem) {
+            fprintf(stream, ", \"heap_delta\": %lld, \"heap_in_use\": %zu"
+                    ", \"alloc_count\": %llu, \"alloc_bytes\": %llu"
+                    ", \"arena_in_use\": %zu, \"arena_peak\": %zu",
+                    (long long)stats->heap_delta, stats->heap_in_use,
+                    (unsigned long long)stats->alloc_count, (unsigned long long)stats->alloc_bytes,
+                    stats->arena_in_use, stats->arena_peak);
+        }
+        fprintf(stream, "}");
+        first = false;
+    }
+    fprintf(stream, "\n  ]\n}\n");
+}
@@ -7,15 +7,30 @@
 
 #include "braggi/region.h"
 #include "braggi/allocation.h"
+#include "braggi/alloc_profile.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdatomic.h>
 
 // Define aliases for the utility memory region functions to distinguish from our high-level functions
 #define util_region_alloc(region, size) braggi_region_alloc((region), (size))
 #define util_region_calloc(region, count, size) braggi_region_calloc((region), (count), (size))
 #define util_region_strdup(region, str) braggi_region_strdup((region), (str))
 
+/* Bytes held by every live region, and the most held since the peak was reset */
+static _Atomic size_t regions_in_use = 0;
+static _Atomic size_t regions_peak = 0;
+
+static void regions_grow(size_t size) {
+    size_t now = atomic_fetch_add_explicit(&regions_in_use, size, memory_order_relaxed) + size;
+    size_t peak = atomic_load_explicit(&regions_peak, memory_order_relaxed);
+    while (now > peak &&
+           !atomic_compare_exchange_weak_explicit(&regions_peak, &peak, now,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
 /* Region type enumeration */
 typedef enum {
     REGION_TYPE_NORMAL,        /* Standard region */
@@ -308,6 +323,8 @@ Region* braggi_mem_region_create_with_allocator(const char* name, RegimeType reg
 void braggi_mem_region_destroy(Region* region) {
     if (!region) return;
     
+    atomic_fetch_sub_explicit(&regions_in_use, braggi_named_region_used(region), memory_order_relaxed);
+    
     // If using a memory region allocator, we don't need to free individual allocations
     if (region->memory_region) {
         // For non-memory region objects inside allocations, we still need to free them
@@ -436,6 +453,12 @@ void* braggi_mem_region_alloc(Region* region, size_t size, SourcePosition source
             return NULL;
     }
     
+    if (ptr) {
+        regions_grow(size);
+        braggi_alloc_profile_note(region->id, region->name, size,
+                                  source_pos.line, source_pos.column, label);
+    }
+    
     return ptr;
 }
 
@@ -676,6 +699,16 @@ size_t braggi_named_region_available(Region* region) {
     return (1024 * 1024) - total_allocated;  // 1MB arbitrary limit
 }
 
+void braggi_named_region_totals(size_t* in_use, size_t* peak) {
+    if (in_use) *in_use = atomic_load_explicit(&regions_in_use, memory_order_relaxed);
+    if (peak) *peak = atomic_load_explicit(&regions_peak, memory_order_relaxed);
+}
+
+void braggi_named_region_reset_peak(void) {
+    atomic_store_explicit(&regions_peak, atomic_load_explicit(&regions_in_use, memory_order_relaxed),
+                          memory_order_relaxed);
+}
+
 size_t braggi_named_region_used(Region* region) {
     if (!region) {
         return 0;
@@ -700,6 +733,14 @@ RegimeType braggi_named_region_regime(Region* region) {
     return region->regime;
 }
 
+const char* braggi_named_region_name(Region* region) {
+    if (!region) {
+        return NULL;
+    }
+    
+    return region->name;
+}
+
 RegionId braggi_named_region_id(Region* region) {
     if (!region) {
         return 0;
@@ -140,6 +140,61 @@ void braggi_region_manager_get_stats(RegionManager* manager, size_t* total, size
         return;
     }
     
+    // Refresh from the regions themselves so the numbers are never stale
+    size_t in_use = 0;
+    if (manager->global_region) {
+        in_use += braggi_named_region_used(manager->global_region);
+    }
+    if (manager->regions) {
+        for (size_t i = 0; i < braggi_vector_size(manager->regions); i++) {
+            Region* region = *(Region**)braggi_vector_get(manager->regions, i);
+            if (region && region != manager->global_region) {
+                in_use += braggi_named_region_used(region);
+            }
+        }
+    }
+    
+    manager->total_allocation = in_use;
+    if (in_use > manager->peak_allocation) {
+        manager->peak_allocation = in_use;
+    }
+    
     if (total) *total = manager->total_allocation;
     if (peak) *peak = manager->peak_allocation;
+}
+
+/*
+ * Print per-region memory usage
+ * 
+ * "A head count's only useful if ya write down which pasture
+ * each cow's standin' in!"
+ */
+void braggi_region_manager_print_stats(RegionManager* manager, FILE* stream) {
+    if (!manager || !stream) {
+        return;
+    }
+    
+    size_t total = 0;
+    braggi_region_manager_get_stats(manager, &total, NULL);
+    
+    fprintf(stream, "%-24s %-10s %12s\n", "Region", "Regime", "Used");
+    if (manager->global_region) {
+        fprintf(stream, "%-24s %-10s %12zu\n",
+                braggi_named_region_name(manager->global_region),
+                braggi_mem_regime_name(braggi_named_region_regime(manager->global_region)),
+                braggi_named_region_used(manager->global_region));
+    }
+    if (manager->regions) {
+        for (size_t i = 0; i < braggi_vector_size(manager->regions); i++) {
+            Region* region = *(Region**)braggi_vector_get(manager->regions, i);
+            if (!region || region == manager->global_region) {
+                continue;
+            }
+            fprintf(stream, "%-24s %-10s %12zu\n",
+                    braggi_named_region_name(region),
+                    braggi_mem_regime_name(braggi_named_region_regime(region)),
+                    braggi_named_region_used(region));
+        }
+    }
+    fprintf(stream, "Total: %zu bytes\n", total);
 } 
\ No newline at end of file
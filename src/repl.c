@@ -9,10 +9,14 @@
 #include "braggi/source.h"
 #include "braggi/braggi_context.h"
 #include "braggi/stdlib.h"  // Include the stdlib header
+#include "braggi/repl_session.h"
+#include "braggi/module_cache.h"
+#include "braggi/rt_io.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <errno.h>
 
 #ifdef HAVE_READLINE
 #include <readline/readline.h>
@@ -42,6 +46,9 @@ static void handle_special_command(const char* cmd, BraggiContext* context);
 // Global context for the REPL session
 static BraggiContext* g_repl_context = NULL;
 
+// Persistent evaluation state - definitions live here between lines
+static ReplSession* g_repl_session = NULL;
+
 int main(void) {
     char* input;
     bool should_exit = false;
@@ -58,13 +65,20 @@ int main(void) {
         fprintf(stderr, "Failed to initialize standard library. Continuing anyway.\n");
     }
     
+    g_repl_session = braggi_repl_session_create();
+    if (!g_repl_session) {
+        fprintf(stderr, "Failed to create REPL session. Exiting.\n");
+        braggi_context_destroy(g_repl_context);
+        return 1;
+    }
+    
     // Display welcome message
     printf("%s\n", WELCOME_MESSAGE);
     
     // Main REPL loop
     while (!should_exit) {
-        // Get user input
-        input = get_input("braggi> ");
+        // Get user input - a different prompt while a block is still open
+        input = get_input(braggi_repl_session_needs_more(g_repl_session) ? "   ...> " : "braggi> ");
         
         // Check for EOF
         if (!input) {
@@ -79,6 +93,9 @@ int main(void) {
         free(input);
     }
     
+    braggi_repl_session_destroy(g_repl_session);
+    g_repl_session = NULL;
+    
     // Clean up the standard library
     braggi_stdlib_cleanup(g_repl_context);
     
@@ -91,6 +108,9 @@ int main(void) {
 
 // Get input from user, using readline if available
 static char* get_input(const char* prompt) {
+    // Anything the last line printed through the runtime comes before the prompt
+    braggi_io_sync(stdout);
+    
 #ifdef HAVE_READLINE
     char* input = readline(prompt);
     if (input && *input) {
@@ -172,11 +192,13 @@ static char* get_input(const char* prompt) {
 static void print_help(void) {
     printf("\nAvailable commands:\n");
     printf("  help, ?            Show this help message\n");
-    printf("  :source <filename> Load a source file (not implemented yet)\n");
+    printf("  :source <filename> Load and run a source file in this session\n");
     printf("  :import <module>   Import a standard library module\n");
+    printf("  :symbols           List variables and functions defined so far\n");
+    printf("  :reset             Forget everything defined in this session\n");
     printf("  exit, quit, q      Exit the REPL\n");
-    printf("\nAny other input will be processed as Braggi code.\n");
-    printf("(Actual interpretation not implemented yet)\n\n");
+    printf("\nAny other input is evaluated as Braggi code. Definitions persist\n");
+    printf("between lines, and blocks can span several lines.\n\n");
 }
 
 // Handle special commands starting with ':'
@@ -188,17 +210,39 @@ static void handle_special_command(const char* cmd, BraggiContext* context) {
         } else {
             filename = cmd + 5;
         }
-        printf("Would load source file: %s (not implemented yet)\n", filename);
+        FILE* file = fopen(filename, "r");
+        if (!file) {
+            printf("Error: Could not open file: %s\n", filename);
+            return;
+        }
+        
+        // Feed the file a line at a time, same as if it were typed in
+        char line[MAX_INPUT_LENGTH];
+        while (fgets(line, sizeof(line), file)) {
+            line[strcspn(line, "\r\n")] = '\0';
+            braggi_repl_session_eval(g_repl_session, line, stdout);
+        }
+        fclose(file);
     } else if (strncmp(cmd, "import ", 7) == 0) {
         const char* module = cmd + 7;
         printf("Importing module: %s\n", module);
         
-        // Try to load the module
+        // Try to load the module; cached modules bring their definitions along
         if (braggi_stdlib_load_module(context, module)) {
+            const BraggiModule* loaded = braggi_module_find_loaded(module);
+            if (loaded) {
+                size_t defined = braggi_repl_session_import(g_repl_session, loaded, stdout);
+                printf("Defined %zu of %zu exports\n", defined, braggi_module_export_count(loaded));
+            }
             printf("Successfully imported module: %s\n", module);
         } else {
             printf("Error: Failed to import module: %s\n", module);
         }
+    } else if (strcmp(cmd, "symbols") == 0) {
+        braggi_repl_session_print_symbols(g_repl_session, stdout);
+    } else if (strcmp(cmd, "reset") == 0) {
+        braggi_repl_session_reset(g_repl_session);
+        printf("Session reset.\n");
     } else {
         printf("Unknown command: :%s\n", cmd);
     }
@@ -231,28 +275,10 @@ static void process_command(const char* input, bool* should_exit) {
         return;
     }
     
-    // Process as Braggi code
-    if (g_repl_context) {
-        // Create a source from the input string
-        size_t input_length = strlen(input);
-        Source* source = braggi_source_from_string("repl_input", input, input_length);
-        
-        if (source) {
-            // Execute the code (placeholder - real execution would be here)
-            printf("Processing code: %s\n", input);
-            printf("Source has %u lines\n", braggi_source_file_get_line_count(source));
-            
-            // In the future, replace with actual execution
-            // if (braggi_execute(context, source)) {
-            //     printf("Execution successful.\n");
-            // }
-            
-            // Clean up
-            braggi_source_file_destroy(source);
-        } else {
-            printf("Failed to create source from input.\n");
-        }
+    // Evaluate against the persistent session - only this line gets tokenized
+    if (g_repl_session) {
+        braggi_repl_session_eval(g_repl_session, input, stdout);
     } else {
-        printf("Failed to create Braggi context.\n");
+        printf("No REPL session available.\n");
     }
-} 
\ No newline at end of file
+}
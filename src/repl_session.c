@@ -0,0 +1,1084 @@
+/*
+ * Braggi - REPL Session Engine Implementation
+ *
+ * "Don't go re-ploughin' the whole field every time ya plant one row!"
+ * - Texan Farming Wisdom
+ *
+ * The session keeps everything a REPL needs between lines: the token
+ * stream (each line is tokenized once and appended), the global bindings
+ * and the function definitions. A small token-walking evaluator runs
+ * statements in-process straight off the accumulated token stream, so
+ * calling a function defined ten lines ago never re-tokenizes it.
+ * Imported modules join the stream straight from their cached token
+ * arrays.
+ *
+ * The evaluator is the REPL's own. It doesn't run lines through the
+ * compiler's symbol table, entropy field or code generator, so it
+ * covers expressions, bindings, control flow and functions, not the
+ * whole language; anything else is reported as unsupported. Numbers
+ * print the way io.print writes them.
+ */
+
+#include "braggi/repl_session.h"
+#include "braggi/source.h"
+#include "braggi/token.h"
+#include "braggi/module_cache.h"
+#include "braggi/rt_io.h"
+#include "braggi/util/vector.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <inttypes.h>
+
+// Deepest call chain before we call it runaway recursion
+#define REPL_MAX_CALL_DEPTH 256
+
+// Named value in a scope
+typedef struct ReplBinding {
+    char* name;
+    ReplValue value;
+} ReplBinding;
+
+// A function defined at the prompt; its body stays in the token stream
+typedef struct ReplFunction {
+    char* name;
+    Vector* params;              // char* parameter names
+    size_t body_start;           // Index of the opening '{'
+    size_t body_end;             // Index one past the closing '}'
+} ReplFunction;
+
+struct ReplSession {
+    Vector* tokens;              // Token* across every input (owned)
+    Vector* globals;             // ReplBinding
+    Vector* locals;              // ReplBinding, stacked per call frame
+    Vector* functions;           // ReplFunction*
+    Vector* strings;             // Interned char* (owned)
+    char* pending;               // Partial input waiting for a closing brace
+    size_t input_count;          // Number of inputs evaluated
+};
+
+// Evaluator state for one run over a token range
+typedef struct ReplEval {
+    ReplSession* session;
+    FILE* out;
+    size_t pos;                  // Current token index
+    size_t end;                  // One past the last token of the range
+    size_t frame_base;           // First local belonging to the current call
+    unsigned call_depth;
+    bool failed;
+    bool returning;              // A 'return' is unwinding the current call
+    ReplValue return_value;
+    bool top_level;              // Expression statements echo their value
+} ReplEval;
+
+static void eval_statement(ReplEval* e, bool live);
+static ReplValue eval_expression(ReplEval* e, bool live);
+
+/* ---------------------------------------------------------------------
+ * Small helpers
+ * ------------------------------------------------------------------- */
+
+static const ReplValue none_value = { .kind = REPL_VALUE_NONE };
+
+static void eval_error(ReplEval* e, const char* fmt, ...) {
+    if (e->failed) return;
+    e->failed = true;
+
+    va_list args;
+    va_start(args, fmt);
+    fprintf(e->out, "Error: ");
+    vfprintf(e->out, fmt, args);
+    fprintf(e->out, "\n");
+    va_end(args);
+}
+
+static Token* token_at(ReplSession* session, size_t index) {
+    return *(Token**)braggi_vector_get(session->tokens, index);
+}
+
+static Token* peek(ReplEval* e) {
+    if (e->pos >= e->end) return NULL;
+    return token_at(e->session, e->pos);
+}
+
+static bool token_is(Token* token, TokenType type, const char* text) {
+    return token && token->type == type && token->text && strcmp(token->text, text) == 0;
+}
+
+static bool peek_punct(ReplEval* e, const char* text) {
+    return token_is(peek(e), TOKEN_PUNCTUATION, text);
+}
+
+static bool peek_op(ReplEval* e, const char* text) {
+    return token_is(peek(e), TOKEN_OPERATOR, text);
+}
+
+static bool peek_keyword(ReplEval* e, const char* text) {
+    return token_is(peek(e), TOKEN_KEYWORD, text);
+}
+
+static bool expect_punct(ReplEval* e, const char* text) {
+    if (!peek_punct(e, text)) {
+        Token* token = peek(e);
+        eval_error(e, "expected '%s' but found '%s'", text,
+                   token && token->text ? token->text : "end of input");
+        return false;
+    }
+    e->pos++;
+    return true;
+}
+
+static const char* intern_string(ReplSession* session, char* owned) {
+    if (!owned) return NULL;
+    if (!braggi_vector_push_back(session->strings, &owned)) {
+        free(owned);
+        return NULL;
+    }
+    return owned;
+}
+
+static double as_float(ReplValue value) {
+    switch (value.kind) {
+        case REPL_VALUE_INT: return (double)value.int_value;
+        case REPL_VALUE_FLOAT: return value.float_value;
+        case REPL_VALUE_BOOL: return value.bool_value ? 1.0 : 0.0;
+        default: return 0.0;
+    }
+}
+
+static bool truthy(ReplValue value) {
+    switch (value.kind) {
+        case REPL_VALUE_INT: return value.int_value != 0;
+        case REPL_VALUE_FLOAT: return value.float_value != 0.0;
+        case REPL_VALUE_BOOL: return value.bool_value;
+        case REPL_VALUE_STRING: return value.string_value && value.string_value[0];
+        default: return false;
+    }
+}
+
+static ReplValue make_int(int64_t v) {
+    ReplValue value = { .kind = REPL_VALUE_INT };
+    value.int_value = v;
+    return value;
+}
+
+static ReplValue make_float(double v) {
+    ReplValue value = { .kind = REPL_VALUE_FLOAT };
+    value.float_value = v;
+    return value;
+}
+
+static ReplValue make_bool(bool v) {
+    ReplValue value = { .kind = REPL_VALUE_BOOL };
+    value.bool_value = v;
+    return value;
+}
+
+static void print_value(FILE* out, ReplValue value) {
+    switch (value.kind) {
+        case REPL_VALUE_INT: fprintf(out, "%" PRId64, value.int_value); break;
+        case REPL_VALUE_FLOAT: {
+            // Same digits io.print would write
+            char text[BRAGGI_IO_NUMBER_MAX];
+            fwrite(text, 1, braggi_io_format_f64(value.float_value, text), out);
+            break;
+        }
+        case REPL_VALUE_BOOL: fprintf(out, "%s", value.bool_value ? "true" : "false"); break;
+        case REPL_VALUE_STRING: fprintf(out, "%s", value.string_value ? value.string_value : ""); break;
+        default: break;
+    }
+}
+
+/* ---------------------------------------------------------------------
+ * Bindings and functions
+ * ------------------------------------------------------------------- */
+
+static ReplBinding* find_binding(ReplEval* e, const char* name) {
+    ReplSession* s = e->session;
+
+    // Innermost call frame first, then globals
+    for (size_t i = braggi_vector_size(s->locals); i > e->frame_base; i--) {
+        ReplBinding* binding = (ReplBinding*)braggi_vector_get(s->locals, i - 1);
+        if (strcmp(binding->name, name) == 0) return binding;
+    }
+
+    for (size_t i = 0; i < braggi_vector_size(s->globals); i++) {
+        ReplBinding* binding = (ReplBinding*)braggi_vector_get(s->globals, i);
+        if (strcmp(binding->name, name) == 0) return binding;
+    }
+
+    return NULL;
+}
+
+static bool define_binding(ReplEval* e, const char* name, ReplValue value) {
+    ReplSession* s = e->session;
+    bool in_call = e->call_depth > 0;
+    Vector* scope = in_call ? s->locals : s->globals;
+    size_t start = in_call ? e->frame_base : 0;
+
+    // Redefinition at the prompt just replaces the old value
+    for (size_t i = start; i < braggi_vector_size(scope); i++) {
+        ReplBinding* binding = (ReplBinding*)braggi_vector_get(scope, i);
+        if (strcmp(binding->name, name) == 0) {
+            binding->value = value;
+            return true;
+        }
+    }
+
+    ReplBinding binding;
+    binding.name = strdup(name);
+    binding.value = value;
+    if (!binding.name || !braggi_vector_push_back(scope, &binding)) {
+        free(binding.name);
+        return false;
+    }
+    return true;
+}
+
+static void pop_locals(ReplSession* session, size_t new_size) {
+    while (braggi_vector_size(session->locals) > new_size) {
+        ReplBinding* binding = (ReplBinding*)braggi_vector_get(session->locals,
+                                                               braggi_vector_size(session->locals) - 1);
+        free(binding->name);
+        braggi_vector_pop_back(session->locals, NULL);
+    }
+}
+
+static ReplFunction* find_function(ReplSession* session, const char* name) {
+    for (size_t i = 0; i < braggi_vector_size(session->functions); i++) {
+        ReplFunction* fn = *(ReplFunction**)braggi_vector_get(session->functions, i);
+        if (strcmp(fn->name, name) == 0) return fn;
+    }
+    return NULL;
+}
+
+static void destroy_function(ReplFunction* fn) {
+    if (!fn) return;
+
+    for (size_t i = 0; i < braggi_vector_size(fn->params); i++) {
+        free(*(char**)braggi_vector_get(fn->params, i));
+    }
+    braggi_vector_destroy(fn->params);
+    free(fn->name);
+    free(fn);
+}
+
+/* ---------------------------------------------------------------------
+ * Expressions
+ * ------------------------------------------------------------------- */
+
+static ReplValue call_function(ReplEval* e, ReplFunction* fn, ReplValue* args, size_t arg_count) {
+    if (arg_count != braggi_vector_size(fn->params)) {
+        eval_error(e, "%s expects %zu argument(s), got %zu", fn->name,
+                   braggi_vector_size(fn->params), arg_count);
+        return none_value;
+    }
+    if (e->call_depth >= REPL_MAX_CALL_DEPTH) {
+        eval_error(e, "call depth limit reached in %s", fn->name);
+        return none_value;
+    }
+
+    ReplSession* s = e->session;
+
+    // Fresh frame on top of the locals stack
+    ReplEval frame = *e;
+    frame.pos = fn->body_start;
+    frame.end = fn->body_end;
+    frame.frame_base = braggi_vector_size(s->locals);
+    frame.call_depth = e->call_depth + 1;
+    frame.returning = false;
+    frame.return_value = none_value;
+    frame.top_level = false;
+
+    for (size_t i = 0; i < arg_count; i++) {
+        ReplBinding binding;
+        binding.name = strdup(*(char**)braggi_vector_get(fn->params, i));
+        binding.value = args[i];
+        if (!binding.name || !braggi_vector_push_back(s->locals, &binding)) {
+            free(binding.name);
+            pop_locals(s, frame.frame_base);
+            eval_error(e, "out of memory calling %s", fn->name);
+            return none_value;
+        }
+    }
+
+    eval_statement(&frame, true);
+
+    pop_locals(s, frame.frame_base);
+
+    if (frame.failed) {
+        e->failed = true;
+        return none_value;
+    }
+    return frame.return_value;
+}
+
+static ReplValue eval_primary(ReplEval* e, bool live) {
+    Token* token = peek(e);
+    if (!token) {
+        eval_error(e, "unexpected end of input in expression");
+        return none_value;
+    }
+
+    if (token->type == TOKEN_LITERAL_INT) {
+        e->pos++;
+        return make_int(strtoll(token->text, NULL, 0));
+    }
+
+    if (token->type == TOKEN_LITERAL_FLOAT) {
+        e->pos++;
+        return make_float(strtod(token->text, NULL));
+    }
+
+    if (token->type == TOKEN_LITERAL_STRING || token->type == TOKEN_LITERAL_CHAR) {
+        e->pos++;
+        ReplValue value = { .kind = REPL_VALUE_STRING };
+        value.string_value = token->string_value ? token->string_value : token->text;
+        return value;
+    }
+
+    if (token_is(token, TOKEN_KEYWORD, "true") || token_is(token, TOKEN_KEYWORD, "false")) {
+        e->pos++;
+        return make_bool(token->text[0] == 't');
+    }
+
+    if (token_is(token, TOKEN_PUNCTUATION, "(")) {
+        e->pos++;
+        ReplValue value = eval_expression(e, live);
+        expect_punct(e, ")");
+        return value;
+    }
+
+    if (token->type == TOKEN_IDENTIFIER) {
+        const char* name = token->text;
+        e->pos++;
+
+        // Function call
+        if (peek_punct(e, "(")) {
+            e->pos++;
+            ReplValue args[16];
+            size_t arg_count = 0;
+
+            while (!e->failed && !peek_punct(e, ")")) {
+                ReplValue arg = eval_expression(e, live);
+                if (arg_count < sizeof(args) / sizeof(args[0])) {
+                    args[arg_count] = arg;
+                }
+                arg_count++;
+                if (!peek_punct(e, ",")) break;
+                e->pos++;
+            }
+            if (!expect_punct(e, ")") || !live) return none_value;
+
+            ReplFunction* fn = find_function(e->session, name);
+            if (!fn) {
+                eval_error(e, "undefined function '%s'", name);
+                return none_value;
+            }
+            if (arg_count > sizeof(args) / sizeof(args[0])) {
+                eval_error(e, "too many arguments to '%s'", name);
+                return none_value;
+            }
+            return call_function(e, fn, args, arg_count);
+        }
+
+        if (!live) return none_value;
+
+        ReplBinding* binding = find_binding(e, name);
+        if (!binding) {
+            eval_error(e, "undefined variable '%s'", name);
+            return none_value;
+        }
+        return binding->value;
+    }
+
+    eval_error(e, "unexpected '%s' in expression", token->text ? token->text : "?");
+    return none_value;
+}
+
+static ReplValue eval_unary(ReplEval* e, bool live) {
+    if (peek_op(e, "-")) {
+        e->pos++;
+        ReplValue value = eval_unary(e, live);
+        if (value.kind == REPL_VALUE_INT) return make_int(-value.int_value);
+        if (value.kind == REPL_VALUE_FLOAT) return make_float(-value.float_value);
+        if (live) eval_error(e, "cannot negate a non-number");
+        return none_value;
+    }
+
+    if (peek_op(e, "!")) {
+        e->pos++;
+        ReplValue value = eval_unary(e, live);
+        return make_bool(!truthy(value));
+    }
+
+    return eval_primary(e, live);
+}
+
+static ReplValue arithmetic(ReplEval* e, const char* op, ReplValue a, ReplValue b, bool live) {
+    if (!live) return none_value;
+
+    // String concatenation
+    if (op[0] == '+' && a.kind == REPL_VALUE_STRING && b.kind == REPL_VALUE_STRING) {
+        size_t la = strlen(a.string_value), lb = strlen(b.string_value);
+        char* joined = (char*)malloc(la + lb + 1);
+        if (!joined) {
+            eval_error(e, "out of memory");
+            return none_value;
+        }
+        memcpy(joined, a.string_value, la);
+        memcpy(joined + la, b.string_value, lb + 1);
+
+        ReplValue value = { .kind = REPL_VALUE_STRING };
+        value.string_value = intern_string(e->session, joined);
+        return value;
+    }
+
+    if (a.kind == REPL_VALUE_STRING || b.kind == REPL_VALUE_STRING ||
+        a.kind == REPL_VALUE_NONE || b.kind == REPL_VALUE_NONE) {
+        eval_error(e, "operator '%s' needs numbers", op);
+        return none_value;
+    }
+
+    if (a.kind == REPL_VALUE_FLOAT || b.kind == REPL_VALUE_FLOAT) {
+        double x = as_float(a), y = as_float(b);
+        switch (op[0]) {
+            case '+': return make_float(x + y);
+            case '-': return make_float(x - y);
+            case '*': return make_float(x * y);
+            case '/': return make_float(x / y);
+            default: break;
+        }
+        eval_error(e, "operator '%s' not supported on floats", op);
+        return none_value;
+    }
+
+    int64_t x = a.int_value, y = b.int_value;
+    if ((op[0] == '/' || op[0] == '%') && y == 0) {
+        eval_error(e, "division by zero");
+        return none_value;
+    }
+    switch (op[0]) {
+        case '+': return make_int(x + y);
+        case '-': return make_int(x - y);
+        case '*': return make_int(x * y);
+        case '/': return make_int(x / y);
+        case '%': return make_int(x % y);
+        default: break;
+    }
+    return none_value;
+}
+
+static ReplValue eval_term(ReplEval* e, bool live) {
+    ReplValue value = eval_unary(e, live);
+    while (!e->failed && (peek_op(e, "*") || peek_op(e, "/") || peek_op(e, "%"))) {
+        const char* op = peek(e)->text;
+        e->pos++;
+        ReplValue rhs = eval_unary(e, live);
+        value = arithmetic(e, op, value, rhs, live);
+    }
+    return value;
+}
+
+static ReplValue eval_sum(ReplEval* e, bool live) {
+    ReplValue value = eval_term(e, live);
+    while (!e->failed && (peek_op(e, "+") || peek_op(e, "-"))) {
+        const char* op = peek(e)->text;
+        e->pos++;
+        ReplValue rhs = eval_term(e, live);
+        value = arithmetic(e, op, value, rhs, live);
+    }
+    return value;
+}
+
+static ReplValue eval_comparison(ReplEval* e, bool live) {
+    ReplValue value = eval_sum(e, live);
+
+    while (!e->failed) {
+        Token* token = peek(e);
+        if (!token || token->type != TOKEN_OPERATOR) break;
+
+        const char* op = token->text;
+        if (strcmp(op, "==") && strcmp(op, "!=") && strcmp(op, "<") &&
+            strcmp(op, ">") && strcmp(op, "<=") && strcmp(op, ">=")) {
+            break;
+        }
+        e->pos++;
+
+        ReplValue rhs = eval_sum(e, live);
+        if (!live) continue;
+
+        int cmp;
+        if (value.kind == REPL_VALUE_STRING && rhs.kind == REPL_VALUE_STRING) {
+            cmp = strcmp(value.string_value, rhs.string_value);
+        } else {
+            double x = as_float(value), y = as_float(rhs);
+            cmp = (x > y) - (x < y);
+        }
+
+        bool result = false;
+        if (strcmp(op, "==") == 0) result = cmp == 0;
+        else if (strcmp(op, "!=") == 0) result = cmp != 0;
+        else if (strcmp(op, "<") == 0) result = cmp < 0;
+        else if (strcmp(op, ">") == 0) result = cmp > 0;
+        else if (strcmp(op, "<=") == 0) result = cmp <= 0;
+        else result = cmp >= 0;
+        value = make_bool(result);
+    }
+
+    return value;
+}
+
+static ReplValue eval_expression(ReplEval* e, bool live) {
+    ReplValue value = eval_comparison(e, live);
+
+    while (!e->failed && (peek_op(e, "&&") || peek_op(e, "||"))) {
+        bool is_and = peek(e)->text[0] == '&';
+        e->pos++;
+
+        // Short-circuit: the right side is parsed but only run if it matters
+        bool lhs = truthy(value);
+        bool need_rhs = live && (is_and ? lhs : !lhs);
+        ReplValue rhs = eval_comparison(e, need_rhs);
+        if (live) {
+            value = make_bool(need_rhs ? truthy(rhs) : lhs);
+        }
+    }
+
+    return value;
+}
+
+/* ---------------------------------------------------------------------
+ * Statements
+ * ------------------------------------------------------------------- */
+
+static void skip_semicolon(ReplEval* e) {
+    if (peek_punct(e, ";")) e->pos++;
+}
+
+// Skip a type annotation after ':' or '->' up to one of the stop tokens
+static void skip_type(ReplEval* e) {
+    int depth = 0;
+    while (peek(e)) {
+        if (depth == 0 && (peek_op(e, "=") || peek_punct(e, ",") || peek_punct(e, ")") ||
+                           peek_punct(e, "{") || peek_punct(e, ";"))) {
+            break;
+        }
+        if (peek_punct(e, "[") || peek_op(e, "<")) depth++;
+        if (peek_punct(e, "]") || peek_op(e, ">")) depth--;
+        e->pos++;
+    }
+}
+
+static void eval_block(ReplEval* e, bool live) {
+    if (!expect_punct(e, "{")) return;
+
+    while (!e->failed && peek(e) && !peek_punct(e, "}")) {
+        eval_statement(e, live && !e->returning);
+    }
+    expect_punct(e, "}");
+}
+
+static void eval_function_decl(ReplEval* e, bool live) {
+    e->pos++;  // fn / func
+
+    Token* name = peek(e);
+    if (!name || name->type != TOKEN_IDENTIFIER) {
+        eval_error(e, "expected function name");
+        return;
+    }
+    e->pos++;
+
+    if (!expect_punct(e, "(")) return;
+
+    Vector* params = braggi_vector_create(sizeof(char*));
+    if (!params) {
+        eval_error(e, "out of memory");
+        return;
+    }
+
+    while (!e->failed && peek(e) && !peek_punct(e, ")")) {
+        Token* param = peek(e);
+        if (param->type != TOKEN_IDENTIFIER) {
+            eval_error(e, "expected parameter name in %s", name->text);
+            break;
+        }
+        char* param_name = strdup(param->text);
+        if (param_name) braggi_vector_push_back(params, &param_name);
+        e->pos++;
+
+        if (peek_op(e, ":")) {
+            e->pos++;
+            skip_type(e);
+        }
+        if (!peek_punct(e, ",")) break;
+        e->pos++;
+    }
+
+    ReplFunction* fn = NULL;
+    if (!e->failed && expect_punct(e, ")")) {
+        if (peek_op(e, "->")) {
+            e->pos++;
+            skip_type(e);
+        }
+
+        size_t body_start = e->pos;
+        eval_block(e, false);
+
+        if (!e->failed && live) {
+            fn = (ReplFunction*)calloc(1, sizeof(ReplFunction));
+            if (fn) {
+                fn->name = strdup(name->text);
+                fn->params = params;
+                fn->body_start = body_start;
+                fn->body_end = e->pos;
+            }
+        }
+    }
+
+    if (!fn) {
+        for (size_t i = 0; i < braggi_vector_size(params); i++) {
+            free(*(char**)braggi_vector_get(params, i));
+        }
+        braggi_vector_destroy(params);
+        return;
+    }
+
+    // Redefinition replaces the old one in place
+    ReplSession* s = e->session;
+    for (size_t i = 0; i < braggi_vector_size(s->functions); i++) {
+        ReplFunction** slot = (ReplFunction**)braggi_vector_get(s->functions, i);
+        if (strcmp((*slot)->name, fn->name) == 0) {
+            destroy_function(*slot);
+            *slot = fn;
+            return;
+        }
+    }
+    braggi_vector_push_back(s->functions, &fn);
+}
+
+static void eval_statement(ReplEval* e, bool live) {
+    Token* token = peek(e);
+    if (!token) return;
+
+    if (token_is(token, TOKEN_PUNCTUATION, ";")) {
+        e->pos++;
+        return;
+    }
+
+    if (token_is(token, TOKEN_PUNCTUATION, "{")) {
+        eval_block(e, live);
+        return;
+    }
+
+    if (token_is(token, TOKEN_KEYWORD, "fn") || token_is(token, TOKEN_KEYWORD, "func")) {
+        if (e->call_depth > 0) {
+            eval_error(e, "nested function definitions aren't supported");
+            return;
+        }
+        eval_function_decl(e, live);
+        return;
+    }
+
+    if (token_is(token, TOKEN_KEYWORD, "var") || token_is(token, TOKEN_KEYWORD, "const")) {
+        e->pos++;
+        Token* name = peek(e);
+        if (!name || name->type != TOKEN_IDENTIFIER) {
+            eval_error(e, "expected a name after '%s'", token->text);
+            return;
+        }
+        e->pos++;
+
+        if (peek_op(e, ":")) {
+            e->pos++;
+            skip_type(e);
+        }
+
+        ReplValue value = none_value;
+        if (peek_op(e, "=")) {
+            e->pos++;
+            value = eval_expression(e, live);
+        }
+        skip_semicolon(e);
+
+        if (live && !e->failed && !define_binding(e, name->text, value)) {
+            eval_error(e, "out of memory defining '%s'", name->text);
+        }
+        return;
+    }
+
+    if (token_is(token, TOKEN_KEYWORD, "print") || token_is(token, TOKEN_KEYWORD, "println")) {
+        bool newline = strcmp(token->text, "println") == 0;
+        e->pos++;
+        ReplValue value = eval_expression(e, live);
+        skip_semicolon(e);
+        if (live && !e->failed) {
+            print_value(e->out, value);
+            if (newline) fprintf(e->out, "\n");
+        }
+        return;
+    }
+
+    if (token_is(token, TOKEN_KEYWORD, "return")) {
+        e->pos++;
+        ReplValue value = none_value;
+        if (peek(e) && !peek_punct(e, ";") && !peek_punct(e, "}")) {
+            value = eval_expression(e, live);
+        }
+        skip_semicolon(e);
+        if (live && !e->failed) {
+            if (e->call_depth == 0) {
+                eval_error(e, "'return' outside of a function");
+                return;
+            }
+            e->returning = true;
+            e->return_value = value;
+        }
+        return;
+    }
+
+    if (token_is(token, TOKEN_KEYWORD, "if")) {
+        e->pos++;
+        ReplValue cond = eval_expression(e, live);
+        bool taken = live && truthy(cond);
+        eval_block(e, taken);
+
+        if (peek_keyword(e, "else")) {
+            e->pos++;
+            if (peek_keyword(e, "if")) {
+                eval_statement(e, live && !taken && !e->returning);
+            } else {
+                eval_block(e, live && !taken && !e->returning);
+            }
+        }
+        return;
+    }
+
+    if (token_is(token, TOKEN_KEYWORD, "while")) {
+        size_t cond_start = e->pos + 1;
+
+        for (;;) {
+            e->pos = cond_start;
+            ReplValue cond = eval_expression(e, live);
+            bool taken = live && !e->failed && truthy(cond);
+            eval_block(e, taken);
+            if (!taken || e->failed || e->returning) break;
+        }
+        return;
+    }
+
+    // Assignment: name = expr
+    if (token->type == TOKEN_IDENTIFIER && e->pos + 1 < e->end &&
+        token_is(token_at(e->session, e->pos + 1), TOKEN_OPERATOR, "=")) {
+        e->pos += 2;
+        ReplValue value = eval_expression(e, live);
+        skip_semicolon(e);
+        if (!live || e->failed) return;
+
+        ReplBinding* binding = find_binding(e, token->text);
+        if (!binding) {
+            eval_error(e, "assignment to undefined variable '%s'", token->text);
+            return;
+        }
+        binding->value = value;
+        return;
+    }
+
+    // Bare expression - echo it at the prompt
+    ReplValue value = eval_expression(e, live);
+    skip_semicolon(e);
+    if (live && !e->failed && e->top_level && value.kind != REPL_VALUE_NONE) {
+        print_value(e->out, value);
+        fprintf(e->out, "\n");
+    }
+}
+
+/* ---------------------------------------------------------------------
+ * Session API
+ * ------------------------------------------------------------------- */
+
+ReplSession* braggi_repl_session_create(void) {
+    ReplSession* session = (ReplSession*)calloc(1, sizeof(ReplSession));
+    if (!session) return NULL;
+
+    session->tokens = braggi_vector_create(sizeof(Token*));
+    session->globals = braggi_vector_create(sizeof(ReplBinding));
+    session->locals = braggi_vector_create(sizeof(ReplBinding));
+    session->functions = braggi_vector_create(sizeof(ReplFunction*));
+    session->strings = braggi_vector_create(sizeof(char*));
+
+    if (!session->tokens || !session->globals || !session->locals ||
+        !session->functions || !session->strings) {
+        braggi_repl_session_destroy(session);
+        return NULL;
+    }
+
+    return session;
+}
+
+static void clear_session(ReplSession* session) {
+    for (size_t i = 0; i < braggi_vector_size(session->globals); i++) {
+        free(((ReplBinding*)braggi_vector_get(session->globals, i))->name);
+    }
+    braggi_vector_clear(session->globals);
+
+    pop_locals(session, 0);
+
+    for (size_t i = 0; i < braggi_vector_size(session->functions); i++) {
+        destroy_function(*(ReplFunction**)braggi_vector_get(session->functions, i));
+    }
+    braggi_vector_clear(session->functions);
+
+    for (size_t i = 0; i < braggi_vector_size(session->strings); i++) {
+        free(*(char**)braggi_vector_get(session->strings, i));
+    }
+    braggi_vector_clear(session->strings);
+
+    for (size_t i = 0; i < braggi_vector_size(session->tokens); i++) {
+        braggi_token_destroy(token_at(session, i));
+    }
+    braggi_vector_clear(session->tokens);
+
+    free(session->pending);
+    session->pending = NULL;
+}
+
+void braggi_repl_session_destroy(ReplSession* session) {
+    if (!session) return;
+
+    if (session->tokens && session->globals && session->locals &&
+        session->functions && session->strings) {
+        clear_session(session);
+    }
+
+    braggi_vector_destroy(session->tokens);
+    braggi_vector_destroy(session->globals);
+    braggi_vector_destroy(session->locals);
+    braggi_vector_destroy(session->functions);
+    braggi_vector_destroy(session->strings);
+    free(session);
+}
+
+void braggi_repl_session_reset(ReplSession* session) {
+    if (!session) return;
+
+    clear_session(session);
+    session->input_count = 0;
+}
+
+// Net count of '{' minus '}' outside string literals and comments
+static int brace_balance(const char* text) {
+    int depth = 0;
+    char quote = 0;
+
+    for (const char* p = text; *p; p++) {
+        if (quote) {
+            if (*p == '\\' && p[1]) p++;
+            else if (*p == quote) quote = 0;
+            continue;
+        }
+        if (*p == '"' || *p == '\'') quote = *p;
+        else if (*p == '/' && p[1] == '/') break;
+        else if (*p == '{') depth++;
+        else if (*p == '}') depth--;
+    }
+
+    return depth;
+}
+
+// Tokenize just the new input and append it to the session stream
+static bool append_tokens(ReplSession* session, const char* text, size_t* out_start) {
+    char name[32];
+    snprintf(name, sizeof(name), "repl_%zu", session->input_count);
+
+    Source* source = braggi_source_from_string(name, text, strlen(text));
+    if (!source) return false;
+
+    Vector* tokens = braggi_tokenize_all(source, true, true);
+    braggi_source_file_destroy(source);
+    if (!tokens) return false;
+
+    *out_start = braggi_vector_size(session->tokens);
+
+    for (size_t i = 0; i < braggi_vector_size(tokens); i++) {
+        Token* token = *(Token**)braggi_vector_get(tokens, i);
+        if (!token) continue;
+
+        if (token->type == TOKEN_EOF) {
+            braggi_token_destroy(token);
+            continue;
+        }
+
+        braggi_vector_push_back(session->tokens, &token);
+    }
+
+    braggi_vector_destroy(tokens);
+    return true;
+}
+
+bool braggi_repl_session_eval(ReplSession* session, const char* line, FILE* out) {
+    if (!session || !line) return false;
+    if (!out) out = stdout;
+
+    // Stitch multi-line input together until the braces balance
+    char* text;
+    if (session->pending) {
+        size_t lp = strlen(session->pending), ll = strlen(line);
+        text = (char*)malloc(lp + ll + 2);
+        if (!text) return false;
+        memcpy(text, session->pending, lp);
+        text[lp] = '\n';
+        memcpy(text + lp + 1, line, ll + 1);
+        free(session->pending);
+        session->pending = NULL;
+    } else {
+        text = strdup(line);
+        if (!text) return false;
+    }
+
+    if (brace_balance(text) > 0) {
+        session->pending = text;
+        return true;
+    }
+
+    size_t start = 0;
+    bool ok = append_tokens(session, text, &start);
+    free(text);
+    session->input_count++;
+
+    if (!ok) {
+        fprintf(out, "Error: failed to tokenize input\n");
+        return false;
+    }
+
+    ReplEval eval;
+    memset(&eval, 0, sizeof(eval));
+    eval.session = session;
+    eval.out = out;
+    eval.pos = start;
+    eval.end = braggi_vector_size(session->tokens);
+    eval.frame_base = braggi_vector_size(session->locals);
+    eval.top_level = true;
+
+    while (!eval.failed && eval.pos < eval.end) {
+        size_t before = eval.pos;
+        eval_statement(&eval, true);
+        if (eval.pos == before) {
+            eval_error(&eval, "unexpected '%s'", peek(&eval)->text);
+        }
+    }
+
+    fflush(out);
+    return !eval.failed;
+}
+
+// Rebuild a token from its cached record; string literals get their
+// unquoted value the way the tokenizer would have set it
+static Token* module_token(const BraggiModuleToken* record) {
+    char* text = strdup(record->text);
+    if (!text) return NULL;
+
+    Token* token = braggi_token_create(record->type, text,
+                                       braggi_source_position_from_line_col(record->line, record->column));
+    if (!token) {
+        free(text);
+        return NULL;
+    }
+
+    size_t length = strlen(text);
+    if ((record->type == TOKEN_LITERAL_STRING || record->type == TOKEN_LITERAL_CHAR) &&
+        length >= 2 && (text[0] == '"' || text[0] == '\'')) {
+        token->string_value = strndup(text + 1, length - 2);
+    }
+    return token;
+}
+
+size_t braggi_repl_session_import(ReplSession* session, const BraggiModule* module, FILE* out) {
+    if (!session || !module) return 0;
+    if (!out) out = stdout;
+
+    size_t start = braggi_vector_size(session->tokens);
+    size_t count = braggi_module_token_count(module);
+
+    for (size_t i = 0; i < count; i++) {
+        BraggiModuleToken record;
+        Token* token = braggi_module_token_at(module, i, &record) ? module_token(&record) : NULL;
+        if (!token || !braggi_vector_push_back(session->tokens, &token)) {
+            braggi_token_destroy(token);
+            // Export indices only line up with the whole stream
+            while (braggi_vector_size(session->tokens) > start) {
+                Token* added = NULL;
+                braggi_vector_pop_back(session->tokens, &added);
+                braggi_token_destroy(added);
+            }
+            fprintf(out, "Error: out of memory importing '%s'\n", braggi_module_name(module));
+            return 0;
+        }
+    }
+
+    size_t defined = 0;
+    for (size_t i = 0; i < braggi_module_export_count(module); i++) {
+        BraggiModuleExport export;
+        if (!braggi_module_export_at(module, i, &export)) continue;
+        if (export.kind != BRAGGI_EXPORT_FUNCTION && export.kind != BRAGGI_EXPORT_CONSTANT &&
+            export.kind != BRAGGI_EXPORT_VARIABLE) {
+            continue;
+        }
+
+        ReplEval eval;
+        memset(&eval, 0, sizeof(eval));
+        eval.session = session;
+        eval.out = out;
+        eval.pos = start + export.token_index;
+        eval.end = start + count;
+        eval.frame_base = braggi_vector_size(session->locals);
+
+        eval_statement(&eval, true);
+        if (!eval.failed) defined++;
+    }
+
+    fflush(out);
+    return defined;
+}
+
+bool braggi_repl_session_needs_more(ReplSession* session) {
+    return session && session->pending != NULL;
+}
+
+bool braggi_repl_session_get_value(ReplSession* session, const char* name, ReplValue* out_value) {
+    if (!session || !name) return false;
+
+    for (size_t i = 0; i < braggi_vector_size(session->globals); i++) {
+        ReplBinding* binding = (ReplBinding*)braggi_vector_get(session->globals, i);
+        if (strcmp(binding->name, name) == 0) {
+            if (out_value) *out_value = binding->value;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void braggi_repl_session_print_symbols(ReplSession* session, FILE* out) {
+    if (!session || !out) return;
+
+    for (size_t i = 0; i < braggi_vector_size(session->globals); i++) {
+        ReplBinding* binding = (ReplBinding*)braggi_vector_get(session->globals, i);
+        fprintf(out, "  var %s = ", binding->name);
+        print_value(out, binding->value);
+        fprintf(out, "\n");
+    }
+
+    for (size_t i = 0; i < braggi_vector_size(session->functions); i++) {
+        ReplFunction* fn = *(ReplFunction**)braggi_vector_get(session->functions, i);
+        fprintf(out, "  fn %s(", fn->name);
+        for (size_t p = 0; p < braggi_vector_size(fn->params); p++) {
+            fprintf(out, "%s%s", p ? ", " : "", *(char**)braggi_vector_get(fn->params, p));
+        }
+        fprintf(out, ")\n");
+    }
+}
+
+size_t braggi_repl_session_token_count(ReplSession* session) {
+    return session ? braggi_vector_size(session->tokens) : 0;
+}
@@ -0,0 +1,525 @@
+/*
+ * Braggi - Runtime I/O Implementation
+ *
+ * "Every trip to the well costs ya the walk, no matter how
+ * small the bucket!" - Irish-Texan Water Haulin' Wisdom
+ */
+
+#define _GNU_SOURCE
+#include "braggi/rt_io.h"
+#include "braggi/rt_superposition.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+
+struct BraggiOutput {
+    int fd;
+    FILE* stream;         // stdio stream sharing the descriptor, flushed before we write
+    bool line_buffered;   // Terminals see each line as it's finished
+    size_t used;
+    char buffer[BRAGGI_IO_BUFFER_SIZE];
+};
+
+typedef struct ThreadOutputs {
+    BraggiOutput out;
+    BraggiOutput err;
+} ThreadOutputs;
+
+static _Thread_local ThreadOutputs* thread_outputs = NULL;
+static pthread_key_t outputs_key;
+static pthread_once_t outputs_once = PTHREAD_ONCE_INIT;
+
+// Write every iovec, retrying short writes and interrupts. total gets
+// the number of bytes that made it out, even when the write fails.
+static bool write_all(int fd, struct iovec* iov, int count, size_t* total) {
+    *total = 0;
+    while (count > 0) {
+        ssize_t written = writev(fd, iov, count);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        *total += (size_t)written;
+
+        size_t remaining = (size_t)written;
+        while (count > 0 && remaining >= iov->iov_len) {
+            remaining -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = (char*)iov->iov_base + remaining;
+            iov->iov_len -= remaining;
+        }
+    }
+    return true;
+}
+
+// Write the buffer and, in the same call, bytes that didn't fit in it.
+// If the write fails, whatever part of the buffer didn't go out stays
+// buffered for the next attempt.
+static bool flush_with(BraggiOutput* out, const void* extra, size_t extra_length) {
+    if (out->used == 0 && extra_length == 0) return true;
+
+    if (out->stream) fflush(out->stream);
+
+    struct iovec iov[2];
+    int count = 0;
+    if (out->used > 0) {
+        iov[count].iov_base = out->buffer;
+        iov[count].iov_len = out->used;
+        count++;
+    }
+    if (extra_length > 0) {
+        iov[count].iov_base = (void*)extra;
+        iov[count].iov_len = extra_length;
+        count++;
+    }
+
+    size_t written = 0;
+    bool ok = write_all(out->fd, iov, count, &written);
+    if (ok || written >= out->used) {
+        out->used = 0;
+    } else {
+        memmove(out->buffer, out->buffer + written, out->used - written);
+        out->used -= written;
+    }
+    return ok;
+}
+
+static void bind_output(BraggiOutput* out, FILE* stream) {
+    out->stream = stream;
+    out->fd = fileno(stream);
+    out->line_buffered = isatty(out->fd) == 1;
+}
+
+static void flush_outputs(ThreadOutputs* outputs) {
+    flush_with(&outputs->out, NULL, 0);
+    flush_with(&outputs->err, NULL, 0);
+}
+
+static void release_outputs(void* data) {
+    ThreadOutputs* outputs = (ThreadOutputs*)data;
+    flush_outputs(outputs);
+    free(outputs);
+}
+
+// Key destructors don't run for the thread that calls exit
+static void flush_at_exit(void) {
+    if (thread_outputs) flush_outputs(thread_outputs);
+}
+
+static void create_key(void) {
+    pthread_key_create(&outputs_key, release_outputs);
+    atexit(flush_at_exit);
+}
+
+static ThreadOutputs* current_outputs(void) {
+    if (thread_outputs) return thread_outputs;
+
+    pthread_once(&outputs_once, create_key);
+
+    ThreadOutputs* outputs = (ThreadOutputs*)malloc(sizeof(ThreadOutputs));
+    if (!outputs) return NULL;
+
+    outputs->out.used = 0;
+    outputs->err.used = 0;
+    bind_output(&outputs->out, stdout);
+    bind_output(&outputs->err, stderr);
+
+    pthread_setspecific(outputs_key, outputs);
+    thread_outputs = outputs;
+    return outputs;
+}
+
+BraggiOutput* braggi_io_stdout(void) {
+    ThreadOutputs* outputs = current_outputs();
+    return outputs ? &outputs->out : NULL;
+}
+
+BraggiOutput* braggi_io_stderr(void) {
+    ThreadOutputs* outputs = current_outputs();
+    return outputs ? &outputs->err : NULL;
+}
+
+void braggi_io_redirect(BraggiOutput* out, FILE* stream) {
+    if (!out || !stream) return;
+
+    flush_with(out, NULL, 0);
+    bind_output(out, stream);
+}
+
+bool braggi_io_write(BraggiOutput* out, const void* data, size_t length) {
+    if (!out) return false;
+    if (length == 0) return true;
+
+    bool ok = true;
+    if (out->used + length <= BRAGGI_IO_BUFFER_SIZE) {
+        memcpy(out->buffer + out->used, data, length);
+        out->used += length;
+    } else if (length < BRAGGI_IO_BUFFER_SIZE / 2) {
+        // Top the buffer off so the next write starts fresh
+        if (!flush_with(out, NULL, 0)) return false;
+        memcpy(out->buffer, data, length);
+        out->used = length;
+    } else {
+        ok = flush_with(out, data, length);
+    }
+
+    if (ok && out->line_buffered && memchr(data, '\n', length)) {
+        ok = flush_with(out, NULL, 0);
+    }
+    return ok;
+}
+
+bool braggi_io_write_char(BraggiOutput* out, char c) {
+    if (out && !out->line_buffered && out->used < BRAGGI_IO_BUFFER_SIZE) {
+        out->buffer[out->used++] = c;
+        return true;
+    }
+    return braggi_io_write(out, &c, 1);
+}
+
+bool braggi_io_write_cstr(BraggiOutput* out, const char* text) {
+    if (!text) return false;
+    return braggi_io_write(out, text, strlen(text));
+}
+
+bool braggi_io_write_i64(BraggiOutput* out, int64_t value) {
+    char text[BRAGGI_IO_NUMBER_MAX];
+    return braggi_io_write(out, text, braggi_io_format_i64(value, text));
+}
+
+bool braggi_io_write_f64(BraggiOutput* out, double value) {
+    char text[BRAGGI_IO_NUMBER_MAX];
+    return braggi_io_write(out, text, braggi_io_format_f64(value, text));
+}
+
+bool braggi_io_write_str(BraggiOutput* out, const BraggiStr* s) {
+    if (!s) return false;
+
+    // Copy ropes out a piece at a time rather than flattening them
+    char chunk[1024];
+    size_t length = braggi_str_length(s);
+    for (size_t offset = 0; offset < length; offset += sizeof(chunk)) {
+        size_t count = braggi_str_copy(s, offset, chunk, sizeof(chunk));
+        if (!braggi_io_write(out, chunk, count)) return false;
+    }
+    return true;
+}
+
+bool braggi_io_write_val(BraggiOutput* out, BraggiVal value) {
+    switch (value.tag) {
+        case BRAGGI_VAL_NULL:
+            return braggi_io_write(out, "null", 4);
+        case BRAGGI_VAL_BOOL:
+            return value.as.boolean ? braggi_io_write(out, "true", 4) : braggi_io_write(out, "false", 5);
+        case BRAGGI_VAL_INT:
+            return braggi_io_write_i64(out, value.as.integer);
+        case BRAGGI_VAL_FLOAT:
+            return braggi_io_write_f64(out, value.as.number);
+        case BRAGGI_VAL_STRING:
+            return braggi_io_write(out, value.as.string, value.length);
+        case BRAGGI_VAL_ARRAY: {
+            size_t length = braggi_val_array_length(value);
+            bool ok = braggi_io_write_char(out, '[');
+            for (size_t i = 0; ok && i < length; i++) {
+                if (i > 0) ok = braggi_io_write(out, ", ", 2);
+                if (ok) ok = braggi_io_write_val(out, braggi_val_array_get(value, i));
+            }
+            return ok && braggi_io_write_char(out, ']');
+        }
+        case BRAGGI_VAL_ERROR:
+            return braggi_io_write(out, "error: ", 7) &&
+                   braggi_io_write_cstr(out, value.as.string ? value.as.string : "unknown");
+        case BRAGGI_VAL_SUPERPOSITION: {
+            if (value.as.superposition->observed >= 0) {
+                return braggi_io_write_val(out, braggi_super_observe(value));
+            }
+            size_t count = braggi_super_count(value);
+            bool ok = braggi_io_write(out, "superpose(", 10);
+            for (size_t i = 0; ok && i < count; i++) {
+                double probability = 0.0;
+                BraggiVal alternative = braggi_super_at(value, i, &probability);
+                if (i > 0) ok = braggi_io_write(out, ", ", 2);
+                ok = ok && braggi_io_write_val(out, alternative) &&
+                     braggi_io_write(out, " @ ", 3) && braggi_io_write_f64(out, probability);
+            }
+            return ok && braggi_io_write_char(out, ')');
+        }
+        default:
+            return braggi_io_write(out, "<unknown>", 9);
+    }
+}
+
+bool braggi_io_flush(BraggiOutput* out) {
+    if (!out) return false;
+    return flush_with(out, NULL, 0);
+}
+
+void braggi_io_flush_all(void) {
+    if (thread_outputs) flush_outputs(thread_outputs);
+}
+
+void braggi_io_sync(FILE* stream) {
+    if (!thread_outputs || !stream) return;
+
+    if (thread_outputs->out.stream == stream) flush_with(&thread_outputs->out, NULL, 0);
+    if (thread_outputs->err.stream == stream) flush_with(&thread_outputs->err, NULL, 0);
+}
+
+// Two digits at a time from a 200-byte table
+static const char digit_pairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static size_t format_u64(uint64_t value, char* dest) {
+    char text[24];
+    char* p = text + sizeof(text);
+
+    while (value >= 100) {
+        unsigned pair = (unsigned)(value % 100) * 2;
+        value /= 100;
+        *--p = digit_pairs[pair + 1];
+        *--p = digit_pairs[pair];
+    }
+    if (value >= 10) {
+        unsigned pair = (unsigned)value * 2;
+        *--p = digit_pairs[pair + 1];
+        *--p = digit_pairs[pair];
+    } else {
+        *--p = (char)('0' + value);
+    }
+
+    size_t length = (size_t)(text + sizeof(text) - p);
+    memcpy(dest, p, length);
+    dest[length] = '\0';
+    return length;
+}
+
+size_t braggi_io_format_i64(int64_t value, char* dest) {
+    if (value < 0) {
+        dest[0] = '-';
+        return 1 + format_u64(0 - (uint64_t)value, dest + 1);
+    }
+    return format_u64((uint64_t)value, dest);
+}
+
+static const double powers_of_ten[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6 };
+
+size_t braggi_io_format_f64(double value, char* dest) {
+    if (isnan(value)) {
+        memcpy(dest, signbit(value) ? "-nan" : "nan", signbit(value) ? 5 : 4);
+        return strlen(dest);
+    }
+    if (isinf(value)) {
+        memcpy(dest, value < 0 ? "-inf" : "inf", value < 0 ? 5 : 4);
+        return strlen(dest);
+    }
+
+    double magnitude = fabs(value);
+
+    // Whole numbers print as integers
+    if (value == trunc(value) && magnitude < 1e15) {
+        if (value == 0.0 && signbit(value)) {
+            memcpy(dest, "-0", 3);
+            return 2;
+        }
+        return braggi_io_format_i64((int64_t)value, dest);
+    }
+
+    // Short decimals such as 0.5 or 12.75: find the fewest places that
+    // read back exactly, then print integer and fraction parts directly
+    if (magnitude >= 1e-4 && magnitude < 1e9) {
+        for (size_t places = 1; places < sizeof(powers_of_ten) / sizeof(powers_of_ten[0]); places++) {
+            double scaled = nearbyint(magnitude * powers_of_ten[places]);
+            if (scaled / powers_of_ten[places] != magnitude) continue;
+
+            uint64_t digits = (uint64_t)scaled;
+            uint64_t divisor = (uint64_t)powers_of_ten[places];
+            size_t length = 0;
+            if (value < 0) dest[length++] = '-';
+            length += format_u64(digits / divisor, dest + length);
+            dest[length++] = '.';
+
+            char fraction[24];
+            size_t fraction_length = format_u64(digits % divisor, fraction);
+            for (size_t pad = fraction_length; pad < places; pad++) dest[length++] = '0';
+            memcpy(dest + length, fraction, fraction_length + 1);
+            return length + fraction_length;
+        }
+    }
+
+    // Everything else: fewest significant digits that round-trip. Any
+    // decimal of 15 digits or fewer survives the trip, so at most three
+    // passes are needed.
+    for (int precision = 15; precision <= 17; precision++) {
+        int length = snprintf(dest, BRAGGI_IO_NUMBER_MAX, "%.*g", precision, value);
+        if (precision == 17 || strtod(dest, NULL) == value) {
+            return (size_t)length;
+        }
+    }
+    return 0;
+}
+
+struct BraggiReader {
+    int fd;
+    bool eof;
+    char* buffer;
+    size_t start;      // First unread byte
+    size_t end;        // One past the last byte read
+    size_t capacity;
+};
+
+BraggiReader* braggi_io_reader_open(const char* path) {
+    if (!path) return NULL;
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return NULL;
+
+    BraggiReader* reader = (BraggiReader*)malloc(sizeof(BraggiReader));
+    char* buffer = (char*)malloc(BRAGGI_IO_READ_SIZE);
+    if (!reader || !buffer) {
+        free(reader);
+        free(buffer);
+        close(fd);
+        return NULL;
+    }
+
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    reader->fd = fd;
+    reader->eof = false;
+    reader->buffer = buffer;
+    reader->start = 0;
+    reader->end = 0;
+    reader->capacity = BRAGGI_IO_READ_SIZE;
+    return reader;
+}
+
+// Read more after the unread bytes, moving or growing the buffer first
+static bool reader_fill(BraggiReader* reader) {
+    if (reader->eof) return false;
+
+    if (reader->start > 0) {
+        memmove(reader->buffer, reader->buffer + reader->start, reader->end - reader->start);
+        reader->end -= reader->start;
+        reader->start = 0;
+    }
+
+    if (reader->end == reader->capacity) {
+        // A line longer than the buffer
+        size_t capacity = reader->capacity * 2;
+        char* buffer = (char*)realloc(reader->buffer, capacity);
+        if (!buffer) return false;
+        reader->buffer = buffer;
+        reader->capacity = capacity;
+    }
+
+    for (;;) {
+        ssize_t count = read(reader->fd, reader->buffer + reader->end, reader->capacity - reader->end);
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) {
+            reader->eof = true;
+            return false;
+        }
+        reader->end += (size_t)count;
+        return true;
+    }
+}
+
+const char* braggi_io_reader_line(BraggiReader* reader, size_t* out_length) {
+    if (!reader || !out_length) return NULL;
+
+    size_t scanned = 0;
+    for (;;) {
+        char* line = reader->buffer + reader->start;
+        size_t available = reader->end - reader->start;
+        char* newline = (char*)memchr(line + scanned, '\n', available - scanned);
+
+        if (newline || (reader->eof && available > 0)) {
+            size_t length = newline ? (size_t)(newline - line) : available;
+            reader->start += newline ? length + 1 : length;
+            if (length > 0 && line[length - 1] == '\r') length--;
+            *out_length = length;
+            return line;
+        }
+
+        scanned = available;
+        if (!reader_fill(reader) && (!reader->eof || available == 0)) return NULL;
+    }
+}
+
+size_t braggi_io_reader_read(BraggiReader* reader, void* dest, size_t length) {
+    if (!reader || !dest) return 0;
+
+    size_t copied = 0;
+    while (copied < length) {
+        if (reader->start == reader->end && !reader_fill(reader)) break;
+
+        size_t count = reader->end - reader->start;
+        if (count > length - copied) count = length - copied;
+        memcpy((char*)dest + copied, reader->buffer + reader->start, count);
+        reader->start += count;
+        copied += count;
+    }
+    return copied;
+}
+
+void braggi_io_reader_close(BraggiReader* reader) {
+    if (!reader) return;
+
+    close(reader->fd);
+    free(reader->buffer);
+    free(reader);
+}
+
+bool braggi_io_map_file(const char* path, BraggiMappedFile* out) {
+    if (!path || !out) return false;
+
+    out->data = NULL;
+    out->size = 0;
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        close(fd);
+        return false;
+    }
+
+    // mmap can't map nothing
+    if (info.st_size == 0) {
+        close(fd);
+        return true;
+    }
+
+    void* data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return false;
+
+    madvise(data, (size_t)info.st_size, MADV_SEQUENTIAL);
+
+    out->data = (const char*)data;
+    out->size = (size_t)info.st_size;
+    return true;
+}
+
+void braggi_io_unmap_file(BraggiMappedFile* file) {
+    if (!file || !file->data) return;
+
+    munmap((void*)file->data, file->size);
+    file->data = NULL;
+    file->size = 0;
+}
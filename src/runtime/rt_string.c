@@ -0,0 +1,317 @@
+/*
+ * Braggi - Runtime Strings Implementation
+ *
+ * "Don't cut a new rope when ya can splice two old ones -
+ * but know when the knots are gettin' too many!" - Irish-Texan Tack Room Wisdom
+ */
+
+#include "braggi/rt_string.h"
+#include <string.h>
+#include <stdlib.h>
+
+// Rope nodes hold pointers, so keep region blocks 8-byte aligned
+#define STR_ALIGN(size) (((size) + 7) & ~(size_t)7)
+
+static void* str_alloc(BraggiRegionHandle region, size_t size, const char* label) {
+    if (!region || size == 0) return NULL;
+    return braggi_rt_region_alloc(region, STR_ALIGN(size), 0, label);
+}
+
+static BraggiStr make_small(const char* text, size_t length) {
+    BraggiStr s = braggi_str_empty();
+    if (length > 0) memcpy(s.small.bytes, text, length);
+    s.small.remaining = (uint8_t)(BRAGGI_STR_SMALL_MAX - length);
+    return s;
+}
+
+static BraggiStr make_large(BraggiStrKind kind, const char* bytes, size_t length) {
+    BraggiStr s;
+    memset(&s, 0, sizeof(s));
+    s.large.bytes = bytes;
+    s.large.length = (uint32_t)length;
+    s.large.tag = BRAGGI_STR_LARGE_FLAG | (uint8_t)kind;
+    return s;
+}
+
+static uint32_t rope_depth(const BraggiStr* s) {
+    return braggi_str_kind(s) == BRAGGI_STR_ROPE ? s->large.rope->depth : 0;
+}
+
+// Bytes of a string that is already contiguous, NULL for an unflattened rope
+static const char* contiguous(const BraggiStr* s) {
+    switch (braggi_str_kind(s)) {
+        case BRAGGI_STR_SMALL: return s->small.bytes;
+        case BRAGGI_STR_ROPE:  return s->large.rope->flat;
+        default:               return s->large.bytes;
+    }
+}
+
+size_t braggi_str_copy(const BraggiStr* s, size_t offset, char* dest, size_t count) {
+    if (!s || !dest) return 0;
+
+    size_t length = braggi_str_length(s);
+    if (offset >= length) return 0;
+    if (count > length - offset) count = length - offset;
+
+    const char* bytes = contiguous(s);
+    if (bytes) {
+        memcpy(dest, bytes + offset, count);
+        return count;
+    }
+
+    // Walk the rope; each half copies the part of the range it covers
+    const BraggiStrRope* rope = s->large.rope;
+    size_t left_length = braggi_str_length(&rope->left);
+    size_t copied = 0;
+
+    if (offset < left_length) {
+        copied = braggi_str_copy(&rope->left, offset, dest, count);
+    }
+    if (copied < count) {
+        size_t right_offset = offset + copied - left_length;
+        copied += braggi_str_copy(&rope->right, right_offset, dest + copied, count - copied);
+    }
+    return copied;
+}
+
+// Join a rope's halves into one buffer, once
+static const char* rope_flatten(BraggiRegionHandle region, BraggiStrRope* rope) {
+    if (rope->flat) return rope->flat;
+
+    char* flat = (char*)str_alloc(region, (size_t)rope->length + 1, "string");
+    if (!flat) return NULL;
+
+    BraggiStr whole = make_large(BRAGGI_STR_ROPE, NULL, rope->length);
+    whole.large.rope = rope;
+    braggi_str_copy(&whole, 0, flat, rope->length);
+    flat[rope->length] = '\0';
+
+    rope->flat = flat;
+    return flat;
+}
+
+bool braggi_str_from(BraggiRegionHandle region, const char* text, size_t length, BraggiStr* out) {
+    if (!out || (!text && length > 0)) return false;
+    if (length > UINT32_MAX - 1) return false;
+
+    if (length <= BRAGGI_STR_SMALL_MAX) {
+        *out = make_small(text, length);
+        return true;
+    }
+
+    char* bytes = (char*)str_alloc(region, length + 1, "string");
+    if (!bytes) return false;
+
+    memcpy(bytes, text, length);
+    bytes[length] = '\0';
+    *out = make_large(BRAGGI_STR_FLAT, bytes, length);
+    return true;
+}
+
+BraggiStr braggi_str_borrow(const char* text, size_t length) {
+    if (!text || length > UINT32_MAX - 1) return braggi_str_empty();
+    if (length <= BRAGGI_STR_SMALL_MAX) return make_small(text, length);
+    return make_large(BRAGGI_STR_SLICE, text, length);
+}
+
+bool braggi_str_concat(BraggiRegionHandle region, const BraggiStr* a, const BraggiStr* b, BraggiStr* out) {
+    if (!a || !b || !out) return false;
+
+    size_t left = braggi_str_length(a);
+    size_t right = braggi_str_length(b);
+    size_t length = left + right;
+    if (length > UINT32_MAX - 1) return false;
+
+    if (left == 0) { *out = *b; return true; }
+    if (right == 0) { *out = *a; return true; }
+
+    if (length <= BRAGGI_STR_SMALL_MAX) {
+        BraggiStr s = braggi_str_empty();
+        braggi_str_copy(a, 0, s.small.bytes, left);
+        braggi_str_copy(b, 0, s.small.bytes + left, right);
+        s.small.remaining = (uint8_t)(BRAGGI_STR_SMALL_MAX - length);
+        *out = s;
+        return true;
+    }
+
+    uint32_t depth = rope_depth(a) > rope_depth(b) ? rope_depth(a) : rope_depth(b);
+
+    // Short results and over-deep ropes get one flat copy instead
+    if (length < BRAGGI_STR_ROPE_MIN_LENGTH || depth >= BRAGGI_STR_ROPE_MAX_DEPTH) {
+        char* bytes = (char*)str_alloc(region, length + 1, "string");
+        if (!bytes) return false;
+
+        braggi_str_copy(a, 0, bytes, left);
+        braggi_str_copy(b, 0, bytes + left, right);
+        bytes[length] = '\0';
+        *out = make_large(BRAGGI_STR_FLAT, bytes, length);
+        return true;
+    }
+
+    BraggiStrRope* rope = (BraggiStrRope*)str_alloc(region, sizeof(BraggiStrRope), "string rope");
+    if (!rope) return false;
+
+    rope->left = *a;
+    rope->right = *b;
+    rope->length = (uint32_t)length;
+    rope->depth = depth + 1;
+    rope->flat = NULL;
+
+    BraggiStr s = make_large(BRAGGI_STR_ROPE, NULL, length);
+    s.large.rope = rope;
+    *out = s;
+    return true;
+}
+
+bool braggi_str_slice(BraggiRegionHandle region, const BraggiStr* s, size_t start, size_t end, BraggiStr* out) {
+    if (!s || !out) return false;
+
+    size_t length = braggi_str_length(s);
+    if (end > length) end = length;
+    if (start > end) return false;
+
+    size_t count = end - start;
+
+    // Short slices are cheaper to copy than to share
+    if (count <= BRAGGI_STR_SMALL_MAX) {
+        BraggiStr small = braggi_str_empty();
+        braggi_str_copy(s, start, small.small.bytes, count);
+        small.small.remaining = (uint8_t)(BRAGGI_STR_SMALL_MAX - count);
+        *out = small;
+        return true;
+    }
+
+    if (start == 0 && end == length) {
+        *out = *s;
+        return true;
+    }
+
+    const char* bytes = contiguous(s);
+    if (!bytes) {
+        bytes = rope_flatten(region, s->large.rope);
+        if (!bytes) return false;
+    }
+
+    *out = make_large(BRAGGI_STR_SLICE, bytes + start, count);
+    return true;
+}
+
+bool braggi_str_vformat(BraggiRegionHandle region, BraggiStr* out, const char* format, va_list args) {
+    if (!out || !format) return false;
+
+    // Most formatted strings fit here and need only one pass
+    char buffer[128];
+    va_list copy;
+    va_copy(copy, args);
+    int length = vsnprintf(buffer, sizeof(buffer), format, copy);
+    va_end(copy);
+
+    if (length < 0) return false;
+    if ((size_t)length < sizeof(buffer)) {
+        return braggi_str_from(region, buffer, (size_t)length, out);
+    }
+
+    char* bytes = (char*)str_alloc(region, (size_t)length + 1, "string");
+    if (!bytes) return false;
+
+    vsnprintf(bytes, (size_t)length + 1, format, args);
+    *out = make_large(BRAGGI_STR_FLAT, bytes, (size_t)length);
+    return true;
+}
+
+bool braggi_str_format(BraggiRegionHandle region, BraggiStr* out, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    bool ok = braggi_str_vformat(region, out, format, args);
+    va_end(args);
+    return ok;
+}
+
+const char* braggi_str_data(BraggiRegionHandle region, BraggiStr* s) {
+    if (!s) return NULL;
+
+    const char* bytes = contiguous(s);
+    if (bytes) return bytes;
+
+    // Keep the flat copy so the rope isn't walked again
+    bytes = rope_flatten(region, s->large.rope);
+    if (bytes) {
+        *s = make_large(BRAGGI_STR_FLAT, bytes, s->large.length);
+    }
+    return bytes;
+}
+
+int braggi_str_byte_at(const BraggiStr* s, size_t index) {
+    if (!s || index >= braggi_str_length(s)) return -1;
+
+    while (!contiguous(s)) {
+        const BraggiStrRope* rope = s->large.rope;
+        size_t left_length = braggi_str_length(&rope->left);
+        if (index < left_length) {
+            s = &rope->left;
+        } else {
+            index -= left_length;
+            s = &rope->right;
+        }
+    }
+    return (unsigned char)contiguous(s)[index];
+}
+
+bool braggi_str_equals(const BraggiStr* a, const BraggiStr* b) {
+    if (!a || !b) return false;
+
+    size_t length = braggi_str_length(a);
+    if (length != braggi_str_length(b)) return false;
+
+    const char* bytes_a = contiguous(a);
+    const char* bytes_b = contiguous(b);
+    if (bytes_a && bytes_b) {
+        return memcmp(bytes_a, bytes_b, length) == 0;
+    }
+
+    // At least one side is a rope - compare a chunk at a time
+    char chunk_a[256];
+    char chunk_b[256];
+    for (size_t offset = 0; offset < length; offset += sizeof(chunk_a)) {
+        size_t count = braggi_str_copy(a, offset, chunk_a, sizeof(chunk_a));
+        braggi_str_copy(b, offset, chunk_b, count);
+        if (memcmp(chunk_a, chunk_b, count) != 0) return false;
+    }
+    return true;
+}
+
+void braggi_str_print(const BraggiStr* s, FILE* stream) {
+    if (!s || !stream) return;
+
+    const char* bytes = contiguous(s);
+    if (bytes) {
+        fwrite(bytes, 1, braggi_str_length(s), stream);
+        return;
+    }
+
+    braggi_str_print(&s->large.rope->left, stream);
+    braggi_str_print(&s->large.rope->right, stream);
+}
+
+BraggiStr braggi_str_from_val(BraggiVal value) {
+    if (value.tag != BRAGGI_VAL_STRING || !value.as.string) return braggi_str_empty();
+    return braggi_str_borrow(value.as.string, value.length);
+}
+
+BraggiVal braggi_str_to_val(BraggiRegionHandle region, const BraggiStr* s) {
+    if (!s) return braggi_val_error("string from NULL");
+
+    BraggiStr copy = *s;
+    BraggiStrKind kind = braggi_str_kind(&copy);
+
+    // Small strings live in the handle itself, so they need a home first
+    if (kind == BRAGGI_STR_SMALL) {
+        return braggi_val_string(region, copy.small.bytes, braggi_str_length(&copy));
+    }
+
+    const char* bytes = braggi_str_data(region, &copy);
+    if (!bytes) return braggi_val_error("out of region memory for string");
+
+    BraggiVal value = { BRAGGI_VAL_STRING, copy.large.length, { .string = bytes } };
+    return value;
+}
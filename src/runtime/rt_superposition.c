@@ -0,0 +1,350 @@
+/*
+ * Braggi - Runtime Superpositions Implementation
+ *
+ * "A cattle buyer who weighs every steer in the pen before he bids
+ * will still be weighin' come Christmas!" - Irish-Texan Stockyard Wisdom
+ */
+
+#include "braggi/rt_superposition.h"
+#include "braggi/math_kernels.h"
+#include <string.h>
+
+// Runtime regions bump-allocate without padding, so keep our blocks aligned
+#define SUPER_ALIGN(size) (((size) + 7) & ~(size_t)7)
+
+// Stops a never-seeded thread from starting at zero, where xorshift sticks
+#define SUPER_DEFAULT_SEED 0x9E3779B97F4A7C15ULL
+
+static _Thread_local uint64_t rng_state = SUPER_DEFAULT_SEED;
+
+static void* super_alloc(BraggiRegionHandle region, size_t size, const char* label) {
+    if (!region || size == 0) return NULL;
+    return braggi_rt_region_alloc(region, SUPER_ALIGN(size), 0, label);
+}
+
+void braggi_super_seed(uint64_t seed) {
+    rng_state = seed ? seed : SUPER_DEFAULT_SEED;
+}
+
+// xorshift64*, scaled to [0, 1)
+static double next_uniform(void) {
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return (double)((rng_state * 0x2545F4914F6CDD1DULL) >> 11) * 0x1.0p-53;
+}
+
+static BraggiSuperposition* as_super(BraggiVal value) {
+    return value.tag == BRAGGI_VAL_SUPERPOSITION ? value.as.superposition : NULL;
+}
+
+static BraggiVal wrap_super(BraggiSuperposition* sp) {
+    BraggiVal value = { BRAGGI_VAL_SUPERPOSITION, 0, { .superposition = sp } };
+    return value;
+}
+
+static BraggiSuperposition* new_super(BraggiRegionHandle region, BraggiValArray* alternatives,
+                                      const double* weights, double total) {
+    BraggiSuperposition* sp = (BraggiSuperposition*)super_alloc(region, sizeof(BraggiSuperposition),
+                                                                "superposition");
+    if (!sp) return NULL;
+
+    sp->alternatives = alternatives;
+    sp->weights = weights;
+    sp->total = total;
+    sp->observed = -1;
+    return sp;
+}
+
+// A typed buffer of n alternatives; the contents are left for the caller
+static BraggiValArray* new_alternatives(BraggiRegionHandle region, BraggiElemKind kind, size_t n) {
+    BraggiVal array = braggi_val_typed_array(region, kind, n);
+    if (braggi_val_is_error(array)) return NULL;
+
+    array.as.array->length = n;
+    return array.as.array;
+}
+
+BraggiVal braggi_super_create(BraggiRegionHandle region, const BraggiVal* alternatives,
+                              const double* weights, size_t count) {
+    if (!alternatives || count == 0) return braggi_val_error("superposition needs alternatives");
+    if (count > BRAGGI_SUPER_MAX_ALTERNATIVES) return braggi_val_error("too many alternatives");
+
+    // Numbers go in a typed buffer so arithmetic can use the kernels
+    BraggiElemKind kind = BRAGGI_ELEM_I64;
+    for (size_t i = 0; i < count && kind != BRAGGI_ELEM_ANY; i++) {
+        if (alternatives[i].tag == BRAGGI_VAL_FLOAT) {
+            kind = BRAGGI_ELEM_F64;
+        } else if (alternatives[i].tag != BRAGGI_VAL_INT) {
+            kind = BRAGGI_ELEM_ANY;
+        }
+    }
+
+    double* w = (double*)super_alloc(region, count * sizeof(double), "superposition weights");
+    BraggiValArray* alts = new_alternatives(region, kind, count);
+    if (!w || !alts) return braggi_val_error("out of region memory for superposition");
+
+    double total = 0.0;
+    for (size_t i = 0; i < count; i++) {
+        w[i] = weights ? weights[i] : 1.0;
+        if (!(w[i] >= 0.0)) return braggi_val_error("superposition weights can't be negative");
+        total += w[i];
+
+        switch (kind) {
+            case BRAGGI_ELEM_I64: alts->i64[i] = alternatives[i].as.integer; break;
+            case BRAGGI_ELEM_F64: alts->f64[i] = braggi_val_as_double(alternatives[i]); break;
+            default:              alts->items[i] = alternatives[i]; break;
+        }
+    }
+    if (!(total > 0.0)) return braggi_val_error("superposition weights are all zero");
+
+    BraggiSuperposition* sp = new_super(region, alts, w, total);
+    if (!sp) return braggi_val_error("out of region memory for superposition");
+    return wrap_super(sp);
+}
+
+size_t braggi_super_count(BraggiVal value) {
+    BraggiSuperposition* sp = as_super(value);
+    return sp ? sp->alternatives->length : 0;
+}
+
+BraggiVal braggi_super_at(BraggiVal value, size_t index, double* probability) {
+    BraggiSuperposition* sp = as_super(value);
+    if (!sp || index >= sp->alternatives->length) return braggi_val_null();
+
+    if (probability) *probability = sp->weights[index] / sp->total;
+
+    BraggiVal array = { BRAGGI_VAL_ARRAY, 0, { .array = sp->alternatives } };
+    return braggi_val_array_get(array, index);
+}
+
+BraggiVal braggi_super_observe(BraggiVal value) {
+    BraggiSuperposition* sp = as_super(value);
+    if (!sp) return value;
+
+    if (sp->observed < 0) {
+        size_t n = sp->alternatives->length;
+        double target = next_uniform() * sp->total;
+        size_t chosen = n - 1;
+
+        for (size_t i = 0; i < n; i++) {
+            target -= sp->weights[i];
+            if (target < 0.0 && sp->weights[i] > 0.0) {
+                chosen = i;
+                break;
+            }
+        }
+        // Rounding can leave the last alternative picked with zero weight
+        while (chosen > 0 && sp->weights[chosen] == 0.0) chosen--;
+
+        sp->observed = (int64_t)chosen;
+    }
+    return braggi_super_at(value, (size_t)sp->observed, NULL);
+}
+
+bool braggi_super_expect(BraggiVal value, double* out) {
+    if (!out) return false;
+
+    if (braggi_val_is_number(value)) {
+        *out = braggi_val_as_double(value);
+        return true;
+    }
+
+    BraggiSuperposition* sp = as_super(value);
+    if (!sp) return false;
+
+    if (sp->observed >= 0) {
+        return braggi_super_expect(braggi_super_observe(value), out);
+    }
+
+    BraggiValArray* alts = sp->alternatives;
+    if (alts->kind == BRAGGI_ELEM_F64) {
+        *out = braggi_kernel_dot_f64(sp->weights, alts->f64, alts->length) / sp->total;
+        return true;
+    }
+    if (alts->kind != BRAGGI_ELEM_I64) return false;
+
+    // Widen a block at a time rather than allocating
+    double block[256];
+    double sum = 0.0;
+    for (size_t i = 0; i < alts->length; i += 256) {
+        size_t n = alts->length - i < 256 ? alts->length - i : 256;
+        braggi_kernel_i64_to_f64(block, alts->i64 + i, n);
+        sum += braggi_kernel_dot_f64(sp->weights + i, block, n);
+    }
+    *out = sum / sp->total;
+    return true;
+}
+
+// Where an operand stands for an arithmetic operation
+typedef struct Operand {
+    const BraggiSuperposition* sp;  // NULL for a definite number
+    BraggiVal number;               // The number when sp is NULL
+    bool is_int;
+} Operand;
+
+static bool make_operand(BraggiVal value, Operand* out) {
+    BraggiSuperposition* sp = as_super(value);
+
+    // Observed superpositions are just their outcome now
+    if (sp && sp->observed >= 0) {
+        value = braggi_super_observe(value);
+        sp = NULL;
+    }
+
+    if (sp) {
+        if (sp->alternatives->kind == BRAGGI_ELEM_ANY) return false;
+        out->sp = sp;
+        out->is_int = sp->alternatives->kind == BRAGGI_ELEM_I64;
+        return true;
+    }
+
+    if (!braggi_val_is_number(value)) return false;
+    out->sp = NULL;
+    out->number = value;
+    out->is_int = value.tag == BRAGGI_VAL_INT;
+    return true;
+}
+
+static BraggiVal scalar_apply(BraggiSuperOp op, BraggiVal a, BraggiVal b) {
+    if (a.tag == BRAGGI_VAL_INT && b.tag == BRAGGI_VAL_INT && op != BRAGGI_SUPER_DIV) {
+        uint64_t x = (uint64_t)a.as.integer;
+        uint64_t y = (uint64_t)b.as.integer;
+        switch (op) {
+            case BRAGGI_SUPER_ADD: return braggi_val_int((int64_t)(x + y));
+            case BRAGGI_SUPER_SUB: return braggi_val_int((int64_t)(x - y));
+            default:               return braggi_val_int((int64_t)(x * y));
+        }
+    }
+
+    double x = braggi_val_as_double(a);
+    double y = braggi_val_as_double(b);
+    switch (op) {
+        case BRAGGI_SUPER_ADD: return braggi_val_float(x + y);
+        case BRAGGI_SUPER_SUB: return braggi_val_float(x - y);
+        case BRAGGI_SUPER_MUL: return braggi_val_float(x * y);
+        default:               return braggi_val_float(x / y);
+    }
+}
+
+// Get a superposition's alternatives as doubles
+static const double* f64_alternatives(BraggiRegionHandle region, const BraggiSuperposition* sp) {
+    BraggiValArray* alts = sp->alternatives;
+    if (alts->kind == BRAGGI_ELEM_F64) return alts->f64;
+
+    double* wide = (double*)super_alloc(region, alts->length * sizeof(double), "superposition values");
+    if (wide) braggi_kernel_i64_to_f64(wide, alts->i64, alts->length);
+    return wide;
+}
+
+// out[i] = x[i] op s, or s op x[i] when scalar_first, over integers
+static void broadcast_i64(int64_t* out, const int64_t* x, int64_t s, size_t n,
+                          BraggiSuperOp op, bool scalar_first) {
+    switch (op) {
+        case BRAGGI_SUPER_ADD:
+            braggi_kernel_add_scalar_i64(out, x, s, n);
+            break;
+        case BRAGGI_SUPER_SUB:
+            if (scalar_first) {
+                braggi_kernel_rsub_scalar_i64(out, x, s, n);
+            } else {
+                braggi_kernel_add_scalar_i64(out, x, (int64_t)(0 - (uint64_t)s), n);
+            }
+            break;
+        default:
+            braggi_kernel_mul_scalar_i64(out, x, s, n);
+            break;
+    }
+}
+
+// out[i] = x[i] op s, or s op x[i] when scalar_first, over doubles
+static void broadcast_f64(double* out, const double* x, double s, size_t n,
+                          BraggiSuperOp op, bool scalar_first) {
+    switch (op) {
+        case BRAGGI_SUPER_ADD:
+            braggi_kernel_add_scalar_f64(out, x, s, n);
+            break;
+        case BRAGGI_SUPER_SUB:
+            if (scalar_first) {
+                braggi_kernel_rsub_scalar_f64(out, x, s, n);
+            } else {
+                braggi_kernel_add_scalar_f64(out, x, -s, n);
+            }
+            break;
+        case BRAGGI_SUPER_MUL:
+            braggi_kernel_mul_scalar_f64(out, x, s, n);
+            break;
+        default:
+            if (scalar_first) {
+                braggi_kernel_rdiv_scalar_f64(out, x, s, n);
+            } else {
+                braggi_kernel_div_scalar_f64(out, x, s, n);
+            }
+            break;
+    }
+}
+
+BraggiVal braggi_super_apply(BraggiRegionHandle region, BraggiSuperOp op, BraggiVal a, BraggiVal b) {
+    Operand x;
+    Operand y;
+    if (!make_operand(a, &x) || !make_operand(b, &y)) {
+        return braggi_val_error("superposition arithmetic needs numbers");
+    }
+
+    if (!x.sp && !y.sp) return scalar_apply(op, x.number, y.number);
+    if (!region) return braggi_val_error("superposition arithmetic needs a region");
+
+    bool integer = x.is_int && y.is_int && op != BRAGGI_SUPER_DIV;
+    BraggiElemKind kind = integer ? BRAGGI_ELEM_I64 : BRAGGI_ELEM_F64;
+
+    // One side definite: broadcast it over the other, sharing its weights
+    if (!x.sp || !y.sp) {
+        const BraggiSuperposition* sp = x.sp ? x.sp : y.sp;
+        BraggiVal s = x.sp ? y.number : x.number;
+        bool scalar_first = !x.sp;
+        size_t n = sp->alternatives->length;
+
+        BraggiValArray* out = new_alternatives(region, kind, n);
+        if (!out) return braggi_val_error("out of region memory for superposition");
+
+        if (integer) {
+            broadcast_i64(out->i64, sp->alternatives->i64, s.as.integer, n, op, scalar_first);
+        } else {
+            const double* values = f64_alternatives(region, sp);
+            if (!values) return braggi_val_error("out of region memory for superposition");
+            broadcast_f64(out->f64, values, braggi_val_as_double(s), n, op, scalar_first);
+        }
+
+        BraggiSuperposition* result = new_super(region, out, sp->weights, sp->total);
+        if (!result) return braggi_val_error("out of region memory for superposition");
+        return wrap_super(result);
+    }
+
+    // Both undecided: every pair of alternatives, row by row. Each row
+    // broadcasts one of x's alternatives over all of y's.
+    size_t n = x.sp->alternatives->length;
+    size_t m = y.sp->alternatives->length;
+    if (n * m > BRAGGI_SUPER_MAX_ALTERNATIVES) return braggi_val_error("too many alternatives");
+
+    BraggiValArray* out = new_alternatives(region, kind, n * m);
+    double* weights = (double*)super_alloc(region, n * m * sizeof(double), "superposition weights");
+    if (!out || !weights) return braggi_val_error("out of region memory for superposition");
+
+    const double* xs = integer ? NULL : f64_alternatives(region, x.sp);
+    const double* ys = integer ? NULL : f64_alternatives(region, y.sp);
+    if (!integer && (!xs || !ys)) return braggi_val_error("out of region memory for superposition");
+
+    for (size_t i = 0; i < n; i++) {
+        if (integer) {
+            broadcast_i64(out->i64 + i * m, y.sp->alternatives->i64,
+                          x.sp->alternatives->i64[i], m, op, true);
+        } else {
+            broadcast_f64(out->f64 + i * m, ys, xs[i], m, op, true);
+        }
+        braggi_kernel_mul_scalar_f64(weights + i * m, y.sp->weights, x.sp->weights[i], m);
+    }
+
+    BraggiSuperposition* result = new_super(region, out, weights, x.sp->total * y.sp->total);
+    if (!result) return braggi_val_error("out of region memory for superposition");
+    return wrap_super(result);
+}
@@ -8,9 +8,16 @@
  */
 
 #include "braggi/runtime.h"
+#include "braggi/alloc_profile.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 // Allocation record structure
 typedef struct BraggiAllocation {
@@ -21,6 +28,19 @@ typedef struct BraggiAllocation {
     struct BraggiAllocation* next; // Next allocation in list
 } BraggiAllocation;
 
+// Always-on usage counters. Shared regions bump them atomically; other
+// regions use relaxed loads and stores, which compile to plain moves.
+typedef struct RegionCounters {
+    _Atomic uint64_t allocs;
+    _Atomic uint64_t frees;
+    _Atomic uint64_t bytes_allocated;
+    _Atomic uint64_t bytes_freed;
+    _Atomic uint64_t high_water;
+    _Atomic uint64_t transfers_out;
+    _Atomic uint64_t transfers_in;
+    _Atomic uint64_t failures[BRAGGI_RT_ERROR_COUNT];
+} RegionCounters;
+
 // Region structure
 struct BraggiRegion {
     void* memory_pool;           // Memory block for the region
@@ -28,6 +48,7 @@ struct BraggiRegion {
     size_t used;                 // Amount of memory used
     BraggiRegimeType regime;     // Access regime
     BraggiAllocation* allocations; // List of allocations
+    BraggiAllocation* last_allocation; // Tail of the list, for O(1) appends
     size_t alloc_count;          // Number of allocations
     
     // Regime-specific pointers
@@ -36,27 +57,87 @@ struct BraggiRegion {
     // Periscopes pointing to this region
     struct BraggiPeriscope** incoming_periscopes;
     size_t incoming_periscope_count;
+    size_t incoming_periscope_capacity;
     
     // Periscopes from this region
     struct BraggiPeriscope** outgoing_periscopes;
     size_t outgoing_periscope_count;
+    size_t outgoing_periscope_capacity;
+    
+    // Shared regions hand out memory with atomics and keep no
+    // allocation records; used and alloc_count are unused for them
+    bool shared;
+    uint64_t id;                 // Never reused, so stale sub-arenas can't match
+    _Atomic size_t cursor;       // Bytes of the pool handed out
+    _Atomic size_t shared_count; // Allocations made
+    size_t subarena_size;        // Chunk a thread takes for RAND allocations
+    
+    RegionCounters counters;
+    
+    // Links in the list of live regions
+    struct BraggiRegion* live_prev;
+    struct BraggiRegion* live_next;
 };
 
+// Which ways data may cross a periscope, worked out when it's created
+#define PERISCOPE_FLOW_FORWARD  0x1  // source -> target
+#define PERISCOPE_FLOW_BACKWARD 0x2  // target -> source
+
 // Periscope structure
 struct BraggiPeriscope {
     BraggiRegionHandle source;
     BraggiRegionHandle target;
     BraggiPeriscopeDirection direction;
+    unsigned flow;               // PERISCOPE_FLOW_* bits
+    _Atomic size_t borrows;      // Outstanding zero-copy borrows
 };
 
-// Last error code
-static BraggiRuntimeError last_error = BRAGGI_RT_SUCCESS;
+// Last error code, one per thread
+static _Thread_local BraggiRuntimeError last_error = BRAGGI_RT_SUCCESS;
+
+// Region IDs for shared regions' sub-arena lookup
+static _Atomic uint64_t next_region_id = 1;
+
+// A thread's current chunk of a shared RAND region
+typedef struct SubArena {
+    uint64_t region_id;
+    char* cursor;
+    char* end;
+} SubArena;
+
+#define SUBARENA_SLOTS 8
+static _Thread_local SubArena subarenas[SUBARENA_SLOTS];
+
+// Every region that hasn't been destroyed, for snapshots
+static pthread_mutex_t live_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct BraggiRegion* live_regions = NULL;
+static size_t live_count = 0;
 
 // Set the last error
 static void set_error(BraggiRuntimeError error) {
     last_error = error;
 }
 
+static void count(const struct BraggiRegion* region, _Atomic uint64_t* counter, uint64_t n) {
+    if (region->shared) {
+        atomic_fetch_add_explicit(counter, n, memory_order_relaxed);
+    } else {
+        atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + n,
+                              memory_order_relaxed);
+    }
+}
+
+// Record a failed allocation and report it
+static void* alloc_failed(struct BraggiRegion* region, BraggiRuntimeError error) {
+    count(region, &region->counters.failures[error], 1);
+    set_error(error);
+    return NULL;
+}
+
+BraggiRuntimeError braggi_rt_last_error(void) {
+    return last_error;
+}
+
 // Create a new region
 BraggiRegionHandle braggi_rt_region_create(size_t size, BraggiRegimeType regime) {
     // Validate parameters
@@ -93,17 +174,103 @@ BraggiRegionHandle braggi_rt_region_create(size_t size, BraggiRegimeType regime)
     region->used = 0;
     region->regime = regime;
     region->allocations = NULL;
+    region->last_allocation = NULL;
     region->alloc_count = 0;
     region->next_alloc = region->memory_pool;  // Start at beginning of pool
     region->incoming_periscopes = NULL;
     region->incoming_periscope_count = 0;
+    region->incoming_periscope_capacity = 0;
     region->outgoing_periscopes = NULL;
     region->outgoing_periscope_count = 0;
+    region->outgoing_periscope_capacity = 0;
+    region->shared = false;
+    region->id = atomic_fetch_add(&next_region_id, 1);
+    atomic_init(&region->cursor, 0);
+    atomic_init(&region->shared_count, 0);
+    region->subarena_size = 0;
+    
+    memset(&region->counters, 0, sizeof(region->counters));
+    
+    pthread_mutex_lock(&live_lock);
+    region->live_prev = NULL;
+    region->live_next = live_regions;
+    if (live_regions) live_regions->live_prev = region;
+    live_regions = region;
+    live_count++;
+    pthread_mutex_unlock(&live_lock);
     
     set_error(BRAGGI_RT_SUCCESS);
     return region;
 }
 
+// Create a region several threads can allocate from at once
+BraggiRegionHandle braggi_rt_region_create_shared(size_t size, BraggiRegimeType regime) {
+    BraggiRegionHandle region = braggi_rt_region_create(size, regime);
+    if (!region) {
+        return NULL;
+    }
+    
+    region->shared = true;
+    
+    // Enough chunks that one busy thread can't starve the rest
+    size_t chunk = size / 16;
+    if (chunk > BRAGGI_RT_SUBARENA_MAX) chunk = BRAGGI_RT_SUBARENA_MAX;
+    region->subarena_size = chunk & ~(size_t)(BRAGGI_RT_SHARED_ALIGN - 1);
+    
+    return region;
+}
+
+bool braggi_rt_region_is_shared(BraggiRegionHandle region) {
+    return region && region->shared;
+}
+
+// Claim bytes from a shared region's pool without a lock. The cursor
+// only ever moves to an offset that fits, so a failed claim leaves it
+// where it was for smaller claims that still fit.
+static char* shared_claim(BraggiRegionHandle region, size_t size) {
+    size_t offset = atomic_load_explicit(&region->cursor, memory_order_relaxed);
+    do {
+        if (size > region->size || offset > region->size - size) {
+            return NULL;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&region->cursor, &offset, offset + size,
+                                                    memory_order_relaxed, memory_order_relaxed));
+    return (char*)region->memory_pool + offset;
+}
+
+// Allocate from a shared region: SEQ, FIFO and FILO bump the shared
+// cursor directly; RAND carves from a chunk owned by the calling thread
+static void* shared_alloc(BraggiRegionHandle region, size_t size) {
+    size = (size + BRAGGI_RT_SHARED_ALIGN - 1) & ~(size_t)(BRAGGI_RT_SHARED_ALIGN - 1);
+    if (size == 0) {
+        return NULL;
+    }
+    
+    char* memory = NULL;
+    if (region->regime == BRAGGI_REGIME_RAND && size <= region->subarena_size / 2) {
+        SubArena* arena = &subarenas[region->id & (SUBARENA_SLOTS - 1)];
+        
+        if (arena->region_id != region->id || (size_t)(arena->end - arena->cursor) < size) {
+            // What's left of the old chunk is abandoned
+            char* chunk = shared_claim(region, region->subarena_size);
+            if (!chunk) {
+                // Near the end of the pool - take just what this needs
+                return shared_claim(region, size);
+            }
+            arena->region_id = region->id;
+            arena->cursor = chunk;
+            arena->end = chunk + region->subarena_size;
+        }
+        
+        memory = arena->cursor;
+        arena->cursor += size;
+    } else {
+        memory = shared_claim(region, size);
+    }
+    
+    return memory;
+}
+
 // Destroy a region
 void braggi_rt_region_destroy(BraggiRegionHandle region) {
     if (!region) {
@@ -111,6 +278,16 @@ void braggi_rt_region_destroy(BraggiRegionHandle region) {
         return;
     }
     
+    pthread_mutex_lock(&live_lock);
+    if (region->live_prev) {
+        region->live_prev->live_next = region->live_next;
+    } else {
+        live_regions = region->live_next;
+    }
+    if (region->live_next) region->live_next->live_prev = region->live_prev;
+    live_count--;
+    pthread_mutex_unlock(&live_lock);
+    
     // Free all allocations
     BraggiAllocation* alloc = region->allocations;
     while (alloc) {
@@ -152,6 +329,19 @@ static BraggiAllocation* find_allocation(BraggiRegionHandle region, void* ptr) {
     return NULL;
 }
 
+// Find the allocation that holds all of [ptr, ptr + size)
+static BraggiAllocation* find_allocation_range(BraggiRegionHandle region, const void* ptr, size_t size) {
+    const char* check = (const char*)ptr;
+    for (BraggiAllocation* alloc = region->allocations; alloc; alloc = alloc->next) {
+        const char* start = (const char*)alloc->memory;
+        if (check >= start && check < start + alloc->size &&
+            size <= (size_t)(start + alloc->size - check)) {
+            return alloc;
+        }
+    }
+    return NULL;
+}
+
 // Allocate memory from a region
 void* braggi_rt_region_alloc(BraggiRegionHandle region, size_t size, 
                         uint32_t source_pos, const char* label) {
@@ -161,14 +351,28 @@ void* braggi_rt_region_alloc(BraggiRegionHandle region, size_t size,
     }
     
     if (size == 0) {
-        set_error(BRAGGI_RT_ERROR_INVALID_SIZE);
-        return NULL;
+        return alloc_failed(region, BRAGGI_RT_ERROR_INVALID_SIZE);
+    }
+    
+    // Shared regions keep no records, so there is nothing to lock. The
+    // sampling profiler isn't thread-safe and doesn't see them.
+    if (region->shared) {
+        void* shared_memory = shared_alloc(region, size);
+        if (!shared_memory) {
+            return alloc_failed(region, BRAGGI_RT_ERROR_REGION_FULL);
+        }
+        atomic_fetch_add_explicit(&region->shared_count, 1, memory_order_relaxed);
+        count(region, &region->counters.allocs, 1);
+        count(region, &region->counters.bytes_allocated, size);
+        (void)source_pos;
+        (void)label;
+        set_error(BRAGGI_RT_SUCCESS);
+        return shared_memory;
     }
     
     // Check if there's enough space
     if (region->used + size > region->size) {
-        set_error(BRAGGI_RT_ERROR_REGION_FULL);
-        return NULL;
+        return alloc_failed(region, BRAGGI_RT_ERROR_REGION_FULL);
     }
     
     // Allocate memory based on regime
@@ -194,8 +398,7 @@ void* braggi_rt_region_alloc(BraggiRegionHandle region, size_t size,
     // Create allocation record
     BraggiAllocation* alloc = (BraggiAllocation*)malloc(sizeof(BraggiAllocation));
     if (!alloc) {
-        set_error(BRAGGI_RT_ERROR_OUT_OF_MEMORY);
-        return NULL;
+        return alloc_failed(region, BRAGGI_RT_ERROR_OUT_OF_MEMORY);
     }
     
     alloc->memory = memory;
@@ -208,24 +411,33 @@ void* braggi_rt_region_alloc(BraggiRegionHandle region, size_t size,
         // For FILO, add at the beginning of the list
         alloc->next = region->allocations;
         region->allocations = alloc;
+        if (!region->last_allocation) {
+            region->last_allocation = alloc;
+        }
     } else {
         // For other regimes, add at the end
         alloc->next = NULL;
         if (!region->allocations) {
             region->allocations = alloc;
         } else {
-            BraggiAllocation* last = region->allocations;
-            while (last->next) {
-                last = last->next;
-            }
-            last->next = alloc;
+            region->last_allocation->next = alloc;
         }
+        region->last_allocation = alloc;
     }
     
     // Update region state
     region->used += size;
     region->alloc_count++;
     
+    count(region, &region->counters.allocs, 1);
+    count(region, &region->counters.bytes_allocated, size);
+    if (region->used > atomic_load_explicit(&region->counters.high_water, memory_order_relaxed)) {
+        atomic_store_explicit(&region->counters.high_water, region->used, memory_order_relaxed);
+    }
+    
+    // Runtime positions are a bare line number
+    braggi_alloc_profile_note((uintptr_t)region, NULL, size, source_pos, 0, label);
+    
     set_error(BRAGGI_RT_SUCCESS);
     return memory;
 }
@@ -242,6 +454,17 @@ void braggi_rt_region_free(BraggiRegionHandle region, void* ptr) {
         return;
     }
     
+    // Memory in a shared region comes back when the region is destroyed
+    if (region->shared) {
+        bool inside = (char*)ptr >= (char*)region->memory_pool &&
+                      (char*)ptr < (char*)region->memory_pool + region->size;
+        if (inside) {
+            count(region, &region->counters.frees, 1);
+        }
+        set_error(inside ? BRAGGI_RT_SUCCESS : BRAGGI_RT_ERROR_INVALID_ALLOCATION);
+        return;
+    }
+    
     // Find the allocation
     BraggiAllocation* prev = NULL;
     BraggiAllocation* alloc = region->allocations;
@@ -262,6 +485,9 @@ void braggi_rt_region_free(BraggiRegionHandle region, void* ptr) {
     } else {
         region->allocations = alloc->next;
     }
+    if (region->last_allocation == alloc) {
+        region->last_allocation = prev;
+    }
     
     // Free label if present
     if (alloc->label) {
@@ -272,6 +498,9 @@ void braggi_rt_region_free(BraggiRegionHandle region, void* ptr) {
     region->used -= alloc->size;
     region->alloc_count--;
     
+    count(region, &region->counters.frees, 1);
+    count(region, &region->counters.bytes_freed, alloc->size);
+    
     // Free allocation record
     free(alloc);
     
@@ -306,6 +535,9 @@ size_t braggi_rt_region_get_used_memory(BraggiRegionHandle region) {
     }
     
     set_error(BRAGGI_RT_SUCCESS);
+    if (region->shared) {
+        return atomic_load_explicit(&region->cursor, memory_order_relaxed);
+    }
     return region->used;
 }
 
@@ -317,6 +549,10 @@ size_t braggi_rt_region_get_free_memory(BraggiRegionHandle region) {
     }
     
     set_error(BRAGGI_RT_SUCCESS);
+    if (region->shared) {
+        size_t claimed = atomic_load_explicit(&region->cursor, memory_order_relaxed);
+        return claimed < region->size ? region->size - claimed : 0;
+    }
     return region->size - region->used;
 }
 
@@ -328,9 +564,94 @@ size_t braggi_rt_region_get_allocation_count(BraggiRegionHandle region) {
     }
     
     set_error(BRAGGI_RT_SUCCESS);
+    if (region->shared) {
+        return atomic_load_explicit(&region->shared_count, memory_order_relaxed);
+    }
     return region->alloc_count;
 }
 
+// Can data written under one regime be handed to another?
+static bool regimes_compatible(BraggiRegimeType from, BraggiRegimeType to) {
+    // FILO->RAND is valid, RAND->FIFO is valid, but FILO->FIFO is not
+    return !(from == BRAGGI_REGIME_FILO && to == BRAGGI_REGIME_FIFO);
+}
+
+// Append to a region's periscope list, doubling it when it's full
+static bool periscope_list_push(struct BraggiPeriscope*** list, size_t* count,
+                                size_t* capacity, struct BraggiPeriscope* periscope) {
+    if (*count == *capacity) {
+        size_t new_capacity = *capacity ? *capacity * 2 : 4;
+        void* grown = realloc(*list, new_capacity * sizeof(struct BraggiPeriscope*));
+        if (!grown) {
+            return false;
+        }
+        *list = (struct BraggiPeriscope**)grown;
+        *capacity = new_capacity;
+    }
+    (*list)[(*count)++] = periscope;
+    return true;
+}
+
+static void fill_stats(BraggiRegionHandle region, BraggiRegionStats* out) {
+    const RegionCounters* c = &region->counters;
+    
+    memset(out, 0, sizeof(*out));
+    out->region = region;
+    out->regime = region->regime;
+    out->shared = region->shared;
+    out->size = region->size;
+    out->allocs = atomic_load_explicit(&c->allocs, memory_order_relaxed);
+    out->frees = atomic_load_explicit(&c->frees, memory_order_relaxed);
+    out->bytes_allocated = atomic_load_explicit(&c->bytes_allocated, memory_order_relaxed);
+    out->bytes_freed = atomic_load_explicit(&c->bytes_freed, memory_order_relaxed);
+    out->transfers_out = atomic_load_explicit(&c->transfers_out, memory_order_relaxed);
+    out->transfers_in = atomic_load_explicit(&c->transfers_in, memory_order_relaxed);
+    
+    // A shared region's cursor never moves back, so it is its own high-water mark
+    if (region->shared) {
+        out->bytes_in_use = atomic_load_explicit(&region->cursor, memory_order_relaxed);
+        out->high_water = out->bytes_in_use;
+    } else {
+        // used belongs to the owning thread; the counters are safe to read
+        // from here. They're loaded separately, so never report less than 0.
+        out->bytes_in_use = out->bytes_allocated > out->bytes_freed ?
+                            out->bytes_allocated - out->bytes_freed : 0;
+        out->high_water = atomic_load_explicit(&c->high_water, memory_order_relaxed);
+    }
+    
+    for (size_t i = 0; i < BRAGGI_RT_ERROR_COUNT; i++) {
+        out->failures[i] = atomic_load_explicit(&c->failures[i], memory_order_relaxed);
+    }
+}
+
+// Read a region's usage counters
+bool braggi_rt_region_get_stats(BraggiRegionHandle region, BraggiRegionStats* out) {
+    if (!region || !out) {
+        set_error(BRAGGI_RT_ERROR_INVALID_HANDLE);
+        return false;
+    }
+    
+    fill_stats(region, out);
+    set_error(BRAGGI_RT_SUCCESS);
+    return true;
+}
+
+// Read the counters of every live region
+size_t braggi_rt_region_snapshot(BraggiRegionStats* out, size_t capacity) {
+    pthread_mutex_lock(&live_lock);
+    
+    size_t filled = 0;
+    for (struct BraggiRegion* region = live_regions; region && filled < capacity; region = region->live_next) {
+        fill_stats(region, &out[filled++]);
+    }
+    size_t total = live_count;
+    
+    pthread_mutex_unlock(&live_lock);
+    
+    set_error(BRAGGI_RT_SUCCESS);
+    return total;
+}
+
 // Create a periscope between regions
 BraggiRuntimeError braggi_rt_region_create_periscope(BraggiRegionHandle source, 
                                             BraggiRegionHandle target,
@@ -340,15 +661,7 @@ BraggiRuntimeError braggi_rt_region_create_periscope(BraggiRegionHandle source,
         return BRAGGI_RT_ERROR_INVALID_HANDLE;
     }
     
-    // Check regime compatibility (this would be more complex in a real implementation)
-    bool compatible = true;
-    
-    // FILO->RAND is valid, RAND->FIFO is valid, but FILO->FIFO is not
-    if (source->regime == BRAGGI_REGIME_FILO && target->regime == BRAGGI_REGIME_FIFO) {
-        compatible = false;
-    }
-    
-    if (!compatible) {
+    if (!regimes_compatible(source->regime, target->regime)) {
         set_error(BRAGGI_RT_ERROR_INCOMPATIBLE_REGIMES);
         return BRAGGI_RT_ERROR_INCOMPATIBLE_REGIMES;
     }
@@ -363,25 +676,29 @@ BraggiRuntimeError braggi_rt_region_create_periscope(BraggiRegionHandle source,
     periscope->source = source;
     periscope->target = target;
     periscope->direction = direction;
+    atomic_init(&periscope->borrows, 0);
+    
+    // Settle the regime rules now so transfers only test a bit
+    periscope->flow = 0;
+    if (direction != BRAGGI_PERISCOPE_IN) {
+        periscope->flow |= PERISCOPE_FLOW_FORWARD;
+    }
+    if (direction != BRAGGI_PERISCOPE_OUT &&
+        regimes_compatible(target->regime, source->regime)) {
+        periscope->flow |= PERISCOPE_FLOW_BACKWARD;
+    }
     
     // Add to source's outgoing periscopes
-    void* new_outgoing = realloc(source->outgoing_periscopes, 
-                               (source->outgoing_periscope_count + 1) * 
-                               sizeof(struct BraggiPeriscope*));
-    if (!new_outgoing) {
+    if (!periscope_list_push(&source->outgoing_periscopes, &source->outgoing_periscope_count,
+                             &source->outgoing_periscope_capacity, periscope)) {
         free(periscope);
         set_error(BRAGGI_RT_ERROR_OUT_OF_MEMORY);
         return BRAGGI_RT_ERROR_OUT_OF_MEMORY;
     }
     
-    source->outgoing_periscopes = (struct BraggiPeriscope**)new_outgoing;
-    source->outgoing_periscopes[source->outgoing_periscope_count++] = periscope;
-    
     // Add to target's incoming periscopes
-    void* new_incoming = realloc(target->incoming_periscopes, 
-                               (target->incoming_periscope_count + 1) * 
-                               sizeof(struct BraggiPeriscope*));
-    if (!new_incoming) {
+    if (!periscope_list_push(&target->incoming_periscopes, &target->incoming_periscope_count,
+                             &target->incoming_periscope_capacity, periscope)) {
         // Rollback
         source->outgoing_periscope_count--;
         free(periscope);
@@ -389,13 +706,29 @@ BraggiRuntimeError braggi_rt_region_create_periscope(BraggiRegionHandle source,
         return BRAGGI_RT_ERROR_OUT_OF_MEMORY;
     }
     
-    target->incoming_periscopes = (struct BraggiPeriscope**)new_incoming;
-    target->incoming_periscopes[target->incoming_periscope_count++] = periscope;
-    
     set_error(BRAGGI_RT_SUCCESS);
     return BRAGGI_RT_SUCCESS;
 }
 
+// Find the periscope from one region to another
+BraggiPeriscopeHandle braggi_rt_region_find_periscope(BraggiRegionHandle source,
+                                                      BraggiRegionHandle target) {
+    if (!source || !target) {
+        set_error(BRAGGI_RT_ERROR_INVALID_HANDLE);
+        return NULL;
+    }
+    
+    for (size_t i = 0; i < source->outgoing_periscope_count; i++) {
+        if (source->outgoing_periscopes[i]->target == target) {
+            set_error(BRAGGI_RT_SUCCESS);
+            return source->outgoing_periscopes[i];
+        }
+    }
+    
+    set_error(BRAGGI_RT_ERROR_INVALID_PERISCOPE);
+    return NULL;
+}
+
 // Destroy a periscope
 void braggi_rt_region_destroy_periscope(BraggiPeriscopeHandle periscope) {
     if (!periscope) {
@@ -403,6 +736,12 @@ void braggi_rt_region_destroy_periscope(BraggiPeriscopeHandle periscope) {
         return;
     }
     
+    // Borrowed views would point through a periscope that's gone
+    if (atomic_load(&periscope->borrows) > 0) {
+        set_error(BRAGGI_RT_ERROR_DANGLING_REFERENCE);
+        return;
+    }
+    
     BraggiRegionHandle source = periscope->source;
     BraggiRegionHandle target = periscope->target;
     
@@ -432,6 +771,189 @@ void braggi_rt_region_destroy_periscope(BraggiPeriscopeHandle periscope) {
     set_error(BRAGGI_RT_SUCCESS);
 }
 
+// Does [ptr, ptr + size) lie inside the region's pool?
+static bool range_in_region(BraggiRegionHandle region, const void* ptr, size_t size) {
+    const char* start = (const char*)region->memory_pool;
+    const char* check = (const char*)ptr;
+    return check >= start && check < start + region->size &&
+           size <= (size_t)(start + region->size - check);
+}
+
+// Work out which end of the periscope ptr is on and whether data may
+// leave from there. The regime rules were settled at creation.
+static bool transfer_ends(BraggiPeriscopeHandle periscope, const void* ptr, size_t size,
+                          BraggiRegionHandle* from, BraggiRegionHandle* to) {
+    if (!periscope || !ptr) {
+        set_error(BRAGGI_RT_ERROR_INVALID_HANDLE);
+        return false;
+    }
+    if (size == 0) {
+        set_error(BRAGGI_RT_ERROR_INVALID_SIZE);
+        return false;
+    }
+    
+    unsigned needed;
+    if (range_in_region(periscope->source, ptr, size)) {
+        *from = periscope->source;
+        *to = periscope->target;
+        needed = PERISCOPE_FLOW_FORWARD;
+    } else if (range_in_region(periscope->target, ptr, size)) {
+        *from = periscope->target;
+        *to = periscope->source;
+        needed = PERISCOPE_FLOW_BACKWARD;
+    } else {
+        set_error(BRAGGI_RT_ERROR_INVALID_ACCESS);
+        return false;
+    }
+    
+    if (!(periscope->flow & needed)) {
+        set_error(BRAGGI_RT_ERROR_INVALID_PERISCOPE);
+        return false;
+    }
+    
+    // Shared regions keep no records, so the pool check is all they get
+    if (!(*from)->shared && !find_allocation_range(*from, ptr, size)) {
+        set_error(BRAGGI_RT_ERROR_INVALID_ALLOCATION);
+        return false;
+    }
+    return true;
+}
+
+// Copy a payload. Big ones are written with streaming stores so they
+// don't push the receiver's working set out of cache on the way.
+static void transfer_bytes(void* dest, const void* src, size_t size) {
+#if defined(__SSE2__)
+    if (size >= BRAGGI_RT_STREAM_THRESHOLD) {
+        char* d = (char*)dest;
+        const char* s = (const char*)src;
+        
+        // Streaming stores need 16-byte aligned destinations
+        size_t head = (16 - ((uintptr_t)d & 15)) & 15;
+        memcpy(d, s, head);
+        d += head;
+        s += head;
+        size -= head;
+        
+        size_t blocks = size / 64;
+        for (size_t i = 0; i < blocks; i++) {
+            __m128i a = _mm_loadu_si128((const __m128i*)(s + 0));
+            __m128i b = _mm_loadu_si128((const __m128i*)(s + 16));
+            __m128i c = _mm_loadu_si128((const __m128i*)(s + 32));
+            __m128i e = _mm_loadu_si128((const __m128i*)(s + 48));
+            _mm_stream_si128((__m128i*)(d + 0), a);
+            _mm_stream_si128((__m128i*)(d + 16), b);
+            _mm_stream_si128((__m128i*)(d + 32), c);
+            _mm_stream_si128((__m128i*)(d + 48), e);
+            d += 64;
+            s += 64;
+        }
+        _mm_sfence();
+        
+        memcpy(d, s, size - blocks * 64);
+        return;
+    }
+#endif
+    memcpy(dest, src, size);
+}
+
+static void count_transfer(BraggiRegionHandle from, BraggiRegionHandle to) {
+    count(from, &from->counters.transfers_out, 1);
+    count(to, &to->counters.transfers_in, 1);
+}
+
+// Copy bytes to the other end of a periscope
+void* braggi_rt_periscope_copy(BraggiPeriscopeHandle periscope, const void* ptr, size_t size) {
+    BraggiRegionHandle from;
+    BraggiRegionHandle to;
+    if (!transfer_ends(periscope, ptr, size, &from, &to)) {
+        return NULL;
+    }
+    void* dest = braggi_rt_region_alloc(to, size, 0, "periscope copy");
+    if (!dest) {
+        return NULL;
+    }
+    
+    transfer_bytes(dest, ptr, size);
+    count_transfer(from, to);
+    set_error(BRAGGI_RT_SUCCESS);
+    return dest;
+}
+
+// Move an allocation to the other end of a periscope
+void* braggi_rt_periscope_move(BraggiPeriscopeHandle periscope, void* ptr, size_t size) {
+    BraggiRegionHandle from;
+    BraggiRegionHandle to;
+    if (!transfer_ends(periscope, ptr, size, &from, &to)) {
+        return NULL;
+    }
+    
+    // The receiver inherits the allocation's source position and label
+    uint32_t source_pos = 0;
+    const char* label = "periscope move";
+    if (!from->shared) {
+        // The sender frees the whole allocation, so only whole ones move
+        BraggiAllocation* alloc = find_allocation(from, ptr);
+        if (!alloc) {
+            set_error(BRAGGI_RT_ERROR_INVALID_ALLOCATION);
+            return NULL;
+        }
+        if (size != alloc->size) {
+            set_error(BRAGGI_RT_ERROR_INVALID_SIZE);
+            return NULL;
+        }
+        source_pos = alloc->source_pos;
+        if (alloc->label) {
+            label = alloc->label;
+        }
+    }
+    
+    void* dest = braggi_rt_region_alloc(to, size, source_pos, label);
+    if (!dest) {
+        return NULL;
+    }
+    
+    transfer_bytes(dest, ptr, size);
+    braggi_rt_region_free(from, ptr);
+    count_transfer(from, to);
+    
+    set_error(BRAGGI_RT_SUCCESS);
+    return dest;
+}
+
+// Lend bytes to the other end of a periscope without copying
+bool braggi_rt_periscope_borrow(BraggiPeriscopeHandle periscope, const void* ptr,
+                                size_t size, BraggiBorrow* out) {
+    BraggiRegionHandle from;
+    BraggiRegionHandle to;
+    if (!out || !transfer_ends(periscope, ptr, size, &from, &to)) {
+        if (!out) set_error(BRAGGI_RT_ERROR_INVALID_HANDLE);
+        return false;
+    }
+    atomic_fetch_add_explicit(&periscope->borrows, 1, memory_order_relaxed);
+    count_transfer(from, to);
+    out->data = ptr;
+    out->size = size;
+    out->periscope = periscope;
+    
+    set_error(BRAGGI_RT_SUCCESS);
+    return true;
+}
+
+// Hand a borrowed view back
+void braggi_rt_periscope_release(BraggiBorrow* borrow) {
+    if (!borrow || !borrow->periscope) {
+        set_error(BRAGGI_RT_ERROR_INVALID_HANDLE);
+        return;
+    }
+    
+    atomic_fetch_sub_explicit(&borrow->periscope->borrows, 1, memory_order_relaxed);
+    borrow->data = NULL;
+    borrow->size = 0;
+    borrow->periscope = NULL;
+    
+    set_error(BRAGGI_RT_SUCCESS);
+}
+
 // Get error message for a runtime error code
 const char* braggi_rt_error_string(BraggiRuntimeError error) {
     switch (error) {
@@ -0,0 +1,234 @@
+/*
+ * Braggi - Immediate Values Implementation
+ *
+ * "Keep the little things handy and the big things in the barn -
+ * and always know whose barn it is!" - Irish-Texan Homestead Wisdom
+ */
+
+#include "braggi/value.h"
+#include "braggi/rt_io.h"
+#include "braggi/rt_superposition.h"
+#include <string.h>
+#include <inttypes.h>
+
+// Runtime regions bump-allocate without padding, so keep our blocks aligned
+#define VAL_ALIGN(size) (((size) + 7) & ~(size_t)7)
+
+static void* val_alloc(BraggiRegionHandle region, size_t size, const char* label) {
+    if (!region || size == 0) return NULL;
+    return braggi_rt_region_alloc(region, VAL_ALIGN(size), 0, label);
+}
+
+BraggiVal braggi_val_string(BraggiRegionHandle region, const char* text, size_t length) {
+    if (!text) return braggi_val_error("string from NULL");
+    if (length > UINT32_MAX) return braggi_val_error("string too long");
+
+    char* data = (char*)val_alloc(region, length + 1, "string");
+    if (!data) return braggi_val_error("out of region memory for string");
+
+    memcpy(data, text, length);
+    data[length] = '\0';
+
+    BraggiVal value = { BRAGGI_VAL_STRING, (uint32_t)length, { .string = data } };
+    return value;
+}
+
+static size_t elem_size(BraggiElemKind kind) {
+    switch (kind) {
+        case BRAGGI_ELEM_I64: return sizeof(int64_t);
+        case BRAGGI_ELEM_F64: return sizeof(double);
+        default:              return sizeof(BraggiVal);
+    }
+}
+
+BraggiVal braggi_val_typed_array(BraggiRegionHandle region, BraggiElemKind kind, size_t capacity) {
+    BraggiValArray* array = (BraggiValArray*)val_alloc(region, sizeof(BraggiValArray), "array");
+    if (!array) return braggi_val_error("out of region memory for array");
+
+    array->region = region;
+    array->kind = kind;
+    array->length = 0;
+    array->capacity = capacity;
+    array->items = NULL;
+
+    if (capacity > 0) {
+        array->items = val_alloc(region, capacity * elem_size(kind), "array items");
+        if (!array->items) return braggi_val_error("out of region memory for array");
+    }
+
+    BraggiVal value = { BRAGGI_VAL_ARRAY, 0, { .array = array } };
+    return value;
+}
+
+BraggiVal braggi_val_array(BraggiRegionHandle region, size_t capacity) {
+    return braggi_val_typed_array(region, BRAGGI_ELEM_ANY, capacity);
+}
+
+bool braggi_val_array_push(BraggiVal array, BraggiVal item) {
+    if (array.tag != BRAGGI_VAL_ARRAY || !array.as.array) return false;
+
+    BraggiValArray* payload = array.as.array;
+    if (payload->kind == BRAGGI_ELEM_I64 && item.tag != BRAGGI_VAL_INT) return false;
+    if (payload->kind == BRAGGI_ELEM_F64 && !braggi_val_is_number(item)) return false;
+
+    if (payload->length == payload->capacity) {
+        // The old block stays behind until the region goes
+        size_t size = elem_size(payload->kind);
+        size_t capacity = payload->capacity ? payload->capacity * 2 : 8;
+        void* items = val_alloc(payload->region, capacity * size, "array items");
+        if (!items) return false;
+
+        if (payload->length > 0) {
+            memcpy(items, payload->items, payload->length * size);
+        }
+        payload->items = items;
+        payload->capacity = capacity;
+    }
+
+    switch (payload->kind) {
+        case BRAGGI_ELEM_I64: payload->i64[payload->length++] = item.as.integer; break;
+        case BRAGGI_ELEM_F64: payload->f64[payload->length++] = braggi_val_as_double(item); break;
+        default:              payload->items[payload->length++] = item; break;
+    }
+    return true;
+}
+
+size_t braggi_val_array_length(BraggiVal array) {
+    if (array.tag != BRAGGI_VAL_ARRAY || !array.as.array) return 0;
+    return array.as.array->length;
+}
+
+BraggiVal braggi_val_array_get(BraggiVal array, size_t index) {
+    if (array.tag != BRAGGI_VAL_ARRAY || !array.as.array) return braggi_val_null();
+    if (index >= array.as.array->length) return braggi_val_null();
+
+    switch (array.as.array->kind) {
+        case BRAGGI_ELEM_I64: return braggi_val_int(array.as.array->i64[index]);
+        case BRAGGI_ELEM_F64: return braggi_val_float(array.as.array->f64[index]);
+        default:              return array.as.array->items[index];
+    }
+}
+
+bool braggi_val_equals(BraggiVal a, BraggiVal b) {
+    if (braggi_val_is_number(a) && braggi_val_is_number(b)) {
+        if (a.tag == BRAGGI_VAL_INT && b.tag == BRAGGI_VAL_INT) {
+            return a.as.integer == b.as.integer;
+        }
+        return braggi_val_as_double(a) == braggi_val_as_double(b);
+    }
+
+    if (a.tag != b.tag) return false;
+
+    switch (a.tag) {
+        case BRAGGI_VAL_NULL:
+            return true;
+        case BRAGGI_VAL_BOOL:
+            return a.as.boolean == b.as.boolean;
+        case BRAGGI_VAL_STRING:
+            return a.length == b.length && memcmp(a.as.string, b.as.string, a.length) == 0;
+        case BRAGGI_VAL_ARRAY: {
+            size_t length = braggi_val_array_length(a);
+            if (length != braggi_val_array_length(b)) return false;
+            for (size_t i = 0; i < length; i++) {
+                if (!braggi_val_equals(braggi_val_array_get(a, i), braggi_val_array_get(b, i))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case BRAGGI_VAL_ERROR:
+            return a.as.string == b.as.string;
+        case BRAGGI_VAL_SUPERPOSITION:
+            return a.as.superposition == b.as.superposition;
+        default:
+            return false;
+    }
+}
+
+bool braggi_val_truthy(BraggiVal value) {
+    switch (value.tag) {
+        case BRAGGI_VAL_BOOL:   return value.as.boolean;
+        case BRAGGI_VAL_INT:    return value.as.integer != 0;
+        case BRAGGI_VAL_FLOAT:  return value.as.number != 0.0;
+        case BRAGGI_VAL_STRING: return value.length > 0;
+        case BRAGGI_VAL_ARRAY:  return true;
+        case BRAGGI_VAL_SUPERPOSITION:
+            // A condition is an observation
+            return braggi_val_truthy(braggi_super_observe(value));
+        default:                return false;
+    }
+}
+
+const char* braggi_val_type_name(BraggiVal value) {
+    switch (value.tag) {
+        case BRAGGI_VAL_NULL:   return "null";
+        case BRAGGI_VAL_BOOL:   return "bool";
+        case BRAGGI_VAL_INT:    return "int";
+        case BRAGGI_VAL_FLOAT:  return "float";
+        case BRAGGI_VAL_STRING: return "string";
+        case BRAGGI_VAL_ARRAY:  return "array";
+        case BRAGGI_VAL_ERROR:  return "error";
+        case BRAGGI_VAL_SUPERPOSITION: return "superposition";
+        default:                return "unknown";
+    }
+}
+
+void braggi_val_print(BraggiVal value, FILE* stream) {
+    if (!stream) return;
+    braggi_io_sync(stream);
+
+    switch (value.tag) {
+        case BRAGGI_VAL_NULL:
+            fputs("null", stream);
+            break;
+        case BRAGGI_VAL_BOOL:
+            fputs(value.as.boolean ? "true" : "false", stream);
+            break;
+        case BRAGGI_VAL_INT:
+            fprintf(stream, "%" PRId64, value.as.integer);
+            break;
+        case BRAGGI_VAL_FLOAT: {
+            // Same shortest form io.print uses
+            char text[BRAGGI_IO_NUMBER_MAX];
+            fwrite(text, 1, braggi_io_format_f64(value.as.number, text), stream);
+            break;
+        }
+        case BRAGGI_VAL_STRING:
+            fwrite(value.as.string, 1, value.length, stream);
+            break;
+        case BRAGGI_VAL_ARRAY: {
+            size_t length = braggi_val_array_length(value);
+            fputc('[', stream);
+            for (size_t i = 0; i < length; i++) {
+                if (i > 0) fputs(", ", stream);
+                braggi_val_print(braggi_val_array_get(value, i), stream);
+            }
+            fputc(']', stream);
+            break;
+        }
+        case BRAGGI_VAL_ERROR:
+            fprintf(stream, "error: %s", value.as.string ? value.as.string : "unknown");
+            break;
+        case BRAGGI_VAL_SUPERPOSITION: {
+            // Printing doesn't observe; once observed, only the outcome is left
+            if (value.as.superposition->observed >= 0) {
+                braggi_val_print(braggi_super_observe(value), stream);
+                break;
+            }
+            size_t count = braggi_super_count(value);
+            fputs("superpose(", stream);
+            for (size_t i = 0; i < count; i++) {
+                double probability = 0.0;
+                if (i > 0) fputs(", ", stream);
+                braggi_val_print(braggi_super_at(value, i, &probability), stream);
+                fputs(" @ ", stream);
+                braggi_val_print(braggi_val_float(probability), stream);
+            }
+            fputc(')', stream);
+            break;
+        }
+        default:
+            fputs("<unknown>", stream);
+            break;
+    }
+}
@@ -284,6 +284,31 @@ static char** split_lines(const char* str, unsigned int* num_lines) {
 // Global file ID counter for unique source file IDs
 static uint32_t next_file_id = 1;
 
+// Give a new source its range of locations. Offsets count a newline
+// after every line, the same way the tokenizer walks the lines.
+static void register_source_locations(Source* source) {
+    source->loc_base = BRAGGI_SOURCE_LOC_INVALID;
+    
+    size_t line_count = source->num_lines > 0 ? source->num_lines : 1;
+    uint32_t* line_map = (uint32_t*)malloc(line_count * sizeof(uint32_t));
+    if (!line_map) {
+        return;
+    }
+    
+    uint64_t offset = 0;
+    line_map[0] = 0;
+    for (unsigned int i = 0; i < source->num_lines; i++) {
+        line_map[i] = (uint32_t)offset;
+        offset += (source->lines[i] ? strlen(source->lines[i]) : 0) + 1;
+    }
+    
+    if (offset <= UINT32_MAX) {
+        source->loc_base = braggi_source_loc_add_file(source->file_id, source->filename,
+                                                      line_map, line_count, (uint32_t)offset);
+    }
+    free(line_map);
+}
+
 Source* braggi_source_file_create(const char* filename) {
     if (!filename) {
         fprintf(stderr, "DEBUG: Filename is NULL in source_file_create\n");
@@ -353,6 +378,7 @@ Source* braggi_source_file_create(const char* filename) {
     source->num_lines = num_lines;
     source->is_file = true;
     source->file_id = next_file_id++;
+    register_source_locations(source);
     
     // Initialize ECS integration data
     source->position_entities = NULL;
@@ -390,6 +416,7 @@ Source* braggi_source_string_create(const char* source_str, const char* name) {
     source->num_lines = num_lines;
     source->is_file = false;
     source->file_id = next_file_id++;
+    register_source_locations(source);
     
     // Initialize ECS integration data
     source->position_entities = NULL;
@@ -625,6 +652,7 @@ Source* braggi_source_from_string(const char* name, const char* content, size_t
     source->num_lines = num_lines;
     source->is_file = false;
     source->file_id = next_file_id++;
+    register_source_locations(source);
     
     // Initialize ECS integration data
     source->position_entities = NULL;
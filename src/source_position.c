@@ -9,6 +9,259 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <pthread.h>
+
+// A file's slice of the location address space
+typedef struct LocFile {
+    BraggiSourceLoc base;     // Location of the file's first byte
+    uint32_t span;            // IDs the file owns: its length plus its end
+    SourceFile file;          // Line map and name; content isn't kept
+} LocFile;
+
+// Where to find a file's base, kept in order of file ID
+typedef struct LocId {
+    uint32_t file_id;
+    BraggiSourceLoc base;
+} LocId;
+
+// Files in order of base, which is also the order they were added
+static pthread_mutex_t loc_lock = PTHREAD_MUTEX_INITIALIZER;
+static LocFile* loc_files = NULL;
+static LocId* loc_ids = NULL;
+static size_t loc_file_count = 0;
+static size_t loc_file_capacity = 0;
+static BraggiSourceLoc loc_next_base = 1;  // 0 stays "unknown"
+
+// Index of the first ID entry not below file_id
+static size_t loc_id_slot(uint32_t file_id) {
+    size_t low = 0;
+    size_t high = loc_file_count;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (loc_ids[mid].file_id < file_id) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// Index of the last file whose base is at or below loc, plus one
+static size_t loc_base_slot(BraggiSourceLoc loc) {
+    size_t low = 0;
+    size_t high = loc_file_count;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (loc_files[mid].base <= loc) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// File whose range holds loc, by binary search on the bases
+static const LocFile* loc_find(BraggiSourceLoc loc) {
+    size_t slot = loc_base_slot(loc);
+    if (slot == 0) {
+        return NULL;
+    }
+
+    const LocFile* entry = &loc_files[slot - 1];
+    return loc - entry->base < entry->span ? entry : NULL;
+}
+
+// File with this ID: its base from the ID index, then the file by base
+static const LocFile* loc_find_id(uint32_t file_id) {
+    size_t slot = loc_id_slot(file_id);
+    if (slot == loc_file_count || loc_ids[slot].file_id != file_id) {
+        return NULL;
+    }
+    return loc_find(loc_ids[slot].base);
+}
+
+static void loc_free_file(LocFile* entry) {
+    free(entry->file.filename);
+    free(entry->file.line_map);
+}
+
+BraggiSourceLoc braggi_source_loc_add_file(uint32_t file_id, const char* filename,
+                                           const uint32_t* line_map, size_t line_count,
+                                           uint32_t length) {
+    if (!line_map || line_count == 0) {
+        return BRAGGI_SOURCE_LOC_INVALID;
+    }
+
+    pthread_mutex_lock(&loc_lock);
+
+    const LocFile* existing = loc_find_id(file_id);
+    if (existing) {
+        BraggiSourceLoc base = existing->base;
+        pthread_mutex_unlock(&loc_lock);
+        return base;
+    }
+
+    // Out of address space - positions in this file stay unknown
+    uint64_t span = (uint64_t)length + 1;
+    if ((uint64_t)loc_next_base + span > UINT32_MAX) {
+        pthread_mutex_unlock(&loc_lock);
+        return BRAGGI_SOURCE_LOC_INVALID;
+    }
+
+    if (loc_file_count == loc_file_capacity) {
+        size_t capacity = loc_file_capacity ? loc_file_capacity * 2 : 16;
+        LocFile* files = (LocFile*)realloc(loc_files, capacity * sizeof(LocFile));
+        if (files) {
+            loc_files = files;
+        }
+        LocId* ids = files ? (LocId*)realloc(loc_ids, capacity * sizeof(LocId)) : NULL;
+        if (!ids) {
+            pthread_mutex_unlock(&loc_lock);
+            return BRAGGI_SOURCE_LOC_INVALID;
+        }
+        loc_ids = ids;
+        loc_file_capacity = capacity;
+    }
+
+    uint32_t* map = (uint32_t*)malloc(line_count * sizeof(uint32_t));
+    char* name = strdup(filename ? filename : "<unknown>");
+    if (!map || !name) {
+        free(map);
+        free(name);
+        pthread_mutex_unlock(&loc_lock);
+        return BRAGGI_SOURCE_LOC_INVALID;
+    }
+    memcpy(map, line_map, line_count * sizeof(uint32_t));
+
+    size_t slot = loc_id_slot(file_id);
+    memmove(&loc_ids[slot + 1], &loc_ids[slot], (loc_file_count - slot) * sizeof(LocId));
+    loc_ids[slot].file_id = file_id;
+    loc_ids[slot].base = loc_next_base;
+
+    LocFile* entry = &loc_files[loc_file_count++];
+    entry->base = loc_next_base;
+    entry->span = (uint32_t)span;
+    entry->file.filename = name;
+    entry->file.content = NULL;
+    entry->file.length = span;  // The end of the file decodes too
+    entry->file.line_map = map;
+    entry->file.line_count = line_count;
+    entry->file.file_id = file_id;
+    loc_next_base += (uint32_t)span;
+
+    BraggiSourceLoc base = entry->base;
+    pthread_mutex_unlock(&loc_lock);
+    return base;
+}
+
+void braggi_source_loc_remove_file(uint32_t file_id) {
+    pthread_mutex_lock(&loc_lock);
+
+    size_t id_slot = loc_id_slot(file_id);
+    if (id_slot < loc_file_count && loc_ids[id_slot].file_id == file_id) {
+        size_t slot = loc_base_slot(loc_ids[id_slot].base) - 1;
+        LocFile* entry = &loc_files[slot];
+
+        // The newest file's range can be handed out again
+        if (slot == loc_file_count - 1) {
+            loc_next_base = entry->base;
+        }
+
+        loc_free_file(entry);
+        memmove(entry, entry + 1, (loc_file_count - slot - 1) * sizeof(LocFile));
+        memmove(&loc_ids[id_slot], &loc_ids[id_slot + 1], (loc_file_count - id_slot - 1) * sizeof(LocId));
+        loc_file_count--;
+    }
+
+    pthread_mutex_unlock(&loc_lock);
+}
+
+void braggi_source_loc_reset(void) {
+    pthread_mutex_lock(&loc_lock);
+
+    for (size_t i = 0; i < loc_file_count; i++) {
+        loc_free_file(&loc_files[i]);
+    }
+    free(loc_files);
+    free(loc_ids);
+    loc_files = NULL;
+    loc_ids = NULL;
+    loc_file_count = 0;
+    loc_file_capacity = 0;
+    loc_next_base = 1;
+
+    pthread_mutex_unlock(&loc_lock);
+}
+
+BraggiSourceLoc braggi_source_loc_get(uint32_t file_id, uint32_t offset) {
+    pthread_mutex_lock(&loc_lock);
+
+    BraggiSourceLoc loc = BRAGGI_SOURCE_LOC_INVALID;
+    const LocFile* entry = loc_find_id(file_id);
+    if (entry && offset < entry->span) {
+        loc = entry->base + offset;
+    }
+
+    pthread_mutex_unlock(&loc_lock);
+    return loc;
+}
+
+BraggiSourceLoc braggi_source_loc_from_position(const SourcePosition* position) {
+    if (!position) {
+        return BRAGGI_SOURCE_LOC_INVALID;
+    }
+
+    pthread_mutex_lock(&loc_lock);
+
+    BraggiSourceLoc loc = BRAGGI_SOURCE_LOC_INVALID;
+    const LocFile* entry = loc_find_id(position->file_id);
+    if (entry) {
+        uint64_t offset = position->offset;
+        if (offset == 0 && position->line > 0 && position->line <= entry->file.line_count) {
+            offset = (uint64_t)entry->file.line_map[position->line - 1] +
+                     (position->column > 0 ? position->column - 1 : 0);
+        }
+        if (offset < entry->span) {
+            loc = entry->base + (uint32_t)offset;
+        }
+    }
+
+    pthread_mutex_unlock(&loc_lock);
+    return loc;
+}
+
+bool braggi_source_loc_decode(BraggiSourceLoc loc, SourcePosition* position) {
+    if (!position) {
+        return false;
+    }
+    memset(position, 0, sizeof(*position));
+
+    if (loc == BRAGGI_SOURCE_LOC_INVALID) {
+        return false;
+    }
+
+    pthread_mutex_lock(&loc_lock);
+
+    const LocFile* entry = loc_find(loc);
+    if (entry) {
+        position->file_id = entry->file.file_id;
+        position->offset = loc - entry->base;
+        braggi_source_position_get_line_col(&entry->file, position);
+    }
+
+    pthread_mutex_unlock(&loc_lock);
+    return entry != NULL;
+}
+
+const char* braggi_source_loc_filename(BraggiSourceLoc loc) {
+    pthread_mutex_lock(&loc_lock);
+    const LocFile* entry = loc_find(loc);
+    const char* name = entry ? entry->file.filename : NULL;
+    pthread_mutex_unlock(&loc_lock);
+    return name;
+}
 
 /*
  * Create a source position from line and column
@@ -93,7 +346,8 @@ int braggi_source_position_compare(const SourcePosition* a, const SourcePosition
  * sometimes ya gotta look at the whole trail to know where it's at!" - Position Detective
  */
 void braggi_source_position_get_line_col(const SourceFile* file, SourcePosition* position) {
-    if (!file || !position || !file->content || !file->line_map) {
+    // Only the line map is needed, so files without content work too
+    if (!file || !position || !file->line_map || file->line_count == 0) {
         return;
     }
     
@@ -0,0 +1,174 @@
+/*
+ * Braggi - Numeric Kernels Implementation
+ *
+ * "Four hands on the rope pull faster than two - so long as
+ * nobody's standin' on it!" - Irish-Texan Barn Raisin' Wisdom
+ *
+ * The element-wise loops are left simple, with restrict pointers, so the
+ * optimizer can vectorize them. Floating point addition isn't
+ * associative, so the reductions keep four independent partial results
+ * by hand. That lets them use SIMD lanes without -ffast-math.
+ * CMakeLists.txt builds this file with -O3 regardless of build type.
+ */
+
+#include "braggi/math_kernels.h"
+
+#define ELEMENTWISE(name, type, op)                                               \
+    void name(type* restrict out, const type* restrict a,                         \
+              const type* restrict b, size_t n) {                                 \
+        for (size_t i = 0; i < n; i++) out[i] = a[i] op b[i];                     \
+    }
+
+ELEMENTWISE(braggi_kernel_add_f64, double, +)
+ELEMENTWISE(braggi_kernel_sub_f64, double, -)
+ELEMENTWISE(braggi_kernel_mul_f64, double, *)
+ELEMENTWISE(braggi_kernel_div_f64, double, /)
+
+#undef ELEMENTWISE
+
+void braggi_kernel_fma_f64(double* restrict out, const double* restrict a,
+                           const double* restrict b, const double* restrict c, size_t n) {
+    for (size_t i = 0; i < n; i++) out[i] = a[i] * b[i] + c[i];
+}
+
+void braggi_kernel_add_scalar_f64(double* restrict out, const double* restrict a, double s, size_t n) {
+    for (size_t i = 0; i < n; i++) out[i] = a[i] + s;
+}
+
+void braggi_kernel_mul_scalar_f64(double* restrict out, const double* restrict a, double s, size_t n) {
+    for (size_t i = 0; i < n; i++) out[i] = a[i] * s;
+}
+
+void braggi_kernel_div_scalar_f64(double* restrict out, const double* restrict a, double s, size_t n) {
+    for (size_t i = 0; i < n; i++) out[i] = a[i] / s;
+}
+
+void braggi_kernel_rsub_scalar_f64(double* restrict out, const double* restrict a, double s, size_t n) {
+    for (size_t i = 0; i < n; i++) out[i] = s - a[i];
+}
+
+void braggi_kernel_rdiv_scalar_f64(double* restrict out, const double* restrict a, double s, size_t n) {
+    for (size_t i = 0; i < n; i++) out[i] = s / a[i];
+}
+
+double braggi_kernel_dot_f64(const double* restrict a, const double* restrict b, size_t n) {
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += a[i]     * b[i];
+        s1 += a[i + 1] * b[i + 1];
+        s2 += a[i + 2] * b[i + 2];
+        s3 += a[i + 3] * b[i + 3];
+    }
+    for (; i < n; i++) s0 += a[i] * b[i];
+    return (s0 + s1) + (s2 + s3);
+}
+
+double braggi_kernel_sum_f64(const double* restrict a, size_t n) {
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += a[i];
+        s1 += a[i + 1];
+        s2 += a[i + 2];
+        s3 += a[i + 3];
+    }
+    for (; i < n; i++) s0 += a[i];
+    return (s0 + s1) + (s2 + s3);
+}
+
+double braggi_kernel_min_f64(const double* restrict a, size_t n) {
+    if (n == 0) return 0.0;
+
+    double m0 = a[0], m1 = a[0], m2 = a[0], m3 = a[0];
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        m0 = a[i]     < m0 ? a[i]     : m0;
+        m1 = a[i + 1] < m1 ? a[i + 1] : m1;
+        m2 = a[i + 2] < m2 ? a[i + 2] : m2;
+        m3 = a[i + 3] < m3 ? a[i + 3] : m3;
+    }
+    for (; i < n; i++) m0 = a[i] < m0 ? a[i] : m0;
+
+    m0 = m1 < m0 ? m1 : m0;
+    m2 = m3 < m2 ? m3 : m2;
+    return m2 < m0 ? m2 : m0;
+}
+
+double braggi_kernel_max_f64(const double* restrict a, size_t n) {
+    if (n == 0) return 0.0;
+
+    double m0 = a[0], m1 = a[0], m2 = a[0], m3 = a[0];
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        m0 = a[i]     > m0 ? a[i]     : m0;
+        m1 = a[i + 1] > m1 ? a[i + 1] : m1;
+        m2 = a[i + 2] > m2 ? a[i + 2] : m2;
+        m3 = a[i + 3] > m3 ? a[i + 3] : m3;
+    }
+    for (; i < n; i++) m0 = a[i] > m0 ? a[i] : m0;
+
+    m0 = m1 > m0 ? m1 : m0;
+    m2 = m3 > m2 ? m3 : m2;
+    return m2 > m0 ? m2 : m0;
+}
+
+// Integer math goes through uint64_t so overflow wraps instead of being undefined
+void braggi_kernel_add_i64(int64_t* restrict out, const int64_t* restrict a,
+                           const int64_t* restrict b, size_t n) {
+    for (size_t i = 0; i < n; i++) out[i] = (int64_t)((uint64_t)a[i] + (uint64_t)b[i]);
+}
+
+void braggi_kernel_sub_i64(int64_t* restrict out, const int64_t* restrict a,
+                           const int64_t* restrict b, size_t n) {
+    for (size_t i = 0; i < n; i++) out[i] = (int64_t)((uint64_t)a[i] - (uint64_t)b[i]);
+}
+
+void braggi_kernel_mul_i64(int64_t* restrict out, const int64_t* restrict a,
+                           const int64_t* restrict b, size_t n) {
+    for (size_t i = 0; i < n; i++) out[i] = (int64_t)((uint64_t)a[i] * (uint64_t)b[i]);
+}
+
+void braggi_kernel_add_scalar_i64(int64_t* restrict out, const int64_t* restrict a, int64_t s, size_t n) {
+    for (size_t i = 0; i < n; i++) out[i] = (int64_t)((uint64_t)a[i] + (uint64_t)s);
+}
+
+void braggi_kernel_mul_scalar_i64(int64_t* restrict out, const int64_t* restrict a, int64_t s, size_t n) {
+    for (size_t i = 0; i < n; i++) out[i] = (int64_t)((uint64_t)a[i] * (uint64_t)s);
+}
+
+void braggi_kernel_rsub_scalar_i64(int64_t* restrict out, const int64_t* restrict a, int64_t s, size_t n) {
+    for (size_t i = 0; i < n; i++) out[i] = (int64_t)((uint64_t)s - (uint64_t)a[i]);
+}
+
+int64_t braggi_kernel_dot_i64(const int64_t* restrict a, const int64_t* restrict b, size_t n) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < n; i++) sum += (uint64_t)a[i] * (uint64_t)b[i];
+    return (int64_t)sum;
+}
+
+int64_t braggi_kernel_sum_i64(const int64_t* restrict a, size_t n) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < n; i++) sum += (uint64_t)a[i];
+    return (int64_t)sum;
+}
+
+int64_t braggi_kernel_min_i64(const int64_t* restrict a, size_t n) {
+    if (n == 0) return 0;
+
+    int64_t m = a[0];
+    for (size_t i = 1; i < n; i++) m = a[i] < m ? a[i] : m;
+    return m;
+}
+
+int64_t braggi_kernel_max_i64(const int64_t* restrict a, size_t n) {
+    if (n == 0) return 0;
+
+    int64_t m = a[0];
+    for (size_t i = 1; i < n; i++) m = a[i] > m ? a[i] : m;
+    return m;
+}
+
+void braggi_kernel_i64_to_f64(double* restrict out, const int64_t* restrict a, size_t n) {
+    for (size_t i = 0; i < n; i++) out[i] = (double)a[i];
+}
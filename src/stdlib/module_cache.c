@@ -0,0 +1,612 @@
+/*
+ * Braggi - Module Cache Implementation
+ *
+ * "Write it down the first time, so the second time ya
+ * just have to read!" - Irish-Texan Ledger Wisdom
+ */
+
+#define _GNU_SOURCE
+#include "braggi/module_cache.h"
+#include "braggi/stdlib.h"
+#include "braggi/rt_io.h"
+#include "braggi/source.h"
+#include "braggi/util/vector.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define MODULE_MAGIC "BRGMOD\0"
+
+// Artifact layout: header, then exports, imports, tokens and the string
+// pool, each section 8-byte aligned. Names are offsets into the pool.
+typedef struct ModuleHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t source_size;
+    int64_t source_mtime_ns;
+    uint32_t export_count;
+    uint32_t import_count;
+    uint32_t token_count;
+    uint32_t string_bytes;
+    uint64_t exports_offset;
+    uint64_t imports_offset;
+    uint64_t tokens_offset;
+    uint64_t strings_offset;
+    uint64_t total_size;
+} ModuleHeader;
+
+typedef struct ModuleExportRecord {
+    uint32_t name;
+    uint32_t kind;
+    uint32_t token_index;
+    uint32_t line;
+} ModuleExportRecord;
+
+typedef struct ModuleTokenRecord {
+    uint32_t type;
+    uint32_t text;
+    uint32_t line;
+    uint32_t column;
+} ModuleTokenRecord;
+
+struct BraggiModule {
+    char* name;
+    char* source_path;
+    bool from_cache;
+    BraggiMappedFile mapping;   // The artifact when it came from the cache directory
+    void* owned;                // The artifact when it couldn't be cached
+    const ModuleHeader* header;
+    const ModuleExportRecord* exports;
+    const uint32_t* imports;
+    const ModuleTokenRecord* tokens;
+    const char* strings;
+    struct BraggiModule* next;
+};
+
+static BraggiModule* loaded_modules = NULL;
+
+#define ALIGN8(size) (((size) + 7) & ~(size_t)7)
+
+static uint64_t hash_bytes(const char* text, size_t length) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)text[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static int64_t mtime_ns(const struct stat* info) {
+    return (int64_t)info->st_mtim.tv_sec * 1000000000 + info->st_mtim.tv_nsec;
+}
+
+// Create each missing directory along path
+static bool make_directories(char* path) {
+    for (char* p = path + 1; *p; p++) {
+        if (*p != '/') continue;
+        *p = '\0';
+        bool ok = mkdir(path, 0755) == 0 || errno == EEXIST;
+        *p = '/';
+        if (!ok) return false;
+    }
+    return mkdir(path, 0755) == 0 || errno == EEXIST;
+}
+
+// Where the artifact for a source file lives, NULL without a cache directory
+static char* cache_path_for(const char* name, const char* source_path) {
+    char directory[PATH_MAX];
+    const char* env = getenv(BRAGGI_MODULE_CACHE_ENV);
+    const char* xdg = getenv("XDG_CACHE_HOME");
+    const char* home = getenv("HOME");
+
+    if (env && *env) {
+        snprintf(directory, sizeof(directory), "%s", env);
+    } else if (xdg && *xdg) {
+        snprintf(directory, sizeof(directory), "%s/braggi/modules", xdg);
+    } else if (home && *home) {
+        snprintf(directory, sizeof(directory), "%s/.cache/braggi/modules", home);
+    } else {
+        return NULL;
+    }
+
+    if (!make_directories(directory)) return NULL;
+
+    // Different files with the same module name get different artifacts
+    char resolved[PATH_MAX];
+    const char* key = realpath(source_path, resolved) ? resolved : source_path;
+
+    char path[PATH_MAX];
+    int length = snprintf(path, sizeof(path), "%s/%s-%016llx.bgm", directory, name,
+                          (unsigned long long)hash_bytes(key, strlen(key)));
+    if (length < 0 || (size_t)length >= sizeof(path)) return NULL;
+    return strdup(path);
+}
+
+// Point a module's section views at an artifact, checking it fits
+static bool attach_artifact(BraggiModule* module, const void* data, size_t size) {
+    if (!data || size < sizeof(ModuleHeader)) return false;
+
+    const ModuleHeader* header = (const ModuleHeader*)data;
+    if (memcmp(header->magic, MODULE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != BRAGGI_MODULE_FORMAT_VERSION ||
+        header->header_size != sizeof(ModuleHeader) ||
+        header->total_size != size) {
+        return false;
+    }
+
+    if (header->exports_offset + (uint64_t)header->export_count * sizeof(ModuleExportRecord) > size ||
+        header->imports_offset + (uint64_t)header->import_count * sizeof(uint32_t) > size ||
+        header->tokens_offset + (uint64_t)header->token_count * sizeof(ModuleTokenRecord) > size ||
+        header->strings_offset + header->string_bytes > size ||
+        header->string_bytes == 0) {
+        return false;
+    }
+
+    const char* base = (const char*)data;
+    module->header = header;
+    module->exports = (const ModuleExportRecord*)(base + header->exports_offset);
+    module->imports = (const uint32_t*)(base + header->imports_offset);
+    module->tokens = (const ModuleTokenRecord*)(base + header->tokens_offset);
+    module->strings = base + header->strings_offset;
+
+    // Every string must end inside the pool
+    return module->strings[header->string_bytes - 1] == '\0';
+}
+
+// Growable arrays used while compiling
+typedef struct ModuleBuilder {
+    ModuleExportRecord* exports;
+    size_t export_count, export_capacity;
+    uint32_t* imports;
+    size_t import_count, import_capacity;
+    ModuleTokenRecord* tokens;
+    size_t token_count, token_capacity;
+    char* strings;
+    size_t string_bytes, string_capacity;
+    uint32_t* string_slots;     // Offset + 1 per slot, for deduplication
+    size_t slot_count;
+    size_t string_count;
+} ModuleBuilder;
+
+static bool grow(void** items, size_t* capacity, size_t needed, size_t item_size) {
+    if (needed <= *capacity) return true;
+
+    size_t new_capacity = *capacity ? *capacity * 2 : 64;
+    while (new_capacity < needed) new_capacity *= 2;
+
+    void* grown = realloc(*items, new_capacity * item_size);
+    if (!grown) return false;
+    *items = grown;
+    *capacity = new_capacity;
+    return true;
+}
+
+static bool rehash_strings(ModuleBuilder* builder) {
+    size_t slot_count = builder->slot_count ? builder->slot_count * 2 : 256;
+    uint32_t* slots = (uint32_t*)calloc(slot_count, sizeof(uint32_t));
+    if (!slots) return false;
+
+    for (size_t i = 0; i < builder->slot_count; i++) {
+        uint32_t entry = builder->string_slots[i];
+        if (!entry) continue;
+
+        const char* text = builder->strings + entry - 1;
+        size_t slot = hash_bytes(text, strlen(text)) & (slot_count - 1);
+        while (slots[slot]) slot = (slot + 1) & (slot_count - 1);
+        slots[slot] = entry;
+    }
+
+    free(builder->string_slots);
+    builder->string_slots = slots;
+    builder->slot_count = slot_count;
+    return true;
+}
+
+// Add a string to the pool once, returning its offset
+static bool intern(ModuleBuilder* builder, const char* text, uint32_t* out) {
+    if (!text) text = "";
+
+    if ((builder->string_count + 1) * 2 > builder->slot_count && !rehash_strings(builder)) {
+        return false;
+    }
+
+    size_t length = strlen(text);
+    size_t slot = hash_bytes(text, length) & (builder->slot_count - 1);
+    while (builder->string_slots[slot]) {
+        uint32_t offset = builder->string_slots[slot] - 1;
+        if (strcmp(builder->strings + offset, text) == 0) {
+            *out = offset;
+            return true;
+        }
+        slot = (slot + 1) & (builder->slot_count - 1);
+    }
+
+    if (builder->string_bytes + length + 1 > UINT32_MAX - 1 ||
+        !grow((void**)&builder->strings, &builder->string_capacity,
+              builder->string_bytes + length + 1, 1)) {
+        return false;
+    }
+
+    uint32_t offset = (uint32_t)builder->string_bytes;
+    memcpy(builder->strings + offset, text, length + 1);
+    builder->string_bytes += length + 1;
+    builder->string_slots[slot] = offset + 1;
+    builder->string_count++;
+    *out = offset;
+    return true;
+}
+
+static bool add_export(ModuleBuilder* builder, const char* name, BraggiExportKind kind,
+                       size_t token_index, uint32_t line) {
+    if (!grow((void**)&builder->exports, &builder->export_capacity,
+              builder->export_count + 1, sizeof(ModuleExportRecord))) {
+        return false;
+    }
+
+    ModuleExportRecord* record = &builder->exports[builder->export_count];
+    if (!intern(builder, name, &record->name)) return false;
+    record->kind = (uint32_t)kind;
+    record->token_index = (uint32_t)token_index;
+    record->line = line;
+    builder->export_count++;
+    return true;
+}
+
+static bool add_import(ModuleBuilder* builder, const char* name) {
+    if (!grow((void**)&builder->imports, &builder->import_capacity,
+              builder->import_count + 1, sizeof(uint32_t))) {
+        return false;
+    }
+    return intern(builder, name, &builder->imports[builder->import_count++]);
+}
+
+static void builder_free(ModuleBuilder* builder) {
+    free(builder->exports);
+    free(builder->imports);
+    free(builder->tokens);
+    free(builder->strings);
+    free(builder->string_slots);
+}
+
+// What a top-level keyword declares, if anything
+static bool declaration_kind(const char* text, BraggiExportKind* kind) {
+    static const struct { const char* word; BraggiExportKind kind; } declarations[] = {
+        { "fn", BRAGGI_EXPORT_FUNCTION },   { "func", BRAGGI_EXPORT_FUNCTION },
+        { "const", BRAGGI_EXPORT_CONSTANT },
+        { "var", BRAGGI_EXPORT_VARIABLE },  { "let", BRAGGI_EXPORT_VARIABLE },
+        { "struct", BRAGGI_EXPORT_TYPE },   { "enum", BRAGGI_EXPORT_TYPE },
+        { "type", BRAGGI_EXPORT_TYPE },
+        { "region", BRAGGI_EXPORT_REGION },
+    };
+
+    for (size_t i = 0; i < sizeof(declarations) / sizeof(declarations[0]); i++) {
+        if (strcmp(text, declarations[i].word) == 0) {
+            *kind = declarations[i].kind;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Tokenize the source and collect its top-level declarations and imports
+static bool compile_tokens(ModuleBuilder* builder, const char* path, const char* text, size_t length) {
+    Source* source = braggi_source_from_string(path, text, length);
+    if (!source) return false;
+
+    Vector* tokens = braggi_tokenize_all(source, true, true);
+    braggi_source_file_destroy(source);
+    if (!tokens) return false;
+
+    bool ok = true;
+    size_t count = braggi_vector_size(tokens);
+    Token** items = (Token**)malloc((count ? count : 1) * sizeof(Token*));
+    if (!items) ok = false;
+
+    size_t kept = 0;
+    for (size_t i = 0; i < count; i++) {
+        Token* token = *(Token**)braggi_vector_get(tokens, i);
+        if (!token) continue;
+        if (token->type == TOKEN_EOF || !items) {
+            braggi_token_destroy(token);
+            continue;
+        }
+        items[kept++] = token;
+    }
+    braggi_vector_destroy(tokens);
+
+    int depth = 0;
+    for (size_t i = 0; ok && i < kept; i++) {
+        Token* token = items[i];
+        const char* word = token->text ? token->text : "";
+
+        if (!grow((void**)&builder->tokens, &builder->token_capacity,
+                  builder->token_count + 1, sizeof(ModuleTokenRecord))) {
+            ok = false;
+            break;
+        }
+
+        ModuleTokenRecord* record = &builder->tokens[builder->token_count++];
+        record->type = (uint32_t)token->type;
+        SourcePosition position = braggi_token_get_position(token);
+        record->line = position.line;
+        record->column = position.column;
+        if (!intern(builder, word, &record->text)) {
+            ok = false;
+            break;
+        }
+
+        if (token->type == TOKEN_PUNCTUATION) {
+            if (strcmp(word, "{") == 0) depth++;
+            else if (strcmp(word, "}") == 0 && depth > 0) depth--;
+            continue;
+        }
+        if (depth != 0 || i + 1 >= kept) continue;
+
+        BraggiExportKind kind;
+        Token* next = items[i + 1];
+        if (strcmp(word, "import") == 0) {
+            // Join dotted names: import a.b;
+            char name[256] = "";
+            size_t used = 0;
+            for (size_t j = i + 1; j < kept && items[j]->text; j++) {
+                if (items[j]->type == TOKEN_PUNCTUATION) break;
+                int added = snprintf(name + used, sizeof(name) - used, "%s", items[j]->text);
+                if (added < 0 || used + (size_t)added >= sizeof(name)) break;
+                used += (size_t)added;
+            }
+            if (used > 0) ok = add_import(builder, name);
+        } else if (declaration_kind(word, &kind) && next->type == TOKEN_IDENTIFIER && next->text) {
+            ok = add_export(builder, next->text, kind, i, position.line);
+        }
+    }
+
+    for (size_t i = 0; i < kept; i++) braggi_token_destroy(items[i]);
+    free(items);
+    return ok;
+}
+
+// Lay the builder out as one artifact
+static void* serialize(const ModuleBuilder* builder, const struct stat* source_info, size_t* out_size) {
+    ModuleHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MODULE_MAGIC, sizeof(header.magic));
+    header.version = BRAGGI_MODULE_FORMAT_VERSION;
+    header.header_size = sizeof(ModuleHeader);
+    header.source_size = (uint64_t)source_info->st_size;
+    header.source_mtime_ns = mtime_ns(source_info);
+    header.export_count = (uint32_t)builder->export_count;
+    header.import_count = (uint32_t)builder->import_count;
+    header.token_count = (uint32_t)builder->token_count;
+    header.string_bytes = (uint32_t)builder->string_bytes;
+
+    size_t offset = ALIGN8(sizeof(ModuleHeader));
+    header.exports_offset = offset;
+    offset = ALIGN8(offset + builder->export_count * sizeof(ModuleExportRecord));
+    header.imports_offset = offset;
+    offset = ALIGN8(offset + builder->import_count * sizeof(uint32_t));
+    header.tokens_offset = offset;
+    offset = ALIGN8(offset + builder->token_count * sizeof(ModuleTokenRecord));
+    header.strings_offset = offset;
+    offset += builder->string_bytes;
+    header.total_size = offset;
+
+    char* data = (char*)calloc(1, offset);
+    if (!data) return NULL;
+
+    memcpy(data, &header, sizeof(header));
+    if (builder->export_count) {
+        memcpy(data + header.exports_offset, builder->exports,
+               builder->export_count * sizeof(ModuleExportRecord));
+    }
+    if (builder->import_count) {
+        memcpy(data + header.imports_offset, builder->imports, builder->import_count * sizeof(uint32_t));
+    }
+    if (builder->token_count) {
+        memcpy(data + header.tokens_offset, builder->tokens,
+               builder->token_count * sizeof(ModuleTokenRecord));
+    }
+    memcpy(data + header.strings_offset, builder->strings, builder->string_bytes);
+
+    *out_size = offset;
+    return data;
+}
+
+// Write to a temporary file and rename it so readers never see half an artifact
+static bool write_artifact(const char* path, const void* data, size_t size) {
+    char temp[PATH_MAX];
+    int length = snprintf(temp, sizeof(temp), "%s.%ld.tmp", path, (long)getpid());
+    if (length < 0 || (size_t)length >= sizeof(temp)) return false;
+
+    FILE* file = fopen(temp, "wb");
+    if (!file) return false;
+
+    bool ok = fwrite(data, 1, size, file) == size;
+    ok = fclose(file) == 0 && ok;
+    if (ok) ok = rename(temp, path) == 0;
+    if (!ok) remove(temp);
+    return ok;
+}
+
+// Compile a module's source into an artifact
+static void* compile_module(const char* source_path, const struct stat* source_info, size_t* out_size) {
+    BraggiMappedFile source;
+    if (!braggi_io_map_file(source_path, &source)) return NULL;
+
+    ModuleBuilder builder;
+    memset(&builder, 0, sizeof(builder));
+
+    // The pool always holds "" so it is never empty
+    uint32_t empty;
+    bool ok = intern(&builder, "", &empty) &&
+              compile_tokens(&builder, source_path, source.data ? source.data : "", source.size);
+    braggi_io_unmap_file(&source);
+
+    void* artifact = ok ? serialize(&builder, source_info, out_size) : NULL;
+    builder_free(&builder);
+    return artifact;
+}
+
+static void module_free(BraggiModule* module) {
+    if (!module) return;
+    braggi_io_unmap_file(&module->mapping);
+    free(module->owned);
+    free(module->name);
+    free(module->source_path);
+    free(module);
+}
+
+const BraggiModule* braggi_module_find_loaded(const char* name) {
+    if (!name) return NULL;
+
+    for (BraggiModule* module = loaded_modules; module; module = module->next) {
+        if (strcmp(module->name, name) == 0) return module;
+    }
+    return NULL;
+}
+
+const BraggiModule* braggi_module_load(const char* name) {
+    if (!name || !*name || strchr(name, '/')) return NULL;
+
+    const BraggiModule* loaded = braggi_module_find_loaded(name);
+    if (loaded) return loaded;
+
+    char file_name[256];
+    snprintf(file_name, sizeof(file_name), "%s.bg", name);
+    char* source_path = braggi_stdlib_find_file(file_name);
+    if (!source_path) return NULL;
+
+    struct stat source_info;
+    BraggiModule* module = (BraggiModule*)calloc(1, sizeof(BraggiModule));
+    if (!module || stat(source_path, &source_info) != 0) {
+        free(module);
+        free(source_path);
+        return NULL;
+    }
+    module->name = strdup(name);
+    module->source_path = source_path;
+    if (!module->name) {
+        module_free(module);
+        return NULL;
+    }
+
+    char* cache_path = cache_path_for(name, source_path);
+
+    // A current artifact is used straight from the mapping
+    if (cache_path && braggi_io_map_file(cache_path, &module->mapping)) {
+        if (attach_artifact(module, module->mapping.data, module->mapping.size) &&
+            module->header->source_size == (uint64_t)source_info.st_size &&
+            module->header->source_mtime_ns == mtime_ns(&source_info)) {
+            module->from_cache = true;
+        } else {
+            braggi_io_unmap_file(&module->mapping);
+        }
+    }
+
+    if (!module->from_cache) {
+        size_t size = 0;
+        void* artifact = compile_module(source_path, &source_info, &size);
+        if (!artifact) {
+            free(cache_path);
+            module_free(module);
+            return NULL;
+        }
+
+        // Prefer the written copy so every load shares the page cache
+        if (cache_path && write_artifact(cache_path, artifact, size) &&
+            braggi_io_map_file(cache_path, &module->mapping) &&
+            attach_artifact(module, module->mapping.data, module->mapping.size)) {
+            free(artifact);
+        } else {
+            braggi_io_unmap_file(&module->mapping);
+            module->owned = artifact;
+            attach_artifact(module, artifact, size);
+        }
+    }
+    free(cache_path);
+
+    module->next = loaded_modules;
+    loaded_modules = module;
+    return module;
+}
+
+void braggi_module_unload_all(void) {
+    while (loaded_modules) {
+        BraggiModule* next = loaded_modules->next;
+        module_free(loaded_modules);
+        loaded_modules = next;
+    }
+}
+
+const char* braggi_module_name(const BraggiModule* module) {
+    return module ? module->name : NULL;
+}
+
+const char* braggi_module_source_path(const BraggiModule* module) {
+    return module ? module->source_path : NULL;
+}
+
+bool braggi_module_from_cache(const BraggiModule* module) {
+    return module && module->from_cache;
+}
+
+size_t braggi_module_export_count(const BraggiModule* module) {
+    return module ? module->header->export_count : 0;
+}
+
+bool braggi_module_export_at(const BraggiModule* module, size_t index, BraggiModuleExport* out) {
+    if (!module || !out || index >= module->header->export_count) return false;
+
+    const ModuleExportRecord* record = &module->exports[index];
+    if (record->name >= module->header->string_bytes) return false;
+
+    out->name = module->strings + record->name;
+    out->kind = (BraggiExportKind)record->kind;
+    out->token_index = record->token_index;
+    out->line = record->line;
+    return true;
+}
+
+bool braggi_module_find_export(const BraggiModule* module, const char* name, BraggiModuleExport* out) {
+    if (!module || !name) return false;
+
+    BraggiModuleExport candidate;
+    for (size_t i = 0; i < module->header->export_count; i++) {
+        if (braggi_module_export_at(module, i, &candidate) && strcmp(candidate.name, name) == 0) {
+            if (out) *out = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t braggi_module_import_count(const BraggiModule* module) {
+    return module ? module->header->import_count : 0;
+}
+
+const char* braggi_module_import_at(const BraggiModule* module, size_t index) {
+    if (!module || index >= module->header->import_count) return NULL;
+    if (module->imports[index] >= module->header->string_bytes) return NULL;
+    return module->strings + module->imports[index];
+}
+
+size_t braggi_module_token_count(const BraggiModule* module) {
+    return module ? module->header->token_count : 0;
+}
+
+bool braggi_module_token_at(const BraggiModule* module, size_t index, BraggiModuleToken* out) {
+    if (!module || !out || index >= module->header->token_count) return false;
+
+    const ModuleTokenRecord* record = &module->tokens[index];
+    if (record->text >= module->header->string_bytes) return false;
+
+    out->type = (TokenType)record->type;
+    out->text = module->strings + record->text;
+    out->line = record->line;
+    out->column = record->column;
+    return true;
+}
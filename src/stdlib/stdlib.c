@@ -12,6 +12,12 @@
 #include "braggi/builtins/builtins.h"
 #include "braggi/stdlib.h"
 #include "braggi/error.h"
+#include "braggi/value.h"
+#include "braggi/rt_string.h"
+#include "braggi/rt_io.h"
+#include "braggi/rt_superposition.h"
+#include "braggi/module_cache.h"
+#include "braggi/math_kernels.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -22,21 +28,40 @@ static void register_math_builtins(BraggiBuiltinRegistry* registry);
 static void register_string_builtins(BraggiBuiltinRegistry* registry);
 static void register_io_builtins(BraggiBuiltinRegistry* registry);
 static void register_system_builtins(BraggiBuiltinRegistry* registry);
+static void register_superposition_builtins(BraggiBuiltinRegistry* registry);
 
-// Forward declare the stub implementations of the example functions
-static BraggiValue* math_add(BraggiValue** args, size_t arg_count, void* context);
-static BraggiValue* math_subtract(BraggiValue** args, size_t arg_count, void* context);
-static BraggiValue* math_multiply(BraggiValue** args, size_t arg_count, void* context);
-static BraggiValue* math_divide(BraggiValue** args, size_t arg_count, void* context);
-static BraggiValue* string_length(BraggiValue** args, size_t arg_count, void* context);
-static BraggiValue* io_print(BraggiValue** args, size_t arg_count, void* context);
+// Forward declarations of the builtin implementations
+static BraggiVal math_add(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context);
+static BraggiVal math_subtract(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context);
+static BraggiVal math_multiply(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context);
+static BraggiVal math_divide(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context);
+static BraggiVal math_fma(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context);
+static BraggiVal math_dot(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context);
+static BraggiVal math_sum(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context);
+static BraggiVal math_min(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context);
+static BraggiVal math_max(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context);
+static BraggiVal superpose(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context);
+static BraggiVal collapse(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context);
+static BraggiVal superposition_expect(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context);
+static BraggiVal string_length(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context);
+static BraggiVal string_concat(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context);
+static BraggiVal string_slice(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context);
+static BraggiVal io_print(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context);
+static BraggiVal io_write(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context);
+static BraggiVal io_flush(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context);
+static BraggiVal io_read_file(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context);
+static BraggiVal io_read_lines(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context);
 static BraggiValue* system_exit(BraggiValue** args, size_t arg_count, void* context);
 
+// The one registry shared by initialize, lookup and cleanup
+static BraggiBuiltinRegistry* global_registry = NULL;
+
 // Default library paths to search
 static const char* default_library_paths[] = {
     "./lib",           // Current directory lib
     "../lib",          // Parent directory lib
     "/usr/local/lib/braggi",  // System lib
+    "./modules",       // User modules
     NULL
 };
 
@@ -49,13 +74,51 @@ static bool file_exists(const char* path) {
     return (stat(path, &buffer) == 0);
 }
 
-// Find a standard library file
-char* braggi_stdlib_find_file(const char* name) {
+// Remembered lookups, including misses, so each name is probed once.
+// The table is dropped if BRAGGI_LIB_PATH changes.
+typedef struct PathCacheEntry {
+    char* name;
+    char* path;    // NULL when the name wasn't found
+    struct PathCacheEntry* next;
+} PathCacheEntry;
+
+#define PATH_CACHE_BUCKETS 64
+
+static PathCacheEntry* path_cache[PATH_CACHE_BUCKETS];
+static char* path_cache_env = NULL;
+
+static size_t path_bucket(const char* name) {
+    uint32_t hash = 2166136261u;
+    while (*name) {
+        hash ^= (unsigned char)*name++;
+        hash *= 16777619u;
+    }
+    return hash & (PATH_CACHE_BUCKETS - 1);
+}
+
+// Forget every remembered lookup
+void braggi_stdlib_reset_path_cache(void) {
+    for (size_t i = 0; i < PATH_CACHE_BUCKETS; i++) {
+        PathCacheEntry* entry = path_cache[i];
+        while (entry) {
+            PathCacheEntry* next = entry->next;
+            free(entry->name);
+            free(entry->path);
+            free(entry);
+            entry = next;
+        }
+        path_cache[i] = NULL;
+    }
+    free(path_cache_env);
+    path_cache_env = NULL;
+}
+
+// Probe the search paths for a file
+static char* search_paths(const char* name, const char* env_path) {
     // Buffer for constructing paths
     char path_buffer[1024];
     
     // Check for environment variable first
-    const char* env_path = getenv(BRAGGI_LIB_PATH_ENV);
     if (env_path) {
         snprintf(path_buffer, sizeof(path_buffer), "%s/%s", env_path, name);
         if (file_exists(path_buffer)) {
@@ -75,8 +138,49 @@ char* braggi_stdlib_find_file(const char* name) {
     return NULL;
 }
 
+// Find a standard library file
+char* braggi_stdlib_find_file(const char* name) {
+    if (!name) {
+        return NULL;
+    }
+    
+    const char* env_path = getenv(BRAGGI_LIB_PATH_ENV);
+    bool env_changed = (env_path == NULL) != (path_cache_env == NULL) ||
+                       (env_path && strcmp(env_path, path_cache_env) != 0);
+    if (env_changed) {
+        braggi_stdlib_reset_path_cache();
+        path_cache_env = env_path ? strdup(env_path) : NULL;
+    }
+    
+    size_t bucket = path_bucket(name);
+    for (PathCacheEntry* entry = path_cache[bucket]; entry; entry = entry->next) {
+        if (strcmp(entry->name, name) == 0) {
+            return entry->path ? strdup(entry->path) : NULL;
+        }
+    }
+    
+    char* path = search_paths(name, env_path);
+    
+    PathCacheEntry* entry = (PathCacheEntry*)malloc(sizeof(PathCacheEntry));
+    if (entry) {
+        entry->name = strdup(name);
+        entry->path = path ? strdup(path) : NULL;
+        if (entry->name && (entry->path || !path)) {
+            entry->next = path_cache[bucket];
+            path_cache[bucket] = entry;
+        } else {
+            free(entry->name);
+            free(entry->path);
+            free(entry);
+        }
+    }
+    
+    return path;
+}
+
 // Debug function to show library paths
 void braggi_stdlib_debug_paths(void) {
+    braggi_io_sync(stdout);
     printf("Braggi standard library paths:\n");
     printf("  Environment: %s\n", getenv(BRAGGI_LIB_PATH_ENV) ? getenv(BRAGGI_LIB_PATH_ENV) : "(not set)");
     for (int i = 0; default_library_paths[i] != NULL; i++) {
@@ -88,63 +192,249 @@ void braggi_stdlib_debug_paths(void) {
 // Use the existing type from builtins.h:
 // typedef BraggiValue* (*BraggiBuiltinFunc)(BraggiValue** args, size_t arg_count, void* context);
 
-// Builtin function entry
+// Builtin function entry. An entry's index in the registry is its ID.
 typedef struct BraggiBuiltinEntry {
     const char* name;            // Function name
-    BraggiBuiltinFunc function;  // Function pointer
+    uint32_t hash;               // Hash of name, kept for probing and growth
+    BraggiBuiltinFunc function;  // Boxed calling convention, NULL for native builtins
+    BraggiNativeFunc native;     // By-value calling convention, NULL for boxed builtins
     const char* description;     // Function description
     const char* signature;       // Function type signature
     void* context;               // Context for the function
-    struct BraggiBuiltinEntry* next;  // Next in linked list
 } BraggiBuiltinEntry;
 
-// Actual implementation of BraggiBuiltinRegistry structure
+// Actual implementation of BraggiBuiltinRegistry structure. Names are
+// hashed into an open-addressed index of IDs; the entries themselves
+// stay dense so an ID is a direct index into the function table.
 typedef struct BraggiBuiltinRegistry {
-    BraggiBuiltinEntry* functions;  // Linked list of functions
-    size_t count;                   // Number of registered functions
+    BraggiBuiltinEntry* entries;  // Function table, indexed by ID
+    size_t count;                 // Number of registered functions
+    size_t capacity;              // Allocated entries
+    uint32_t* slots;              // ID + 1 per slot, 0 when empty
+    size_t slot_count;            // Power of two, at least twice count
 } BraggiBuiltinRegistry;
 
+#define REGISTRY_INITIAL_SLOTS 64
+
+static uint32_t hash_name(const char* name) {
+    uint32_t hash = 2166136261u;
+    while (*name) {
+        hash ^= (unsigned char)*name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
 // Proper implementation for builtin registry creation
 BraggiBuiltinRegistry* braggi_builtin_registry_create(void) {
     // Allocate and initialize a registry
-    BraggiBuiltinRegistry* registry = (BraggiBuiltinRegistry*)malloc(sizeof(BraggiBuiltinRegistry));
-    if (registry) {
-        registry->functions = NULL;
-        registry->count = 0;
+    BraggiBuiltinRegistry* registry = (BraggiBuiltinRegistry*)calloc(1, sizeof(BraggiBuiltinRegistry));
+    if (!registry) {
+        return NULL;
+    }
+    
+    registry->slots = (uint32_t*)calloc(REGISTRY_INITIAL_SLOTS, sizeof(uint32_t));
+    if (!registry->slots) {
+        free(registry);
+        return NULL;
     }
+    registry->slot_count = REGISTRY_INITIAL_SLOTS;
+    
     return registry;
 }
 
-// Helper to register a single builtin function
-static bool register_builtin(BraggiBuiltinRegistry* registry, 
-                             const char* name,
-                             BraggiBuiltinFunc func, 
-                             const char* description,
-                             const char* signature,
-                             void* context) {
-    if (!registry || !name || !func) {
-        return false;
+// Find the slot holding name, or the empty slot where it would go
+static size_t find_slot(const BraggiBuiltinRegistry* registry, const char* name, uint32_t hash) {
+    size_t mask = registry->slot_count - 1;
+    size_t slot = hash & mask;
+    
+    while (registry->slots[slot] != 0) {
+        const BraggiBuiltinEntry* entry = &registry->entries[registry->slots[slot] - 1];
+        if (entry->hash == hash && strcmp(entry->name, name) == 0) {
+            break;
+        }
+        slot = (slot + 1) & mask;
     }
     
-    // Create a new entry
-    BraggiBuiltinEntry* entry = (BraggiBuiltinEntry*)malloc(sizeof(BraggiBuiltinEntry));
-    if (!entry) {
+    return slot;
+}
+
+// Double the index; IDs don't change, only where they sit
+static bool grow_slots(BraggiBuiltinRegistry* registry) {
+    size_t slot_count = registry->slot_count * 2;
+    uint32_t* slots = (uint32_t*)calloc(slot_count, sizeof(uint32_t));
+    if (!slots) {
         return false;
     }
     
+    for (size_t id = 0; id < registry->count; id++) {
+        size_t slot = registry->entries[id].hash & (slot_count - 1);
+        while (slots[slot] != 0) {
+            slot = (slot + 1) & (slot_count - 1);
+        }
+        slots[slot] = (uint32_t)id + 1;
+    }
+    
+    free(registry->slots);
+    registry->slots = slots;
+    registry->slot_count = slot_count;
+    return true;
+}
+
+// Add an entry for either calling convention. Registering a name twice
+// replaces the function but keeps the ID already handed out.
+static BraggiBuiltinId add_entry(BraggiBuiltinRegistry* registry, 
+                                 const char* name,
+                                 BraggiBuiltinFunc func, 
+                                 BraggiNativeFunc native,
+                                 const char* description,
+                                 const char* signature,
+                                 void* context) {
+    if (!registry || !name || (!func && !native)) {
+        return BRAGGI_BUILTIN_INVALID;
+    }
+    
+    uint32_t hash = hash_name(name);
+    size_t slot = find_slot(registry, name, hash);
+    
+    if (registry->slots[slot] != 0) {
+        BraggiBuiltinEntry* entry = &registry->entries[registry->slots[slot] - 1];
+        entry->function = func;
+        entry->native = native;
+        entry->context = context;
+        return registry->slots[slot] - 1;
+    }
+    
+    if (registry->count >= BRAGGI_BUILTIN_INVALID - 1) {
+        return BRAGGI_BUILTIN_INVALID;
+    }
+    
+    // Keep the index at most half full
+    if ((registry->count + 1) * 2 > registry->slot_count) {
+        if (!grow_slots(registry)) {
+            return BRAGGI_BUILTIN_INVALID;
+        }
+        slot = find_slot(registry, name, hash);
+    }
+    
+    if (registry->count == registry->capacity) {
+        size_t capacity = registry->capacity ? registry->capacity * 2 : 32;
+        BraggiBuiltinEntry* entries = (BraggiBuiltinEntry*)realloc(registry->entries,
+                                                                   capacity * sizeof(BraggiBuiltinEntry));
+        if (!entries) {
+            return BRAGGI_BUILTIN_INVALID;
+        }
+        registry->entries = entries;
+        registry->capacity = capacity;
+    }
+    
     // Initialize the entry
+    BraggiBuiltinEntry* entry = &registry->entries[registry->count];
     entry->name = strdup(name);
+    if (!entry->name) {
+        return BRAGGI_BUILTIN_INVALID;
+    }
+    entry->hash = hash;
     entry->function = func;
+    entry->native = native;
     entry->description = description ? strdup(description) : NULL;
     entry->signature = signature ? strdup(signature) : NULL;
     entry->context = context;
     
-    // Add to the list (at the beginning for simplicity)
-    entry->next = registry->functions;
-    registry->functions = entry;
-    registry->count++;
+    BraggiBuiltinId id = (BraggiBuiltinId)registry->count++;
+    registry->slots[slot] = id + 1;
+    return id;
+}
+
+// Helper to register a single boxed builtin function
+static BraggiBuiltinId register_builtin(BraggiBuiltinRegistry* registry, 
+                                        const char* name,
+                                        BraggiBuiltinFunc func, 
+                                        const char* description,
+                                        const char* signature,
+                                        void* context) {
+    return add_entry(registry, name, func, NULL, description, signature, context);
+}
+
+// Helper to register a builtin that takes its arguments by value
+static BraggiBuiltinId register_native(BraggiBuiltinRegistry* registry, 
+                                       const char* name,
+                                       BraggiNativeFunc func, 
+                                       const char* description,
+                                       const char* signature,
+                                       void* context) {
+    return add_entry(registry, name, NULL, func, description, signature, context);
+}
+
+// Public registration for boxed builtins outside the stdlib
+void braggi_builtin_registry_register(BraggiBuiltinRegistry* registry, const char* name,
+                                      BraggiBuiltinFunc func, void* context) {
+    register_builtin(registry, name, func, NULL, NULL, context);
+}
+
+BraggiBuiltinId braggi_builtin_registry_resolve(const BraggiBuiltinRegistry* registry, const char* name) {
+    if (!registry || !name) {
+        return BRAGGI_BUILTIN_INVALID;
+    }
     
-    return true;
+    uint32_t slot = registry->slots[find_slot(registry, name, hash_name(name))];
+    return slot ? slot - 1 : BRAGGI_BUILTIN_INVALID;
+}
+
+size_t braggi_builtin_registry_count(const BraggiBuiltinRegistry* registry) {
+    return registry ? registry->count : 0;
+}
+
+const char* braggi_builtin_registry_name(const BraggiBuiltinRegistry* registry, BraggiBuiltinId id) {
+    if (!registry || id >= registry->count) {
+        return NULL;
+    }
+    return registry->entries[id].name;
+}
+
+BraggiBuiltinFunc braggi_builtin_registry_func_at(const BraggiBuiltinRegistry* registry,
+                                                  BraggiBuiltinId id, void** out_context) {
+    if (!registry || id >= registry->count) {
+        return NULL;
+    }
+    if (out_context) *out_context = registry->entries[id].context;
+    return registry->entries[id].function;
+}
+
+BraggiNativeFunc braggi_builtin_registry_native_at(const BraggiBuiltinRegistry* registry,
+                                                   BraggiBuiltinId id, void** out_context) {
+    if (!registry || id >= registry->count) {
+        return NULL;
+    }
+    if (out_context) *out_context = registry->entries[id].context;
+    return registry->entries[id].native;
+}
+
+BraggiVal braggi_builtin_registry_call(const BraggiBuiltinRegistry* registry, BraggiBuiltinId id,
+                                       const BraggiVal* args, size_t arg_count,
+                                       BraggiRegionHandle region) {
+    if (!registry || id >= registry->count) {
+        return braggi_val_error("unknown builtin");
+    }
+    
+    const BraggiBuiltinEntry* entry = &registry->entries[id];
+    if (!entry->native) {
+        return braggi_val_error("builtin does not take values");
+    }
+    return entry->native(args, arg_count, region, entry->context);
+}
+
+// Look up a boxed builtin by name
+BraggiBuiltinFunc braggi_builtin_registry_lookup(BraggiBuiltinRegistry* registry, const char* name, void** out_context) {
+    return braggi_builtin_registry_func_at(registry, braggi_builtin_registry_resolve(registry, name),
+                                           out_context);
+}
+
+// Look up a builtin registered with the by-value calling convention
+BraggiNativeFunc braggi_builtin_registry_lookup_native(BraggiBuiltinRegistry* registry,
+                                                      const char* name, void** out_context) {
+    return braggi_builtin_registry_native_at(registry, braggi_builtin_registry_resolve(registry, name),
+                                             out_context);
 }
 
 // Proper implementation for builtin registry destruction
@@ -153,121 +443,619 @@ void braggi_builtin_registry_destroy(BraggiBuiltinRegistry* registry) {
         return;
     }
     
-    // Free all entries
-    BraggiBuiltinEntry* entry = registry->functions;
-    while (entry) {
-        BraggiBuiltinEntry* next = entry->next;
-        
-        // Free strings
-        if (entry->name) free((void*)entry->name);
+    // Free the strings each entry owns
+    for (size_t id = 0; id < registry->count; id++) {
+        BraggiBuiltinEntry* entry = &registry->entries[id];
+        free((void*)entry->name);
         if (entry->description) free((void*)entry->description);
         if (entry->signature) free((void*)entry->signature);
-        
-        // Free the entry
-        free(entry);
-        
-        entry = next;
     }
     
     // Free the registry
+    free(registry->entries);
+    free(registry->slots);
     free(registry);
 }
 
-// Example builtin functions matching the real signature
-static BraggiValue* math_add(BraggiValue** args, size_t arg_count, void* context) {
-    // Check if we have the right number of arguments
+// Math builtins take numbers or arrays. Two ints stay an int and any
+// float makes the result a float. Arrays are worked on element-wise
+// through the kernels in math_kernels.c; a scalar operand is broadcast
+// across the array. Array results are allocated in the caller's region.
+
+typedef enum MathOp {
+    MATH_OP_ADD,
+    MATH_OP_SUB,
+    MATH_OP_MUL,
+    MATH_OP_DIV
+} MathOp;
+
+// Scalar fast path - no allocation
+static BraggiVal scalar_op(MathOp op, BraggiVal a, BraggiVal b) {
+    if (a.tag == BRAGGI_VAL_INT && b.tag == BRAGGI_VAL_INT) {
+        uint64_t x = (uint64_t)a.as.integer;
+        uint64_t y = (uint64_t)b.as.integer;
+        switch (op) {
+            case MATH_OP_ADD: return braggi_val_int((int64_t)(x + y));
+            case MATH_OP_SUB: return braggi_val_int((int64_t)(x - y));
+            case MATH_OP_MUL: return braggi_val_int((int64_t)(x * y));
+            case MATH_OP_DIV:
+                if (b.as.integer == 0) return braggi_val_error("division by zero");
+                if (a.as.integer == INT64_MIN && b.as.integer == -1) {
+                    return braggi_val_error("integer overflow");
+                }
+                return braggi_val_int(a.as.integer / b.as.integer);
+        }
+    }
+    
+    double x = braggi_val_as_double(a);
+    double y = braggi_val_as_double(b);
+    switch (op) {
+        case MATH_OP_ADD: return braggi_val_float(x + y);
+        case MATH_OP_SUB: return braggi_val_float(x - y);
+        case MATH_OP_MUL: return braggi_val_float(x * y);
+        case MATH_OP_DIV: return braggi_val_float(x / y);
+    }
+    return braggi_val_error("unknown operation");
+}
+
+// The superposition operation that matches a math operation
+static BraggiSuperOp super_op(MathOp op) {
+    switch (op) {
+        case MATH_OP_ADD: return BRAGGI_SUPER_ADD;
+        case MATH_OP_SUB: return BRAGGI_SUPER_SUB;
+        case MATH_OP_MUL: return BRAGGI_SUPER_MUL;
+        case MATH_OP_DIV: return BRAGGI_SUPER_DIV;
+    }
+    return BRAGGI_SUPER_ADD;
+}
+
+// Make a typed array of a given length; the contents are left for the caller
+static BraggiValArray* new_typed(BraggiRegionHandle region, BraggiElemKind kind, size_t length) {
+    BraggiVal array = braggi_val_typed_array(region, kind, length ? length : 1);
+    if (braggi_val_is_error(array)) return NULL;
+    
+    array.as.array->length = length;
+    return array.as.array;
+}
+
+static BraggiVal wrap_array(BraggiValArray* array) {
+    BraggiVal value = { BRAGGI_VAL_ARRAY, 0, { .array = array } };
+    return value;
+}
+
+// Get a typed view of a numeric array, converting a BRAGGI_ELEM_ANY
+// array into the region on the way. Returns NULL if it isn't all numbers.
+static BraggiValArray* numeric_array(BraggiVal value, BraggiRegionHandle region) {
+    if (value.tag != BRAGGI_VAL_ARRAY || !value.as.array) return NULL;
+    
+    BraggiValArray* array = value.as.array;
+    if (array->kind != BRAGGI_ELEM_ANY) return array;
+    
+    BraggiElemKind kind = BRAGGI_ELEM_I64;
+    for (size_t i = 0; i < array->length; i++) {
+        if (array->items[i].tag == BRAGGI_VAL_FLOAT) {
+            kind = BRAGGI_ELEM_F64;
+        } else if (array->items[i].tag != BRAGGI_VAL_INT) {
+            return NULL;
+        }
+    }
+    
+    BraggiValArray* typed = new_typed(region, kind, array->length);
+    if (!typed) return NULL;
+    
+    for (size_t i = 0; i < array->length; i++) {
+        if (kind == BRAGGI_ELEM_I64) {
+            typed->i64[i] = array->items[i].as.integer;
+        } else {
+            typed->f64[i] = braggi_val_as_double(array->items[i]);
+        }
+    }
+    return typed;
+}
+
+// Get an operand as a double buffer of the given length
+static const double* f64_operand(BraggiVal value, BraggiValArray* array,
+                                 BraggiRegionHandle region, size_t length) {
+    if (array && array->kind == BRAGGI_ELEM_F64) return array->f64;
+    
+    BraggiValArray* out = new_typed(region, BRAGGI_ELEM_F64, length);
+    if (!out) return NULL;
+    
+    if (array) {
+        braggi_kernel_i64_to_f64(out->f64, array->i64, length);
+    } else {
+        double s = braggi_val_as_double(value);
+        for (size_t i = 0; i < length; i++) out->f64[i] = s;
+    }
+    return out->f64;
+}
+
+// Get an operand as an int64_t buffer; only called when it's all ints
+static const int64_t* i64_operand(BraggiVal value, BraggiValArray* array,
+                                  BraggiRegionHandle region, size_t length) {
+    if (array) return array->i64;
+    
+    BraggiValArray* out = new_typed(region, BRAGGI_ELEM_I64, length);
+    if (!out) return NULL;
+    
+    for (size_t i = 0; i < length; i++) out->i64[i] = value.as.integer;
+    return out->i64;
+}
+
+static BraggiVal binary_op(MathOp op, const BraggiVal* args, size_t arg_count, BraggiRegionHandle region) {
     if (arg_count != 2) {
-        printf("math.add: Expected 2 arguments, got %zu\n", arg_count);
-        return NULL;
+        return braggi_val_error("expected 2 arguments");
+    }
+    
+    BraggiVal a = args[0];
+    BraggiVal b = args[1];
+    if (braggi_val_is_number(a) && braggi_val_is_number(b)) {
+        return scalar_op(op, a, b);
+    }
+    
+    // Superpositions carry the operation to every alternative
+    if (a.tag == BRAGGI_VAL_SUPERPOSITION || b.tag == BRAGGI_VAL_SUPERPOSITION) {
+        return braggi_super_apply(region, super_op(op), a, b);
     }
     
-    // In a full implementation, we would check the types of the arguments
-    // and perform proper error handling
+    if (!region) {
+        return braggi_val_error("array math needs a region");
+    }
     
-    // For the demo, just print a message about the operation being performed
-    printf("math.add: Adding two numbers (stub implementation)\n");
+    BraggiValArray* x = a.tag == BRAGGI_VAL_ARRAY ? numeric_array(a, region) : NULL;
+    BraggiValArray* y = b.tag == BRAGGI_VAL_ARRAY ? numeric_array(b, region) : NULL;
+    if ((!x && !braggi_val_is_number(a)) || (!y && !braggi_val_is_number(b))) {
+        return braggi_val_error("expected numbers or numeric arrays");
+    }
+    if (x && y && x->length != y->length) {
+        return braggi_val_error("array lengths differ");
+    }
     
-    // This would be a real implementation in the full version
-    // double a = braggi_value_to_number(args[0]);
-    // double b = braggi_value_to_number(args[1]);
-    // return braggi_value_create_number(a + b);
+    size_t n = x ? x->length : y->length;
+    bool x_int = x ? x->kind == BRAGGI_ELEM_I64 : a.tag == BRAGGI_VAL_INT;
+    bool y_int = y ? y->kind == BRAGGI_ELEM_I64 : b.tag == BRAGGI_VAL_INT;
     
-    (void)args;
+    // Integer arrays stay integer except under division
+    if (x_int && y_int && op != MATH_OP_DIV) {
+        const int64_t* xs = i64_operand(a, x, region, n);
+        const int64_t* ys = i64_operand(b, y, region, n);
+        BraggiValArray* out = new_typed(region, BRAGGI_ELEM_I64, n);
+        if (!xs || !ys || !out) return braggi_val_error("out of region memory");
+        
+        switch (op) {
+            case MATH_OP_ADD: braggi_kernel_add_i64(out->i64, xs, ys, n); break;
+            case MATH_OP_SUB: braggi_kernel_sub_i64(out->i64, xs, ys, n); break;
+            case MATH_OP_MUL: braggi_kernel_mul_i64(out->i64, xs, ys, n); break;
+            default: break;
+        }
+        return wrap_array(out);
+    }
+    
+    BraggiValArray* out = new_typed(region, BRAGGI_ELEM_F64, n);
+    if (!out) return braggi_val_error("out of region memory");
+    
+    // Broadcasting a scalar has its own kernels for the common cases
+    if (x && !y && (op == MATH_OP_ADD || op == MATH_OP_SUB || op == MATH_OP_MUL)) {
+        const double* xs = f64_operand(a, x, region, n);
+        if (!xs) return braggi_val_error("out of region memory");
+        
+        double s = braggi_val_as_double(b);
+        if (op == MATH_OP_MUL) {
+            braggi_kernel_mul_scalar_f64(out->f64, xs, s, n);
+        } else {
+            braggi_kernel_add_scalar_f64(out->f64, xs, op == MATH_OP_SUB ? -s : s, n);
+        }
+        return wrap_array(out);
+    }
+    
+    const double* xs = f64_operand(a, x, region, n);
+    const double* ys = f64_operand(b, y, region, n);
+    if (!xs || !ys) return braggi_val_error("out of region memory");
+    
+    switch (op) {
+        case MATH_OP_ADD: braggi_kernel_add_f64(out->f64, xs, ys, n); break;
+        case MATH_OP_SUB: braggi_kernel_sub_f64(out->f64, xs, ys, n); break;
+        case MATH_OP_MUL: braggi_kernel_mul_f64(out->f64, xs, ys, n); break;
+        case MATH_OP_DIV: braggi_kernel_div_f64(out->f64, xs, ys, n); break;
+    }
+    return wrap_array(out);
+}
+
+static BraggiVal math_add(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context) {
+    (void)context;
+    return binary_op(MATH_OP_ADD, args, arg_count, region);
+}
+
+static BraggiVal math_subtract(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context) {
     (void)context;
-    return NULL; // Return a BraggiValue* in a real implementation
+    return binary_op(MATH_OP_SUB, args, arg_count, region);
 }
 
-static BraggiValue* math_subtract(BraggiValue** args, size_t arg_count, void* context) {
-    // Check if we have the right number of arguments
+static BraggiVal math_multiply(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context) {
+    (void)context;
+    return binary_op(MATH_OP_MUL, args, arg_count, region);
+}
+
+static BraggiVal math_divide(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context) {
+    (void)context;
+    return binary_op(MATH_OP_DIV, args, arg_count, region);
+}
+
+static BraggiVal math_fma(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context) {
+    (void)context;
+    
+    if (arg_count != 3) {
+        return braggi_val_error("expected 3 arguments");
+    }
+    if (braggi_val_is_number(args[0]) && braggi_val_is_number(args[1]) && braggi_val_is_number(args[2])) {
+        BraggiVal product = scalar_op(MATH_OP_MUL, args[0], args[1]);
+        return scalar_op(MATH_OP_ADD, product, args[2]);
+    }
+    if (!region) {
+        return braggi_val_error("array math needs a region");
+    }
+    
+    BraggiValArray* arrays[3];
+    size_t n = 0;
+    for (size_t i = 0; i < 3; i++) {
+        arrays[i] = args[i].tag == BRAGGI_VAL_ARRAY ? numeric_array(args[i], region) : NULL;
+        if (!arrays[i] && !braggi_val_is_number(args[i])) {
+            return braggi_val_error("expected numbers or numeric arrays");
+        }
+        if (arrays[i]) {
+            if (n && arrays[i]->length != n) return braggi_val_error("array lengths differ");
+            n = arrays[i]->length;
+        }
+    }
+    
+    const double* a = f64_operand(args[0], arrays[0], region, n);
+    const double* b = f64_operand(args[1], arrays[1], region, n);
+    const double* c = f64_operand(args[2], arrays[2], region, n);
+    BraggiValArray* out = new_typed(region, BRAGGI_ELEM_F64, n);
+    if (!a || !b || !c || !out) return braggi_val_error("out of region memory");
+    
+    braggi_kernel_fma_f64(out->f64, a, b, c, n);
+    return wrap_array(out);
+}
+
+static BraggiVal math_dot(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context) {
+    (void)context;
+    
     if (arg_count != 2) {
-        printf("math.subtract: Expected 2 arguments, got %zu\n", arg_count);
-        return NULL;
+        return braggi_val_error("expected 2 arguments");
     }
     
-    // In a full implementation, we would check the types of the arguments
-    // and perform proper error handling
+    BraggiValArray* x = numeric_array(args[0], region);
+    BraggiValArray* y = numeric_array(args[1], region);
+    if (!x || !y) {
+        return braggi_val_error("expected numeric arrays");
+    }
+    if (x->length != y->length) {
+        return braggi_val_error("array lengths differ");
+    }
     
-    // For the demo, just print a message about the operation being performed
-    printf("math.subtract: Subtracting two numbers (stub implementation)\n");
+    if (x->kind == BRAGGI_ELEM_I64 && y->kind == BRAGGI_ELEM_I64) {
+        return braggi_val_int(braggi_kernel_dot_i64(x->i64, y->i64, x->length));
+    }
     
-    // This would be a real implementation in the full version
-    // double a = braggi_value_to_number(args[0]);
-    // double b = braggi_value_to_number(args[1]);
-    // return braggi_value_create_number(a - b);
+    const double* xs = f64_operand(args[0], x, region, x->length);
+    const double* ys = f64_operand(args[1], y, region, y->length);
+    if (!xs || !ys) return braggi_val_error("out of region memory");
     
-    (void)args;
+    return braggi_val_float(braggi_kernel_dot_f64(xs, ys, x->length));
+}
+
+// sum, min and max reduce one array, or fold a list of scalars
+typedef enum MathReduce {
+    MATH_REDUCE_SUM,
+    MATH_REDUCE_MIN,
+    MATH_REDUCE_MAX
+} MathReduce;
+
+static BraggiVal reduce(MathReduce kind, const BraggiVal* args, size_t arg_count, BraggiRegionHandle region) {
+    if (arg_count == 1 && args[0].tag == BRAGGI_VAL_ARRAY) {
+        BraggiValArray* array = numeric_array(args[0], region);
+        if (!array) {
+            return braggi_val_error("expected a numeric array");
+        }
+        if (array->length == 0 && kind != MATH_REDUCE_SUM) {
+            return braggi_val_error("empty array");
+        }
+        
+        if (array->kind == BRAGGI_ELEM_I64) {
+            switch (kind) {
+                case MATH_REDUCE_SUM: return braggi_val_int(braggi_kernel_sum_i64(array->i64, array->length));
+                case MATH_REDUCE_MIN: return braggi_val_int(braggi_kernel_min_i64(array->i64, array->length));
+                case MATH_REDUCE_MAX: return braggi_val_int(braggi_kernel_max_i64(array->i64, array->length));
+            }
+        }
+        switch (kind) {
+            case MATH_REDUCE_SUM: return braggi_val_float(braggi_kernel_sum_f64(array->f64, array->length));
+            case MATH_REDUCE_MIN: return braggi_val_float(braggi_kernel_min_f64(array->f64, array->length));
+            case MATH_REDUCE_MAX: return braggi_val_float(braggi_kernel_max_f64(array->f64, array->length));
+        }
+    }
+    
+    if (arg_count == 0) {
+        return braggi_val_error("expected at least 1 argument");
+    }
+    
+    BraggiVal result = args[0];
+    for (size_t i = 0; i < arg_count; i++) {
+        if (!braggi_val_is_number(args[i])) {
+            return braggi_val_error("expected numbers or one numeric array");
+        }
+        if (i == 0) continue;
+        
+        switch (kind) {
+            case MATH_REDUCE_SUM:
+                result = scalar_op(MATH_OP_ADD, result, args[i]);
+                break;
+            case MATH_REDUCE_MIN:
+                if (braggi_val_as_double(args[i]) < braggi_val_as_double(result)) result = args[i];
+                break;
+            case MATH_REDUCE_MAX:
+                if (braggi_val_as_double(args[i]) > braggi_val_as_double(result)) result = args[i];
+                break;
+        }
+    }
+    return result;
+}
+
+static BraggiVal math_sum(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context) {
     (void)context;
-    return NULL;
+    return reduce(MATH_REDUCE_SUM, args, arg_count, region);
 }
 
-static BraggiValue* math_multiply(BraggiValue** args, size_t arg_count, void* context) {
-    // Check if we have the right number of arguments
-    if (arg_count != 2) {
-        printf("math.multiply: Expected 2 arguments, got %zu\n", arg_count);
-        return NULL;
+static BraggiVal math_min(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context) {
+    (void)context;
+    return reduce(MATH_REDUCE_MIN, args, arg_count, region);
+}
+
+static BraggiVal math_max(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context) {
+    (void)context;
+    return reduce(MATH_REDUCE_MAX, args, arg_count, region);
+}
+
+// BRAGGI_SUPER_MAX_ALTERNATIVES spelled out for error messages
+#define SUPER_TEXT(n) #n
+#define SUPER_NUMBER_TEXT(n) SUPER_TEXT(n)
+#define SUPER_MAX_TEXT SUPER_NUMBER_TEXT(BRAGGI_SUPER_MAX_ALTERNATIVES)
+
+// Alternatives come as an array, weights as an optional array of numbers
+static BraggiVal superpose(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context) {
+    (void)context;
+    
+    if (arg_count < 1 || arg_count > 2 || args[0].tag != BRAGGI_VAL_ARRAY) {
+        return braggi_val_error("expected an array of alternatives and optional weights");
     }
     
-    // For the demo, just print a message about the operation being performed
-    printf("math.multiply: Multiplying two numbers (stub implementation)\n");
+    size_t count = braggi_val_array_length(args[0]);
+    if (count == 0 || count > BRAGGI_SUPER_MAX_ALTERNATIVES) {
+        return braggi_val_error("superposition needs 1 to " SUPER_MAX_TEXT " alternatives");
+    }
+    if (arg_count == 2 && args[1].tag != BRAGGI_VAL_ARRAY) {
+        return braggi_val_error("weights must be an array");
+    }
+    if (arg_count == 2 && braggi_val_array_length(args[1]) != count) {
+        return braggi_val_error("need one weight per alternative");
+    }
     
-    (void)args;
+    BraggiVal* alternatives = (BraggiVal*)malloc(count * sizeof(BraggiVal));
+    double* weights = (double*)malloc(count * sizeof(double));
+    if (!alternatives || !weights) {
+        free(alternatives);
+        free(weights);
+        return braggi_val_error("out of memory");
+    }
+    
+    BraggiVal result = braggi_val_null();
+    for (size_t i = 0; i < count; i++) {
+        alternatives[i] = braggi_val_array_get(args[0], i);
+        if (arg_count == 2) {
+            BraggiVal weight = braggi_val_array_get(args[1], i);
+            if (!braggi_val_is_number(weight)) {
+                result = braggi_val_error("weights must be numbers");
+                break;
+            }
+            weights[i] = braggi_val_as_double(weight);
+        }
+    }
+    
+    if (!braggi_val_is_error(result)) {
+        result = braggi_super_create(region, alternatives, arg_count == 2 ? weights : NULL, count);
+    }
+    
+    free(alternatives);
+    free(weights);
+    return result;
+}
+
+static BraggiVal collapse(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context) {
+    (void)region;
     (void)context;
-    return NULL;
+    
+    if (arg_count != 1) {
+        return braggi_val_error("expected 1 argument");
+    }
+    return braggi_super_observe(args[0]);
 }
 
-static BraggiValue* math_divide(BraggiValue** args, size_t arg_count, void* context) {
-    // Check if we have the right number of arguments
-    if (arg_count != 2) {
-        printf("math.divide: Expected 2 arguments, got %zu\n", arg_count);
-        return NULL;
+static BraggiVal superposition_expect(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context) {
+    (void)region;
+    (void)context;
+    
+    double mean;
+    if (arg_count != 1 || !braggi_super_expect(args[0], &mean)) {
+        return braggi_val_error("expected a number or a superposition of numbers");
     }
+    return braggi_val_float(mean);
+}
+
+static BraggiVal string_length(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context) {
+    (void)region;
+    (void)context;
     
-    // For the demo, just print a message about the operation being performed
-    printf("math.divide: Dividing two numbers (stub implementation)\n");
+    if (arg_count != 1) {
+        return braggi_val_error("expected 1 argument");
+    }
+    if (args[0].tag == BRAGGI_VAL_STRING) {
+        return braggi_val_int((int64_t)args[0].length);
+    }
+    if (args[0].tag == BRAGGI_VAL_ARRAY) {
+        return braggi_val_int((int64_t)braggi_val_array_length(args[0]));
+    }
+    return braggi_val_error("expected a string");
+}
+
+// Join any number of strings. The pieces are roped together and copied
+// once at the end, so a long argument list isn't recopied per piece.
+static BraggiVal string_concat(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context) {
+    (void)context;
     
-    (void)args;
+    BraggiStr result = braggi_str_empty();
+    for (size_t i = 0; i < arg_count; i++) {
+        if (args[i].tag != BRAGGI_VAL_STRING) {
+            return braggi_val_error("expected strings");
+        }
+        
+        BraggiStr piece = braggi_str_from_val(args[i]);
+        if (!braggi_str_concat(region, &result, &piece, &result)) {
+            return braggi_val_error("out of region memory for string");
+        }
+    }
+    
+    return braggi_str_to_val(region, &result);
+}
+
+// Bytes [start, end) of a string; end defaults to the length. Long
+// slices share the argument's bytes rather than copying them.
+static BraggiVal string_slice(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context) {
     (void)context;
-    return NULL;
+    
+    if (arg_count < 2 || arg_count > 3) {
+        return braggi_val_error("expected 2 or 3 arguments");
+    }
+    if (args[0].tag != BRAGGI_VAL_STRING || args[1].tag != BRAGGI_VAL_INT ||
+        (arg_count == 3 && args[2].tag != BRAGGI_VAL_INT)) {
+        return braggi_val_error("expected a string and integer bounds");
+    }
+    
+    int64_t start = args[1].as.integer;
+    int64_t end = arg_count == 3 ? args[2].as.integer : (int64_t)args[0].length;
+    if (start < 0 || end < start) {
+        return braggi_val_error("slice bounds out of range");
+    }
+    
+    BraggiStr text = braggi_str_from_val(args[0]);
+    BraggiStr slice;
+    if (!braggi_str_slice(region, &text, (size_t)start, (size_t)end, &slice)) {
+        return braggi_val_error("slice bounds out of range");
+    }
+    
+    return braggi_str_to_val(region, &slice);
 }
 
-static BraggiValue* string_length(BraggiValue** args, size_t arg_count, void* context) {
-    // In a real implementation, this would return the length of a string
-    printf("string.length called with %zu args\n", arg_count);
-    (void)args;
+// Output goes through this thread's buffer and reaches the descriptor
+// when it fills, at a newline on a terminal, on io.flush or at exit
+static BraggiVal io_print(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context) {
+    (void)region;
     (void)context;
-    return NULL;
+    
+    BraggiOutput* out = braggi_io_stdout();
+    bool ok = true;
+    for (size_t i = 0; ok && i < arg_count; i++) {
+        if (i > 0) ok = braggi_io_write_char(out, ' ');
+        if (ok) ok = braggi_io_write_val(out, args[i]);
+    }
+    if (ok) ok = braggi_io_write_char(out, '\n');
+    
+    return ok ? braggi_val_null() : braggi_val_error("write to standard output failed");
+}
+
+static BraggiVal io_write(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context) {
+    (void)region;
+    (void)context;
+    
+    BraggiOutput* out = braggi_io_stdout();
+    for (size_t i = 0; i < arg_count; i++) {
+        if (!braggi_io_write_val(out, args[i])) {
+            return braggi_val_error("write to standard output failed");
+        }
+    }
+    
+    return braggi_val_null();
 }
 
-static BraggiValue* io_print(BraggiValue** args, size_t arg_count, void* context) {
-    // In a real implementation, this would print output
-    printf("io.print called with %zu args\n", arg_count);
+static BraggiVal io_flush(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context) {
     (void)args;
+    (void)arg_count;
+    (void)region;
     (void)context;
-    return NULL;
+    
+    braggi_io_flush_all();
+    return braggi_val_null();
+}
+
+// Copy a path argument out so it is NUL-terminated
+static bool path_argument(BraggiVal value, char* path, size_t size) {
+    if (value.tag != BRAGGI_VAL_STRING || value.length == 0 || value.length >= size) {
+        return false;
+    }
+    memcpy(path, value.as.string, value.length);
+    path[value.length] = '\0';
+    return true;
+}
+
+// The file is mapped rather than read, then copied once into the region
+static BraggiVal io_read_file(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context) {
+    (void)context;
+    
+    char path[4096];
+    if (arg_count != 1 || !path_argument(args[0], path, sizeof(path))) {
+        return braggi_val_error("expected a file path");
+    }
+    
+    BraggiMappedFile file;
+    if (!braggi_io_map_file(path, &file)) {
+        return braggi_val_error("could not open file");
+    }
+    
+    BraggiVal text = braggi_val_string(region, file.data ? file.data : "", file.size);
+    braggi_io_unmap_file(&file);
+    return text;
+}
+
+static BraggiVal io_read_lines(const BraggiVal* args, size_t arg_count, BraggiRegionHandle region, void* context) {
+    (void)context;
+    
+    char path[4096];
+    if (arg_count != 1 || !path_argument(args[0], path, sizeof(path))) {
+        return braggi_val_error("expected a file path");
+    }
+    
+    BraggiReader* reader = braggi_io_reader_open(path);
+    if (!reader) {
+        return braggi_val_error("could not open file");
+    }
+    
+    BraggiVal lines = braggi_val_array(region, 16);
+    const char* line;
+    size_t length;
+    while (!braggi_val_is_error(lines) && (line = braggi_io_reader_line(reader, &length)) != NULL) {
+        BraggiVal text = braggi_val_string(region, line, length);
+        if (braggi_val_is_error(text) || !braggi_val_array_push(lines, text)) {
+            lines = braggi_val_error("out of region memory for lines");
+        }
+    }
+    
+    braggi_io_reader_close(reader);
+    return lines;
 }
 
 static BraggiValue* system_exit(BraggiValue** args, size_t arg_count, void* context) {
     // In a real implementation, this would exit the program
+    braggi_io_sync(stdout);
     printf("system.exit called with %zu args\n", arg_count);
     (void)args;
     (void)context;
@@ -278,53 +1066,123 @@ static BraggiValue* system_exit(BraggiValue** args, size_t arg_count, void* cont
 static void register_math_builtins(BraggiBuiltinRegistry* registry) {
     if (!registry) return;
     
-    // Register math functions
-    register_builtin(registry, "math.add", math_add, 
-                    "Add two numbers", 
-                    "func(a: number, b: number) -> number",
+    // Register math functions - each takes numbers or numeric arrays
+    register_native(registry, "math.add", math_add, 
+                    "Add two numbers, or arrays element-wise", 
+                    "func(a: number|array, b: number|array) -> number|array",
                     NULL);
                     
-    register_builtin(registry, "math.subtract", math_subtract,
-                    "Subtract two numbers",
-                    "func(a: number, b: number) -> number",
+    register_native(registry, "math.subtract", math_subtract,
+                    "Subtract two numbers, or arrays element-wise",
+                    "func(a: number|array, b: number|array) -> number|array",
                     NULL);
                     
-    // Register new math functions
-    register_builtin(registry, "math.multiply", math_multiply,
-                    "Multiply two numbers",
-                    "func(a: number, b: number) -> number",
+    register_native(registry, "math.multiply", math_multiply,
+                    "Multiply two numbers, or arrays element-wise",
+                    "func(a: number|array, b: number|array) -> number|array",
                     NULL);
                     
-    register_builtin(registry, "math.divide", math_divide,
-                    "Divide two numbers",
-                    "func(a: number, b: number) -> number",
+    register_native(registry, "math.divide", math_divide,
+                    "Divide two numbers, or arrays element-wise (array results are floats)",
+                    "func(a: number|array, b: number|array) -> number|array",
+                    NULL);
+                    
+    register_native(registry, "math.fma", math_fma,
+                    "Multiply then add: a * b + c",
+                    "func(a: number|array, b: number|array, c: number|array) -> number|array",
+                    NULL);
+                    
+    register_native(registry, "math.dot", math_dot,
+                    "Dot product of two arrays",
+                    "func(a: array, b: array) -> number",
+                    NULL);
+                    
+    register_native(registry, "math.sum", math_sum,
+                    "Sum of an array or of the arguments",
+                    "func(values: array|number...) -> number",
+                    NULL);
+                    
+    register_native(registry, "math.min", math_min,
+                    "Smallest element of an array or of the arguments",
+                    "func(values: array|number...) -> number",
+                    NULL);
+                    
+    register_native(registry, "math.max", math_max,
+                    "Largest element of an array or of the arguments",
+                    "func(values: array|number...) -> number",
                     NULL);
                     
     // More math functions would be added here
 }
 
+static void register_superposition_builtins(BraggiBuiltinRegistry* registry) {
+    if (!registry) return;
+    
+    // Math builtins also accept superpositions and apply across alternatives
+    register_native(registry, "superpose", superpose,
+                    "Make a value that is any of several alternatives until observed",
+                    "func(alternatives: array, weights: array?) -> superposition",
+                    NULL);
+    
+    register_native(registry, "collapse", collapse,
+                    "Observe a superposition, choosing one alternative by weight",
+                    "func(value: any) -> any",
+                    NULL);
+    
+    register_native(registry, "superposition.expect", superposition_expect,
+                    "Weighted mean of a numeric superposition, without observing it",
+                    "func(value: number|superposition) -> number",
+                    NULL);
+}
+
 static void register_string_builtins(BraggiBuiltinRegistry* registry) {
     if (!registry) return;
     
     // Register string functions
-    register_builtin(registry, "string.length", string_length,
+    register_native(registry, "string.length", string_length,
                     "Get the length of a string",
                     "func(s: string) -> number",
                     NULL);
-                    
-    // More string functions would be added here
+    
+    register_native(registry, "string.concat", string_concat,
+                    "Join strings end to end",
+                    "func(parts: string...) -> string",
+                    NULL);
+    
+    register_native(registry, "string.slice", string_slice,
+                    "Get bytes [start, end) of a string, sharing its memory",
+                    "func(s: string, start: number, end: number?) -> string",
+                    NULL);
 }
 
 static void register_io_builtins(BraggiBuiltinRegistry* registry) {
     if (!registry) return;
     
     // Register I/O functions
-    register_builtin(registry, "io.print", io_print,
+    register_native(registry, "io.print", io_print,
                     "Print to standard output",
-                    "func(value: any) -> void",
+                    "func(values: any...) -> void",
+                    NULL);
+    
+    register_native(registry, "io.write", io_write,
+                    "Write to standard output without separators or a newline",
+                    "func(values: any...) -> void",
+                    NULL);
+    
+    register_native(registry, "io.flush", io_flush,
+                    "Flush buffered output",
+                    "func() -> void",
+                    NULL);
+    
+    register_native(registry, "io.read_file", io_read_file,
+                    "Read a whole file into a string",
+                    "func(path: string) -> string",
+                    NULL);
+    
+    register_native(registry, "io.read_lines", io_read_lines,
+                    "Read a file as an array of lines",
+                    "func(path: string) -> array",
                     NULL);
-                    
-    // More I/O functions would be added here
 }
 
 static void register_system_builtins(BraggiBuiltinRegistry* registry) {
@@ -345,6 +1203,9 @@ bool braggi_stdlib_load_module(BraggiContext* context, const char* module_name)
         return false;
     }
     
+    // Runtime output buffered so far goes ahead of what we print here
+    braggi_io_sync(stdout);
+    
     // Check for built-in modules first
     if (strcmp(module_name, "math") == 0) {
         printf("Loaded built-in 'math' module\n");
@@ -366,13 +1227,9 @@ bool braggi_stdlib_load_module(BraggiContext* context, const char* module_name)
         return true; // System module is always available
     }
     
-    // For external modules, try to find the file
-    char file_path[1024];
-    snprintf(file_path, sizeof(file_path), "modules/%s.bg", module_name);
-    
-    // Check if the file exists
-    FILE* file = fopen(file_path, "r");
-    if (!file) {
+    // Anything else is compiled once and mapped from the module cache
+    const BraggiModule* module = braggi_module_load(module_name);
+    if (!module) {
         const char* error_message = "Module not found";
         
         // Set error - using error handling API instead of direct field access
@@ -386,14 +1243,11 @@ bool braggi_stdlib_load_module(BraggiContext* context, const char* module_name)
         
         return false;
     }
-    fclose(file);
-    
-    // Process the file - we'll need to implement this function
-    bool result = false;
-    // Commenting out for now - this function isn't defined yet
-    // bool result = braggi_process_file(context, file_path);
     
-    return result;
+    printf("Loaded module '%s' from %s (%zu exports%s)\n", module_name,
+           braggi_module_source_path(module), braggi_module_export_count(module),
+           braggi_module_from_cache(module) ? ", cached" : "");
+    return true;
 }
 
 // Initialize the standard library for a context
@@ -408,19 +1262,16 @@ bool braggi_stdlib_initialize(BraggiContext* context) {
         return false;
     }
     
-    // Register all standard library functions
+    // Register all standard library functions. IDs follow this order.
+    braggi_builtins_register_core(registry);
     register_math_builtins(registry);
     register_string_builtins(registry);
     register_io_builtins(registry);
     register_system_builtins(registry);
+    register_superposition_builtins(registry);
     
-    // Since BraggiContext doesn't have a builtin_registry field,
-    // we'll store it in the user_data field if available, or free it
-    // In a real implementation, BraggiContext would have a dedicated field
-    
-    // Store registry in context somehow - for now, let's just hold onto it
-    // and free it in cleanup
-    static BraggiBuiltinRegistry* global_registry = NULL;
+    // BraggiContext doesn't have a builtin_registry field yet, so the
+    // registry is shared at file scope and freed in cleanup
     
     // Clean up old registry if it exists
     if (global_registry) {
@@ -439,15 +1290,30 @@ void braggi_stdlib_cleanup(BraggiContext* context) {
         return;
     }
     
-    // In a real implementation, we would retrieve the registry from context
-    // For now we use our static variable
-    static BraggiBuiltinRegistry* global_registry = NULL;
-    
     // Clean up the registry if it exists
     if (global_registry) {
         braggi_builtin_registry_destroy(global_registry);
         global_registry = NULL;
     }
+    
+    braggi_module_unload_all();
+    braggi_stdlib_reset_path_cache();
+}
+
+// Get the shared registry, populating it on first use
+BraggiBuiltinRegistry* braggi_stdlib_get_registry(BraggiContext* context) {
+    if (!global_registry && (!context || !braggi_stdlib_initialize(context))) {
+        return NULL;
+    }
+    return global_registry;
+}
+
+// Resolve a builtin name to its ID in the shared registry
+BraggiBuiltinId braggi_stdlib_resolve(BraggiContext* context, const char* name) {
+    if (!name) {
+        return BRAGGI_BUILTIN_INVALID;
+    }
+    return braggi_builtin_registry_resolve(braggi_stdlib_get_registry(context), name);
 }
 
 // Update our utility lookup function to properly call the registry lookup
@@ -456,16 +1322,15 @@ BraggiBuiltinFunc braggi_stdlib_lookup_builtin(BraggiContext* context, const cha
         return NULL;
     }
     
-    // In a real implementation, we would retrieve the registry from context
-    static BraggiBuiltinRegistry* global_registry = NULL;
-    
-    // Create the registry if it doesn't exist
-    if (!global_registry) {
-        global_registry = braggi_builtin_registry_create();
-        if (!global_registry) return NULL;
+    void* builtin_context = NULL;
+    return braggi_builtin_registry_lookup(braggi_stdlib_get_registry(context), name, &builtin_context);
+} 
+
+// Look up a builtin that takes its arguments by value
+BraggiNativeFunc braggi_stdlib_lookup_native(BraggiContext* context, const char* name, void** out_context) {
+    if (!context || !name) {
+        return NULL;
     }
     
-    // Call the registry lookup function with the correct parameters
-    void* builtin_context = NULL;
-    return braggi_builtin_registry_lookup(global_registry, name, &builtin_context);
-} 
\ No newline at end of file
+    return braggi_builtin_registry_lookup_native(braggi_stdlib_get_registry(context), name, out_context);
+}
@@ -1,8 +1,15 @@
 /*
  * Braggi - Symbol Table Implementation
- * 
+ *
  * "A symbol table is like the phonebook at a Texas family reunion -
  * it tells you where to find everyone and who they're related to!"
+ *
+ * Every name is interned once into an atom. Each atom points at the
+ * innermost binding of that name, and each binding remembers the one
+ * it shadows, so lookup is a single hash probe however deep the
+ * scopes nest. Bindings are pushed onto one stack in the order they're
+ * made, which makes the stack its own undo list: leaving a scope pops
+ * the bindings made since it was entered and restores what they hid.
  */
 
 #include <stdlib.h>
@@ -10,54 +17,162 @@
 #include <string.h>
 #include <stdbool.h>
 
-#include "braggi/util/hashmap.h"
+#include "braggi/symbol_table.h"
 #include "braggi/util/vector.h"
 
-// Define symbol types
-typedef enum {
-    SYMBOL_UNKNOWN = 0,
-    SYMBOL_VARIABLE,
-    SYMBOL_FUNCTION,
-    SYMBOL_TYPE,
-    SYMBOL_CONSTANT,
-    SYMBOL_MODULE,
-    SYMBOL_NAMESPACE
-} SymbolType;
+// Hash slots per interned name before the table doubles
+#define NAME_LOAD_NUM 3
+#define NAME_LOAD_DEN 4
+#define NAME_INITIAL_SLOTS 256
 
 // Structure for a symbol
-typedef struct Symbol {
+struct Symbol {
     char* name;              // Symbol name
     SymbolType type;         // Symbol type
     void* data;              // Symbol-specific data
     uint32_t scope_id;       // Scope ID (0 = global)
     uint32_t declaration_id; // Declaration token ID
     struct Symbol* parent;   // Parent symbol (for nested symbols)
-} Symbol;
+};
 
-// Structure for a scope
-typedef struct Scope {
+// An interned name
+typedef struct NameAtom {
+    char* name;              // Owned copy of the name
+    uint32_t hash;
+    uint32_t top;            // Innermost binding index + 1, 0 when unbound
+} NameAtom;
+
+// A name bound in some scope
+typedef struct Binding {
+    Symbol* symbol;
+    uint32_t atom;           // Which name this binds
+    uint32_t depth;          // Scope depth it was made at
+    uint32_t shadowed;       // Binding it hides, index + 1, 0 for none
+} Binding;
+
+// A scope that's currently open
+typedef struct ScopeFrame {
     uint32_t id;             // Scope ID
-    uint32_t parent_id;      // Parent scope ID
-    HashMap* symbols;        // Map from name to Symbol*
+    uint32_t binding_mark;   // Bindings on the stack when it was entered
     char* name;              // Optional scope name (e.g., function name)
-} Scope;
+} ScopeFrame;
 
 // Structure for the symbol table
-typedef struct SymbolTable {
-    HashMap* scopes;          // Map from scope ID to Scope*
-    HashMap* global_symbols;  // Map from name to Symbol* (global scope)
-    Vector* all_symbols;      // Vector of Symbol* (all symbols)
+struct SymbolTable {
+    NameAtom* atoms;          // Interned names, indexed by atom
+    uint32_t atom_count;
+    uint32_t atom_capacity;
+    uint32_t* slots;          // Open-addressed hash: atom + 1, 0 when empty
+    uint32_t slot_count;      // Always a power of two
+    
+    Binding* bindings;        // Binding stack, innermost last
+    uint32_t binding_count;
+    uint32_t binding_capacity;
+    
+    ScopeFrame* scopes;       // Open scopes; [0] is global
+    uint32_t scope_depth;     // Index of the current scope
+    uint32_t scope_capacity;
     uint32_t next_scope_id;   // Next available scope ID
-    uint32_t current_scope_id; // Current scope ID
-    Scope* current_scope;     // Current scope
-    Scope* global_scope;      // Global scope
-    bool initialized;         // Whether the table is initialized
-} SymbolTable;
+    
+    Vector* all_symbols;      // Vector of Symbol* (all symbols)
+};
+
+// FNV-1a
+static uint32_t hash_name(const char* name) {
+    uint32_t hash = 2166136261u;
+    for (const unsigned char* p = (const unsigned char*)name; *p; p++) {
+        hash ^= *p;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Slot holding name, or the empty slot where it would go
+static uint32_t find_slot(const SymbolTable* table, const char* name, uint32_t hash) {
+    uint32_t mask = table->slot_count - 1;
+    uint32_t slot = hash & mask;
+    
+    while (table->slots[slot]) {
+        const NameAtom* atom = &table->atoms[table->slots[slot] - 1];
+        if (atom->hash == hash && strcmp(atom->name, name) == 0) {
+            break;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+static bool grow_slots(SymbolTable* table) {
+    uint32_t slot_count = table->slot_count * 2;
+    uint32_t* slots = (uint32_t*)calloc(slot_count, sizeof(uint32_t));
+    if (!slots) {
+        return false;
+    }
+    
+    // Atoms never move, so rehashing only rebuilds the slot array
+    for (uint32_t i = 0; i < table->atom_count; i++) {
+        uint32_t slot = table->atoms[i].hash & (slot_count - 1);
+        while (slots[slot]) {
+            slot = (slot + 1) & (slot_count - 1);
+        }
+        slots[slot] = i + 1;
+    }
+    
+    free(table->slots);
+    table->slots = slots;
+    table->slot_count = slot_count;
+    return true;
+}
+
+// Get the atom for a name, interning it on first sight. Returns
+// UINT32_MAX if out of memory.
+static uint32_t intern(SymbolTable* table, const char* name) {
+    uint32_t hash = hash_name(name);
+    uint32_t slot = find_slot(table, name, hash);
+    if (table->slots[slot]) {
+        return table->slots[slot] - 1;
+    }
+    
+    if ((table->atom_count + 1) * NAME_LOAD_DEN > table->slot_count * NAME_LOAD_NUM) {
+        if (!grow_slots(table)) {
+            return UINT32_MAX;
+        }
+        slot = find_slot(table, name, hash);
+    }
+    
+    if (table->atom_count == table->atom_capacity) {
+        uint32_t capacity = table->atom_capacity ? table->atom_capacity * 2 : 64;
+        NameAtom* atoms = (NameAtom*)realloc(table->atoms, capacity * sizeof(NameAtom));
+        if (!atoms) {
+            return UINT32_MAX;
+        }
+        table->atoms = atoms;
+        table->atom_capacity = capacity;
+    }
+    
+    char* copy = strdup(name);
+    if (!copy) {
+        return UINT32_MAX;
+    }
+    
+    uint32_t index = table->atom_count++;
+    table->atoms[index].name = copy;
+    table->atoms[index].hash = hash;
+    table->atoms[index].top = 0;
+    table->slots[slot] = index + 1;
+    return index;
+}
+
+// Find the atom for a name without interning it
+static uint32_t find_atom(const SymbolTable* table, const char* name) {
+    uint32_t slot = find_slot(table, name, hash_name(name));
+    return table->slots[slot] ? table->slots[slot] - 1 : UINT32_MAX;
+}
 
 /*
  * Create a new symbol
- * 
- * "Branding a new symbol is like naming a new foal - 
+ *
+ * "Branding a new symbol is like naming a new foal -
  * you gotta make sure it's unique and fits its purpose!"
  */
 static Symbol* create_symbol(const char* name, SymbolType type, uint32_t scope_id) {
@@ -87,7 +202,7 @@ static Symbol* create_symbol(const char* name, SymbolType type, uint32_t scope_i
 
 /*
  * Destroy a symbol
- * 
+ *
  * "When a symbol's time is up, make sure you clean up after it -
  * no memory leaks on this ranch!"
  */
@@ -102,111 +217,65 @@ static void destroy_symbol(Symbol* symbol) {
 }
 
 /*
- * Create a new scope
- * 
+ * Push a new scope frame
+ *
  * "A new scope is like a new pasture - you need to fence it off
  * properly so your symbols don't wander into the wrong area!"
  */
-static Scope* create_scope(uint32_t id, uint32_t parent_id, const char* name) {
-    Scope* scope = (Scope*)malloc(sizeof(Scope));
-    if (!scope) {
-        return NULL;
-    }
-    
-    scope->id = id;
-    scope->parent_id = parent_id;
-    scope->symbols = braggi_hashmap_create_with_capacity(64);  // Start with reasonable size
-    
-    if (!scope->symbols) {
-        free(scope);
-        return NULL;
+static bool push_scope(SymbolTable* table, uint32_t depth, const char* name) {
+    if (depth == table->scope_capacity) {
+        uint32_t capacity = table->scope_capacity ? table->scope_capacity * 2 : 16;
+        ScopeFrame* scopes = (ScopeFrame*)realloc(table->scopes, capacity * sizeof(ScopeFrame));
+        if (!scopes) {
+            return false;
+        }
+        table->scopes = scopes;
+        table->scope_capacity = capacity;
     }
     
+    ScopeFrame* frame = &table->scopes[depth];
+    frame->name = NULL;
     if (name) {
-        scope->name = strdup(name);
-        if (!scope->name) {
-            braggi_hashmap_destroy(scope->symbols);
-            free(scope);
-            return NULL;
+        frame->name = strdup(name);
+        if (!frame->name) {
+            return false;
         }
-    } else {
-        scope->name = NULL;
-    }
-    
-    return scope;
-}
-
-/*
- * Destroy a scope
- * 
- * "Cleaning up a scope is like dismantling a corral - 
- * make sure all the critters are accounted for first!"
- */
-static void destroy_scope(Scope* scope) {
-    if (!scope) {
-        return;
     }
-    
-    // Symbols are freed separately when destroying the symbol table
-    
-    braggi_hashmap_destroy(scope->symbols);
-    free(scope->name);
-    free(scope);
+    frame->id = table->next_scope_id++;
+    frame->binding_mark = table->binding_count;
+    return true;
 }
 
 /*
  * Create a new symbol table
- * 
+ *
  * "Starting a new symbol table is like opening a brand new ranch -
  * you've got to set it up right from the get-go!"
  */
 SymbolTable* braggi_symbol_table_create(void) {
-    SymbolTable* table = (SymbolTable*)malloc(sizeof(SymbolTable));
+    SymbolTable* table = (SymbolTable*)calloc(1, sizeof(SymbolTable));
     if (!table) {
         return NULL;
     }
     
-    // Initialize table
-    table->scopes = braggi_hashmap_create_with_capacity(16);  // Start with reasonable size
-    if (!table->scopes) {
-        free(table);
-        return NULL;
-    }
-    
+    table->slot_count = NAME_INITIAL_SLOTS;
+    table->slots = (uint32_t*)calloc(table->slot_count, sizeof(uint32_t));
     table->all_symbols = braggi_vector_create(sizeof(Symbol*));
-    if (!table->all_symbols) {
-        braggi_hashmap_destroy(table->scopes);
-        free(table);
-        return NULL;
-    }
     
-    // Create global scope
-    table->next_scope_id = 1;  // Start from 1, reserve 0 as invalid
-    table->global_scope = create_scope(table->next_scope_id++, 0, "global");
-    if (!table->global_scope) {
-        braggi_vector_destroy(table->all_symbols);
-        braggi_hashmap_destroy(table->scopes);
-        free(table);
+    // Create global scope, starting IDs from 1 to reserve 0 as invalid
+    table->next_scope_id = 1;
+    if (!table->slots || !table->all_symbols || !push_scope(table, 0, "global")) {
+        braggi_symbol_table_destroy(table);
         return NULL;
     }
-    
-    // Add global scope to scopes map
-    char scope_key[32];
-    snprintf(scope_key, sizeof(scope_key), "%u", table->global_scope->id);
-    braggi_hashmap_set(table->scopes, scope_key, table->global_scope);
-    
-    // Set global scope as current
-    table->current_scope = table->global_scope;
-    table->current_scope_id = table->global_scope->id;
-    table->global_symbols = table->global_scope->symbols;
-    table->initialized = true;
+    table->scope_depth = 0;
     
     return table;
 }
 
 /*
  * Destroy a symbol table
- * 
+ *
  * "When it's time to close down the ranch, make sure you account for
  * every last symbol - we don't leave stragglers behind in Texas!"
  */
@@ -226,18 +295,20 @@ void braggi_symbol_table_destroy(SymbolTable* table) {
         braggi_vector_destroy(table->all_symbols);
     }
     
-    // Clean up all scopes
+    // Clean up the scopes still open
     if (table->scopes) {
-        // Note: We can't iterate over a hashmap, so we'll handle the global scope separately
-        if (table->global_scope) {
-            destroy_scope(table->global_scope);
+        for (uint32_t i = 0; i <= table->scope_depth; i++) {
+            free(table->scopes[i].name);
         }
-        
-        // In a full implementation, we would iterate over the vector for scopes
-        // and free each one. Since we can't directly iterate over the hashmap,
-        // we'll destroy the hashmap directly, knowing the scopes have been freed.
-        braggi_hashmap_destroy(table->scopes);
+        free(table->scopes);
+    }
+    
+    for (uint32_t i = 0; i < table->atom_count; i++) {
+        free(table->atoms[i].name);
     }
+    free(table->atoms);
+    free(table->slots);
+    free(table->bindings);
     
     // Free the table itself
     free(table);
@@ -245,7 +316,7 @@ void braggi_symbol_table_destroy(SymbolTable* table) {
 
 /*
  * Enter a new scope
- * 
+ *
  * "Moving into a new scope is like entering a new pasture -
  * different rules apply, but you're still on the same ranch!"
  */
@@ -254,124 +325,117 @@ uint32_t braggi_symbol_table_enter_scope(SymbolTable* table, const char* name) {
         return 0;
     }
     
-    // Create new scope
-    Scope* scope = create_scope(table->next_scope_id++, table->current_scope_id, name);
-    if (!scope) {
+    if (!push_scope(table, table->scope_depth + 1, name)) {
         return 0;
     }
     
-    // Add scope to scopes map
-    char scope_key[32];
-    snprintf(scope_key, sizeof(scope_key), "%u", scope->id);
-    braggi_hashmap_set(table->scopes, scope_key, scope);
-    
-    // Update current scope
-    table->current_scope = scope;
-    table->current_scope_id = scope->id;
-    
-    return scope->id;
+    table->scope_depth++;
+    return table->scopes[table->scope_depth].id;
 }
 
 /*
  * Exit the current scope
- * 
+ *
  * "Leaving a scope is like moving back to the main corral -
  * you go back to where you came from, with all your symbols in tow!"
  */
 uint32_t braggi_symbol_table_exit_scope(SymbolTable* table) {
-    if (!table || !table->current_scope || table->current_scope == table->global_scope) {
+    if (!table || table->scope_depth == 0) {
         return 0;  // Can't exit from global scope
     }
     
-    // Get parent scope
-    uint32_t parent_id = table->current_scope->parent_id;
-    char scope_key[32];
-    snprintf(scope_key, sizeof(scope_key), "%u", parent_id);
-    Scope* parent_scope = (Scope*)braggi_hashmap_get(table->scopes, scope_key);
+    ScopeFrame* frame = &table->scopes[table->scope_depth];
     
-    if (!parent_scope) {
-        // Something went wrong, fall back to global scope
-        table->current_scope = table->global_scope;
-        table->current_scope_id = table->global_scope->id;
-        return table->global_scope->id;
+    // Unbind what this scope bound, uncovering whatever it shadowed
+    while (table->binding_count > frame->binding_mark) {
+        Binding* binding = &table->bindings[--table->binding_count];
+        table->atoms[binding->atom].top = binding->shadowed;
     }
     
-    // Update current scope
-    table->current_scope = parent_scope;
-    table->current_scope_id = parent_id;
+    free(frame->name);
+    frame->name = NULL;
+    table->scope_depth--;
     
-    return parent_id;
+    return table->scopes[table->scope_depth].id;
 }
 
 /*
  * Add a symbol to the current scope
- * 
+ *
  * "Adding a new symbol to the corral is like registering a new brand -
  * you gotta make sure it's unique in its scope!"
  */
 Symbol* braggi_symbol_table_add_symbol(SymbolTable* table, const char* name, SymbolType type) {
-    if (!table || !name || !table->current_scope) {
+    if (!table || !name) {
+        return NULL;
+    }
+    
+    uint32_t atom = intern(table, name);
+    if (atom == UINT32_MAX) {
         return NULL;
     }
     
     // Check if symbol already exists in current scope
-    if (braggi_hashmap_get(table->current_scope->symbols, name)) {
-        return NULL;  // Symbol already exists in this scope
+    uint32_t top = table->atoms[atom].top;
+    if (top && table->bindings[top - 1].depth == table->scope_depth) {
+        return NULL;
+    }
+    
+    if (table->binding_count == table->binding_capacity) {
+        uint32_t capacity = table->binding_capacity ? table->binding_capacity * 2 : 64;
+        Binding* bindings = (Binding*)realloc(table->bindings, capacity * sizeof(Binding));
+        if (!bindings) {
+            return NULL;
+        }
+        table->bindings = bindings;
+        table->binding_capacity = capacity;
     }
     
     // Create new symbol
-    Symbol* symbol = create_symbol(name, type, table->current_scope_id);
+    Symbol* symbol = create_symbol(name, type, table->scopes[table->scope_depth].id);
     if (!symbol) {
         return NULL;
     }
     
-    // Add to current scope
-    braggi_hashmap_set(table->current_scope->symbols, name, symbol);
-    
     // Add to all symbols vector
-    braggi_vector_push(table->all_symbols, &symbol);
+    if (!braggi_vector_push(table->all_symbols, &symbol)) {
+        destroy_symbol(symbol);
+        return NULL;
+    }
+    
+    // Bind it, hiding any outer symbol of the same name
+    Binding* binding = &table->bindings[table->binding_count++];
+    binding->symbol = symbol;
+    binding->atom = atom;
+    binding->depth = table->scope_depth;
+    binding->shadowed = top;
+    table->atoms[atom].top = table->binding_count;
     
     return symbol;
 }
 
 /*
  * Look up a symbol in the current scope or parent scopes
- * 
+ *
  * "Looking up a symbol is like tracking a wandering steer -
- * you might find it in the current pasture, or you might have to
- * look in the neighboring fields to track it down!"
+ * except this steer always answers to its name from the nearest pasture!"
  */
 Symbol* braggi_symbol_table_lookup(SymbolTable* table, const char* name) {
     if (!table || !name) {
         return NULL;
     }
     
-    // Start with current scope
-    Scope* scope = table->current_scope;
-    while (scope) {
-        // Look for symbol in this scope
-        Symbol* symbol = (Symbol*)braggi_hashmap_get(scope->symbols, name);
-        if (symbol) {
-            return symbol;
-        }
-        
-        // Move to parent scope if not found
-        if (scope->parent_id == 0) {
-            break;  // No parent scope
-        }
-        
-        char scope_key[32];
-        snprintf(scope_key, sizeof(scope_key), "%u", scope->parent_id);
-        scope = (Scope*)braggi_hashmap_get(table->scopes, scope_key);
+    uint32_t atom = find_atom(table, name);
+    if (atom == UINT32_MAX || !table->atoms[atom].top) {
+        return NULL;
     }
     
-    // Symbol not found in any accessible scope
-    return NULL;
+    return table->bindings[table->atoms[atom].top - 1].symbol;
 }
 
 /*
  * Get the name of a symbol
- * 
+ *
  * "Every symbol's got a name, just like every cow's got a brand -
  * it's how we tell 'em apart!"
  */
@@ -385,7 +449,7 @@ const char* braggi_symbol_get_name(Symbol* symbol) {
 
 /*
  * Get the type of a symbol
- * 
+ *
  * "Knowing a symbol's type is like knowing if you're dealing with a
  * longhorn or a heifer - makes all the difference in how you handle it!"
  */
@@ -399,7 +463,7 @@ SymbolType braggi_symbol_get_type(Symbol* symbol) {
 
 /*
  * Set custom data for a symbol
- * 
+ *
  * "Customizing a symbol is like giving your prize steer a fancy saddle -
  * it's still the same critter, but now it's carrying something extra!"
  */
@@ -414,7 +478,7 @@ bool braggi_symbol_set_data(Symbol* symbol, void* data) {
 
 /*
  * Get the custom data for a symbol
- * 
+ *
  * "Getting a symbol's data is like checking what your horse is carrying -
  * hopefully it's exactly what you packed earlier!"
  */
@@ -424,4 +488,4 @@ void* braggi_symbol_get_data(Symbol* symbol) {
     }
     
     return symbol->data;
-} 
\ No newline at end of file
+}
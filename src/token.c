@@ -9,6 +9,7 @@
 #include "braggi/token.h"
 #include "braggi/source.h"
 #include "braggi/util/vector.h"
+#include "braggi/alloc_profile.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -306,6 +307,13 @@ static size_t get_source_total_length(Source* source) {
     return total_length;
 }
 
+// Location of a byte offset in the tokenizer's source. A source that
+// couldn't be registered has no locations, so its tokens stay unknown.
+static BraggiSourceLoc source_loc(const Tokenizer* tokenizer, size_t offset) {
+    BraggiSourceLoc base = tokenizer->source->loc_base;
+    return base == BRAGGI_SOURCE_LOC_INVALID ? BRAGGI_SOURCE_LOC_INVALID : base + (BraggiSourceLoc)offset;
+}
+
 // Scan an identifier token
 static size_t scan_identifier(Tokenizer* tokenizer, Token* token) {
     size_t start_position = tokenizer->position;
@@ -315,6 +323,7 @@ static size_t scan_identifier(Tokenizer* tokenizer, Token* token) {
     if (!is_identifier_start(c)) {
         return 0;
     }
+    consume_char(tokenizer);
     
     // Consume all valid identifier parts
     size_t length = 1;
@@ -334,8 +343,7 @@ static size_t scan_identifier(Tokenizer* tokenizer, Token* token) {
     
     // Set token data
     token->type = is_kw ? TOKEN_KEYWORD : TOKEN_IDENTIFIER;
-    token->position.offset = start_position;
-    token->position.length = length;
+    token->loc = source_loc(tokenizer, start_position);
     token->text = text;
     token->length = length;
     
@@ -353,10 +361,12 @@ static size_t scan_number(Tokenizer* tokenizer, Token* token) {
     }
     
     // If it starts with a dot, there must be a digit after it
-    if (c == '.' && !isdigit(peek_char(tokenizer, 0))) {
+    if (c == '.' && !isdigit(peek_char(tokenizer, 1))) {
         return 0;
     }
     
+    consume_char(tokenizer);
+    
     // Assume integer until proven otherwise
     bool is_float = (c == '.');
     size_t length = 1;
@@ -417,8 +427,7 @@ static size_t scan_number(Tokenizer* tokenizer, Token* token) {
     
     // Set token data
     token->type = is_float ? TOKEN_LITERAL_FLOAT : TOKEN_LITERAL_INT;
-    token->position.offset = start_position;
-    token->position.length = length;
+    token->loc = source_loc(tokenizer, start_position);
     token->text = text;
     token->length = length;
     
@@ -441,6 +450,7 @@ static size_t scan_string_literal(Tokenizer* tokenizer, Token* token) {
     if (c != '"') {
         return 0;
     }
+    consume_char(tokenizer);
     
     // Consume all characters until closing quote or end of input
     size_t length = 1;
@@ -485,8 +495,7 @@ static size_t scan_string_literal(Tokenizer* tokenizer, Token* token) {
     
     // Set token data
     token->type = TOKEN_LITERAL_STRING;
-    token->position.offset = start_position;
-    token->position.length = length;
+    token->loc = source_loc(tokenizer, start_position);
     token->text = full_text;
     token->length = length;
     
@@ -510,6 +519,7 @@ static size_t scan_char_literal(Tokenizer* tokenizer, Token* token) {
     if (c != '\'') {
         return 0;
     }
+    consume_char(tokenizer);
     
     // Consume all characters until closing quote or end of input
     size_t length = 1;
@@ -554,8 +564,7 @@ static size_t scan_char_literal(Tokenizer* tokenizer, Token* token) {
     
     // Set token data
     token->type = TOKEN_LITERAL_CHAR;
-    token->position.offset = start_position;
-    token->position.length = length;
+    token->loc = source_loc(tokenizer, start_position);
     token->text = full_text;
     token->length = length;
     
@@ -566,7 +575,6 @@ static size_t scan_char_literal(Tokenizer* tokenizer, Token* token) {
         token->string_value[0] = full_text[1] == '\\' ? full_text[2] : full_text[1];
         token->string_value[1] = '\0';
     }
-    token->int_value = (int)token->string_value[0];
     
     return length;
 }
@@ -580,6 +588,7 @@ static size_t scan_operator(Tokenizer* tokenizer, Token* token) {
     if (!is_operator_char(c)) {
         return 0;
     }
+    consume_char(tokenizer);
     
     // Handle multi-character operators
     size_t length = 1;
@@ -625,8 +634,7 @@ static size_t scan_operator(Tokenizer* tokenizer, Token* token) {
     
     // Set token data
     token->type = TOKEN_OPERATOR;
-    token->position.offset = start_position;
-    token->position.length = length;
+    token->loc = source_loc(tokenizer, start_position);
     token->text = text;
     token->length = length;
     
@@ -651,8 +659,7 @@ static size_t scan_punctuation(Tokenizer* tokenizer, Token* token) {
     
     // Set token data
     token->type = TOKEN_PUNCTUATION;
-    token->position.offset = start_position;
-    token->position.length = 1;
+    token->loc = source_loc(tokenizer, start_position);
     token->text = text;
     token->length = 1;
     
@@ -668,6 +675,7 @@ static size_t scan_whitespace(Tokenizer* tokenizer, Token* token) {
     if (!isspace(c)) {
         return 0;
     }
+    consume_char(tokenizer);
     
     // Consume all consecutive whitespace
     size_t length = 1;
@@ -678,8 +686,7 @@ static size_t scan_whitespace(Tokenizer* tokenizer, Token* token) {
     
     // Set token data
     token->type = TOKEN_WHITESPACE;
-    token->position.offset = start_position;
-    token->position.length = length;
+    token->loc = source_loc(tokenizer, start_position);
     token->text = get_source_segment(tokenizer, start_position, length);
     token->length = length;
     
@@ -695,6 +702,7 @@ static size_t scan_comment(Tokenizer* tokenizer, Token* token) {
     if (c != '/') {
         return 0;
     }
+    consume_char(tokenizer);
     
     char next = peek_char(tokenizer, 0);
     if (next != '/' && next != '*') {
@@ -741,14 +749,38 @@ static size_t scan_comment(Tokenizer* tokenizer, Token* token) {
     
     // Set token data
     token->type = TOKEN_COMMENT;
-    token->position.offset = start_position;
-    token->position.length = length;
+    token->loc = source_loc(tokenizer, start_position);
     token->text = text;
     token->length = length;
     
     return length;
 }
 
+// Copy the current token into the tokenizer's storage vector, if it has one
+static void store_current_token(Tokenizer* tokenizer) {
+    if (!tokenizer->tokens) return;
+    
+    // Duplicate the token for storage
+    Token* stored_token = (Token*)malloc(sizeof(Token));
+    if (!stored_token) return;
+    
+    memcpy(stored_token, &tokenizer->current_token, sizeof(Token));
+    
+    // Duplicate the text field since the original will be freed
+    if (stored_token->text) {
+        stored_token->text = strdup(stored_token->text);
+    }
+    
+    // Duplicate string value if present
+    if ((stored_token->type == TOKEN_LITERAL_STRING || 
+         stored_token->type == TOKEN_LITERAL_CHAR) && 
+        stored_token->string_value) {
+        stored_token->string_value = strdup(stored_token->string_value);
+    }
+    
+    braggi_vector_push_back(tokenizer->tokens, &stored_token);
+}
+
 // Get the next token from the source
 bool braggi_tokenizer_next(Tokenizer* tokenizer) {
     if (!tokenizer) return false;
@@ -796,44 +828,21 @@ bool braggi_tokenizer_next(Tokenizer* tokenizer) {
     if (tokenizer->position >= source_length) {
         fprintf(stderr, "DEBUG: Reached end of source at position %zu\n", tokenizer->position);
         tokenizer->current_token.type = TOKEN_EOF;
-        tokenizer->current_token.position.offset = tokenizer->position;
-        tokenizer->current_token.position.length = 0;
+        tokenizer->current_token.loc = source_loc(tokenizer, tokenizer->position);
         tokenizer->current_token.text = NULL;
         tokenizer->current_token.length = 0;
         return true;
     }
     
-    // Save the original position for token extraction
+    // Save the original position for token extraction. Line and column
+    // aren't worked out here; they're decoded from the token's location
+    // when someone asks for them.
     size_t start_position = tokenizer->position;
-    size_t line_pos = 0;
-    size_t column_pos = 0;
-    
-    // Calculate line and column for the current position
-    for (unsigned int i = 0; i < tokenizer->source->num_lines; i++) {
-        const char* line_text = tokenizer->source->lines[i];
-        if (!line_text) continue;
-        
-        size_t line_length = strlen(line_text);
-        
-        if (start_position >= line_pos && start_position < line_pos + line_length + 1) {
-            // Position is in this line (or at the newline after it)
-            line_pos = i + 1; // Line is 1-indexed
-            column_pos = start_position - (line_pos - 1) + 1; // Column is 1-indexed
-            break;
-        }
-        
-        line_pos += line_length + 1; // +1 for newline
-    }
-    
-    // Set file_id for position
-    tokenizer->current_token.position.file_id = tokenizer->source->file_id;
-    tokenizer->current_token.position.line = line_pos;
-    tokenizer->current_token.position.column = column_pos;
     
     // Debug: Show the current character we're about to scan
     char current_char = read_char(tokenizer);
-    fprintf(stderr, "DEBUG: Scanning at position %zu (%zu:%zu), char: '%c' (0x%02X)\n", 
-            tokenizer->position, line_pos, column_pos, 
+    fprintf(stderr, "DEBUG: Scanning at position %zu, char: '%c' (0x%02X)\n", 
+            tokenizer->position, 
             isprint(current_char) ? current_char : '.', 
             (unsigned char)current_char);
     
@@ -868,8 +877,7 @@ bool braggi_tokenizer_next(Tokenizer* tokenizer) {
         // If we get here, we encountered an invalid token
         fprintf(stderr, "DEBUG: Invalid token at position %zu\n", tokenizer->position);
         tokenizer->current_token.type = TOKEN_INVALID;
-        tokenizer->current_token.position.offset = tokenizer->position;
-        tokenizer->current_token.position.length = 1;
+        tokenizer->current_token.loc = source_loc(tokenizer, tokenizer->position);
         
         current_char = read_char(tokenizer);
         if (current_char != '\0') {
@@ -895,27 +903,7 @@ bool braggi_tokenizer_next(Tokenizer* tokenizer) {
     tokenizer->position = start_position + length;
     
     // Store in vector if available
-    if (tokenizer->tokens) {
-        // Duplicate the token for storage
-        Token* stored_token = (Token*)malloc(sizeof(Token));
-        if (stored_token) {
-            memcpy(stored_token, &tokenizer->current_token, sizeof(Token));
-            
-            // Duplicate the text field since the original will be freed
-            if (stored_token->text) {
-                stored_token->text = strdup(stored_token->text);
-            }
-            
-            // Duplicate string value if present
-            if ((stored_token->type == TOKEN_LITERAL_STRING || 
-                 stored_token->type == TOKEN_LITERAL_CHAR) && 
-                stored_token->string_value) {
-                stored_token->string_value = strdup(stored_token->string_value);
-            }
-            
-            braggi_vector_push_back(tokenizer->tokens, stored_token);
-        }
-    }
+    store_current_token(tokenizer);
     
     return true;
 }
@@ -1048,10 +1036,11 @@ Token* braggi_token_create(TokenType type, char* text, SourcePosition position)
     if (!token) {
         return NULL;
     }
+    braggi_alloc_profile_note(BRAGGI_ALLOC_PROFILE_HEAP_KEY, "heap", sizeof(Token), position.line, position.column, "token");
     
     token->type = type;
     token->text = text;  // Note: The caller is responsible for allocating text
-    token->position = position;
+    token->loc = braggi_source_loc_from_position(&position);
     token->length = text ? strlen(text) : 0;
     
     // Initialize the value union to zero
@@ -1060,6 +1049,18 @@ Token* braggi_token_create(TokenType type, char* text, SourcePosition position)
     return token;
 }
 
+SourcePosition braggi_token_get_position(const Token* token) {
+    SourcePosition position;
+    if (!token) {
+        memset(&position, 0, sizeof(position));
+        return position;
+    }
+    
+    braggi_source_loc_decode(token->loc, &position);
+    position.length = (uint32_t)token->length;
+    return position;
+}
+
 /*
  * Destroy a token and free its resources
  * 
@@ -1218,6 +1219,12 @@ Vector* braggi_tokenize_all(Source* source, bool skip_whitespace, bool skip_comm
     // Attach the vector to the tokenizer (for token storage in next())
     tokenizer->tokens = tokens;
     
+    // The first token was scanned when the tokenizer was primed, before
+    // there was anywhere to keep it
+    if (tokenizer->current_token.type != TOKEN_EOF) {
+        store_current_token(tokenizer);
+    }
+    
     // Process all tokens
     size_t token_count = 0;
     size_t error_count = 0;
@@ -1251,8 +1258,9 @@ Vector* braggi_tokenize_all(Source* source, bool skip_whitespace, bool skip_comm
             }
         } else if (token->type == TOKEN_INVALID) {
             error_count++;
+            SourcePosition where = braggi_token_get_position(token);
             fprintf(stderr, "WARNING: Invalid token at line %u, column %u: '%s'\n",
-                    token->position.line, token->position.column,
+                    where.line, where.column,
                     token->text ? token->text : "(null)");
         }
         
@@ -165,7 +165,7 @@ EntityID braggi_token_create_entity(ECSWorld* world, Token* token, uint32_t toke
     // Initialize component data
     component->token_id = token_id;
     component->type = token->type;
-    component->position = token->position;
+    component->position = braggi_token_get_position(token);
     
     // Duplicate text to avoid lifetime issues
     if (token->text) {
@@ -183,12 +183,13 @@ bool braggi_token_manager_add_token(TokenManager* manager, Token* token) {
     braggi_hashmap_put(manager->token_by_id, strdup(id_key), token);
     
     // Add by position if token has a position
-    if (token->position.line > 0) {
+    SourcePosition position = braggi_token_get_position(token);
+    if (position.line > 0) {
         char pos_key[64];
         snprintf(pos_key, sizeof(pos_key), "%u:%u:%u", 
-                 token->position.file_id, 
-                 token->position.line, 
-                 token->position.column);
+                 position.file_id, 
+                 position.line, 
+                 position.column);
         braggi_hashmap_put(manager->token_by_position, strdup(pos_key), token);
     }
     
@@ -20,6 +20,8 @@
 #include "braggi/braggi_context.h"
 #include "braggi/constraint_patterns.h"
 #include "braggi/error.h"
+#include "braggi/error_handler.h"
+#include "braggi/diagnostics.h"
 #include "braggi/periscope.h"
 #include "braggi/ecs.h"
 
@@ -44,7 +46,6 @@ extern EntropyState* braggi_state_create(uint32_t id, uint32_t type, const char*
 extern bool braggi_functional_validator(EntropyState** states, size_t state_count, void* context);
 extern bool braggi_default_adjacency_validator(EntropyConstraint* constraint, EntropyField* field);
 extern bool braggi_default_sequence_validator(EntropyConstraint* constraint, EntropyField* field);
-extern uint32_t braggi_normalize_field_cell_id(EntropyField* field, uint32_t cell_id);
 
 // External function declarations
 extern bool braggi_constraint_patterns_set_periscope(Periscope* periscope);
@@ -105,7 +106,7 @@ struct TokenPropagator {
 static bool propagate_token_constraints(TokenPropagator* propagator, uint32_t cell_id);
 static void report_propagation_error(TokenPropagator* propagator, 
                                     uint32_t cell_id, 
-                                    const char* message);
+                                    const BraggiDiagRecord* record);
 static bool create_syntax_constraints(TokenPropagator* propagator);
 static bool create_semantic_constraints(TokenPropagator* propagator, EntropyField* field, Vector* tokens);
 static bool add_token_state_to_cell(EntropyCell* cell, Token* token, float weight);
@@ -114,119 +115,6 @@ static bool create_adjacency_constraint(EntropyCell* cell1, EntropyCell* cell2,
 static bool create_sequence_constraint(EntropyCell** cells, uint32_t cell_count, TokenPropagator* propagator);
 static bool token_propagator_create_constraints(TokenPropagator* propagator);
 static bool create_default_periscope_contracts(TokenPropagator* propagator);
-static uint32_t normalize_cell_id(TokenPropagator* propagator, uint32_t cell_id);
-
-// Helper function to ensure cell IDs are within bounds
-static uint32_t normalize_cell_id(TokenPropagator* propagator, uint32_t cell_id) {
-    if (!propagator) {
-        fprintf(stderr, "ERROR: NULL propagator in normalize_cell_id\n");
-        return 0;
-    }
-    
-    // If we have a field, use the braggi_normalize_field_cell_id function
-    if (propagator->field) {
-        return braggi_normalize_field_cell_id(propagator->field, cell_id);
-    }
-    
-    uint32_t max_cell_id = 0;
-    
-    // Determine the maximum valid cell ID
-    if (propagator->tokens) {
-        max_cell_id = braggi_vector_size(propagator->tokens);
-        // Ensure we don't underflow if tokens vector is empty
-        if (max_cell_id > 0) {
-            max_cell_id -= 1;
-        }
-    }
-    
-    // Sanity check for completely uninitialized state
-    if (max_cell_id == 0) {
-        fprintf(stderr, "WARNING: Token vector is empty or not properly initialized\n");
-        return 0;
-    }
-    
-    // Check if cell_id is out of bounds
-    if (cell_id > max_cell_id) {
-        // If the cell ID is way out of bounds (more than 100 over max), 
-        // it's likely a completely invalid ID, so use a modulo approach
-        if (cell_id > max_cell_id + 100) {
-            // Check for very high values that suggest memory corruption
-            if (cell_id > 1000000) {
-                fprintf(stderr, "WARNING: Cell ID %u is extremely high, may indicate memory corruption\n", cell_id);
-                
-                // Use modulo with extra safety check
-                uint32_t normalized_id = cell_id % (max_cell_id + 1);
-                
-                // Ensure the result is valid even after modulo
-                if (normalized_id > max_cell_id) {
-                    normalized_id = max_cell_id;
-                }
-                
-                fprintf(stderr, "WARNING: Cell ID %u is significantly out of bounds (max: %u), using modulo to get %u\n", 
-                        cell_id, max_cell_id, normalized_id);
-                return normalized_id;
-            } else {
-                uint32_t normalized_id = cell_id % (max_cell_id + 1);
-                fprintf(stderr, "WARNING: Cell ID %u is significantly out of bounds (max: %u), using modulo to get %u\n", 
-                        cell_id, max_cell_id, normalized_id);
-                return normalized_id;
-            }
-        } else {
-            // Otherwise, just clamp to the maximum
-            fprintf(stderr, "WARNING: Cell ID %u is out of bounds (max: %u), clamping to valid range\n", 
-                    cell_id, max_cell_id);
-            return max_cell_id;
-        }
-    }
-    
-    return cell_id;
-}
-
-// Get cell ID for a token, ensuring it's within bounds
-static uint32_t get_valid_cell_id_for_token(TokenPropagator* propagator, Token* token) {
-    if (!propagator || !token) {
-        fprintf(stderr, "ERROR: NULL parameters in get_valid_cell_id_for_token\n");
-        return 0;
-    }
-    
-    uint32_t cell_id = 0;
-    bool found = false;
-    
-    // First try to get cell ID from periscope
-    if (propagator->periscope) {
-        fprintf(stderr, "DEBUG: Using periscope to get cell ID for token %p\n", (void*)token);
-        cell_id = braggi_periscope_get_cell_id_for_token(propagator->periscope, token, propagator->field);
-        
-        if (cell_id != UINT32_MAX) {
-            found = true;
-        }
-    }
-    
-    // If periscope didn't work, use fallback (token index)
-    if (!found) {
-        fprintf(stderr, "WARNING: No cell ID found for token at %p, using fallback\n", (void*)token);
-        
-        // Find token index in the propagator's tokens vector
-        size_t token_count = braggi_vector_size(propagator->tokens);
-        for (uint32_t i = 0; i < token_count; i++) {
-            Token** token_ptr = braggi_vector_get(propagator->tokens, i);
-            if (token_ptr && *token_ptr == token) {
-                cell_id = i;
-                found = true;
-                break;
-            }
-        }
-        
-        // If still not found, use a safe default
-        if (!found) {
-            fprintf(stderr, "WARNING: Token not found in propagator's tokens vector, using default cell ID 0\n");
-            return 0;
-        }
-    }
-    
-    // Normalize the cell ID to ensure it's within bounds
-    return normalize_cell_id(propagator, cell_id);
-}
 
 // Create a constraint from a pattern definition
 bool create_constraint_from_pattern(TokenPropagator* propagator, const char* pattern_name, 
@@ -488,74 +376,82 @@ bool braggi_token_propagator_initialize_field(TokenPropagator* propagator) {
     // Check if we have tokens
     if (!propagator->tokens || braggi_vector_size(propagator->tokens) == 0) {
         // No tokens, report error
-        report_propagation_error(propagator, 0, "No tokens to initialize field");
+        report_propagation_error(propagator, 0, &(BraggiDiagRecord){.id = BRAGGI_DIAG_NO_TOKENS});
         return false;
     }
     
     // Create the entropy field
     propagator->field = braggi_entropy_field_create(propagator->source_file_id, propagator->error_handler);
     if (!propagator->field) {
-        report_propagation_error(propagator, 0, "Failed to create entropy field");
+        report_propagation_error(propagator, 0, &(BraggiDiagRecord){.id = BRAGGI_DIAG_FIELD_FAILED});
         return false;
     }
     
-    // Map to keep track of cell IDs by token position
-    Vector* cell_map = braggi_vector_create(sizeof(EntropyCell*));
-    if (!cell_map) {
-        report_propagation_error(propagator, 0, "Failed to create cell map");
+    // Cell ID of each token by its index in propagator->tokens. Built
+    // once here and handed to the field, so constraint creation and every
+    // pattern function look cells up by index instead of searching.
+    size_t token_count = braggi_vector_size(propagator->tokens);
+    uint32_t* token_cells = malloc(token_count * sizeof(uint32_t));
+    if (!token_cells) {
+        report_propagation_error(propagator, 0, &(BraggiDiagRecord){
+            .id = BRAGGI_DIAG_OUT_OF_MEMORY, .args = {BRAGGI_DIAG_TEXT("token cell map")}});
         return false;
     }
     
     // First pass: Create cells for each token
-    for (size_t i = 0; i < braggi_vector_size(propagator->tokens); i++) {
-        Token* token = *(Token**)braggi_vector_get(propagator->tokens, i);
+    for (size_t i = 0; i < token_count; i++) {
+        Token* token = braggi_vector_at(propagator->tokens, Token*, i);
+        token_cells[i] = ENTROPY_NO_CELL;
         if (!token) continue;
         
         // Create a cell in the entropy field for this token
-        EntropyCell* cell = braggi_entropy_field_add_cell(propagator->field, token->position.offset);
+        SourcePosition position = braggi_token_get_position(token);
+        EntropyCell* cell = braggi_entropy_field_add_cell(propagator->field, position.offset);
         if (!cell) {
-            report_propagation_error(propagator, 0, "Failed to add cell to entropy field");
-            braggi_vector_destroy(cell_map);
+            report_propagation_error(propagator, 0, &(BraggiDiagRecord){
+                .id = BRAGGI_DIAG_CELL_FAILED, .args = {BRAGGI_DIAG_TOKEN(token)}});
+            free(token_cells);
             return false;
         }
         
         // Set cell position information
-        cell->position_line = token->position.line;
-        cell->position_column = token->position.column;
-        cell->position_offset = token->position.offset;
-        
-        // Store the cell in our map
-        if (!braggi_vector_push_back(cell_map, &cell)) {
-            report_propagation_error(propagator, 0, "Failed to add cell to map");
-            braggi_vector_destroy(cell_map);
-            return false;
-        }
+        cell->position_line = position.line;
+        cell->position_column = position.column;
+        cell->position_offset = position.offset;
+        
+        token_cells[i] = cell->id;
         
         // Add token state to the cell
         if (!add_token_state_to_cell(cell, token, 1.0f)) {
-            report_propagation_error(propagator, cell->id, "Failed to add token state to cell");
-            braggi_vector_destroy(cell_map);
+            report_propagation_error(propagator, cell->id, &(BraggiDiagRecord){
+                .id = BRAGGI_DIAG_STATE_FAILED,
+                .args = {BRAGGI_DIAG_TOKEN(token), BRAGGI_DIAG_CELL(cell->id)}});
+            free(token_cells);
             return false;
         }
     }
     
+    braggi_entropy_field_set_token_cells(propagator->field, token_cells, token_count);
+    
     // Second pass: Create adjacency constraints between tokens
-    for (size_t i = 0; i < braggi_vector_size(propagator->tokens) - 1; i++) {
-        Token* current_token = *(Token**)braggi_vector_get(propagator->tokens, i);
-        Token* next_token = *(Token**)braggi_vector_get(propagator->tokens, i + 1);
+    for (size_t i = 0; i + 1 < token_count; i++) {
+        Token* current_token = braggi_vector_at(propagator->tokens, Token*, i);
+        Token* next_token = braggi_vector_at(propagator->tokens, Token*, i + 1);
         
         if (!current_token || !next_token) continue;
         
         // Check if these tokens are adjacent
         if (tokens_are_adjacent(current_token, next_token)) {
             // Get the corresponding cells
-            EntropyCell* current_cell = *(EntropyCell**)braggi_vector_get(cell_map, i);
-            EntropyCell* next_cell = *(EntropyCell**)braggi_vector_get(cell_map, i + 1);
+            EntropyCell* current_cell = propagator->field->cells[token_cells[i]];
+            EntropyCell* next_cell = propagator->field->cells[token_cells[i + 1]];
             
             // Create adjacency constraint
             if (!create_adjacency_constraint(current_cell, next_cell, propagator)) {
-                report_propagation_error(propagator, current_cell->id, "Failed to create adjacency constraint");
-                braggi_vector_destroy(cell_map);
+                report_propagation_error(propagator, current_cell->id, &(BraggiDiagRecord){
+                    .id = BRAGGI_DIAG_CONSTRAINT_FAILED,
+                    .args = {BRAGGI_DIAG_TEXT("adjacency"), BRAGGI_DIAG_CELL(current_cell->id),
+                             BRAGGI_DIAG_CELL(next_cell->id)}});
                 return false;
             }
         }
@@ -563,14 +459,10 @@ bool braggi_token_propagator_initialize_field(TokenPropagator* propagator) {
     
     // Create syntax and semantic constraints
     if (!create_syntax_constraints(propagator) || !create_semantic_constraints(propagator, propagator->field, propagator->tokens)) {
-        report_propagation_error(propagator, 0, "Failed to create syntax or semantic constraints");
-        braggi_vector_destroy(cell_map);
+        report_propagation_error(propagator, 0, &(BraggiDiagRecord){.id = BRAGGI_DIAG_CONSTRAINTS_FAILED});
         return false;
     }
     
-    // Clean up
-    braggi_vector_destroy(cell_map);
-    
     // Mark as initialized
     propagator->initialized = true;
     propagator->status = TOKEN_PROPAGATOR_STATUS_RUNNING;
@@ -608,9 +500,9 @@ static bool create_syntax_constraints(TokenPropagator* propagator) {
             continue;
         }
         
-        // Get cell IDs for tokens, ensuring they're within bounds
-        uint32_t cell1_id = get_valid_cell_id_for_token(propagator, *token1_ptr);
-        uint32_t cell2_id = get_valid_cell_id_for_token(propagator, *token2_ptr);
+        // Cells come straight from the field's token map
+        uint32_t cell1_id = braggi_entropy_field_token_cell(propagator->field, i);
+        uint32_t cell2_id = braggi_entropy_field_token_cell(propagator->field, i + 1);
         
         // Get cells from field
         EntropyCell* cell1 = braggi_entropy_field_get_cell(propagator->field, cell1_id);
@@ -885,10 +777,10 @@ static bool token_propagator_create_constraints(TokenPropagator* propagator) {
                 
                 // Check if tokens are adjacent without whitespace
                 // If tokens have position info, verify they're directly adjacent
-                if (token1->position.offset + strlen(token1->text) == token2->position.offset) {
-                    fprintf(stderr, "DEBUG: Detected compound operator: %s%s at positions %u and %u\n",
+                if (token1->loc + strlen(token1->text) == token2->loc) {
+                    fprintf(stderr, "DEBUG: Detected compound operator: %s%s at locations %u and %u\n",
                             token1->text, token2->text, 
-                            token1->position.offset, token2->position.offset);
+                            token1->loc, token2->loc);
                     
                     // Create a stronger adjacency constraint for compound operators
                     // to ensure they're treated as a single unit
@@ -901,13 +793,15 @@ static bool token_propagator_create_constraints(TokenPropagator* propagator) {
         EntropyCell* cell2 = NULL;
         
         // Find cells for these tokens by position
+        uint32_t offset1 = braggi_token_get_position(token1).offset;
+        uint32_t offset2 = braggi_token_get_position(token2).offset;
         for (size_t j = 0; j < propagator->field->cell_count; j++) {
             EntropyCell* cell = propagator->field->cells[j];
             if (!cell) continue;
             
-            if (cell->position_offset == token1->position.offset) {
+            if (cell->position_offset == offset1) {
                 cell1 = cell;
-            } else if (cell->position_offset == token2->position.offset) {
+            } else if (cell->position_offset == offset2) {
                 cell2 = cell;
             }
             
@@ -947,7 +841,7 @@ static bool token_propagator_create_constraints(TokenPropagator* propagator) {
         } else {
             fprintf(stderr, "WARNING: Could not find cells for tokens at %zu and %zu\n", i, i+1);
             fprintf(stderr, "         Token1: type=%d, offset=%u; Token2: type=%d, offset=%u\n", 
-                    token1->type, token1->position.offset, token2->type, token2->position.offset);
+                    token1->type, offset1, token2->type, offset2);
         }
     }
     
@@ -1154,7 +1048,13 @@ bool braggi_token_propagator_collapse_field(TokenPropagator* propagator) {
     
     if (!success) {
         fprintf(stderr, "ERROR: Wave Function Collapse algorithm failed\n");
-        report_propagation_error(propagator, 0, "Wave Function Collapse algorithm failed");
+        EntropyField* field = propagator->field;
+        if (field->has_contradiction) {
+            report_propagation_error(propagator, field->contradiction_cell_id, &(BraggiDiagRecord){
+                .id = BRAGGI_DIAG_CONTRADICTION, .args = {BRAGGI_DIAG_CELL(field->contradiction_cell_id)}});
+        } else {
+            report_propagation_error(propagator, 0, &(BraggiDiagRecord){.id = BRAGGI_DIAG_COLLAPSE_FAILED});
+        }
         return false;
     }
     
@@ -1225,42 +1125,24 @@ static bool create_default_periscope_contracts(TokenPropagator* propagator) {
             (void*)propagator, (void*)propagator->periscope);
     
     // Create a simple default contract
-    RegionLifetimeContract* contract = braggi_periscope_create_contract(
+    PeriscopeContractId contract = braggi_periscope_create_contract(
         propagator->periscope,
         1,  // Default region ID (1 for main region)
         1,  // Default validator ID (1 for main validator)
         1   // Basic guarantee flag
     );
     
-    if (!contract) {
+    if (contract == PERISCOPE_CONTRACT_INVALID) {
         fprintf(stderr, "ERROR: Failed to create default contract\n");
         return false;
     }
     
-    fprintf(stderr, "DEBUG: Created default contract %p for token validation\n", (void*)contract);
+    fprintf(stderr, "DEBUG: Created default contract %u for token validation\n", contract);
     
-    // Explicitly verify that the contract was added to active_contracts
-    if (propagator->periscope->active_contracts) {
-        size_t contract_count = braggi_vector_size(propagator->periscope->active_contracts);
-        fprintf(stderr, "DEBUG: After creating contract, periscope has %zu active contracts\n", 
-                contract_count);
-        
-        // Verify the contract's validity flag is set
-        for (size_t i = 0; i < contract_count; i++) {
-            RegionLifetimeContract** current = braggi_vector_get(
-                propagator->periscope->active_contracts, i);
-            
-            if (current && *current == contract) {
-                fprintf(stderr, "DEBUG: Found contract %p at index %zu, is_valid=%d\n", 
-                        (void*)contract, i, (*current)->is_valid);
-                
-                // Ensure the contract is valid
-                (*current)->is_valid = true;
-            }
-        }
-    } else {
-        fprintf(stderr, "ERROR: Periscope has no active_contracts vector after contract creation\n");
-    }
+    // Ensure the contract is in force
+    braggi_periscope_set_contract_valid(propagator->periscope, contract, true);
+    fprintf(stderr, "DEBUG: After creating contract, periscope has %zu active contracts\n", 
+            braggi_periscope_contract_count(propagator->periscope));
     
     // Set default validator if not already set
     if (!propagator->periscope->validator) {
@@ -1291,21 +1173,8 @@ bool braggi_token_propagator_run_with_wfc(TokenPropagator* propagator) {
         // Check if periscope has valid contracts before proceeding
         fprintf(stderr, "DEBUG: Validating periscope contracts before constraint creation\n");
         
-        size_t valid_contracts = 0;
-        size_t total_contracts = 0;
-        
-        if (propagator->periscope->active_contracts) {
-            total_contracts = braggi_vector_size(propagator->periscope->active_contracts);
-            
-            for (size_t i = 0; i < total_contracts; i++) {
-                RegionLifetimeContract** contract_ptr = braggi_vector_get(
-                    propagator->periscope->active_contracts, i);
-                
-                if (contract_ptr && *contract_ptr && (*contract_ptr)->is_valid) {
-                    valid_contracts++;
-                }
-            }
-        }
+        size_t total_contracts = braggi_periscope_contract_count(propagator->periscope);
+        size_t valid_contracts = braggi_periscope_valid_contract_count(propagator->periscope);
         
         fprintf(stderr, "DEBUG: Periscope contract validation: %zu valid out of %zu total\n", 
                 valid_contracts, total_contracts);
@@ -1534,20 +1403,22 @@ EntropyField* braggi_token_propagator_get_field(TokenPropagator* propagator) {
 // Helper function to report propagation errors
 static void report_propagation_error(TokenPropagator* propagator, 
                                      uint32_t cell_id, 
-                                     const char* message) {
-    if (!propagator || !message) {
+                                     const BraggiDiagRecord* record) {
+    if (!propagator || !record) {
         return;
     }
     
-    // Get the cell's position information
-    SourcePosition position = { 0, 0, 0 };
+    // Only the message ID and arguments are recorded here; the text is
+    // put together if and when the diagnostic is shown
+    BraggiDiagRecord diagnostic = *record;
+    diagnostic.category = ERROR_CATEGORY_SEMANTIC;
+    diagnostic.severity = ERROR_SEVERITY_ERROR;
     
-    if (cell_id > 0 && propagator->field) {
+    // Point at the cell's token unless the caller already said where
+    if (diagnostic.loc == BRAGGI_SOURCE_LOC_INVALID && cell_id > 0 && propagator->field) {
         EntropyCell* cell = braggi_entropy_field_get_cell(propagator->field, cell_id);
         if (cell) {
-            position.line = cell->position_line;
-            position.column = cell->position_column;
-            position.offset = cell->position_offset;
+            diagnostic.loc = braggi_source_loc_get(propagator->source_file_id, cell->position_offset);
         }
     }
     
@@ -1556,27 +1427,13 @@ static void report_propagation_error(TokenPropagator* propagator,
     
     // Report the error
     if (propagator->error_handler) {
-        // Create an error object
-        Error* error = braggi_error_create(
-            propagator->source_file_id,
-            ERROR_CATEGORY_SEMANTIC,
-            ERROR_SEVERITY_ERROR,
-            position,
-            NULL,
-            message,
-            NULL
-        );
-        
-        if (error) {
-            // Add to error handler
-            // This function signature might need adjustment
-            // braggi_error_handler_add_error(propagator->error_handler, error);
-            
-            // For now, just free it
-            braggi_error_free(error);
-        }
+        braggi_error_report_record(propagator->error_handler, &diagnostic);
     } else {
         // Just print to stderr if no error handler
+        char message[256];
+        SourcePosition position;
+        braggi_diag_format(&diagnostic, message, sizeof(message));
+        braggi_source_loc_decode(diagnostic.loc, &position);
         fprintf(stderr, "Propagation error at %u:%u:%u: %s\n",
                 position.line, position.column, position.offset, message);
     }
@@ -1637,7 +1494,7 @@ static bool tokens_are_adjacent(Token* token1, Token* token2) {
     
     // Simple heuristic: tokens are adjacent if they're consecutive in the source
     // A more sophisticated implementation would consider whitespace and comments
-    return (token1->position.offset + strlen(token1->text) <= token2->position.offset);
+    return (token1->loc + strlen(token1->text) <= token2->loc);
 }
 
 // Wrapper function for periscope validator
@@ -1666,14 +1523,10 @@ static bool create_adjacency_constraint(EntropyCell* cell1, EntropyCell* cell2,
         return false;
     }
     
-    // Get cell IDs
+    // Get cell IDs; they come from cells in the field, so they're in bounds
     uint32_t cell1_id = cell1->id;
     uint32_t cell2_id = cell2->id;
     
-    // Normalize cell IDs to ensure they're within bounds
-    cell1_id = normalize_cell_id(propagator, cell1_id);
-    cell2_id = normalize_cell_id(propagator, cell2_id);
-    
     // Create constraint description
     char description[256];
     snprintf(description, sizeof(description), "Adjacency: Cell %u -> Cell %u", cell1_id, cell2_id);
@@ -1772,7 +1625,7 @@ static bool create_sequence_constraint(EntropyCell** cells, uint32_t cell_count,
     
     // Add cells to constraint
     for (uint32_t i = 0; i < cell_count; i++) {
-        uint32_t cell_id = normalize_cell_id(propagator, cells[i]->id);
+        uint32_t cell_id = cells[i]->id;
         if (!braggi_constraint_add_cell(constraint, cell_id)) {
             fprintf(stderr, "ERROR: Failed to add cell %u to constraint\n", cell_id);
             braggi_constraint_destroy(constraint);
@@ -1869,8 +1722,9 @@ bool braggi_token_propagator_register_tokens_with_periscope(TokenPropagator* pro
         uint32_t cell_id = (uint32_t)i;
         
         // If token has position info, use the line number
-        if (token->position.line > 0) {
-            cell_id = token->position.line;
+        SourcePosition position = braggi_token_get_position(token);
+        if (position.line > 0) {
+            cell_id = position.line;
         }
         
         if (!braggi_periscope_register_token(propagator->periscope, token, cell_id)) {
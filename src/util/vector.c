@@ -6,17 +6,15 @@
  */
 
 #include "braggi/util/vector.h"
+#include "braggi/alloc_profile.h"
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <stdint.h>
 #include <sys/types.h>  // For ssize_t
 
-// Include the necessary headers for region support
-#include "braggi/mem/region.h"
-#include "braggi/mem/regime.h"
-
-// Forward declaration if needed for any remaining MemoryRegion references
-typedef struct MemoryRegion MemoryRegion;
+// Region vectors allocate through the named region API
+#include "braggi/region.h"
 
 /*
  * "Good code is like a good pair of boots - well-constructed, 
@@ -30,6 +28,83 @@ typedef struct MemoryRegion MemoryRegion;
 // Growth factor when resizing
 #define VECTOR_GROWTH_FACTOR 2
 
+// Vector memory in a region has no source position of its own
+static void* region_alloc(Region* region, size_t size) {
+    SourcePosition none = {0};
+    return braggi_named_region_alloc(region, size, none, "vector");
+}
+
+/*
+ * Move the data to a block of exactly new_capacity elements. Every
+ * change of capacity comes through here, so this is the one place
+ * that knows where the memory comes from.
+ *
+ * Heap vectors realloc. A region can't give memory back, so a region
+ * vector carves out a new block, copies, and abandons the old block to
+ * the region. Region vectors never shrink.
+ */
+static bool vector_set_capacity(Vector* vector, size_t new_capacity) {
+    if (new_capacity == vector->capacity) {
+        return true;
+    }
+    
+    if (vector->elem_size > 0 && new_capacity > SIZE_MAX / vector->elem_size) {
+        return false;
+    }
+    
+    size_t new_bytes = new_capacity * vector->elem_size;
+    
+    if (!vector->region) {
+        void* new_data = realloc(vector->data, new_bytes);
+        if (!new_data && new_bytes > 0) {
+            return false;
+        }
+        if (new_capacity > vector->capacity) {
+            braggi_alloc_profile_note(BRAGGI_ALLOC_PROFILE_HEAP_KEY, "heap", new_bytes, 0, 0, "vector");
+        }
+        vector->data = new_data;
+        vector->capacity = new_capacity;
+        return true;
+    }
+    
+    if (new_capacity < vector->capacity) {
+        return true;
+    }
+    
+    void* new_data = region_alloc(vector->region, new_bytes);
+    if (!new_data) {
+        return false;
+    }
+    if (vector->size > 0) {
+        memcpy(new_data, vector->data, vector->size * vector->elem_size);
+    }
+    
+    vector->data = new_data;
+    vector->capacity = new_capacity;
+    return true;
+}
+
+/*
+ * Make room for at least needed elements, growing geometrically so a
+ * run of pushes or appends copies each element a bounded number of times
+ */
+static bool vector_grow(Vector* vector, size_t needed) {
+    if (needed <= vector->capacity) {
+        return true;
+    }
+    
+    size_t new_capacity = vector->capacity > 0 ? vector->capacity : VECTOR_DEFAULT_CAPACITY;
+    while (new_capacity < needed) {
+        if (new_capacity > SIZE_MAX / VECTOR_GROWTH_FACTOR) {
+            new_capacity = needed;
+            break;
+        }
+        new_capacity *= VECTOR_GROWTH_FACTOR;
+    }
+    
+    return vector_set_capacity(vector, new_capacity);
+}
+
 /* 
  * Create a new vector with the specified element size
  */
@@ -49,6 +124,7 @@ Vector* braggi_vector_create_with_capacity(size_t elem_size, size_t initial_capa
     vector->elem_size = elem_size;
     vector->size = 0;
     vector->capacity = initial_capacity;
+    vector->region = NULL;
     
     vector->data = malloc(vector->capacity * vector->elem_size);
     if (!vector->data) {
@@ -56,6 +132,7 @@ Vector* braggi_vector_create_with_capacity(size_t elem_size, size_t initial_capa
         return NULL;
     }
     
+    braggi_alloc_profile_note(BRAGGI_ALLOC_PROFILE_HEAP_KEY, "heap", sizeof(Vector) + vector->capacity * elem_size, 0, 0, "vector");
     return vector;
 }
 
@@ -66,7 +143,7 @@ Vector* braggi_vector_create_in_region(Region* region, size_t elem_size) {
     Vector* vector;
     
     if (region) {
-        vector = (Vector*)braggi_mem_region_alloc(region, sizeof(Vector));
+        vector = (Vector*)region_alloc(region, sizeof(Vector));
     } else {
         vector = (Vector*)malloc(sizeof(Vector));
     }
@@ -79,10 +156,11 @@ Vector* braggi_vector_create_in_region(Region* region, size_t elem_size) {
     vector->elem_size = elem_size > 0 ? elem_size : sizeof(void*);
     vector->size = 0;
     vector->capacity = VECTOR_DEFAULT_CAPACITY;
+    vector->region = region;
     
     // Allocate data array from the region or standard memory
     if (region) {
-        vector->data = braggi_mem_region_alloc(region, vector->capacity * vector->elem_size);
+        vector->data = region_alloc(region, vector->capacity * vector->elem_size);
     } else {
         vector->data = malloc(vector->capacity * vector->elem_size);
     }
@@ -103,7 +181,8 @@ Vector* braggi_vector_create_in_region(Region* region, size_t elem_size) {
  * Destroy a vector and free its memory
  */
 void braggi_vector_destroy(Vector* vector) {
-    if (vector) {
+    // A region vector and its data go when the region does
+    if (vector && !vector->region) {
         if (vector->data) {
             free(vector->data);
         }
@@ -119,15 +198,7 @@ bool braggi_vector_resize(Vector* vector, size_t new_capacity) {
         return false;
     }
     
-    void* new_data = realloc(vector->data, new_capacity * vector->elem_size);
-    if (!new_data) {
-        return false;
-    }
-    
-    vector->data = new_data;
-    vector->capacity = new_capacity;
-    
-    return true;
+    return vector_set_capacity(vector, new_capacity);
 }
 
 /*
@@ -139,11 +210,8 @@ bool braggi_vector_push(Vector* vector, const void* element) {
     }
     
     // Resize if necessary
-    if (vector->size >= vector->capacity) {
-        size_t new_capacity = vector->capacity * 2;
-        if (!braggi_vector_resize(vector, new_capacity)) {
-            return false;
-        }
+    if (!vector_grow(vector, vector->size + 1)) {
+        return false;
     }
     
     // Copy the element to the end of the vector
@@ -207,11 +275,8 @@ bool braggi_vector_insert(Vector* vector, size_t index, const void* element) {
     }
     
     // Resize if necessary
-    if (vector->size >= vector->capacity) {
-        size_t new_capacity = vector->capacity * 2;
-        if (!braggi_vector_resize(vector, new_capacity)) {
-            return false;
-        }
+    if (!vector_grow(vector, vector->size + 1)) {
+        return false;
     }
     
     // Shift elements after the insertion point
@@ -229,6 +294,81 @@ bool braggi_vector_insert(Vector* vector, size_t index, const void* element) {
     return true;
 }
 
+/*
+ * Append a run of packed elements with a single copy
+ */
+bool braggi_vector_append_n(Vector* vector, const void* elems, size_t count) {
+    if (!vector || (!elems && count > 0)) {
+        return false;
+    }
+    
+    if (count == 0) {
+        return true;
+    }
+    
+    if (count > SIZE_MAX - vector->size) {
+        return false;
+    }
+    
+    // Growing may move the data, so remember where elems sat inside it
+    const char* data = (const char*)vector->data;
+    const char* src = (const char*)elems;
+    bool aliased = data && src >= data && src < data + vector->size * vector->elem_size;
+    size_t offset = aliased ? (size_t)(src - data) : 0;
+    
+    if (!vector_grow(vector, vector->size + count)) {
+        return false;
+    }
+    
+    if (aliased) {
+        src = (const char*)vector->data + offset;
+    }
+    
+    memcpy((char*)vector->data + (vector->size * vector->elem_size), src, count * vector->elem_size);
+    vector->size += count;
+    
+    return true;
+}
+
+/*
+ * Append all of another vector's elements
+ */
+bool braggi_vector_extend_from(Vector* dst, const Vector* src) {
+    if (!dst || !src || dst->elem_size != src->elem_size) {
+        return false;
+    }
+    
+    return braggi_vector_append_n(dst, src->data, src->size);
+}
+
+/*
+ * Insert a run of packed elements, moving the tail once
+ */
+bool braggi_vector_insert_range(Vector* vector, size_t index, const void* elems, size_t count) {
+    if (!vector || (!elems && count > 0) || index > vector->size) {
+        return false;
+    }
+    
+    if (count == 0) {
+        return true;
+    }
+    
+    if (count > SIZE_MAX - vector->size || !vector_grow(vector, vector->size + count)) {
+        return false;
+    }
+    
+    char* at = (char*)vector->data + (index * vector->elem_size);
+    size_t bytes_to_move = (vector->size - index) * vector->elem_size;
+    if (bytes_to_move > 0) {
+        memmove(at + (count * vector->elem_size), at, bytes_to_move);
+    }
+    
+    memcpy(at, elems, count * vector->elem_size);
+    vector->size += count;
+    
+    return true;
+}
+
 /*
  * Remove an element at the specified index
  */
@@ -304,30 +444,6 @@ bool braggi_vector_empty(const Vector* vector) {
     return vector ? vector->size == 0 : true;
 }
 
-/*
- * Ensure the vector has enough capacity
- */
-static bool ensure_capacity(Vector* vector, size_t capacity) {
-    if (vector->capacity >= capacity) {
-        return true;
-    }
-    
-    size_t new_capacity = vector->capacity;
-    while (new_capacity < capacity) {
-        new_capacity *= VECTOR_GROWTH_FACTOR;
-    }
-    
-    void* new_data = realloc(vector->data, new_capacity * vector->elem_size);
-    if (!new_data) {
-        return false;
-    }
-    
-    vector->data = new_data;
-    vector->capacity = new_capacity;
-    
-    return true;
-}
-
 /*
  * Add an element to the end of a vector
  */
@@ -336,10 +452,8 @@ bool braggi_vector_push_back(Vector* vector, const void* elem) {
         return false;
     }
     
-    if (vector->size >= vector->capacity) {
-        if (!ensure_capacity(vector, vector->size + 1)) {
-            return false;
-        }
+    if (!vector_grow(vector, vector->size + 1)) {
+        return false;
     }
     
     memcpy((char*)vector->data + (vector->size * vector->elem_size), elem, vector->elem_size);
@@ -450,14 +564,7 @@ bool braggi_vector_reserve(Vector* vector, size_t capacity) {
         return true; // Nothing to do
     }
     
-    void* new_data = realloc(vector->data, capacity * vector->elem_size);
-    if (!new_data) {
-        return false;
-    }
-    
-    vector->data = new_data;
-    vector->capacity = capacity;
-    return true;
+    return vector_set_capacity(vector, capacity);
 }
 
 /*
@@ -472,11 +579,7 @@ void braggi_vector_shrink_to_fit(Vector* vector) {
         return;
     }
     
-    void* new_data = realloc(vector->data, vector->size * vector->elem_size);
-    if (new_data) {
-        vector->data = new_data;
-        vector->capacity = vector->size;
-    }
+    vector_set_capacity(vector, vector->size);
 }
 
 /*
@@ -512,15 +615,8 @@ void* braggi_vector_emplace(Vector* vector) {
         return NULL;
     }
     
-    if (vector->size >= vector->capacity) {
-        size_t new_capacity = vector->capacity * 2;
-        void* new_data = realloc(vector->data, new_capacity * vector->elem_size);
-        if (!new_data) {
-            return NULL;
-        }
-        
-        vector->data = new_data;
-        vector->capacity = new_capacity;
+    if (!vector_grow(vector, vector->size + 1)) {
+        return NULL;
     }
     
     // Return pointer to the new element position
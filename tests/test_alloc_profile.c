@@ -0,0 +1,111 @@
+/*
+ * Braggi - Allocation Profiler Tests
+ *
+ * "Pull a steer at random from the chute, not every tenth one -
+ * the tenth one's always the runt." - Fort Worth Stockyard Buyer
+ */
+
+#include "braggi/alloc_profile.h"
+#include "braggi/util/vector.h"
+#include "braggi/token.h"
+#include "test_common.h"
+#include <pthread.h>
+#include <string.h>
+
+#define THREADS 4
+#define PER_THREAD 20000
+
+// Allocate through the hooked heap paths the compiler uses
+static void churn(size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        Vector* vector = braggi_vector_create(sizeof(int));
+        braggi_vector_destroy(vector);
+    }
+}
+
+static void* churn_thread(void* arg) {
+    (void)arg;
+    churn(PER_THREAD);
+    return NULL;
+}
+
+int main(void) {
+    TEST_QUIET_STDERR();
+
+    braggi_alloc_profile_reset();
+    CHECK(!braggi_alloc_profile_is_enabled());
+    churn(1000);
+    CHECK(braggi_alloc_profile_sample_count() == 0);
+
+    // Real allocator paths reach the sampler
+    braggi_alloc_profile_enable(16);
+    CHECK(braggi_alloc_profile_is_enabled());
+    Token* token = braggi_token_create(TOKEN_IDENTIFIER, NULL, (SourcePosition){0});
+    braggi_token_destroy(token);
+    churn(PER_THREAD);
+    uint64_t samples = braggi_alloc_profile_sample_count();
+    CHECK(samples > 0);
+    // Mean interval is 16, so about 1250 samples; allow plenty of slack
+    CHECK(samples > PER_THREAD / 32 && samples < PER_THREAD / 8);
+
+    // Gaps between samples vary instead of repeating the rate exactly
+    AllocSample recent[64];
+    size_t count = braggi_alloc_profile_recent(recent, 64);
+    CHECK(count == 64);
+    bool varied = false;
+    for (size_t i = 1; i < count; i++) {
+        CHECK(recent[i - 1].sequence > recent[i].sequence);
+        uint64_t gap = recent[i - 1].sequence - recent[i].sequence;
+        if (gap != 16) varied = true;
+    }
+    CHECK(varied);
+    char name[8];
+    CHECK(braggi_alloc_profile_atom_name(recent[0].label_atom, name, sizeof(name)) == 6);
+    CHECK(strcmp(name, "vector") == 0);
+    CHECK(recent[0].region_key == BRAGGI_ALLOC_PROFILE_HEAP_KEY);
+    CHECK(braggi_alloc_profile_atom_name(0, name, sizeof(name)) == strlen("(unlabeled)"));
+    CHECK(strcmp(name, "(unlabe") == 0);
+
+    // Threads count down on their own and share the totals
+    braggi_alloc_profile_reset();
+    pthread_t threads[THREADS];
+    for (int i = 0; i < THREADS; i++) {
+        pthread_create(&threads[i], NULL, churn_thread, NULL);
+    }
+    for (int i = 0; i < THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    samples = braggi_alloc_profile_sample_count();
+    CHECK(samples > THREADS * PER_THREAD / 32 && samples < THREADS * PER_THREAD / 8);
+
+    // Nothing is sampled once disabled, but the data stays for the report
+    braggi_alloc_profile_disable();
+    churn(PER_THREAD);
+    CHECK(braggi_alloc_profile_sample_count() == samples);
+
+    char* text = NULL;
+    size_t size = 0;
+    FILE* stream = open_memstream(&text, &size);
+    braggi_alloc_profile_print(stream, 5);
+    fclose(stream);
+    CHECK(text && strstr(text, "vector") != NULL);
+    CHECK(text && strstr(text, "heap") != NULL);
+    free(text);
+
+    // Heap samples don't land in the totals of region 0
+    braggi_alloc_profile_reset();
+    braggi_alloc_profile_sample(BRAGGI_ALLOC_PROFILE_HEAP_KEY, "heap", 64, 0, 0, "vector");
+    braggi_alloc_profile_sample(0, NULL, 32, 1, 1, "var");
+    text = NULL;
+    stream = open_memstream(&text, &size);
+    braggi_alloc_profile_print(stream, 0);
+    fclose(stream);
+    CHECK(text && strstr(text, "heap") != NULL);
+    CHECK(text && strstr(text, "#0") != NULL);
+    free(text);
+
+    braggi_alloc_profile_reset();
+    CHECK(braggi_alloc_profile_sample_count() == 0);
+
+    TEST_DONE("alloc_profile");
+}
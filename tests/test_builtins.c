@@ -0,0 +1,109 @@
+/*
+ * Braggi - Builtin Registry Tests
+ *
+ * "Give every horse in the string a number, and ya never have to
+ * shout names across the corral." - Pecos Wrangler
+ */
+
+#include "braggi/builtins/builtins.h"
+#include "braggi/stdlib.h"
+#include "braggi/braggi_context.h"
+#include "test_common.h"
+#include <string.h>
+
+static int boxed_calls = 0;
+
+static BraggiValue* boxed_one(BraggiValue** args, size_t arg_count, void* context) {
+    (void)args;
+    (void)arg_count;
+    (void)context;
+    boxed_calls += 1;
+    return NULL;
+}
+
+static BraggiValue* boxed_two(BraggiValue** args, size_t arg_count, void* context) {
+    (void)args;
+    (void)arg_count;
+    (void)context;
+    boxed_calls += 2;
+    return NULL;
+}
+
+int main(void) {
+    TEST_QUIET_STDERR();
+
+    // A bare registry hands out dense IDs in registration order
+    BraggiBuiltinRegistry* registry = braggi_builtin_registry_create();
+    CHECK(registry != NULL);
+    CHECK(braggi_builtin_registry_count(registry) == 0);
+
+    braggi_builtins_register_core(registry);
+    CHECK(braggi_builtin_registry_count(registry) == 2);
+    CHECK(braggi_builtin_registry_resolve(registry, "print") == 0);
+    CHECK(braggi_builtin_registry_resolve(registry, "exit") == 1);
+    CHECK(strcmp(braggi_builtin_registry_name(registry, 1), "exit") == 0);
+    CHECK(braggi_builtin_registry_name(registry, 2) == NULL);
+
+    int marker = 0;
+    braggi_builtin_registry_register(registry, "ranch.count", boxed_one, &marker);
+    BraggiBuiltinId id = braggi_builtin_registry_resolve(registry, "ranch.count");
+    CHECK(id == 2);
+
+    void* context = NULL;
+    BraggiBuiltinFunc func = braggi_builtin_registry_func_at(registry, id, &context);
+    CHECK(func == boxed_one && context == &marker);
+    func(NULL, 0, context);
+    CHECK(boxed_calls == 1);
+
+    // Re-registering replaces the function but keeps the ID
+    braggi_builtin_registry_register(registry, "ranch.count", boxed_two, NULL);
+    CHECK(braggi_builtin_registry_resolve(registry, "ranch.count") == id);
+    CHECK(braggi_builtin_registry_count(registry) == 3);
+    func = braggi_builtin_registry_func_at(registry, id, NULL);
+    CHECK(func == boxed_two);
+    CHECK(braggi_builtin_registry_lookup(registry, "ranch.count", NULL) == boxed_two);
+
+    // Unknown names and IDs
+    CHECK(braggi_builtin_registry_resolve(registry, "ranch") == BRAGGI_BUILTIN_INVALID);
+    CHECK(braggi_builtin_registry_resolve(registry, "") == BRAGGI_BUILTIN_INVALID);
+    CHECK(braggi_builtin_registry_func_at(registry, 99, NULL) == NULL);
+    CHECK(braggi_builtin_registry_native_at(registry, id, NULL) == NULL);
+
+    // Lots of names force the hash table to grow without moving IDs
+    char name[32];
+    for (int i = 0; i < 500; i++) {
+        snprintf(name, sizeof(name), "herd.head%d", i);
+        braggi_builtin_registry_register(registry, name, boxed_one, NULL);
+    }
+    CHECK(braggi_builtin_registry_count(registry) == 503);
+    CHECK(braggi_builtin_registry_resolve(registry, "ranch.count") == id);
+    CHECK(braggi_builtin_registry_resolve(registry, "herd.head0") == 3);
+    CHECK(braggi_builtin_registry_resolve(registry, "herd.head499") == 502);
+    braggi_builtin_registry_destroy(registry);
+
+    // The stdlib registry calls natives through their IDs
+    BraggiContext* braggi = braggi_context_create();
+    CHECK(braggi != NULL);
+    if (!braggi) TEST_DONE("builtins");
+
+    BraggiBuiltinRegistry* stdlib = braggi_stdlib_get_registry(braggi);
+    CHECK(stdlib != NULL);
+    BraggiBuiltinId add = braggi_stdlib_resolve(braggi, "math.add");
+    CHECK(add != BRAGGI_BUILTIN_INVALID);
+    CHECK(braggi_builtin_registry_native_at(stdlib, add, NULL) != NULL);
+    CHECK(braggi_builtin_registry_func_at(stdlib, add, NULL) == NULL);
+
+    BraggiVal args[2] = { braggi_val_int(40), braggi_val_int(2) };
+    BraggiVal result = braggi_builtin_registry_call(stdlib, add, args, 2, NULL);
+    CHECK(result.tag == BRAGGI_VAL_INT && result.as.integer == 42);
+
+    // Calling a boxed builtin or a bad ID by value is an error value
+    BraggiBuiltinId print = braggi_stdlib_resolve(braggi, "print");
+    CHECK(print != BRAGGI_BUILTIN_INVALID);
+    CHECK(braggi_val_is_error(braggi_builtin_registry_call(stdlib, print, args, 2, NULL)));
+    CHECK(braggi_val_is_error(braggi_builtin_registry_call(stdlib, BRAGGI_BUILTIN_INVALID, args, 2, NULL)));
+
+    braggi_stdlib_cleanup(braggi);
+    braggi_context_destroy(braggi);
+    TEST_DONE("builtins");
+}
@@ -0,0 +1,45 @@
+/*
+ * Braggi - Test Helpers
+ *
+ * "Count yer cattle twice before ya tell the buyer how many ya got."
+ * - Panhandle Stockman
+ *
+ * Each test is its own executable registered with CTest. CHECK records
+ * a failure on stdout and keeps going so one run reports everything that
+ * broke; TEST_DONE turns the tally into the exit status. Set
+ * BRAGGI_TEST_VERBOSE to keep the library's stderr output.
+ */
+
+#ifndef BRAGGI_TEST_COMMON_H
+#define BRAGGI_TEST_COMMON_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static int test_failures = 0;
+static int test_checks = 0;
+
+#define CHECK(cond) do {                                                    \
+        test_checks++;                                                      \
+        if (!(cond)) {                                                      \
+            printf("%s:%d: CHECK failed: %s\n",                            \
+                   __FILE__, __LINE__, #cond);                              \
+            test_failures++;                                                \
+        }                                                                   \
+    } while (0)
+
+// Quiet the library's DEBUG chatter on stderr, keeping our own output
+#define TEST_QUIET_STDERR() do {                                            \
+        if (!getenv("BRAGGI_TEST_VERBOSE")) {                               \
+            fflush(stderr);                                                 \
+            if (!freopen("/dev/null", "w", stderr)) { }                     \
+        }                                                                   \
+    } while (0)
+
+#define TEST_DONE(name) do {                                                \
+        printf("%s: %d checks, %d failed\n", (name), test_checks,           \
+               test_failures);                                              \
+        return test_failures == 0 ? 0 : 1;                                  \
+    } while (0)
+
+#endif /* BRAGGI_TEST_COMMON_H */
@@ -0,0 +1,143 @@
+/*
+ * Braggi - Compile Pool Tests
+ *
+ * "When a horse quits under ya, ya don't shoot the rider -
+ * ya fetch another horse." - Pecos Remuda Boss
+ */
+
+#include "braggi/compile_pool.h"
+#include "test_common.h"
+#include <signal.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#define JOBS 12
+
+// Workers report their pid here, and wait for a byte from the gate
+static int pid_pipe[2];
+static int gate_pipe[2];
+
+// The -O level picks what the job does: 0 succeeds, 1 fails with the
+// length of its input, 2 kills the worker mid-job, 3 answers and then
+// lets the worker die while it sits idle, and 4 holds the worker until
+// the gate opens
+static int compile(const BraggiCompileJob* job, void* user_data) {
+    (void)user_data;
+    pid_t pid = getpid();
+    char byte;
+    switch (job->optimize_level) {
+        case 1:
+            return (int)strlen(job->input);
+        case 2:
+            _exit(9);
+        case 3:
+            alarm(1);
+            return write(pid_pipe[1], &pid, sizeof(pid)) == sizeof(pid) ? 0 : 1;
+        case 4:
+            return read(gate_pipe[0], &byte, 1) == 1 ? 0 : 1;
+        default:
+            return strcmp(job->output, "out") == 0 ? 0 : 100;
+    }
+}
+
+// Wait for every pending job, filling statuses by ID
+static size_t drain(BraggiCompilePool* pool, int* statuses, size_t max) {
+    size_t finished = 0;
+    uint32_t id;
+    int status;
+    while (braggi_compile_pool_wait(pool, &id, &status)) {
+        if (id < max) statuses[id] = status;
+        finished++;
+    }
+    return finished;
+}
+
+int main(void) {
+    TEST_QUIET_STDERR();
+    CHECK(pipe(pid_pipe) == 0 && pipe(gate_pipe) == 0);
+
+    CHECK(braggi_compile_pool_create(0, compile, NULL) == NULL);
+    CHECK(braggi_compile_pool_create(2, NULL, NULL) == NULL);
+
+    BraggiCompilePool* pool = braggi_compile_pool_create(3, compile, NULL);
+    CHECK(pool != NULL);
+    if (!pool) TEST_DONE("compile_pool");
+    CHECK(braggi_compile_pool_workers(pool) == 3);
+
+    // The pool leaves the process's SIGPIPE handling as it found it
+    struct sigaction action;
+    sigaction(SIGPIPE, NULL, &action);
+    CHECK(action.sa_handler == SIG_DFL);
+
+    // More jobs than workers all finish, each with its own status
+    int statuses[JOBS];
+    for (uint32_t i = 0; i < JOBS; i++) {
+        statuses[i] = -100;
+        BraggiCompileJob job = {i, i % 2 ? "abcde" : "in", "out", (int)(i % 2)};
+        CHECK(braggi_compile_pool_submit(pool, &job));
+    }
+    CHECK(braggi_compile_pool_pending(pool) == JOBS);
+    CHECK(drain(pool, statuses, JOBS) == JOBS);
+    bool answered = true;
+    for (size_t i = 0; i < JOBS; i++) answered = answered && statuses[i] == (i % 2 ? 5 : 0);
+    CHECK(answered);
+    CHECK(braggi_compile_pool_pending(pool) == 0);
+    uint32_t id;
+    int status;
+    CHECK(!braggi_compile_pool_wait(pool, &id, &status));
+    CHECK(!braggi_compile_pool_wait_timeout(pool, &id, &status, 0));
+
+    // A worker that dies mid-job loses only that job
+    BraggiCompileJob crash = {0, "in", "out", 2};
+    BraggiCompileJob fine = {1, "in", "out", 0};
+    CHECK(braggi_compile_pool_submit(pool, &crash) && braggi_compile_pool_submit(pool, &fine));
+    statuses[0] = statuses[1] = -100;
+    CHECK(drain(pool, statuses, JOBS) == 2);
+    CHECK(statuses[0] == BRAGGI_COMPILE_POOL_CRASHED && statuses[1] == 0);
+
+    // Workers that died while idle are replaced when handed a job: the
+    // write to them fails with EPIPE rather than ending this process
+    for (uint32_t i = 0; i < 3; i++) {
+        BraggiCompileJob doomed = {i, "in", "out", 3};
+        CHECK(braggi_compile_pool_submit(pool, &doomed));
+    }
+    CHECK(drain(pool, statuses, JOBS) == 3);
+    for (int i = 0; i < 3; i++) {
+        // Wait for each to die, leaving it for the pool to reap
+        pid_t doomed_pid;
+        siginfo_t info;
+        CHECK(read(pid_pipe[0], &doomed_pid, sizeof(doomed_pid)) == sizeof(doomed_pid));
+        CHECK(waitid(P_PID, (id_t)doomed_pid, &info, WEXITED | WNOWAIT) == 0);
+    }
+    for (uint32_t i = 0; i < 3; i++) {
+        statuses[i] = -100;
+        BraggiCompileJob job = {i, "in", "out", 0};
+        CHECK(braggi_compile_pool_submit(pool, &job));
+    }
+    CHECK(drain(pool, statuses, JOBS) == 3);
+    CHECK(statuses[0] == 0 && statuses[1] == 0 && statuses[2] == 0);
+
+    sigset_t pending;
+    sigpending(&pending);
+    CHECK(!sigismember(&pending, SIGPIPE));
+
+    // The pool's fds can join another event loop: one per busy worker,
+    // readable once its job is done
+    struct pollfd fds[3];
+    CHECK(braggi_compile_pool_poll_fds(pool, fds, 3) == 0);
+    for (uint32_t i = 0; i < 2; i++) {
+        BraggiCompileJob held = {i, "in", "out", 4};
+        CHECK(braggi_compile_pool_submit(pool, &held));
+    }
+    CHECK(braggi_compile_pool_poll_fds(pool, fds, 3) == 2);
+    CHECK(braggi_compile_pool_poll_fds(pool, fds, 1) == 1);
+    CHECK(braggi_compile_pool_poll_fds(pool, fds, 3) == 2 && poll(fds, 2, 0) == 0);
+    CHECK(write(gate_pipe[1], "go", 2) == 2);
+    CHECK(poll(fds, 2, 5000) > 0);
+    CHECK(drain(pool, statuses, JOBS) == 2);
+    CHECK(braggi_compile_pool_poll_fds(pool, fds, 3) == 0);
+
+    braggi_compile_pool_destroy(pool);
+    TEST_DONE("compile_pool");
+}
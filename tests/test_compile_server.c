@@ -0,0 +1,236 @@
+/*
+ * Braggi - Compile Server Tests
+ *
+ * "Two hands sent to fetch the same steer means one rides and the
+ * other waits at the gate." - Goliad County Foreman
+ */
+
+#include "braggi/compile_server.h"
+#include "test_common.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+static char dir[64];
+static char socket_path[96];
+static char log_path[96];
+static char input[96];
+static char output[96];
+
+// Compiles report their worker's pid here once started, then wait for
+// a byte from the gate
+static int started_pipe[2];
+static int gate_pipe[2];
+
+// Whether this process has a socket open, such as one of the server's
+static bool holds_socket(void) {
+    DIR* fds = opendir("/proc/self/fd");
+    if (!fds) return false;
+    bool found = false;
+    struct dirent* entry;
+    while (!found && (entry = readdir(fds)) != NULL) {
+        char link[64];
+        ssize_t length = readlinkat(dirfd(fds), entry->d_name, link, sizeof(link) - 1);
+        if (length > 0) {
+            link[length] = '\0';
+            found = strncmp(link, "socket:", 7) == 0;
+        }
+    }
+    closedir(fds);
+    return found;
+}
+
+// Held at the gate so other requests arrive while it runs; -O3 kills
+// the worker instead. Each compile appends a byte to the log.
+static int compile(const BraggiCompileJob* job, void* user_data) {
+    (void)user_data;
+    if (job->optimize_level == 3) _exit(9);
+
+    pid_t pid = getpid();
+    char byte;
+    if (write(started_pipe[1], &pid, sizeof(pid)) != sizeof(pid)) return 1;
+    if (read(gate_pipe[0], &byte, 1) != 1) return 1;
+    if (holds_socket()) return 7;
+
+    int fd = open(job->output, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return 1;
+    char text[32];
+    int length = snprintf(text, sizeof(text), "O%d\n", job->optimize_level);
+    bool written = write(fd, text, (size_t)length) == length;
+    close(fd);
+
+    int log = open(log_path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (log < 0) return 1;
+    written = write(log, "x", 1) == 1 && written;
+    close(log);
+    return written ? 0 : 1;
+}
+
+static size_t compiles(void) {
+    struct stat st;
+    return stat(log_path, &st) == 0 ? (size_t)st.st_size : 0;
+}
+
+typedef struct Request {
+    int optimize_level;
+    BraggiServerReply reply;
+    char message[128];
+} Request;
+
+static void* send_request(void* arg) {
+    Request* request = arg;
+    BraggiCompileJob job = {0, input, output, request->optimize_level};
+    request->reply = braggi_compile_server_request(socket_path, &job, request->message,
+                                                   sizeof(request->message));
+    return NULL;
+}
+
+// Send a compile request without waiting for the reply
+static int open_request(int optimize_level) {
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    snprintf(address.sun_path, sizeof(address.sun_path), "%s", socket_path);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    char line[256];
+    int length = snprintf(line, sizeof(line), "compile\t%d\t%s\t%s\n", optimize_level, input, output);
+    if (connect(fd, (struct sockaddr*)&address, sizeof(address)) != 0 ||
+        write(fd, line, (size_t)length) != length) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static bool read_reply(int fd, const char* expected) {
+    char text[128];
+    size_t length = 0;
+    while (length < sizeof(text) - 1) {
+        ssize_t n = read(fd, text + length, 1);
+        if (n <= 0 || text[length] == '\n') break;
+        length++;
+    }
+    text[length] = '\0';
+    close(fd);
+    return strcmp(text, expected) == 0;
+}
+
+// Wait for a compile to start, returning its worker's pid
+static pid_t wait_started(void) {
+    pid_t pid = -1;
+    return read(started_pipe[0], &pid, sizeof(pid)) == sizeof(pid) ? pid : -1;
+}
+
+static void pause_ms(long ms) {
+    struct timespec delay = {ms / 1000, (ms % 1000) * 1000000L};
+    nanosleep(&delay, NULL);
+}
+
+int main(void) {
+    TEST_QUIET_STDERR();
+
+    snprintf(dir, sizeof(dir), "/tmp/braggi_serverXXXXXX");
+    CHECK(mkdtemp(dir) != NULL);
+    snprintf(socket_path, sizeof(socket_path), "%s/sock", dir);
+    snprintf(log_path, sizeof(log_path), "%s/log", dir);
+    snprintf(input, sizeof(input), "%s/herd.bg", dir);
+    snprintf(output, sizeof(output), "%s/herd.out", dir);
+    FILE* source = fopen(input, "w");
+    CHECK(source != NULL);
+    if (!source) TEST_DONE("compile_server");
+    fputs("var herd = 40;\n", source);
+    fclose(source);
+
+    CHECK(pipe(started_pipe) == 0 && pipe(gate_pipe) == 0);
+
+    // One worker, so the replacement for a lost one runs the next job
+    pid_t server = fork();
+    if (server == 0) {
+        BraggiCompilePool* pool = braggi_compile_pool_create(1, compile, NULL);
+        int result = pool ? braggi_compile_server_run(socket_path, pool) : 1;
+        braggi_compile_pool_destroy(pool);
+        _exit(result);
+    }
+    CHECK(server > 0);
+
+    // Wait for the server to listen
+    struct stat st;
+    for (int i = 0; i < 200 && stat(socket_path, &st) != 0; i++) pause_ms(10);
+    CHECK(stat(socket_path, &st) == 0);
+
+    // A second request for a running compile shares it. The server reads
+    // requests in the order they connect, so by the time the third is
+    // answered the second has joined.
+    Request first = {1, BRAGGI_SERVER_ERROR, ""};
+    pthread_t thread;
+    pthread_create(&thread, NULL, send_request, &first);
+    CHECK(wait_started() > 0);
+    int second = open_request(1);
+    CHECK(second >= 0);
+
+    // ...while a different compile of the same output is turned away
+    Request other = {2, BRAGGI_SERVER_COMPILED, ""};
+    send_request(&other);
+    CHECK(other.reply == BRAGGI_SERVER_ERROR && strcmp(other.message, "busy") == 0);
+
+    CHECK(write(gate_pipe[1], "g", 1) == 1);
+    pthread_join(thread, NULL);
+    CHECK(first.reply == BRAGGI_SERVER_COMPILED);
+    CHECK(read_reply(second, "ok compiled"));
+    CHECK(compiles() == 1);
+
+    // Once it's done, the same request is answered from the cache and a
+    // different one compiles
+    Request again = {1, BRAGGI_SERVER_ERROR, ""};
+    send_request(&again);
+    CHECK(again.reply == BRAGGI_SERVER_CACHED);
+    pthread_create(&thread, NULL, send_request, &other);
+    CHECK(wait_started() > 0 && write(gate_pipe[1], "g", 1) == 1);
+    pthread_join(thread, NULL);
+    CHECK(other.reply == BRAGGI_SERVER_COMPILED);
+    CHECK(compiles() == 2);
+
+    // A lost worker fails its job, and its replacement holds none of the
+    // server's sockets
+    Request lost = {3, BRAGGI_SERVER_ERROR, ""};
+    send_request(&lost);
+    CHECK(lost.reply == BRAGGI_SERVER_FAILED);
+    Request replaced = {0, BRAGGI_SERVER_ERROR, ""};
+    pthread_create(&thread, NULL, send_request, &replaced);
+    CHECK(wait_started() > 0 && write(gate_pipe[1], "g", 1) == 1);
+    pthread_join(thread, NULL);
+    CHECK(replaced.reply == BRAGGI_SERVER_COMPILED);
+    CHECK(compiles() == 3);
+
+    // A Ctrl-C reaches the worker too, but the running job still finishes
+    // and is answered before the server stops
+    Request interrupted = {5, BRAGGI_SERVER_ERROR, ""};
+    pthread_create(&thread, NULL, send_request, &interrupted);
+    pid_t worker = wait_started();
+    CHECK(worker > 0);
+    CHECK(kill(worker, SIGINT) == 0 && kill(server, SIGINT) == 0);
+    CHECK(write(gate_pipe[1], "g", 1) == 1);
+    pthread_join(thread, NULL);
+    CHECK(interrupted.reply == BRAGGI_SERVER_COMPILED);
+    CHECK(compiles() == 4);
+
+    int status = -1;
+    CHECK(waitpid(server, &status, 0) == server);
+    CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    unlink(input);
+    unlink(output);
+    unlink(log_path);
+    rmdir(dir);
+    TEST_DONE("compile_server");
+}
@@ -0,0 +1,211 @@
+/*
+ * Braggi - Diagnostics Tests
+ *
+ * "Wipe the slate and it's a clean slate, not one with last week's
+ * sums showin' through." - Roscommon Schoolmistress
+ */
+
+#include "braggi/diagnostics.h"
+#include "braggi/error_handler.h"
+#include "braggi/error.h"
+#include "braggi/entropy.h"
+#include "braggi/braggi_context.h"
+#include "test_common.h"
+#include <string.h>
+#include <unistd.h>
+
+typedef struct Seen {
+    size_t count;
+    uint32_t repeats;
+    BraggiDiagId last;
+    char message[128];
+    char filename[32];
+    uint32_t line;
+    uint32_t column;
+} Seen;
+
+// Strings a sink sees only last for the call, so keep copies
+static void emit(const BraggiDiagnostic* diagnostic, void* user_data) {
+    Seen* seen = user_data;
+    seen->count++;
+    seen->repeats += diagnostic->repeats;
+    seen->last = diagnostic->record ? diagnostic->record->id : BRAGGI_DIAG_NONE;
+    snprintf(seen->message, sizeof(seen->message), "%s", diagnostic->message ? diagnostic->message : "");
+    snprintf(seen->filename, sizeof(seen->filename), "%s", diagnostic->filename ? diagnostic->filename : "");
+    seen->line = diagnostic->position.line;
+    seen->column = diagnostic->position.column;
+}
+
+static BraggiDiagRecord record(BraggiDiagId id, ErrorSeverity severity, int64_t cell) {
+    BraggiDiagRecord r;
+    memset(&r, 0, sizeof(r));
+    r.id = id;
+    r.category = ERROR_CATEGORY_SEMANTIC;
+    r.severity = severity;
+    r.loc = BRAGGI_SOURCE_LOC_INVALID;
+    r.args[0] = BRAGGI_DIAG_CELL((uint32_t)cell);
+    return r;
+}
+
+int main(void) {
+    TEST_QUIET_STDERR();
+
+    // Clearing a handler forgets its errors
+    ErrorHandler* handler = braggi_error_handler_create();
+    CHECK(handler != NULL);
+    if (!handler) TEST_DONE("diagnostics");
+    braggi_diagnostics_clear_sinks(braggi_error_handler_get_diagnostics(handler));
+    CHECK(!braggi_error_handler_has_errors(handler));
+
+    BraggiDiagRecord contradiction = record(BRAGGI_DIAG_CONTRADICTION, ERROR_SEVERITY_ERROR, 3);
+    braggi_error_report_record(handler, &contradiction);
+    CHECK(braggi_error_handler_has_errors(handler));
+    braggi_error_handler_clear(handler);
+    CHECK(!braggi_error_handler_has_errors(handler));
+    braggi_error_handler_destroy(handler);
+
+    // Flushing empties the queue but keeps the counts
+    BraggiDiagnostics* diagnostics = braggi_diagnostics_create();
+    Seen seen = {0};
+    CHECK(braggi_diagnostics_add_sink(diagnostics, (BraggiDiagnosticSink){emit, NULL, &seen}));
+
+    CHECK(braggi_diagnostics_report_record(diagnostics, &contradiction));
+    CHECK(!braggi_diagnostics_report_record(diagnostics, &contradiction));
+    BraggiDiagRecord note = record(BRAGGI_DIAG_NO_TOKENS, ERROR_SEVERITY_NOTE, 0);
+    CHECK(braggi_diagnostics_report_record(diagnostics, &note));
+    CHECK(braggi_diagnostics_pending(diagnostics) == 2);
+    CHECK(braggi_diagnostics_count(diagnostics, ERROR_SEVERITY_ERROR) == 2);
+    CHECK(braggi_diagnostics_count(diagnostics, ERROR_SEVERITY_NOTE) == 3);
+
+    CHECK(braggi_diagnostics_flush(diagnostics) == 2);
+    CHECK(seen.count == 2 && seen.repeats == 1);
+    CHECK(braggi_diagnostics_pending(diagnostics) == 0);
+    CHECK(braggi_diagnostics_count(diagnostics, ERROR_SEVERITY_ERROR) == 2);
+
+    // Clearing drops pending reports unseen and zeroes the counts
+    BraggiDiagRecord other = record(BRAGGI_DIAG_CONTRADICTION, ERROR_SEVERITY_FATAL, 9);
+    braggi_diagnostics_report_record(diagnostics, &other);
+    braggi_diagnostics_clear(diagnostics);
+    CHECK(braggi_diagnostics_pending(diagnostics) == 0);
+    CHECK(braggi_diagnostics_count(diagnostics, ERROR_SEVERITY_NOTE) == 0);
+    CHECK(braggi_diagnostics_flush(diagnostics) == 0);
+    CHECK(seen.count == 2);
+
+    // ...and a report after a clear counts from zero again
+    CHECK(braggi_diagnostics_report_record(diagnostics, &contradiction));
+    CHECK(braggi_diagnostics_count(diagnostics, ERROR_SEVERITY_ERROR) == 1);
+
+    // Over the limit, reports are counted but not kept
+    braggi_diagnostics_clear(diagnostics);
+    braggi_diagnostics_set_limit(diagnostics, 2);
+    for (int cell = 0; cell < 5; cell++) {
+        BraggiDiagRecord r = record(BRAGGI_DIAG_CONTRADICTION, ERROR_SEVERITY_ERROR, cell);
+        braggi_diagnostics_report_record(diagnostics, &r);
+    }
+    CHECK(braggi_diagnostics_pending(diagnostics) == 2);
+    CHECK(braggi_diagnostics_suppressed(diagnostics) == 3);
+    CHECK(braggi_diagnostics_count(diagnostics, ERROR_SEVERITY_ERROR) == 5);
+
+    // Records are rendered from their arguments only when flushed
+    char text[128];
+    BraggiDiagRecord built = record(BRAGGI_DIAG_CONSTRAINT_FAILED, ERROR_SEVERITY_ERROR, 0);
+    built.args[0] = BRAGGI_DIAG_TEXT("syntax");
+    built.args[1] = BRAGGI_DIAG_CELL(4);
+    built.args[2] = BRAGGI_DIAG_STATE(7);
+    CHECK(braggi_diag_format(&built, text, sizeof(text)) == strlen(text));
+    CHECK(strcmp(text, "Failed to create syntax constraint between cell 4 and state 7") == 0);
+    size_t full = braggi_diag_format(&built, text, 10);
+    CHECK(full == strlen("Failed to create syntax constraint between cell 4 and state 7"));
+    CHECK(strlen(text) < 10);
+    built.id = BRAGGI_DIAG_ID_COUNT;
+    braggi_diag_format(&built, text, sizeof(text));
+    CHECK(strcmp(text, "Unknown diagnostic") == 0);
+
+    uint32_t lines[] = { 0, 11 };
+    BraggiSourceLoc base = braggi_source_loc_add_file(70001, "pen.bg", lines, 2, 24);
+    CHECK(base != BRAGGI_SOURCE_LOC_INVALID);
+    BraggiDiagRecord located = record(BRAGGI_DIAG_OUT_OF_MEMORY, ERROR_SEVERITY_ERROR, 0);
+    located.loc = base + 14;
+    located.args[0] = BRAGGI_DIAG_TEXT("a herd");
+    braggi_diagnostics_clear(diagnostics);
+    braggi_diagnostics_set_limit(diagnostics, 0);
+    seen.count = 0;
+    CHECK(braggi_diagnostics_report_record(diagnostics, &located));
+    CHECK(braggi_diagnostics_flush(diagnostics) == 1);
+    CHECK(seen.count == 1 && seen.last == BRAGGI_DIAG_OUT_OF_MEMORY);
+    CHECK(strcmp(seen.message, "Out of memory building a herd") == 0);
+    CHECK(strcmp(seen.filename, "pen.bg") == 0);
+    CHECK(seen.line == 2 && seen.column == 4);
+
+    // Reports sort by file, line and column, unnamed first
+    BraggiDiagRecord early = located;
+    early.loc = base + 1;
+    BraggiDiagRecord nowhere = record(BRAGGI_DIAG_COLLAPSE_FAILED, ERROR_SEVERITY_ERROR, 0);
+    braggi_diagnostics_report_record(diagnostics, &located);
+    braggi_diagnostics_report_record(diagnostics, &early);
+    braggi_diagnostics_report_record(diagnostics, &nowhere);
+    seen.count = 0;
+    CHECK(braggi_diagnostics_flush(diagnostics) == 3);
+    CHECK(seen.count == 3 && seen.line == 2);
+
+    // With no sinks, a flush drops the reports
+    braggi_diagnostics_clear_sinks(diagnostics);
+    braggi_diagnostics_report_record(diagnostics, &located);
+    CHECK(braggi_diagnostics_flush(diagnostics) == 1);
+    CHECK(braggi_diagnostics_pending(diagnostics) == 0);
+    CHECK(seen.count == 3);
+    braggi_source_loc_remove_file(70001);
+
+    braggi_diagnostics_destroy(diagnostics);
+
+    // A field's contradiction comes out as a record, and the text form
+    // is rendered from it
+    EntropyField* field = braggi_entropy_field_create(0, NULL);
+    CHECK(field != NULL);
+    BraggiDiagRecord found;
+    CHECK(!braggi_entropy_field_get_contradiction_record(field, &found));
+    braggi_entropy_field_add_cell(field, 5);
+    CHECK(braggi_entropy_field_get_contradiction_record(field, &found));
+    CHECK(found.id == BRAGGI_DIAG_CONTRADICTION && found.severity == ERROR_SEVERITY_ERROR);
+    CHECK(found.args[0].kind == BRAGGI_DIAG_ARG_CELL && found.args[0].as.id == 0);
+    char* info = NULL;
+    char rendered[128];
+    braggi_diag_format(&found, rendered, sizeof(rendered));
+    CHECK(braggi_entropy_field_get_contradiction_info(field, NULL, &info));
+    CHECK(info && strcmp(info, rendered) == 0);
+    free(info);
+    braggi_entropy_field_destroy(field);
+
+    // Context errors are records too
+    BraggiContext* context = braggi_context_create();
+    CHECK(context != NULL);
+    if (context) {
+        BraggiDiagnostics* engine = braggi_error_handler_get_diagnostics(braggi_context_get_error_handler(context));
+        braggi_diagnostics_clear_sinks(engine);
+        braggi_context_report_error(context, ERROR_CATEGORY_CODEGEN, ERROR_SEVERITY_ERROR, 0, 0,
+                                    "braggi_context.c", "Failed to apply constraints", NULL);
+        CHECK(braggi_context_has_errors(context));
+        CHECK(braggi_diagnostics_pending(engine) == 1);
+        braggi_context_destroy(context);
+    }
+
+    // Reports to the global handler reach stderr without anyone flushing,
+    // and starting the error system over prints rather than drops them
+    char path[] = "/tmp/braggi_diagnosticsXXXXXX";
+    int fd = mkstemp(path);
+    CHECK(fd >= 0);
+    fflush(stderr);
+    CHECK(freopen(path, "w", stderr) != NULL);
+    braggi_error_init();
+    braggi_error_report_ctx(ERROR_CATEGORY_SYSTEM, ERROR_SEVERITY_ERROR, 0, 0, NULL,
+                            "Module not found", NULL);
+    fflush(stderr);
+    char printed[256] = "";
+    CHECK(pread(fd, printed, sizeof(printed) - 1, 0) > 0);
+    CHECK(strstr(printed, "Module not found") != NULL);
+    braggi_error_cleanup();
+    close(fd);
+    unlink(path);
+
+    TEST_DONE("diagnostics");
+}
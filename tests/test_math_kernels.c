@@ -0,0 +1,177 @@
+/*
+ * Braggi - Numeric Kernel Tests
+ *
+ * "Check the fence by walkin' it, not by countin' the posts ya bought."
+ * - Hill Country Rancher
+ */
+
+#include "braggi/math_kernels.h"
+#include "braggi/value.h"
+#include "braggi/stdlib.h"
+#include "braggi/braggi_context.h"
+#include "test_common.h"
+#include <math.h>
+#include <string.h>
+
+static BraggiContext* context;
+
+static BraggiVal call(const char* name, const BraggiVal* args, size_t count, BraggiRegionHandle region) {
+    void* builtin_context = NULL;
+    BraggiNativeFunc func = braggi_stdlib_lookup_native(context, name, &builtin_context);
+    CHECK(func != NULL);
+    if (!func) return braggi_val_error("missing builtin");
+    return func(args, count, region, builtin_context);
+}
+
+static bool close_to(double a, double b) {
+    return fabs(a - b) <= 1e-9 * (1.0 + fabs(b));
+}
+
+// Lengths around the unroll width and a long one
+static const size_t lengths[] = { 0, 1, 3, 4, 5, 7, 8, 17, 1031 };
+
+static void check_f64_kernels(size_t n) {
+    double a[1031], b[1031], c[1031], out[1031];
+    for (size_t i = 0; i < n; i++) {
+        a[i] = (double)i * 0.5 - 3.0;
+        b[i] = (double)(n - i) * 0.25 + 1.0;
+        c[i] = (double)(i % 7) - 2.5;
+    }
+
+    braggi_kernel_add_f64(out, a, b, n);
+    for (size_t i = 0; i < n; i++) CHECK(out[i] == a[i] + b[i]);
+    braggi_kernel_sub_f64(out, a, b, n);
+    for (size_t i = 0; i < n; i++) CHECK(out[i] == a[i] - b[i]);
+    braggi_kernel_mul_f64(out, a, b, n);
+    for (size_t i = 0; i < n; i++) CHECK(out[i] == a[i] * b[i]);
+    braggi_kernel_div_f64(out, a, b, n);
+    for (size_t i = 0; i < n; i++) CHECK(out[i] == a[i] / b[i]);
+    braggi_kernel_fma_f64(out, a, b, c, n);
+    for (size_t i = 0; i < n; i++) CHECK(close_to(out[i], a[i] * b[i] + c[i]));
+    braggi_kernel_mul_scalar_f64(out, a, 3.0, n);
+    for (size_t i = 0; i < n; i++) CHECK(out[i] == a[i] * 3.0);
+    braggi_kernel_rsub_scalar_f64(out, a, 0.5, n);
+    for (size_t i = 0; i < n; i++) CHECK(out[i] == 0.5 - a[i]);
+    braggi_kernel_rdiv_scalar_f64(out, b, 2.0, n);
+    for (size_t i = 0; i < n; i++) CHECK(out[i] == 2.0 / b[i]);
+
+    double dot = 0.0, sum = 0.0, lo = n ? a[0] : 0.0, hi = n ? a[0] : 0.0;
+    for (size_t i = 0; i < n; i++) {
+        dot += a[i] * b[i];
+        sum += a[i];
+        if (a[i] < lo) lo = a[i];
+        if (a[i] > hi) hi = a[i];
+    }
+    CHECK(close_to(braggi_kernel_dot_f64(a, b, n), dot));
+    CHECK(close_to(braggi_kernel_sum_f64(a, n), sum));
+    CHECK(braggi_kernel_min_f64(a, n) == lo);
+    CHECK(braggi_kernel_max_f64(a, n) == hi);
+}
+
+static void check_i64_kernels(size_t n) {
+    int64_t a[1031], b[1031], out[1031];
+    for (size_t i = 0; i < n; i++) {
+        a[i] = (int64_t)(i * 37 % 101) - 50;
+        b[i] = (int64_t)(i * 13 % 29) - 7;
+    }
+    // Wrapping, not undefined, on overflow
+    if (n > 2) a[2] = INT64_MAX;
+
+    braggi_kernel_add_i64(out, a, b, n);
+    for (size_t i = 0; i < n; i++) CHECK(out[i] == (int64_t)((uint64_t)a[i] + (uint64_t)b[i]));
+    braggi_kernel_mul_scalar_i64(out, a, -3, n);
+    for (size_t i = 0; i < n; i++) CHECK(out[i] == (int64_t)((uint64_t)a[i] * (uint64_t)-3));
+    braggi_kernel_rsub_scalar_i64(out, a, INT64_MIN, n);
+    for (size_t i = 0; i < n; i++) CHECK(out[i] == (int64_t)((uint64_t)INT64_MIN - (uint64_t)a[i]));
+
+    uint64_t dot = 0, sum = 0;
+    int64_t lo = n ? a[0] : 0, hi = n ? a[0] : 0;
+    for (size_t i = 0; i < n; i++) {
+        dot += (uint64_t)a[i] * (uint64_t)b[i];
+        sum += (uint64_t)a[i];
+        if (a[i] < lo) lo = a[i];
+        if (a[i] > hi) hi = a[i];
+    }
+    CHECK(braggi_kernel_dot_i64(a, b, n) == (int64_t)dot);
+    CHECK(braggi_kernel_sum_i64(a, n) == (int64_t)sum);
+    CHECK(braggi_kernel_min_i64(a, n) == lo);
+    CHECK(braggi_kernel_max_i64(a, n) == hi);
+
+    double widened[1031];
+    braggi_kernel_i64_to_f64(widened, a, n);
+    for (size_t i = 0; i < n; i++) CHECK(widened[i] == (double)a[i]);
+}
+
+int main(void) {
+    TEST_QUIET_STDERR();
+
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        check_f64_kernels(lengths[i]);
+        check_i64_kernels(lengths[i]);
+    }
+
+    context = braggi_context_create();
+    CHECK(context != NULL);
+    if (!context) TEST_DONE("math_kernels");
+    BraggiRegionHandle region = braggi_rt_region_create(1 << 20, BRAGGI_REGIME_RAND);
+
+    // Untyped arrays of ints are converted and stay integer
+    BraggiVal xs = braggi_val_array(region, 4);
+    BraggiVal ys = braggi_val_typed_array(region, BRAGGI_ELEM_I64, 4);
+    for (int i = 1; i <= 100; i++) {
+        braggi_val_array_push(xs, braggi_val_int(i));
+        braggi_val_array_push(ys, braggi_val_int(2));
+    }
+
+    BraggiVal args[3] = { xs, ys };
+    BraggiVal sum = call("math.add", args, 2, region);
+    CHECK(sum.tag == BRAGGI_VAL_ARRAY && sum.as.array->kind == BRAGGI_ELEM_I64);
+    CHECK(braggi_val_array_length(sum) == 100);
+    CHECK(braggi_val_array_get(sum, 99).as.integer == 102);
+
+    BraggiVal dot = call("math.dot", args, 2, region);
+    CHECK(dot.tag == BRAGGI_VAL_INT && dot.as.integer == 2 * 5050);
+
+    // Broadcasting a float scalar produces doubles
+    args[1] = braggi_val_float(0.5);
+    BraggiVal scaled = call("math.multiply", args, 2, region);
+    CHECK(scaled.tag == BRAGGI_VAL_ARRAY && scaled.as.array->kind == BRAGGI_ELEM_F64);
+    CHECK(braggi_val_array_get(scaled, 9).as.number == 5.0);
+
+    // Division always goes to doubles
+    args[1] = braggi_val_int(4);
+    BraggiVal quarter = call("math.divide", args, 2, region);
+    CHECK(quarter.tag == BRAGGI_VAL_ARRAY && quarter.as.array->f64[1] == 0.5);
+
+    args[0] = xs;
+    args[1] = xs;
+    args[2] = braggi_val_int(1);
+    BraggiVal fma = call("math.fma", args, 3, region);
+    CHECK(fma.tag == BRAGGI_VAL_ARRAY && fma.as.array->f64[9] == 101.0);
+
+    CHECK(call("math.sum", &xs, 1, region).as.integer == 5050);
+    CHECK(call("math.min", &xs, 1, region).as.integer == 1);
+    CHECK(call("math.max", &xs, 1, region).as.integer == 100);
+    BraggiVal list[3] = { braggi_val_int(3), braggi_val_float(-1.5), braggi_val_int(9) };
+    CHECK(call("math.min", list, 3, region).as.number == -1.5);
+
+    // Mismatched and non-numeric operands are errors, not crashes
+    BraggiVal short_array = braggi_val_typed_array(region, BRAGGI_ELEM_I64, 1);
+    braggi_val_array_push(short_array, braggi_val_int(1));
+    args[0] = xs;
+    args[1] = short_array;
+    CHECK(braggi_val_is_error(call("math.add", args, 2, region)));
+    CHECK(braggi_val_is_error(call("math.dot", args, 2, region)));
+    BraggiVal mixed = braggi_val_array(region, 2);
+    braggi_val_array_push(mixed, braggi_val_bool(true));
+    CHECK(braggi_val_is_error(call("math.sum", &mixed, 1, region)));
+    BraggiVal empty = braggi_val_typed_array(region, BRAGGI_ELEM_F64, 1);
+    CHECK(braggi_val_is_error(call("math.max", &empty, 1, region)));
+    args[1] = braggi_val_int(1);
+    CHECK(braggi_val_is_error(call("math.add", args, 2, NULL)));
+
+    braggi_rt_region_destroy(region);
+    braggi_stdlib_cleanup(context);
+    braggi_context_destroy(context);
+    TEST_DONE("math_kernels");
+}
@@ -0,0 +1,107 @@
+/*
+ * Braggi - Module Cache Tests
+ *
+ * "Write the tally in the book once and ya needn't count the herd
+ * again come Sunday." - Pecos Trail Boss
+ */
+
+#include "braggi/module_cache.h"
+#include "braggi/repl_session.h"
+#include "braggi/stdlib.h"
+#include "test_common.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+static bool write_file(const char* path, const char* text) {
+    FILE* f = fopen(path, "w");
+    if (!f) return false;
+    fputs(text, f);
+    return fclose(f) == 0;
+}
+
+int main(void) {
+    TEST_QUIET_STDERR();
+    FILE* out = fopen("/dev/null", "w");
+    if (!out) out = stdout;
+
+    char dir[] = "/tmp/braggi_module_cacheXXXXXX";
+    CHECK(mkdtemp(dir) != NULL);
+
+    // Sized from the template so the paths can't be cut short
+    char lib[sizeof(dir) + sizeof("/lib")];
+    char cache[sizeof(dir) + sizeof("/cache")];
+    char source[sizeof(lib) + sizeof("/ranch.bg")];
+    snprintf(lib, sizeof(lib), "%s/lib", dir);
+    snprintf(cache, sizeof(cache), "%s/cache", dir);
+    snprintf(source, sizeof(source), "%s/ranch.bg", lib);
+    CHECK(mkdir(lib, 0755) == 0);
+    CHECK(write_file(source,
+                     "const herd = 40;\n"
+                     "fn double(n) { return n * 2; }\n"
+                     "var hands = 3;\n"
+                     "region Pasture(1024) regime FIFO { }\n"));
+
+    setenv("BRAGGI_LIB_PATH", lib, 1);
+    setenv(BRAGGI_MODULE_CACHE_ENV, cache, 1);
+    braggi_stdlib_reset_path_cache();
+
+    // First load compiles the artifact
+    const BraggiModule* module = braggi_module_load("ranch");
+    CHECK(module != NULL);
+    if (!module) TEST_DONE("module_cache");
+    CHECK(!braggi_module_from_cache(module));
+    CHECK(strcmp(braggi_module_name(module), "ranch") == 0);
+    CHECK(braggi_module_export_count(module) == 4);
+    CHECK(braggi_module_token_count(module) > 0);
+
+    BraggiModuleExport export;
+    CHECK(braggi_module_find_export(module, "double", &export));
+    CHECK(export.kind == BRAGGI_EXPORT_FUNCTION && export.line == 2);
+    CHECK(braggi_module_find_export(module, "herd", &export));
+    CHECK(export.kind == BRAGGI_EXPORT_CONSTANT);
+    CHECK(braggi_module_find_export(module, "Pasture", &export));
+    CHECK(export.kind == BRAGGI_EXPORT_REGION);
+
+    BraggiModuleToken token;
+    CHECK(braggi_module_token_at(module, 0, &token));
+    CHECK(token.line == 1 && strcmp(token.text, "const") == 0);
+
+    // Importing into a session defines the code exports from cached tokens
+    ReplSession* session = braggi_repl_session_create();
+    CHECK(braggi_repl_session_import(session, module, out) == 3);
+    CHECK(braggi_repl_session_eval(session, "var x = double(herd) + hands;", out));
+    ReplValue value;
+    CHECK(braggi_repl_session_get_value(session, "x", &value));
+    CHECK(value.kind == REPL_VALUE_INT && value.int_value == 83);
+
+    // An unchanged source is served from the artifact
+    braggi_module_unload_all();
+    module = braggi_module_load("ranch");
+    CHECK(module != NULL && braggi_module_from_cache(module));
+    CHECK(module && braggi_module_export_count(module) == 4);
+
+    // A changed source is recompiled
+    braggi_module_unload_all();
+    CHECK(write_file(source, "fn triple(n) { return n * 3; }\n"));
+    module = braggi_module_load("ranch");
+    CHECK(module != NULL && !braggi_module_from_cache(module));
+    CHECK(module && braggi_module_export_count(module) == 1);
+    CHECK(module && !braggi_module_find_export(module, "double", NULL));
+
+    braggi_repl_session_reset(session);
+    CHECK(module && braggi_repl_session_import(session, module, out) == 1);
+    CHECK(braggi_repl_session_eval(session, "var y = triple(5);", out));
+    CHECK(braggi_repl_session_get_value(session, "y", &value));
+    CHECK(value.kind == REPL_VALUE_INT && value.int_value == 15);
+
+    braggi_repl_session_destroy(session);
+    braggi_module_unload_all();
+
+    char command[sizeof(dir) + sizeof("rm -rf ''")];
+    snprintf(command, sizeof(command), "rm -rf '%s'", dir);
+    CHECK(system(command) == 0);
+    if (out != stdout) fclose(out);
+    TEST_DONE("module_cache");
+}
@@ -0,0 +1,70 @@
+/*
+ * Braggi - Periscope Transfer Tests
+ *
+ * "Pass the whole bucket over the wall, lad, or keep it on yer side."
+ * - Tipperary Stonemason
+ */
+
+#include "braggi/runtime.h"
+#include "test_common.h"
+#include <string.h>
+
+int main(void) {
+    TEST_QUIET_STDERR();
+
+    BraggiRegionHandle left = braggi_rt_region_create(4096, BRAGGI_REGIME_SEQ);
+    BraggiRegionHandle right = braggi_rt_region_create(4096, BRAGGI_REGIME_SEQ);
+    CHECK(left && right);
+    CHECK(braggi_rt_region_create_periscope(left, right, BRAGGI_PERISCOPE_BIDIRECTIONAL) == BRAGGI_RT_SUCCESS);
+    BraggiPeriscopeHandle periscope = braggi_rt_region_find_periscope(left, right);
+    CHECK(periscope != NULL);
+    if (!periscope) TEST_DONE("periscope");
+
+    char* a = braggi_rt_region_alloc(left, 64, 7, "cattle");
+    char* b = braggi_rt_region_alloc(left, 64, 0, "horses");
+    CHECK(a && b);
+    memset(a, 'a', 64);
+    memset(b, 'b', 64);
+
+    // Copies may take any range inside one allocation
+    char* copy = braggi_rt_periscope_copy(periscope, a + 8, 32);
+    CHECK(copy != NULL && braggi_rt_region_contains(right, copy));
+    CHECK(copy && copy[0] == 'a' && copy[31] == 'a');
+
+    // ...but not one that runs into the next allocation or the free pool
+    CHECK(braggi_rt_periscope_copy(periscope, a + 32, 64) == NULL);
+    CHECK(braggi_rt_last_error() == BRAGGI_RT_ERROR_INVALID_ALLOCATION);
+    CHECK(braggi_rt_periscope_copy(periscope, b + 128, 16) == NULL);
+    CHECK(braggi_rt_last_error() == BRAGGI_RT_ERROR_INVALID_ALLOCATION);
+
+    // Borrows are held to the same rule
+    BraggiBorrow borrow;
+    CHECK(braggi_rt_periscope_borrow(periscope, b, 64, &borrow));
+    CHECK(borrow.data == b && borrow.size == 64);
+    braggi_rt_periscope_release(&borrow);
+    CHECK(!braggi_rt_periscope_borrow(periscope, b + 60, 8, &borrow));
+    CHECK(braggi_rt_last_error() == BRAGGI_RT_ERROR_INVALID_ALLOCATION);
+    CHECK(!braggi_rt_periscope_borrow(periscope, (char*)b + 512, 8, &borrow));
+
+    // Moves take the whole allocation or nothing
+    size_t before = braggi_rt_region_get_allocation_count(left);
+    CHECK(braggi_rt_periscope_move(periscope, a, 32) == NULL);
+    CHECK(braggi_rt_last_error() == BRAGGI_RT_ERROR_INVALID_SIZE);
+    CHECK(braggi_rt_periscope_move(periscope, a + 8, 56) == NULL);
+    CHECK(braggi_rt_last_error() == BRAGGI_RT_ERROR_INVALID_ALLOCATION);
+    CHECK(braggi_rt_region_get_allocation_count(left) == before);
+
+    char* moved = braggi_rt_periscope_move(periscope, b, 64);
+    CHECK(moved != NULL && braggi_rt_region_contains(right, moved));
+    CHECK(moved && moved[0] == 'b' && moved[63] == 'b');
+    CHECK(braggi_rt_region_get_allocation_count(left) == before - 1);
+
+    // And they go back the other way across a bidirectional periscope
+    char* back = braggi_rt_periscope_move(periscope, moved, 64);
+    CHECK(back != NULL && braggi_rt_region_contains(left, back));
+
+    braggi_rt_region_destroy_periscope(periscope);
+    braggi_rt_region_destroy(left);
+    braggi_rt_region_destroy(right);
+    TEST_DONE("periscope");
+}
@@ -0,0 +1,74 @@
+/*
+ * Braggi - Periscope Contract Tests
+ *
+ * "A handshake's good whether the fella's name is on the gate yet or
+ * not." - Hill Country Cattle Buyer
+ */
+
+#include "braggi/periscope.h"
+#include "braggi/ecs.h"
+#include "test_common.h"
+
+int main(void) {
+    TEST_QUIET_STDERR();
+
+    ECSWorld* world = braggi_ecs_create_world();
+    Periscope* periscope = world ? braggi_periscope_create(world) : NULL;
+    CHECK(periscope != NULL);
+    if (!periscope) TEST_DONE("periscope_contracts");
+
+    CHECK(braggi_periscope_contract_count(periscope) == 0);
+    CHECK(braggi_periscope_validate_contracts(periscope, 0) == 0);
+
+    // Contracts start in force and copy out as they went in
+    PeriscopeContractId first = braggi_periscope_create_contract(periscope, 3, 4, 0x5);
+    CHECK(first == 0);
+    RegionLifetimeContract contract;
+    CHECK(braggi_periscope_get_contract(periscope, first, &contract));
+    CHECK(contract.region_entity == 3 && contract.validator_entity == 4);
+    CHECK(contract.guarantee_flags == 0x5 && contract.is_valid);
+    CHECK(!braggi_periscope_get_contract(periscope, 1, &contract));
+
+    // Unset entities don't break a contract that is in force
+    PeriscopeContractId unwired = braggi_periscope_create_contract(periscope, INVALID_ENTITY,
+                                                                   INVALID_ENTITY, 0x1);
+    CHECK(unwired == 1);
+    CHECK(braggi_periscope_validate_contracts(periscope, 0) == 0);
+    CHECK(braggi_periscope_valid_contract_count(periscope) == 2);
+    CHECK(!braggi_periscope_contract_violated(periscope, unwired));
+
+    // Required flags and being out of force do
+    CHECK(braggi_periscope_validate_contracts(periscope, 0x4) == 1);
+    CHECK(braggi_periscope_contract_violated(periscope, unwired));
+    CHECK(!braggi_periscope_contract_violated(periscope, first));
+    CHECK(braggi_periscope_set_contract_valid(periscope, first, false));
+    CHECK(braggi_periscope_validate_contracts(periscope, 0) == 1);
+    CHECK(braggi_periscope_contract_violated(periscope, first));
+    CHECK(braggi_periscope_valid_contract_count(periscope) == 1);
+    CHECK(!braggi_periscope_set_contract_valid(periscope, 99, true));
+
+    // Registered contracts keep their own validity
+    RegionLifetimeContract lapsed = { 7, 8, 0x1, false };
+    CHECK(braggi_periscope_register_contract(periscope, &lapsed));
+    CHECK(braggi_periscope_contract_count(periscope) == 3);
+    CHECK(braggi_periscope_validate_contracts(periscope, 0) == 2);
+    CHECK(braggi_periscope_get_contract(periscope, 2, &contract) && !contract.is_valid);
+
+    // Enough contracts to span several bitmap words
+    bool created = true;
+    for (uint32_t i = 0; i < 200; i++) {
+        PeriscopeContractId id = braggi_periscope_create_contract(periscope, i, i + 1, i % 2 ? 0x3 : 0x1);
+        created = created && id == i + 3;
+    }
+    CHECK(created);
+    for (uint32_t i = 0; i < 200; i += 10) braggi_periscope_set_contract_valid(periscope, i + 3, false);
+    CHECK(braggi_periscope_validate_contracts(periscope, 0) == 2 + 20);
+    CHECK(braggi_periscope_validate_contracts(periscope, 0x2) == 3 + 100);
+    CHECK(braggi_periscope_contract_violated(periscope, 3 + 10));
+    CHECK(!braggi_periscope_contract_violated(periscope, 3 + 11));
+    CHECK(braggi_periscope_contract_violated(periscope, 3 + 12));
+
+    braggi_periscope_destroy(periscope);
+    braggi_ecs_destroy_world(world);
+    TEST_DONE("periscope_contracts");
+}
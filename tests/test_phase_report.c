@@ -0,0 +1,104 @@
+/*
+ * Braggi - Phase Report Tests
+ *
+ * "Write the day's miles in the book before supper, or ya'll
+ * swear ya rode twice as far." - Chisholm Trail Cook
+ */
+
+#include "braggi/phase_report.h"
+#include "braggi/region.h"
+#include "braggi/util/vector.h"
+#include "test_common.h"
+#include <string.h>
+#include <stdlib.h>
+
+// Run the JSON writer into a heap string
+static char* report_json(const PhaseReport* report, bool time, bool mem) {
+    char* text = NULL;
+    size_t size = 0;
+    FILE* stream = open_memstream(&text, &size);
+    if (!stream) return NULL;
+    braggi_phase_report_write_json(report, stream, time, mem);
+    fclose(stream);
+    return text;
+}
+
+int main(void) {
+    TEST_QUIET_STDERR();
+
+    PhaseReport report;
+    braggi_phase_report_init(&report);
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        CHECK(!report.phases[i].ran);
+    }
+
+    // Setup has its own phase ahead of tokenizing
+    CHECK(PHASE_SETUP < PHASE_TOKENIZE);
+    CHECK(strcmp(braggi_phase_name(PHASE_SETUP), "setup") == 0);
+    CHECK(strcmp(braggi_phase_name(PHASE_ECS_SYNC), "ecs sync") == 0);
+    CHECK(strcmp(braggi_phase_name(PHASE_COUNT), "unknown") == 0);
+
+    braggi_phase_report_begin(&report, PHASE_SETUP);
+    void* block = malloc(1 << 16);
+    memset(block, 1, 1 << 16);
+    for (int i = 0; i < 10; i++) {
+        braggi_vector_destroy(braggi_vector_create(sizeof(int)));
+    }
+    Region* region = braggi_named_region_create("phase", REGIME_RAND, 0);
+    for (int i = 0; i < 4; i++) {
+        braggi_named_region_alloc(region, 1000, (SourcePosition){0}, "block");
+    }
+    // Beginning another phase closes the open one
+    braggi_phase_report_begin(&report, PHASE_TOKENIZE);
+    free(block);
+    braggi_named_region_destroy(region);
+    braggi_phase_report_end(&report);
+    CHECK(report.current == PHASE_COUNT);
+
+    CHECK(report.phases[PHASE_SETUP].ran);
+    CHECK(report.phases[PHASE_TOKENIZE].ran);
+    CHECK(!report.phases[PHASE_ECS_SYNC].ran);
+#if defined(__GLIBC__)
+    CHECK(report.phases[PHASE_SETUP].heap_delta > 0);
+    CHECK(report.phases[PHASE_SETUP].heap_in_use > 0);
+#endif
+
+    // Allocations are counted per phase, and regions are measured at
+    // their high-water mark as well as at the end
+    const PhaseStats* setup = &report.phases[PHASE_SETUP];
+    const PhaseStats* tokenize = &report.phases[PHASE_TOKENIZE];
+    CHECK(setup->alloc_count >= 14);
+    CHECK(setup->alloc_bytes >= 4000);
+    CHECK(setup->arena_peak >= 4000 && setup->arena_in_use >= 4000);
+    CHECK(tokenize->alloc_count == 0);
+    CHECK(tokenize->arena_peak >= 4000);
+    CHECK(tokenize->arena_in_use + 4000 <= setup->arena_in_use);
+
+    // A phase entered twice adds up
+    uint64_t first = report.phases[PHASE_TOKENIZE].wall_ns;
+    braggi_phase_report_begin(&report, PHASE_TOKENIZE);
+    braggi_phase_report_end(&report);
+    CHECK(report.phases[PHASE_TOKENIZE].wall_ns >= first);
+
+    char* json = report_json(&report, true, true);
+    CHECK(json != NULL);
+    if (json) {
+        CHECK(strstr(json, "\"name\": \"setup\"") != NULL);
+        CHECK(strstr(json, "\"name\": \"tokenize\"") != NULL);
+        CHECK(strstr(json, "\"name\": \"ecs sync\"") == NULL);
+        CHECK(strstr(json, "\"wall_ns\"") != NULL);
+        CHECK(strstr(json, "\"heap_in_use\"") != NULL);
+        CHECK(strstr(json, "\"alloc_count\"") != NULL);
+        CHECK(strstr(json, "\"arena_peak\"") != NULL);
+        free(json);
+    }
+
+    json = report_json(&report, true, false);
+    CHECK(json != NULL);
+    if (json) {
+        CHECK(strstr(json, "\"heap_in_use\"") == NULL);
+        free(json);
+    }
+
+    TEST_DONE("phase_report");
+}
@@ -0,0 +1,127 @@
+/*
+ * Braggi - Runtime Region Counter Tests
+ *
+ * "A tally stick that only counts the lambs comin' in is no tally at all."
+ * - Wicklow Shepherd
+ */
+
+#include "braggi/runtime.h"
+#include "test_common.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+
+// Find a region in a snapshot
+static bool in_snapshot(BraggiRegionHandle region, BraggiRegionStats* out) {
+    BraggiRegionStats all[64];
+    size_t count = braggi_rt_region_snapshot(all, 64);
+    for (size_t i = 0; i < count && i < 64; i++) {
+        if (all[i].region == region) {
+            if (out) *out = all[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+typedef struct Watcher {
+    BraggiRegionHandle region;
+    atomic_bool done;
+    bool sane;
+} Watcher;
+
+// Read another thread's region while it allocates and frees
+static void* watch(void* arg) {
+    Watcher* watcher = arg;
+    while (!atomic_load(&watcher->done)) {
+        BraggiRegionStats stats;
+        if (in_snapshot(watcher->region, &stats) && stats.bytes_in_use > 16) watcher->sane = false;
+    }
+    return NULL;
+}
+
+int main(void) {
+    TEST_QUIET_STDERR();
+
+    size_t before = braggi_rt_region_snapshot(NULL, 0);
+    BraggiRegionHandle region = braggi_rt_region_create(1024, BRAGGI_REGIME_SEQ);
+    BraggiRegionHandle other = braggi_rt_region_create(1024, BRAGGI_REGIME_SEQ);
+    CHECK(region && other);
+    CHECK(braggi_rt_region_snapshot(NULL, 0) == before + 2);
+
+    BraggiRegionStats stats;
+    CHECK(braggi_rt_region_get_stats(region, &stats));
+    CHECK(stats.region == region && stats.regime == BRAGGI_REGIME_SEQ && !stats.shared);
+    CHECK(stats.size == 1024 && stats.allocs == 0 && stats.bytes_in_use == 0);
+    CHECK(!braggi_rt_region_get_stats(NULL, &stats));
+    CHECK(!braggi_rt_region_get_stats(region, NULL));
+
+    // Allocations, frees and the high-water mark
+    void* a = braggi_rt_region_alloc(region, 100, 0, "a");
+    void* b = braggi_rt_region_alloc(region, 200, 0, "b");
+    CHECK(a && b);
+    braggi_rt_region_free(region, b);
+    CHECK(braggi_rt_region_get_stats(region, &stats));
+    CHECK(stats.allocs == 2 && stats.frees == 1);
+    CHECK(stats.bytes_allocated == 300 && stats.bytes_freed == 200);
+    CHECK(stats.bytes_in_use == 100 && stats.high_water == 300);
+
+    // Failures are counted by error code
+    CHECK(braggi_rt_region_alloc(region, 4096, 0, "too big") == NULL);
+    CHECK(braggi_rt_region_alloc(region, 0, 0, "empty") == NULL);
+    CHECK(braggi_rt_region_alloc(region, 5000, 0, "too big") == NULL);
+    CHECK(braggi_rt_region_get_stats(region, &stats));
+    CHECK(stats.failures[BRAGGI_RT_ERROR_REGION_FULL] == 2);
+    CHECK(stats.failures[BRAGGI_RT_ERROR_INVALID_SIZE] == 1);
+    CHECK(stats.allocs == 2);
+
+    // Transfers count on both ends
+    CHECK(braggi_rt_region_create_periscope(region, other, BRAGGI_PERISCOPE_OUT) == BRAGGI_RT_SUCCESS);
+    BraggiPeriscopeHandle periscope = braggi_rt_region_find_periscope(region, other);
+    CHECK(braggi_rt_periscope_copy(periscope, a, 50) != NULL);
+    BraggiRegionStats sent;
+    BraggiRegionStats received;
+    CHECK(braggi_rt_region_get_stats(region, &sent));
+    CHECK(braggi_rt_region_get_stats(other, &received));
+    CHECK(sent.transfers_out == 1 && sent.transfers_in == 0);
+    CHECK(received.transfers_in == 1 && received.allocs == 1);
+    braggi_rt_region_destroy_periscope(periscope);
+
+    // Snapshots see the same counters
+    CHECK(in_snapshot(region, &stats));
+    CHECK(stats.bytes_allocated == 300 && stats.transfers_out == 1);
+
+    // Shared regions count through their cursor
+    BraggiRegionHandle shared = braggi_rt_region_create_shared(4096, BRAGGI_REGIME_SEQ);
+    CHECK(braggi_rt_region_alloc(shared, 10, 0, "x") != NULL);
+    CHECK(braggi_rt_region_alloc(shared, 20, 0, "y") != NULL);
+    CHECK(braggi_rt_region_get_stats(shared, &stats));
+    CHECK(stats.shared && stats.allocs == 2);
+    CHECK(stats.bytes_in_use == 2 * BRAGGI_RT_SHARED_ALIGN + BRAGGI_RT_SHARED_ALIGN);
+    CHECK(stats.high_water == stats.bytes_in_use);
+
+    // Another thread can read the counters while the owner works
+    Watcher watcher = { braggi_rt_region_create(1024, BRAGGI_REGIME_RAND), false, true };
+    CHECK(watcher.region != NULL);
+    pthread_t thread;
+    pthread_create(&thread, NULL, watch, &watcher);
+    for (int i = 0; i < 20000; i++) {
+        braggi_rt_region_free(watcher.region, braggi_rt_region_alloc(watcher.region, 16, 0, NULL));
+    }
+    atomic_store(&watcher.done, true);
+    pthread_join(thread, NULL);
+    CHECK(watcher.sane);
+    CHECK(braggi_rt_region_get_stats(watcher.region, &stats));
+    CHECK(stats.bytes_in_use == 0 && stats.high_water == 16);
+    braggi_rt_region_destroy(watcher.region);
+
+    // Destroyed regions leave the snapshot
+    braggi_rt_region_destroy(shared);
+    braggi_rt_region_destroy(other);
+    CHECK(!in_snapshot(other, NULL));
+    CHECK(in_snapshot(region, NULL));
+    braggi_rt_region_destroy(region);
+    CHECK(braggi_rt_region_snapshot(NULL, 0) == before);
+
+    TEST_DONE("region_stats");
+}
@@ -0,0 +1,77 @@
+/*
+ * Braggi - REPL Session Tests
+ *
+ * "Ask the barman twice and he'll pour ya the same pint twice."
+ * - Kilkenny Regular
+ */
+
+#include "braggi/repl_session.h"
+#include "test_common.h"
+#include <stdlib.h>
+#include <string.h>
+
+static FILE* sink(void) {
+    FILE* out = fopen("/dev/null", "w");
+    return out ? out : stdout;
+}
+
+int main(void) {
+    TEST_QUIET_STDERR();
+    FILE* out = sink();
+
+    ReplSession* session = braggi_repl_session_create();
+    CHECK(session != NULL);
+    if (!session) TEST_DONE("repl_session");
+
+    // Definitions persist across lines
+    CHECK(braggi_repl_session_eval(session, "var x = 40;", out));
+    CHECK(braggi_repl_session_eval(session, "fn add(a, b) { return a + b; }", out));
+    CHECK(braggi_repl_session_eval(session, "var y = add(x, 2);", out));
+
+    ReplValue value;
+    CHECK(braggi_repl_session_get_value(session, "y", &value));
+    CHECK(value.kind == REPL_VALUE_INT && value.int_value == 42);
+
+    // Only new input is tokenized and appended
+    size_t before = braggi_repl_session_token_count(session);
+    CHECK(before > 0);
+    CHECK(braggi_repl_session_eval(session, "var z = y * 2;", out));
+    CHECK(braggi_repl_session_token_count(session) > before);
+    CHECK(braggi_repl_session_get_value(session, "z", &value));
+    CHECK(value.kind == REPL_VALUE_INT && value.int_value == 84);
+
+    // A block waits for its closing brace
+    CHECK(braggi_repl_session_eval(session, "fn twice(n) {", out));
+    CHECK(braggi_repl_session_needs_more(session));
+    CHECK(braggi_repl_session_eval(session, "return n * 2; }", out));
+    CHECK(!braggi_repl_session_needs_more(session));
+    CHECK(braggi_repl_session_eval(session, "var w = twice(21);", out));
+    CHECK(braggi_repl_session_get_value(session, "w", &value));
+    CHECK(value.kind == REPL_VALUE_INT && value.int_value == 42);
+
+    // Errors are reported without losing earlier state
+    CHECK(!braggi_repl_session_eval(session, "var bad = missing(1);", out));
+    CHECK(braggi_repl_session_get_value(session, "x", &value));
+
+    // Floats print the way io.print writes them
+    char* printed = NULL;
+    size_t printed_size = 0;
+    FILE* echo = open_memstream(&printed, &printed_size);
+    CHECK(braggi_repl_session_eval(session, "0.1 + 0.2;", echo));
+    CHECK(braggi_repl_session_eval(session, "2.5 * 4.0;", echo));
+    fclose(echo);
+    CHECK(printed && strstr(printed, "0.30000000000000004") != NULL);
+    CHECK(printed && strstr(printed, "10") != NULL && strstr(printed, "e+") == NULL);
+    free(printed);
+
+    braggi_repl_session_reset(session);
+    CHECK(braggi_repl_session_token_count(session) == 0);
+    CHECK(!braggi_repl_session_get_value(session, "x", NULL));
+    CHECK(braggi_repl_session_eval(session, "var x = 1;", out));
+    CHECK(braggi_repl_session_get_value(session, "x", &value));
+    CHECK(value.kind == REPL_VALUE_INT && value.int_value == 1);
+
+    braggi_repl_session_destroy(session);
+    if (out != stdout) fclose(out);
+    TEST_DONE("repl_session");
+}
@@ -0,0 +1,128 @@
+/*
+ * Braggi - Runtime I/O Tests
+ *
+ * "If the bucket comes up dry, ya don't pour out what's in the trough."
+ * - Sligo Farmhand
+ */
+
+#include "braggi/rt_io.h"
+#include "test_common.h"
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// Everything written to a temporary file so far
+static size_t slurp(FILE* file, char* dest, size_t size) {
+    fflush(file);
+    rewind(file);
+    size_t length = fread(dest, 1, size - 1, file);
+    dest[length] = '\0';
+    return length;
+}
+
+int main(void) {
+    TEST_QUIET_STDERR();
+
+    char text[BRAGGI_IO_NUMBER_MAX];
+    CHECK(braggi_io_format_i64(0, text) == 1 && strcmp(text, "0") == 0);
+    CHECK(braggi_io_format_i64(-1234567, text) == 8 && strcmp(text, "-1234567") == 0);
+    braggi_io_format_i64(INT64_MIN, text);
+    CHECK(strcmp(text, "-9223372036854775808") == 0);
+    braggi_io_format_f64(0.1, text);
+    CHECK(strtod(text, NULL) == 0.1);
+    braggi_io_format_f64(1e300, text);
+    CHECK(strtod(text, NULL) == 1e300);
+
+    BraggiOutput* out = braggi_io_stdout();
+    CHECK(out != NULL);
+
+    // Writes stay buffered until flushed
+    FILE* sink = tmpfile();
+    char seen[BRAGGI_IO_BUFFER_SIZE * 4];
+    braggi_io_redirect(out, sink);
+    CHECK(braggi_io_write_cstr(out, "howdy "));
+    CHECK(braggi_io_write_i64(out, 42));
+    CHECK(braggi_io_write_val(out, braggi_val_bool(true)));
+    CHECK(slurp(sink, seen, sizeof(seen)) == 0);
+    CHECK(braggi_io_flush(out));
+    CHECK(slurp(sink, seen, sizeof(seen)) > 0 && strcmp(seen, "howdy 42true") == 0);
+
+    // Writing to the stream directly comes after what was buffered,
+    // once the stdio side syncs
+    rewind(sink);
+    CHECK(ftruncate(fileno(sink), 0) == 0);
+    CHECK(braggi_io_write_cstr(out, "first "));
+    braggi_io_sync(sink);
+    fputs("second ", sink);
+    CHECK(braggi_io_write_cstr(out, "third "));
+    braggi_val_print(braggi_val_int(4), sink);
+    CHECK(slurp(sink, seen, sizeof(seen)) > 0 && strcmp(seen, "first second third 4") == 0);
+
+    // A failed write keeps the buffered bytes for the next attempt
+    FILE* read_only = fopen("/dev/null", "r");
+    CHECK(read_only != NULL);
+    braggi_io_redirect(out, read_only);
+    CHECK(braggi_io_write_cstr(out, "keep me"));
+    CHECK(!braggi_io_flush(out));
+    CHECK(!braggi_io_flush(out));
+
+    // Nothing buffered is overwritten when topping off fails
+    char big[BRAGGI_IO_BUFFER_SIZE / 2 - 1];
+    memset(big, 'x', sizeof(big));
+    CHECK(braggi_io_write(out, big, sizeof(big)));
+    CHECK(!braggi_io_write(out, big, sizeof(big)));
+
+    rewind(sink);
+    CHECK(ftruncate(fileno(sink), 0) == 0);
+    braggi_io_redirect(out, sink);
+    CHECK(braggi_io_flush(out));
+    size_t length = slurp(sink, seen, sizeof(seen));
+    CHECK(length == 7 + sizeof(big));
+    CHECK(memcmp(seen, "keep me", 7) == 0);
+
+    // Writes too big for the buffer go straight out after it
+    char huge[BRAGGI_IO_BUFFER_SIZE * 2];
+    memset(huge, 'y', sizeof(huge));
+    rewind(sink);
+    CHECK(ftruncate(fileno(sink), 0) == 0);
+    CHECK(braggi_io_write_char(out, '<'));
+    CHECK(braggi_io_write(out, huge, sizeof(huge)));
+    CHECK(braggi_io_flush(out));
+    length = slurp(sink, seen, sizeof(seen));
+    CHECK(length == sizeof(huge) + 1 && seen[0] == '<' && seen[length - 1] == 'y');
+
+    braggi_io_redirect(out, stdout);
+    fclose(read_only);
+
+    // Reading back lines and whole files
+    FILE* lines = tmpfile();
+    fputs("first\n\nthird line\nno newline", lines);
+    fflush(lines);
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/self/fd/%d", fileno(lines));
+
+    BraggiReader* reader = braggi_io_reader_open(path);
+    CHECK(reader != NULL);
+    if (reader) {
+        const char* line = braggi_io_reader_line(reader, &length);
+        CHECK(line && length == 5 && memcmp(line, "first", 5) == 0);
+        line = braggi_io_reader_line(reader, &length);
+        CHECK(line && length == 0);
+        line = braggi_io_reader_line(reader, &length);
+        CHECK(line && length == 10);
+        line = braggi_io_reader_line(reader, &length);
+        CHECK(line && length == 10 && memcmp(line, "no newline", 10) == 0);
+        CHECK(braggi_io_reader_line(reader, &length) == NULL);
+        braggi_io_reader_close(reader);
+    }
+
+    BraggiMappedFile mapped;
+    CHECK(braggi_io_map_file(path, &mapped));
+    CHECK(mapped.size == 28 && memcmp(mapped.data, "first\n", 6) == 0);
+    braggi_io_unmap_file(&mapped);
+    CHECK(!braggi_io_map_file("/nonexistent/braggi", &mapped));
+
+    fclose(lines);
+    fclose(sink);
+    TEST_DONE("rt_io");
+}
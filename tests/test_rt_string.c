@@ -0,0 +1,142 @@
+/*
+ * Braggi - Runtime String Tests
+ *
+ * "Tie two ropes together and ya still got to check the knot."
+ * - Bandera Roper
+ */
+
+#include "braggi/rt_string.h"
+#include "braggi/stdlib.h"
+#include "braggi/braggi_context.h"
+#include "test_common.h"
+#include <string.h>
+
+static const char* LONG_TEXT = "the quick brown steer jumped the lazy dog's fence";
+
+int main(void) {
+    TEST_QUIET_STDERR();
+
+    BraggiRegionHandle region = braggi_rt_region_create(1 << 20, BRAGGI_REGIME_RAND);
+    CHECK(region != NULL);
+
+    // Short strings are inline and need no region
+    BraggiStr small;
+    CHECK(braggi_str_from(NULL, "howdy", 5, &small));
+    CHECK(braggi_str_kind(&small) == BRAGGI_STR_SMALL);
+    CHECK(braggi_str_length(&small) == 5);
+    CHECK(strcmp(braggi_str_data(NULL, &small), "howdy") == 0);
+
+    BraggiStr full;
+    CHECK(braggi_str_from(NULL, "fifteen bytes!!", BRAGGI_STR_SMALL_MAX, &full));
+    CHECK(braggi_str_kind(&full) == BRAGGI_STR_SMALL);
+    CHECK(braggi_str_data(NULL, &full)[BRAGGI_STR_SMALL_MAX] == '\0');
+
+    BraggiStr empty = braggi_str_empty();
+    CHECK(braggi_str_length(&empty) == 0);
+
+    // Longer ones are copied into the region, and need one
+    BraggiStr flat;
+    CHECK(!braggi_str_from(NULL, LONG_TEXT, strlen(LONG_TEXT), &flat));
+    CHECK(braggi_str_from(region, LONG_TEXT, strlen(LONG_TEXT), &flat));
+    CHECK(braggi_str_kind(&flat) == BRAGGI_STR_FLAT);
+    CHECK(braggi_rt_region_contains(region, (void*)flat.large.bytes));
+    CHECK(braggi_str_byte_at(&flat, 4) == 'q');
+    CHECK(braggi_str_byte_at(&flat, 1000) == -1);
+
+    // Slices of long strings share the parent's bytes
+    BraggiStr slice;
+    CHECK(braggi_str_slice(region, &flat, 4, 40, &slice));
+    CHECK(braggi_str_kind(&slice) == BRAGGI_STR_SLICE);
+    CHECK(slice.large.bytes == flat.large.bytes + 4);
+    CHECK(braggi_str_length(&slice) == 36);
+    CHECK(!braggi_str_slice(region, &flat, 10, 5, &slice));
+    BraggiStr tail;
+    CHECK(braggi_str_slice(region, &flat, 40, 1000, &tail));
+    CHECK(braggi_str_length(&tail) == strlen(LONG_TEXT) - 40);
+
+    // Short joins copy, long joins rope
+    BraggiStr joined;
+    CHECK(braggi_str_concat(region, &small, &small, &joined));
+    CHECK(braggi_str_kind(&joined) == BRAGGI_STR_SMALL);
+    CHECK(strcmp(braggi_str_data(NULL, &joined), "howdyhowdy") == 0);
+
+    CHECK(braggi_str_concat(region, &flat, &flat, &joined));
+    CHECK(braggi_str_kind(&joined) == BRAGGI_STR_ROPE);
+    CHECK(braggi_str_length(&joined) == 2 * strlen(LONG_TEXT));
+
+    // Reading a rope doesn't flatten it; asking for its data does, once
+    char buffer[8];
+    CHECK(braggi_str_copy(&joined, strlen(LONG_TEXT), buffer, 3) == 3);
+    CHECK(memcmp(buffer, "the", 3) == 0);
+    CHECK(joined.large.rope->flat == NULL);
+    const char* data = braggi_str_data(region, &joined);
+    CHECK(data != NULL && strncmp(data + strlen(LONG_TEXT), LONG_TEXT, strlen(LONG_TEXT)) == 0);
+    CHECK(braggi_str_data(region, &joined) == data);
+
+    // Equality ignores representation
+    BraggiStr copy;
+    CHECK(braggi_str_from(region, data, braggi_str_length(&joined), &copy));
+    CHECK(braggi_str_equals(&joined, &copy));
+    CHECK(!braggi_str_equals(&joined, &flat));
+
+    // Repeated appends stay bounded in depth
+    BraggiStr grown = braggi_str_empty();
+    size_t expected = 0;
+    for (int i = 0; i < 200; i++) {
+        CHECK(braggi_str_concat(region, &grown, &flat, &grown));
+        expected += strlen(LONG_TEXT);
+    }
+    CHECK(braggi_str_length(&grown) == expected);
+    CHECK(braggi_str_kind(&grown) == BRAGGI_STR_ROPE);
+    CHECK(grown.large.rope->depth <= BRAGGI_STR_ROPE_MAX_DEPTH);
+    CHECK(braggi_str_byte_at(&grown, expected - 1) == 'e');
+
+    // Formatting picks inline or region storage by length
+    BraggiStr formatted;
+    CHECK(braggi_str_format(region, &formatted, "%d head", 42));
+    CHECK(braggi_str_kind(&formatted) == BRAGGI_STR_SMALL);
+    CHECK(strcmp(braggi_str_data(NULL, &formatted), "42 head") == 0);
+    CHECK(braggi_str_format(region, &formatted, "%s and %s", LONG_TEXT, "more"));
+    CHECK(braggi_str_length(&formatted) == strlen(LONG_TEXT) + 9);
+
+    // Values share flat and slice bytes
+    BraggiVal value = braggi_str_to_val(region, &flat);
+    CHECK(value.tag == BRAGGI_VAL_STRING && value.as.string == flat.large.bytes);
+    BraggiStr back = braggi_str_from_val(value);
+    CHECK(braggi_str_equals(&back, &flat));
+    value = braggi_str_to_val(region, &small);
+    CHECK(value.tag == BRAGGI_VAL_STRING && value.length == 5);
+
+    // The string builtins on top
+    BraggiContext* context = braggi_context_create();
+    CHECK(context != NULL);
+    if (context) {
+        void* builtin_context = NULL;
+        BraggiNativeFunc concat = braggi_stdlib_lookup_native(context, "string.concat", &builtin_context);
+        BraggiNativeFunc slicer = braggi_stdlib_lookup_native(context, "string.slice", &builtin_context);
+        CHECK(concat && slicer);
+
+        BraggiVal args[3] = {
+            braggi_val_string(region, LONG_TEXT, strlen(LONG_TEXT)),
+            braggi_val_string(region, " - ", 3),
+            braggi_val_string(region, "yeehaw", 6)
+        };
+        BraggiVal result = concat(args, 3, region, builtin_context);
+        CHECK(result.tag == BRAGGI_VAL_STRING && result.length == strlen(LONG_TEXT) + 9);
+        CHECK(memcmp(result.as.string + strlen(LONG_TEXT), " - yeehaw", 9) == 0);
+
+        BraggiVal bounds[3] = { args[0], braggi_val_int(4), braggi_val_int(40) };
+        result = slicer(bounds, 3, region, builtin_context);
+        CHECK(result.tag == BRAGGI_VAL_STRING && result.as.string == args[0].as.string + 4);
+        bounds[1] = braggi_val_int(-1);
+        CHECK(braggi_val_is_error(slicer(bounds, 3, region, builtin_context)));
+        bounds[1] = braggi_val_int(1);
+        CHECK(braggi_val_is_error(concat(bounds, 2, region, builtin_context)));
+
+        braggi_stdlib_cleanup(context);
+        braggi_context_destroy(context);
+    }
+
+    braggi_rt_region_destroy(region);
+    TEST_DONE("rt_string");
+}
@@ -0,0 +1,132 @@
+/*
+ * Braggi - Shared Runtime Region Tests
+ *
+ * "Eight hands at one chuck box, and nobody gets the same biscuit."
+ * - Goodnight Trail Cook
+ */
+
+#include "braggi/runtime.h"
+#include "test_common.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define THREADS 8
+#define CLAIM 48
+#define CLAIMS 1000
+
+typedef struct Worker {
+    BraggiRegionHandle region;
+    size_t size;
+    char stamp;
+    char* got[CLAIMS];
+    size_t count;
+} Worker;
+
+// Allocate until the region says no, stamping each allocation
+static void* grab(void* arg) {
+    Worker* worker = arg;
+    while (worker->count < CLAIMS) {
+        char* p = braggi_rt_region_alloc(worker->region, worker->size, 0, "grab");
+        if (!p) break;
+        memset(p, worker->stamp, worker->size);
+        worker->got[worker->count++] = p;
+    }
+    return NULL;
+}
+
+static int compare_ptr(const void* a, const void* b) {
+    char* x = *(char* const*)a;
+    char* y = *(char* const*)b;
+    return (x > y) - (x < y);
+}
+
+// Every allocation is inside the region and none overlap
+static bool disjoint(Worker* workers, size_t size) {
+    static char* all[THREADS * CLAIMS];
+    size_t n = 0;
+    for (int t = 0; t < THREADS; t++) {
+        for (size_t i = 0; i < workers[t].count; i++) all[n++] = workers[t].got[i];
+    }
+    qsort(all, n, sizeof(char*), compare_ptr);
+    for (size_t i = 0; i < n; i++) {
+        if (!braggi_rt_region_contains(workers[0].region, all[i])) return false;
+        if (i > 0 && all[i - 1] + size > all[i]) return false;
+    }
+    return true;
+}
+
+static size_t run(BraggiRegionHandle region, Worker* workers) {
+    pthread_t threads[THREADS];
+    for (int t = 0; t < THREADS; t++) {
+        memset(&workers[t], 0, sizeof(Worker));
+        workers[t].region = region;
+        workers[t].size = CLAIM;
+        workers[t].stamp = (char)('a' + t);
+        pthread_create(&threads[t], NULL, grab, &workers[t]);
+    }
+    size_t total = 0;
+    for (int t = 0; t < THREADS; t++) {
+        pthread_join(threads[t], NULL);
+        total += workers[t].count;
+    }
+    return total;
+}
+
+static void* fail_alloc(void* arg) {
+    BraggiRuntimeError* seen = arg;
+    braggi_rt_region_alloc(NULL, 16, 0, "none");
+    *seen = braggi_rt_last_error();
+    return NULL;
+}
+
+int main(void) {
+    TEST_QUIET_STDERR();
+    static Worker workers[THREADS];
+
+    // A region split exactly into claims is handed out in full, with no
+    // claim refused while room remains
+    for (int round = 0; round < 20; round++) {
+        BraggiRegionHandle region = braggi_rt_region_create_shared(CLAIM * CLAIMS, BRAGGI_REGIME_SEQ);
+        CHECK(region != NULL && braggi_rt_region_is_shared(region));
+        CHECK(run(region, workers) == CLAIMS);
+        CHECK(disjoint(workers, CLAIM));
+        braggi_rt_region_destroy(region);
+    }
+
+    // A claim that doesn't fit leaves room for one that does
+    BraggiRegionHandle region = braggi_rt_region_create_shared(4096, BRAGGI_REGIME_FIFO);
+    CHECK(braggi_rt_region_alloc(region, 4000, 0, "big") != NULL);
+    CHECK(braggi_rt_region_alloc(region, 128, 0, "too big") == NULL);
+    CHECK(braggi_rt_region_alloc(region, 96, 0, "rest") != NULL);
+    CHECK(braggi_rt_region_alloc(region, 16, 0, "full") == NULL);
+    CHECK(braggi_rt_region_alloc(region, SIZE_MAX - 8, 0, "huge") == NULL);
+    braggi_rt_region_destroy(region);
+
+    // RAND regions hand each thread its own chunk
+    region = braggi_rt_region_create_shared(CLAIM * CLAIMS * 4, BRAGGI_REGIME_RAND);
+    size_t total = run(region, workers);
+    CHECK(total > 0);
+    CHECK(disjoint(workers, CLAIM));
+    bool stamped = true;
+    for (int t = 0; t < THREADS; t++) {
+        for (size_t i = 0; i < workers[t].count; i++) {
+            for (size_t b = 0; b < CLAIM; b++) stamped = stamped && workers[t].got[i][b] == workers[t].stamp;
+        }
+    }
+    CHECK(stamped);
+    braggi_rt_region_destroy(region);
+
+    // Errors belong to the thread that caused them
+    region = braggi_rt_region_create(1024, BRAGGI_REGIME_SEQ);
+    CHECK(braggi_rt_last_error() == BRAGGI_RT_SUCCESS);
+    BraggiRuntimeError seen = BRAGGI_RT_SUCCESS;
+    pthread_t thread;
+    pthread_create(&thread, NULL, fail_alloc, &seen);
+    pthread_join(thread, NULL);
+    CHECK(seen == BRAGGI_RT_ERROR_INVALID_HANDLE);
+    CHECK(braggi_rt_last_error() == BRAGGI_RT_SUCCESS);
+    braggi_rt_region_destroy(region);
+
+    TEST_DONE("runtime_shared");
+}
@@ -0,0 +1,113 @@
+/*
+ * Braggi - Source Location Tests
+ *
+ * "Every furrow has its number, and ya never plough the same number
+ * into two fields." - Mayo Ploughman
+ */
+
+#include "braggi/source.h"
+#include "braggi/source_position.h"
+#include "braggi/token.h"
+#include "test_common.h"
+#include <string.h>
+
+// Register a file of one line per newline in text
+static BraggiSourceLoc add_text(uint32_t file_id, const char* name, const char* text) {
+    uint32_t map[64];
+    size_t lines = 1;
+    map[0] = 0;
+    for (uint32_t i = 0; text[i] && lines < 64; i++) {
+        if (text[i] == '\n' && text[i + 1]) map[lines++] = i + 1;
+    }
+    return braggi_source_loc_add_file(file_id, name, map, lines, (uint32_t)strlen(text));
+}
+
+int main(void) {
+    TEST_QUIET_STDERR();
+    braggi_source_loc_reset();
+
+    // Files are found by ID in any order they were registered
+    BraggiSourceLoc b = add_text(900, "b.bg", "fn b() {}\n");
+    BraggiSourceLoc a = add_text(5, "a.bg", "var x = 1;\nvar y = 2;\n");
+    BraggiSourceLoc c = add_text(42, "c.bg", "x\n");
+    CHECK(b != BRAGGI_SOURCE_LOC_INVALID && a > b && c > a);
+    CHECK(add_text(5, "again.bg", "ignored") == a);
+    CHECK(braggi_source_loc_get(900, 3) == b + 3);
+    CHECK(braggi_source_loc_get(5, 11) == a + 11);
+    CHECK(braggi_source_loc_get(42, 0) == c);
+    CHECK(braggi_source_loc_get(7, 0) == BRAGGI_SOURCE_LOC_INVALID);
+
+    SourcePosition position;
+    CHECK(braggi_source_loc_decode(a + 15, &position));
+    CHECK(position.file_id == 5 && position.line == 2 && position.column == 5);
+    CHECK(strcmp(braggi_source_loc_filename(c), "c.bg") == 0);
+
+    // Removing a file makes its locations unknown and leaves the rest
+    braggi_source_loc_remove_file(5);
+    CHECK(braggi_source_loc_get(5, 0) == BRAGGI_SOURCE_LOC_INVALID);
+    CHECK(!braggi_source_loc_decode(a + 15, &position));
+    CHECK(braggi_source_loc_get(900, 3) == b + 3);
+    CHECK(braggi_source_loc_get(42, 1) == c + 1);
+    CHECK(braggi_source_loc_decode(c + 1, &position) && position.file_id == 42);
+    braggi_source_loc_remove_file(12345);
+
+    // Only the newest file's range is reused
+    braggi_source_loc_remove_file(42);
+    CHECK(add_text(43, "d.bg", "y\n") == c);
+    BraggiSourceLoc e = add_text(6, "e.bg", "z\n");
+    CHECK(e > c);
+
+    // Many files stay searchable by ID and by location
+    bool found = true;
+    for (uint32_t id = 1000; id < 1200; id++) {
+        char name[32];
+        snprintf(name, sizeof(name), "f%u.bg", id);
+        BraggiSourceLoc base = add_text(2200 - id, name, "var v = 0;\n");
+        found = found && base != BRAGGI_SOURCE_LOC_INVALID && braggi_source_loc_get(2200 - id, 4) == base + 4;
+        found = found && braggi_source_loc_decode(base + 4, &position) && position.file_id == 2200 - id;
+    }
+    CHECK(found);
+    CHECK(braggi_source_loc_get(6, 0) == e);
+
+    // Reset starts the address space over
+    braggi_source_loc_reset();
+    CHECK(braggi_source_loc_get(900, 0) == BRAGGI_SOURCE_LOC_INVALID);
+    CHECK(braggi_source_loc_filename(b) == NULL);
+    CHECK(add_text(77, "new.bg", "x\n") == b);
+
+    // Tokens of a source that has no locations stay unknown
+    Source* source = braggi_source_string_create("var herd = 40;", "herd.bg");
+    CHECK(source != NULL);
+    if (source) {
+        source->loc_base = BRAGGI_SOURCE_LOC_INVALID;
+        Tokenizer* tokenizer = braggi_tokenizer_create(source);
+        bool unknown = true;
+        int count = 0;
+        while (tokenizer && braggi_tokenizer_next(tokenizer) && count++ < 20) {
+            Token* token = braggi_tokenizer_current(tokenizer);
+            unknown = unknown && token->loc == BRAGGI_SOURCE_LOC_INVALID;
+            if (token->type == TOKEN_EOF) break;
+        }
+        CHECK(count > 1 && unknown);
+        braggi_tokenizer_destroy(tokenizer);
+        braggi_source_file_destroy(source);
+    }
+
+    // ...while a registered source's tokens decode to their place
+    source = braggi_source_string_create("var herd = 40;", "herd.bg");
+    Tokenizer* tokenizer = source ? braggi_tokenizer_create(source) : NULL;
+    CHECK(tokenizer && braggi_tokenizer_next(tokenizer) && braggi_tokenizer_next(tokenizer));
+    if (tokenizer) {
+        Token* token = braggi_tokenizer_current(tokenizer);
+        while (token->type == TOKEN_WHITESPACE && braggi_tokenizer_next(tokenizer)) {
+            token = braggi_tokenizer_current(tokenizer);
+        }
+        position = braggi_token_get_position(token);
+        CHECK(strcmp(token->text, "herd") == 0 && position.line == 1 && position.column == 5);
+        braggi_tokenizer_destroy(tokenizer);
+    }
+    braggi_source_file_destroy(source);
+
+    braggi_source_loc_reset();
+    TEST_DONE("source_loc");
+}
@@ -0,0 +1,100 @@
+/*
+ * Braggi - Superposition Builtin Tests
+ *
+ * "The calf's in one pen or the other, but ya won't know which till
+ * ya open the gate." - Palo Duro Cowhand
+ */
+
+#include "braggi/rt_superposition.h"
+#include "braggi/value.h"
+#include "braggi/stdlib.h"
+#include "braggi/braggi_context.h"
+#include "test_common.h"
+#include <math.h>
+#include <string.h>
+
+static BraggiContext* context;
+
+static BraggiVal call(const char* name, const BraggiVal* args, size_t count, BraggiRegionHandle region) {
+    void* builtin_context = NULL;
+    BraggiNativeFunc func = braggi_stdlib_lookup_native(context, name, &builtin_context);
+    CHECK(func != NULL);
+    if (!func) return braggi_val_error("missing builtin");
+    return func(args, count, region, builtin_context);
+}
+
+static BraggiVal int_array(BraggiRegionHandle region, const int64_t* items, size_t count) {
+    BraggiVal array = braggi_val_array(region, count);
+    for (size_t i = 0; i < count; i++) braggi_val_array_push(array, braggi_val_int(items[i]));
+    return array;
+}
+
+int main(void) {
+    TEST_QUIET_STDERR();
+    braggi_super_seed(42);
+
+    context = braggi_context_create();
+    CHECK(context != NULL);
+    if (!context) TEST_DONE("superposition");
+    BraggiRegionHandle region = braggi_rt_region_create(1 << 20, BRAGGI_REGIME_RAND);
+
+    // Weighted alternatives and their mean
+    int64_t sides[] = { 1, 2, 3 };
+    int64_t odds[] = { 1, 1, 2 };
+    BraggiVal args[2] = { int_array(region, sides, 3), int_array(region, odds, 3) };
+    BraggiVal die = call("superpose", args, 2, region);
+    CHECK(die.tag == BRAGGI_VAL_SUPERPOSITION);
+    CHECK(braggi_super_count(die) == 3);
+    BraggiVal mean = call("superposition.expect", &die, 1, region);
+    CHECK(mean.tag == BRAGGI_VAL_FLOAT && fabs(mean.as.number - 2.25) < 1e-12);
+
+    // Math builtins carry every operation across the alternatives
+    const char* ops[] = { "math.add", "math.subtract", "math.multiply", "math.divide" };
+    const double expected[] = { 4.25, 0.25, 4.5, 1.125 };
+    for (size_t i = 0; i < 4; i++) {
+        BraggiVal operands[2] = { die, braggi_val_int(2) };
+        BraggiVal result = call(ops[i], operands, 2, region);
+        CHECK(result.tag == BRAGGI_VAL_SUPERPOSITION);
+        BraggiVal shifted = call("superposition.expect", &result, 1, region);
+        CHECK(fabs(shifted.as.number - expected[i]) < 1e-12);
+    }
+
+    // ...with the scalar on either side
+    BraggiVal scalars[2] = { braggi_val_int(2), braggi_val_float(0.5) };
+    const double flipped[] = { -0.25, -1.75 };
+    for (size_t i = 0; i < 2; i++) {
+        BraggiVal operands[2] = { scalars[i], die };
+        BraggiVal result = call("math.subtract", operands, 2, region);
+        CHECK(result.tag == BRAGGI_VAL_SUPERPOSITION);
+        BraggiVal shifted = call("superposition.expect", &result, 1, region);
+        CHECK(fabs(shifted.as.number - flipped[i]) < 1e-12);
+    }
+
+    // Collapsing picks one alternative and sticks with it
+    BraggiVal first = call("collapse", &die, 1, region);
+    CHECK(first.tag == BRAGGI_VAL_INT && first.as.integer >= 1 && first.as.integer <= 3);
+    BraggiVal again = call("collapse", &die, 1, region);
+    CHECK(again.tag == BRAGGI_VAL_INT && again.as.integer == first.as.integer);
+
+    // Bad arguments are errors, not crashes
+    BraggiVal not_array[2] = { args[0], braggi_val_int(3) };
+    BraggiVal result = call("superpose", not_array, 2, region);
+    CHECK(braggi_val_is_error(result));
+    CHECK(result.as.string && strcmp(result.as.string, "weights must be an array") == 0);
+
+    BraggiVal short_weights[2] = { args[0], int_array(region, odds, 2) };
+    CHECK(braggi_val_is_error(call("superpose", short_weights, 2, region)));
+
+    BraggiVal empty = braggi_val_array(region, 1);
+    result = call("superpose", &empty, 1, region);
+    CHECK(braggi_val_is_error(result));
+    CHECK(result.as.string && strcmp(result.as.string, "superposition needs 1 to 4096 alternatives") == 0);
+
+    CHECK(braggi_val_is_error(call("superposition.expect", NULL, 0, region)));
+    CHECK(braggi_val_is_error(call("collapse", NULL, 0, region)));
+
+    braggi_rt_region_destroy(region);
+    braggi_stdlib_cleanup(context);
+    braggi_context_destroy(context);
+    TEST_DONE("superposition");
+}
@@ -0,0 +1,84 @@
+/*
+ * Braggi - Symbol Table Tests
+ *
+ * "When the young bull leaves the pasture, the old one's still standin'
+ * right where ya left him." - Brazos Valley Rancher
+ */
+
+#include "braggi/symbol_table.h"
+#include "test_common.h"
+#include <stdio.h>
+#include <string.h>
+
+int main(void) {
+    TEST_QUIET_STDERR();
+
+    SymbolTable* table = braggi_symbol_table_create();
+    CHECK(table != NULL);
+    if (!table) TEST_DONE("symbol_table");
+
+    // The global scope can't be left
+    CHECK(braggi_symbol_table_exit_scope(table) == 0);
+
+    Symbol* outer = braggi_symbol_table_add_symbol(table, "herd", SYMBOL_VARIABLE);
+    CHECK(outer != NULL);
+    CHECK(strcmp(braggi_symbol_get_name(outer), "herd") == 0);
+    CHECK(braggi_symbol_get_type(outer) == SYMBOL_VARIABLE);
+    CHECK(braggi_symbol_table_lookup(table, "herd") == outer);
+    CHECK(braggi_symbol_table_lookup(table, "missing") == NULL);
+
+    // Redeclaring in the same scope fails
+    CHECK(braggi_symbol_table_add_symbol(table, "herd", SYMBOL_CONSTANT) == NULL);
+    CHECK(braggi_symbol_table_lookup(table, "herd") == outer);
+
+    // Inner scopes shadow and restore on exit
+    uint32_t fn_scope = braggi_symbol_table_enter_scope(table, "fn");
+    CHECK(fn_scope != 0);
+    Symbol* inner = braggi_symbol_table_add_symbol(table, "herd", SYMBOL_FUNCTION);
+    Symbol* local = braggi_symbol_table_add_symbol(table, "calf", SYMBOL_VARIABLE);
+    CHECK(inner && inner != outer && local);
+    CHECK(braggi_symbol_table_lookup(table, "herd") == inner);
+
+    uint32_t block = braggi_symbol_table_enter_scope(table, NULL);
+    CHECK(block != 0 && block != fn_scope);
+    Symbol* deepest = braggi_symbol_table_add_symbol(table, "herd", SYMBOL_TYPE);
+    CHECK(braggi_symbol_table_lookup(table, "herd") == deepest);
+    CHECK(braggi_symbol_table_lookup(table, "calf") == local);
+    CHECK(braggi_symbol_table_exit_scope(table) == fn_scope);
+    CHECK(braggi_symbol_table_lookup(table, "herd") == inner);
+
+    braggi_symbol_table_exit_scope(table);
+    CHECK(braggi_symbol_table_lookup(table, "herd") == outer);
+    CHECK(braggi_symbol_table_lookup(table, "calf") == NULL);
+
+    // Symbols outlive their scope
+    CHECK(strcmp(braggi_symbol_get_name(local), "calf") == 0);
+    CHECK(braggi_symbol_get_type(deepest) == SYMBOL_TYPE);
+
+    // Data rides along with a symbol
+    int payload = 7;
+    CHECK(braggi_symbol_set_data(outer, &payload));
+    CHECK(braggi_symbol_get_data(outer) == &payload);
+
+    // Enough names and scopes to grow every table
+    char name[32];
+    for (int depth = 0; depth < 40; depth++) {
+        CHECK(braggi_symbol_table_enter_scope(table, NULL) != 0);
+        for (int i = 0; i < 100; i++) {
+            snprintf(name, sizeof(name), "n%d", i);
+            if (!braggi_symbol_table_add_symbol(table, name, SYMBOL_VARIABLE)) CHECK(false);
+        }
+    }
+    bool found = true;
+    for (int i = 0; i < 100; i++) {
+        snprintf(name, sizeof(name), "n%d", i);
+        found = found && braggi_symbol_table_lookup(table, name) != NULL;
+    }
+    CHECK(found);
+    for (int depth = 0; depth < 40; depth++) braggi_symbol_table_exit_scope(table);
+    CHECK(braggi_symbol_table_lookup(table, "n0") == NULL);
+    CHECK(braggi_symbol_table_lookup(table, "herd") == outer);
+
+    braggi_symbol_table_destroy(table);
+    TEST_DONE("symbol_table");
+}
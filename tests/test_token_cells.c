@@ -0,0 +1,86 @@
+/*
+ * Braggi - Token Cell Map Tests
+ *
+ * "Count the herd once at the gate and write it down; ya don't go
+ * countin' 'em again at every fence post." - Llano County Drover
+ */
+
+#include "braggi/token_propagator.h"
+#include "braggi/source_position.h"
+#include "test_common.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define TOKENS 6
+
+int main(void) {
+    TEST_QUIET_STDERR();
+
+    // var x = 1 ; x, laid out on one line
+    static const struct { TokenType type; const char* text; uint32_t offset; } words[TOKENS] = {
+        { TOKEN_KEYWORD, "var", 0 }, { TOKEN_IDENTIFIER, "x", 4 }, { TOKEN_OPERATOR, "=", 6 },
+        { TOKEN_LITERAL_INT, "1", 8 }, { TOKEN_PUNCTUATION, ";", 9 }, { TOKEN_IDENTIFIER, "x", 11 },
+    };
+    uint32_t lines[] = { 0 };
+    CHECK(braggi_source_loc_add_file(31, "cells.bg", lines, 1, 12) != BRAGGI_SOURCE_LOC_INVALID);
+    Token* tokens[TOKENS];
+    TokenPropagator* propagator = braggi_token_propagator_create();
+    CHECK(propagator != NULL);
+    if (!propagator) TEST_DONE("token_cells");
+    for (int i = 0; i < TOKENS; i++) {
+        SourcePosition position = {0};
+        position.file_id = 31;
+        position.line = 1;
+        position.column = words[i].offset + 1;
+        position.offset = words[i].offset;
+        position.length = 1;
+        tokens[i] = braggi_token_create(words[i].type, strdup(words[i].text), position);
+        CHECK(braggi_token_propagator_add_token(propagator, tokens[i]));
+    }
+    CHECK(!braggi_token_propagator_add_token(propagator, NULL));
+
+    // Building the field records each token's cell by index
+    CHECK(braggi_token_propagator_initialize_field(propagator));
+    EntropyField* field = braggi_token_propagator_get_field(propagator);
+    CHECK(field != NULL);
+    if (!field) TEST_DONE("token_cells");
+    CHECK(field->token_count == TOKENS);
+
+    bool mapped = true;
+    for (size_t i = 0; i < TOKENS; i++) {
+        uint32_t cell_id = braggi_entropy_field_token_cell(field, i);
+        EntropyCell* cell = braggi_entropy_field_get_cell(field, cell_id);
+        mapped = mapped && cell_id != ENTROPY_NO_CELL && cell && cell->id == cell_id;
+        mapped = mapped && cell && cell->position_offset == words[i].offset;
+    }
+    CHECK(mapped);
+    CHECK(braggi_entropy_field_token_cell(field, 1) != braggi_entropy_field_token_cell(field, 5));
+    CHECK(braggi_entropy_field_token_cell(field, TOKENS) == ENTROPY_NO_CELL);
+    CHECK(braggi_entropy_field_get_cell(field, (uint32_t)field->cell_count) == NULL);
+
+    // A field built without a map has no cells for any token
+    EntropyField* bare = braggi_entropy_field_create(0, NULL);
+    CHECK(bare && braggi_entropy_field_token_cell(bare, 0) == ENTROPY_NO_CELL);
+    EntropyCell* first = braggi_entropy_field_add_cell(bare, 0);
+    EntropyCell* second = braggi_entropy_field_add_cell(bare, 3);
+    CHECK(first && second && first->id != second->id);
+    CHECK(braggi_entropy_field_get_cell(bare, second->id) == second);
+
+    // Handing over a map replaces the old one; unset entries stay empty
+    uint32_t* map = malloc(3 * sizeof(uint32_t));
+    map[0] = second->id;
+    map[1] = ENTROPY_NO_CELL;
+    map[2] = first->id;
+    braggi_entropy_field_set_token_cells(bare, map, 3);
+    CHECK(braggi_entropy_field_token_cell(bare, 0) == second->id);
+    CHECK(braggi_entropy_field_token_cell(bare, 1) == ENTROPY_NO_CELL);
+    CHECK(braggi_entropy_field_token_cell(bare, 2) == first->id);
+    braggi_entropy_field_set_token_cells(bare, NULL, 3);
+    CHECK(bare->token_count == 0 && braggi_entropy_field_token_cell(bare, 0) == ENTROPY_NO_CELL);
+    braggi_entropy_field_destroy(bare);
+
+    braggi_token_propagator_destroy(propagator);
+    for (int i = 0; i < TOKENS; i++) braggi_token_destroy(tokens[i]);
+    braggi_source_loc_remove_file(31);
+    TEST_DONE("token_cells");
+}
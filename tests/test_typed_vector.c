@@ -0,0 +1,82 @@
+/*
+ * Braggi - Typed Vector Tests
+ *
+ * "Sixteen pegs on the barn wall, and a nail box for when the pegs
+ * run out." - Kerry Saddler
+ */
+
+#include "braggi/util/typed_vector.h"
+#include "test_common.h"
+#include <stdint.h>
+
+typedef struct Brand {
+    uint32_t ranch;
+    double weight;
+} Brand;
+
+BRAGGI_VEC_DECLARE(U32Vec, u32_vec, uint32_t)
+BRAGGI_VEC_DECLARE(BrandVec, brand_vec, Brand)
+BRAGGI_SMALL_VEC_DECLARE(U32List, u32_list, uint32_t, 4)
+
+int main(void) {
+    TEST_QUIET_STDERR();
+
+    // A zeroed heap vector is an empty one
+    U32Vec vec = {0};
+    CHECK(u32_vec_size(&vec) == 0 && u32_vec_data(&vec) == NULL);
+    CHECK(!u32_vec_pop(&vec, NULL));
+    for (uint32_t i = 0; i < 1000; i++) {
+        if (!u32_vec_push(&vec, i * 3)) CHECK(false);
+    }
+    CHECK(u32_vec_size(&vec) == 1000 && vec.capacity >= 1000);
+    bool ordered = true;
+    for (size_t i = 0; i < 1000; i++) ordered = ordered && u32_vec_at(&vec, i) == i * 3;
+    CHECK(ordered);
+
+    *u32_vec_ptr(&vec, 10) = 7;
+    CHECK(u32_vec_at(&vec, 10) == 7);
+    uint32_t last = 0;
+    CHECK(u32_vec_pop(&vec, &last) && last == 999 * 3);
+    CHECK(u32_vec_size(&vec) == 999);
+
+    // Clearing keeps the storage; reserving never shrinks
+    size_t capacity = vec.capacity;
+    u32_vec_clear(&vec);
+    CHECK(u32_vec_size(&vec) == 0 && vec.capacity == capacity);
+    CHECK(u32_vec_reserve(&vec, 10) && vec.capacity == capacity);
+    CHECK(u32_vec_reserve(&vec, capacity * 4 + 1) && vec.capacity >= capacity * 4 + 1);
+    u32_vec_free(&vec);
+    CHECK(vec.data == NULL && vec.capacity == 0);
+
+    // Struct elements are stored by value
+    BrandVec brands;
+    brand_vec_init(&brands);
+    CHECK(brand_vec_push(&brands, (Brand){ 1, 2.5 }));
+    CHECK(brand_vec_push(&brands, (Brand){ 2, 4.0 }));
+    CHECK(brand_vec_at(&brands, 1).ranch == 2 && brand_vec_at(&brands, 0).weight == 2.5);
+    brand_vec_free(&brands);
+
+    // Small vectors stay inline until they outgrow their slots
+    U32List list;
+    u32_list_init(&list);
+    CHECK(u32_list_is_inline(&list) && list.capacity == 4);
+    for (uint32_t i = 0; i < 4; i++) CHECK(u32_list_push(&list, i + 1));
+    CHECK(u32_list_is_inline(&list));
+    CHECK(u32_list_push(&list, 5));
+    CHECK(!u32_list_is_inline(&list) && list.capacity >= 5);
+    bool copied = true;
+    for (size_t i = 0; i < 5; i++) copied = copied && u32_list_at(&list, i) == i + 1;
+    CHECK(copied);
+    for (uint32_t i = 0; i < 100; i++) u32_list_push(&list, i);
+    CHECK(u32_list_size(&list) == 105 && u32_list_at(&list, 104) == 99);
+
+    // Freeing returns to the inline slots, ready for reuse
+    u32_list_free(&list);
+    CHECK(u32_list_is_inline(&list) && u32_list_size(&list) == 0);
+    CHECK(u32_list_push(&list, 42) && u32_list_at(&list, 0) == 42);
+    CHECK(u32_list_pop(&list, &last) && last == 42);
+    CHECK(!u32_list_pop(&list, &last));
+    u32_list_free(&list);
+
+    TEST_DONE("typed_vector");
+}
@@ -0,0 +1,106 @@
+/*
+ * Braggi - Immediate Value Tests
+ *
+ * "A coin in yer pocket spends quicker than a note in the bank."
+ * - Galway Horse Fair Trader
+ */
+
+#include "braggi/value.h"
+#include "braggi/stdlib.h"
+#include "braggi/braggi_context.h"
+#include "test_common.h"
+#include <string.h>
+#include <math.h>
+
+static BraggiContext* context;
+
+static BraggiVal call(const char* name, const BraggiVal* args, size_t count, BraggiRegionHandle region) {
+    void* builtin_context = NULL;
+    BraggiNativeFunc func = braggi_stdlib_lookup_native(context, name, &builtin_context);
+    CHECK(func != NULL);
+    if (!func) return braggi_val_error("missing builtin");
+    return func(args, count, region, builtin_context);
+}
+
+int main(void) {
+    TEST_QUIET_STDERR();
+
+    context = braggi_context_create();
+    CHECK(context != NULL);
+    if (!context) TEST_DONE("value");
+
+    BraggiRegionHandle region = braggi_rt_region_create(1 << 16, BRAGGI_REGIME_RAND);
+    CHECK(region != NULL);
+
+    // Immediates live inline
+    CHECK(sizeof(BraggiVal) == 16);
+    CHECK(braggi_val_int(7).as.integer == 7);
+    CHECK(braggi_val_is_number(braggi_val_float(1.5)));
+    CHECK(!braggi_val_is_number(braggi_val_bool(true)));
+    CHECK(braggi_val_as_double(braggi_val_int(3)) == 3.0);
+    CHECK(braggi_val_is_error(braggi_val_error("nope")));
+    CHECK(strcmp(braggi_val_type_name(braggi_val_null()), "null") == 0);
+
+    // Truthiness
+    CHECK(!braggi_val_truthy(braggi_val_null()));
+    CHECK(!braggi_val_truthy(braggi_val_int(0)));
+    CHECK(braggi_val_truthy(braggi_val_int(-1)));
+    CHECK(!braggi_val_truthy(braggi_val_error("x")));
+
+    // Strings are copied into the region and compare by content
+    char text[] = "howdy partner";
+    BraggiVal s = braggi_val_string(region, text, strlen(text));
+    CHECK(s.tag == BRAGGI_VAL_STRING && s.length == strlen(text));
+    CHECK(braggi_rt_region_contains(region, (void*)s.as.string));
+    text[0] = 'H';
+    CHECK(memcmp(s.as.string, "howdy", 5) == 0);
+    CHECK(braggi_val_equals(s, braggi_val_string(region, "howdy partner", 13)));
+    CHECK(!braggi_val_equals(s, braggi_val_string(region, "howdy", 5)));
+    CHECK(braggi_val_equals(braggi_val_int(2), braggi_val_float(2.0)));
+
+    // Arrays grow inside their region
+    BraggiVal array = braggi_val_array(region, 1);
+    CHECK(array.tag == BRAGGI_VAL_ARRAY);
+    for (int i = 0; i < 100; i++) {
+        CHECK(braggi_val_array_push(array, braggi_val_int(i)));
+    }
+    CHECK(braggi_val_array_length(array) == 100);
+    CHECK(braggi_val_array_get(array, 42).as.integer == 42);
+    CHECK(braggi_val_array_get(array, 100).tag == BRAGGI_VAL_NULL);
+    CHECK(braggi_rt_region_contains(region, array.as.array->items));
+    CHECK(braggi_val_array_length(braggi_val_int(1)) == 0);
+
+    // Typed arrays only take what fits
+    BraggiVal ints = braggi_val_typed_array(region, BRAGGI_ELEM_I64, 2);
+    CHECK(braggi_val_array_push(ints, braggi_val_int(5)));
+    CHECK(!braggi_val_array_push(ints, braggi_val_float(0.5)));
+    BraggiVal floats = braggi_val_typed_array(region, BRAGGI_ELEM_F64, 2);
+    CHECK(braggi_val_array_push(floats, braggi_val_int(5)));
+    CHECK(braggi_val_array_get(floats, 0).tag == BRAGGI_VAL_FLOAT);
+
+    // By-value builtins
+    BraggiVal args[2] = { braggi_val_int(40), braggi_val_int(2) };
+    BraggiVal result = call("math.add", args, 2, region);
+    CHECK(result.tag == BRAGGI_VAL_INT && result.as.integer == 42);
+
+    args[1] = braggi_val_float(0.5);
+    result = call("math.multiply", args, 2, NULL);
+    CHECK(result.tag == BRAGGI_VAL_FLOAT && fabs(result.as.number - 20.0) < 1e-12);
+
+    args[1] = braggi_val_int(0);
+    CHECK(braggi_val_is_error(call("math.divide", args, 2, NULL)));
+    CHECK(braggi_val_is_error(call("math.add", args, 1, NULL)));
+
+    args[0] = s;
+    args[1] = braggi_val_int(1);
+    CHECK(braggi_val_is_error(call("math.subtract", args, 2, region)));
+
+    result = call("string.length", &s, 1, NULL);
+    CHECK(result.tag == BRAGGI_VAL_INT && result.as.integer == 13);
+    CHECK(braggi_val_is_error(call("string.length", &args[1], 1, NULL)));
+
+    braggi_rt_region_destroy(region);
+    braggi_stdlib_cleanup(context);
+    braggi_context_destroy(context);
+    TEST_DONE("value");
+}
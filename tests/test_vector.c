@@ -0,0 +1,103 @@
+/*
+ * Braggi - Vector Tests
+ *
+ * "A wagon that's built on the ranch gets mended on the ranch."
+ * - Nueces Strip Wheelwright
+ */
+
+#include "braggi/util/vector.h"
+#include "braggi/region.h"
+#include "test_common.h"
+#include <stdint.h>
+#include <string.h>
+
+// Every element equals the sequence the checks built up
+static bool holds(Vector* vector, const uint32_t* expect, size_t count) {
+    if (braggi_vector_size(vector) != count) return false;
+    for (size_t i = 0; i < count; i++) {
+        if (*(uint32_t*)braggi_vector_get(vector, i) != expect[i]) return false;
+    }
+    return true;
+}
+
+// Push, bulk append and insert, mirroring each change in expect
+static void exercise(Vector* vector) {
+    static uint32_t expect[4096];
+    size_t count = 0;
+
+    bool pushed = true;
+    for (uint32_t i = 0; i < 500; i++) {
+        pushed = pushed && braggi_vector_push_back(vector, &i);
+        expect[count++] = i;
+    }
+    CHECK(pushed);
+    CHECK(braggi_vector_capacity(vector) >= 500);
+    CHECK(holds(vector, expect, count));
+
+    uint32_t block[1000];
+    for (uint32_t i = 0; i < 1000; i++) block[i] = 10000 + i;
+    CHECK(braggi_vector_append_n(vector, block, 1000));
+    for (uint32_t i = 0; i < 1000; i++) expect[count++] = block[i];
+    CHECK(holds(vector, expect, count));
+
+    // Insert in the middle and at the front
+    uint32_t middle[3] = { 7, 8, 9 };
+    CHECK(braggi_vector_insert_range(vector, 250, middle, 3));
+    memmove(&expect[253], &expect[250], (count - 250) * sizeof(uint32_t));
+    memcpy(&expect[250], middle, sizeof(middle));
+    count += 3;
+    uint32_t first = 424242;
+    CHECK(braggi_vector_insert(vector, 0, &first));
+    memmove(&expect[1], &expect[0], count * sizeof(uint32_t));
+    expect[0] = first;
+    count++;
+    CHECK(holds(vector, expect, count));
+
+    // Inserting past the end fails and changes nothing
+    CHECK(!braggi_vector_insert(vector, count + 1, &first));
+    CHECK(holds(vector, expect, count));
+
+    // Appending another vector
+    Vector* other = braggi_vector_create(sizeof(uint32_t));
+    CHECK(braggi_vector_append_n(other, block, 100));
+    CHECK(braggi_vector_extend_from(vector, other));
+    for (uint32_t i = 0; i < 100; i++) expect[count++] = block[i];
+    CHECK(holds(vector, expect, count));
+    braggi_vector_destroy(other);
+
+    CHECK(braggi_vector_remove_at(vector, 0));
+    CHECK(holds(vector, expect + 1, count - 1));
+}
+
+int main(void) {
+    TEST_QUIET_STDERR();
+
+    Vector* heap = braggi_vector_create(sizeof(uint32_t));
+    CHECK(heap != NULL);
+    exercise(heap);
+    braggi_vector_shrink_to_fit(heap);
+    CHECK(braggi_vector_capacity(heap) == braggi_vector_size(heap));
+    braggi_vector_destroy(heap);
+
+    // Region vectors grow by carving new blocks from the region
+    Region* region = braggi_named_region_create("vectors", REGIME_RAND, 0);
+    CHECK(region != NULL);
+    if (!region) TEST_DONE("vector");
+    size_t used = braggi_named_region_used(region);
+
+    Vector* pen = braggi_vector_create_in_region(region, sizeof(uint32_t));
+    CHECK(pen != NULL && pen->region == region);
+    exercise(pen);
+    CHECK(braggi_named_region_used(region) > used);
+
+    // They never shrink, and destroying one leaves it to the region
+    size_t capacity = braggi_vector_capacity(pen);
+    braggi_vector_shrink_to_fit(pen);
+    CHECK(braggi_vector_capacity(pen) == capacity);
+    CHECK(braggi_vector_reserve(pen, capacity * 2));
+    CHECK(braggi_vector_capacity(pen) >= capacity * 2);
+    braggi_vector_destroy(pen);
+
+    braggi_named_region_destroy(region);
+    TEST_DONE("vector");
+}
@@ -0,0 +1,751 @@
+/*
+ * Braggi - Benchmark Suite
+ *
+ * "Ya can't brag about how fast your horse is until ya've timed it
+ * 'round the barrel a few hundred times!" - Irish-Texan Rodeo Wisdom
+ *
+ * Reproducible micro- and macro-benchmarks for the tokenizer, the entropy
+ * solver, the ECS, the allocators, the numeric kernels and the full
+ * compile pipeline. Results are printed as a table and can be written as
+ * JSON for tracking between commits.
+ */
+
+#include "braggi/braggi_context.h"
+#include "braggi/source.h"
+#include "braggi/token.h"
+#include "braggi/entropy.h"
+#include "braggi/ecs.h"
+#include "braggi/allocation.h"
+#include "braggi/region.h"
+#include "braggi/runtime.h"
+#include "braggi/math_kernels.h"
+#include "braggi/util/vector.h"
+#include "program_gen.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Fixed seed so the collapse choices are the same run to run
+#define BENCH_SEED 0x42A66
+
+// Maximum number of results a single run can record
+#define BENCH_MAX_RESULTS 32
+
+// Command line arguments
+static const char* json_path = NULL;
+static const char* only_filter = NULL;
+static size_t iterations = 5;
+static size_t field_cells = 512;
+static size_t field_ambiguity = 4;
+static size_t source_size = 16 * 1024;
+static size_t ecs_entities = 100000;
+static size_t alloc_count = 10000;
+static size_t math_elements = 1024 * 1024;
+static bool verbose = false;
+
+// A single benchmark measurement
+typedef struct BenchResult {
+    const char* name;       // Benchmark name
+    size_t iterations;      // Timed iterations
+    size_t ops;             // Operations per iteration
+    size_t bytes;           // Bytes processed per iteration (0 if n/a)
+    double total_ns;        // Total wall time across all iterations
+    double min_ns;          // Fastest single iteration
+    double* samples;        // Every iteration's time, for the median
+} BenchResult;
+
+static BenchResult results[BENCH_MAX_RESULTS];
+static size_t result_count = 0;
+
+// Saved descriptors while the library's chatter is muted
+static int saved_stdout = -1;
+static int saved_stderr = -1;
+
+// Forward declarations
+void print_usage(const char* program_name);
+int parse_args(int argc, char** argv);
+
+/*
+ * Monotonic clock in nanoseconds
+ */
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/*
+ * Mute stdout/stderr while timing. The compiler is a mite talkative on
+ * stderr and we'd rather not benchmark the terminal.
+ */
+static void quiet_begin(void) {
+    if (verbose || saved_stderr >= 0) return;
+
+    fflush(stdout);
+    fflush(stderr);
+
+    int devnull = open("/dev/null", O_WRONLY);
+    if (devnull < 0) return;
+
+    saved_stdout = dup(STDOUT_FILENO);
+    saved_stderr = dup(STDERR_FILENO);
+    dup2(devnull, STDOUT_FILENO);
+    dup2(devnull, STDERR_FILENO);
+    close(devnull);
+}
+
+static void quiet_end(void) {
+    if (saved_stderr < 0) return;
+
+    fflush(stdout);
+    fflush(stderr);
+    dup2(saved_stdout, STDOUT_FILENO);
+    dup2(saved_stderr, STDERR_FILENO);
+    close(saved_stdout);
+    close(saved_stderr);
+    saved_stdout = -1;
+    saved_stderr = -1;
+}
+
+/*
+ * Start a new result slot
+ */
+static BenchResult* result_begin(const char* name, size_t ops, size_t bytes) {
+    if (result_count >= BENCH_MAX_RESULTS) return NULL;
+
+    BenchResult* result = &results[result_count++];
+    result->name = name;
+    result->iterations = 0;
+    result->ops = ops;
+    result->bytes = bytes;
+    result->total_ns = 0.0;
+    result->min_ns = 0.0;
+    result->samples = (double*)calloc(iterations, sizeof(double));
+    return result;
+}
+
+/*
+ * Record one timed iteration
+ */
+static void result_add(BenchResult* result, double elapsed_ns) {
+    if (!result) return;
+
+    if (result->iterations == 0 || elapsed_ns < result->min_ns) {
+        result->min_ns = elapsed_ns;
+    }
+    if (result->samples && result->iterations < iterations) {
+        result->samples[result->iterations] = elapsed_ns;
+    }
+    result->total_ns += elapsed_ns;
+    result->iterations++;
+}
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/*
+ * Median iteration time. Throughput is reported from this rather than
+ * the fastest run, which flatters anything with a noisy tail.
+ */
+static double result_median(BenchResult* result) {
+    size_t count = result->iterations < iterations ? result->iterations : iterations;
+    if (!result->samples || count == 0) {
+        return result->iterations ? result->total_ns / (double)result->iterations : 0.0;
+    }
+
+    qsort(result->samples, count, sizeof(double), compare_double);
+    if (count % 2) {
+        return result->samples[count / 2];
+    }
+    return (result->samples[count / 2 - 1] + result->samples[count / 2]) / 2.0;
+}
+
+static double result_mb_per_sec(BenchResult* result) {
+    double median_ns = result_median(result);
+    if (median_ns <= 0.0) return 0.0;
+    return ((double)result->bytes / (1024.0 * 1024.0)) / (median_ns / 1e9);
+}
+
+static bool selected(const char* name) {
+    return !only_filter || strstr(name, only_filter) != NULL;
+}
+
+/*
+ * Build a synthetic Braggi program of roughly target_size bytes.
+ * Caller frees the result.
+ */
+static char* make_program(size_t target_size, size_t* out_length) {
+    ProgramGenOptions options;
+    braggi_progen_default_options(&options);
+    options.target_size = target_size;
+    options.seed = BENCH_SEED;
+
+    return braggi_progen_generate(&options, out_length);
+}
+
+/* ---------------------------------------------------------------------
+ * Tokenizer throughput
+ * ------------------------------------------------------------------- */
+
+static void bench_tokenize(void) {
+    size_t length = 0;
+    char* program = make_program(source_size, &length);
+    if (!program) return;
+
+    Source* source = braggi_source_string_create(program, "bench_tokenize.bg");
+    if (!source) {
+        fprintf(stderr, "Failed to create source for tokenizer benchmark\n");
+        free(program);
+        return;
+    }
+
+    BenchResult* result = result_begin("tokenize_all", 1, length);
+    size_t token_count = 0;
+
+    for (size_t it = 0; it < iterations; it++) {
+        quiet_begin();
+        double start = now_ns();
+        Vector* tokens = braggi_tokenize_all(source, true, true);
+        double elapsed = now_ns() - start;
+        quiet_end();
+
+        result_add(result, elapsed);
+
+        if (tokens) {
+            token_count = braggi_vector_size(tokens);
+            for (size_t i = 0; i < token_count; i++) {
+                braggi_token_destroy(*(Token**)braggi_vector_get(tokens, i));
+            }
+            braggi_vector_destroy(tokens);
+        }
+    }
+
+    if (result) result->ops = token_count;
+
+    braggi_source_file_destroy(source);
+    free(program);
+}
+
+/* ---------------------------------------------------------------------
+ * Entropy field propagate + collapse
+ * ------------------------------------------------------------------- */
+
+// Drop states from 'to' that match the collapsed type of 'from'
+static void prune_matching(EntropyCell* from, EntropyCell* to) {
+    if (!from || !to || from->state_count != 1 || to->state_count <= 1) return;
+
+    uint32_t taken = from->states[0]->type;
+    size_t kept = 0;
+
+    for (size_t i = 0; i < to->state_count; i++) {
+        EntropyState* state = to->states[i];
+        bool last_standing = (kept == 0 && i == to->state_count - 1);
+
+        if (state->type == taken && !last_standing) {
+            braggi_state_destroy(state);
+        } else {
+            to->states[kept++] = state;
+        }
+    }
+    to->state_count = kept;
+}
+
+// Neighbours must pick different types - graph colourin' on a line
+static bool bench_differ_validate(EntropyConstraint* constraint, EntropyField* field) {
+    if (constraint->cell_count < 2) return true;
+
+    EntropyCell* a = field->cells[constraint->cell_ids[0]];
+    EntropyCell* b = field->cells[constraint->cell_ids[1]];
+    prune_matching(a, b);
+    prune_matching(b, a);
+
+    return true;
+}
+
+static EntropyField* make_field(size_t cells, size_t ambiguity) {
+    EntropyField* field = braggi_entropy_field_create(0, NULL);
+    if (!field) return NULL;
+
+    for (size_t i = 0; i < cells; i++) {
+        EntropyCell* cell = braggi_entropy_field_add_cell(field, (uint32_t)i);
+        if (!cell) break;
+
+        for (size_t s = 0; s < ambiguity; s++) {
+            EntropyState* state = braggi_entropy_state_create(
+                (uint32_t)s, (uint32_t)s, "bench", NULL, (uint32_t)(100 / ambiguity));
+            if (state) braggi_entropy_cell_add_state(cell, state);
+        }
+
+        if (i > 0) {
+            EntropyConstraint* constraint = braggi_constraint_create(
+                CONSTRAINT_SYNTAX, bench_differ_validate, NULL, "bench neighbours differ");
+            if (constraint) {
+                braggi_constraint_add_cell(constraint, (uint32_t)(i - 1));
+                braggi_constraint_add_cell(constraint, (uint32_t)i);
+                braggi_entropy_field_add_constraint(field, constraint);
+            }
+        }
+    }
+
+    return field;
+}
+
+static void bench_entropy(void) {
+    BenchResult* result = result_begin("entropy_collapse_propagate", field_cells, 0);
+
+    for (size_t it = 0; it < iterations; it++) {
+        quiet_begin();
+        EntropyField* field = make_field(field_cells, field_ambiguity);
+        quiet_end();
+        if (!field) {
+            fprintf(stderr, "Failed to create entropy field\n");
+            return;
+        }
+
+        srand(BENCH_SEED);
+
+        quiet_begin();
+        double start = now_ns();
+        for (size_t i = 0; i < field->cell_count; i++) {
+            if (field->cells[i]->state_count > 1) {
+                braggi_entropy_field_collapse_cell(field, (uint32_t)i, UINT32_MAX);
+            }
+            braggi_entropy_field_propagate_constraints(field, (uint32_t)i);
+        }
+        double elapsed = now_ns() - start;
+
+        braggi_entropy_field_destroy(field);
+        quiet_end();
+
+        result_add(result, elapsed);
+    }
+}
+
+/* ---------------------------------------------------------------------
+ * ECS query iteration
+ * ------------------------------------------------------------------- */
+
+typedef struct BenchPosition {
+    float x, y;
+} BenchPosition;
+
+typedef struct BenchVelocity {
+    float dx, dy;
+} BenchVelocity;
+
+static void bench_ecs(void) {
+    quiet_begin();
+    ECSWorld* world = braggi_ecs_world_create(ecs_entities + 1, 8);
+    quiet_end();
+    if (!world) {
+        fprintf(stderr, "Failed to create ECS world\n");
+        return;
+    }
+
+    quiet_begin();
+    ComponentTypeID position_type = braggi_ecs_register_component(world, sizeof(BenchPosition));
+    ComponentTypeID velocity_type = braggi_ecs_register_component(world, sizeof(BenchVelocity));
+
+    size_t matching = 0;
+    for (size_t i = 0; i < ecs_entities; i++) {
+        EntityID entity = braggi_ecs_create_entity(world);
+        BenchPosition* pos = braggi_ecs_add_component(world, entity, position_type);
+        if (pos) {
+            pos->x = (float)i;
+            pos->y = 0.0f;
+        }
+
+        // Every other entity gets a velocity so the query has to skip some
+        if (i % 2 == 0) {
+            BenchVelocity* vel = braggi_ecs_add_component(world, entity, velocity_type);
+            if (vel) {
+                vel->dx = 1.0f;
+                vel->dy = 0.5f;
+            }
+            matching++;
+        }
+    }
+    quiet_end();
+
+    ComponentMask mask = 0;
+    braggi_ecs_mask_set(&mask, position_type);
+    braggi_ecs_mask_set(&mask, velocity_type);
+
+    BenchResult* result = result_begin("ecs_query_iterate", matching, 0);
+    volatile float sink = 0.0f;
+
+    for (size_t it = 0; it < iterations; it++) {
+        quiet_begin();
+        double start = now_ns();
+        EntityQuery query = braggi_ecs_query_entities(world, mask);
+        EntityID entity;
+        while (braggi_ecs_query_next(&query, &entity)) {
+            BenchPosition* pos = braggi_ecs_get_component(world, entity, position_type);
+            BenchVelocity* vel = braggi_ecs_get_component(world, entity, velocity_type);
+            if (pos && vel) {
+                pos->x += vel->dx;
+                pos->y += vel->dy;
+                sink += pos->x;
+            }
+        }
+        double elapsed = now_ns() - start;
+        quiet_end();
+
+        result_add(result, elapsed);
+    }
+    (void)sink;
+
+    quiet_begin();
+    braggi_ecs_world_destroy(world);
+    quiet_end();
+}
+
+/* ---------------------------------------------------------------------
+ * Compiler-side region allocation
+ * ------------------------------------------------------------------- */
+
+static void bench_region_alloc(void) {
+    BenchResult* result = result_begin("region_alloc", alloc_count, 0);
+    SourcePosition position = braggi_source_position_from_line_col(1, 1);
+
+    for (size_t it = 0; it < iterations; it++) {
+        // A fresh compiler region each time, the way a compile gets one
+        Region* region = braggi_named_region_create("bench", REGIME_RAND, 0);
+        if (!region) {
+            fprintf(stderr, "Failed to create region for region_alloc benchmark\n");
+            break;
+        }
+
+        double start = now_ns();
+        for (size_t i = 0; i < alloc_count; i++) {
+            // Mixed sizes from 16 to 256 bytes, like AST nodes and strings
+            if (!braggi_named_region_alloc(region, 16 + (i * 7 % 241), position, "bench")) {
+                fprintf(stderr, "Region allocation failed during benchmark\n");
+                break;
+            }
+        }
+        double elapsed = now_ns() - start;
+
+        result_add(result, elapsed);
+
+        // Everything goes with the region, outside the timed part
+        braggi_named_region_destroy(region);
+    }
+}
+
+/* ---------------------------------------------------------------------
+ * Runtime region alloc/free per regime
+ * ------------------------------------------------------------------- */
+
+static void bench_rt_regime(const char* name, BraggiRegimeType regime) {
+    const size_t block = 32;
+    void** blocks = (void**)malloc(alloc_count * sizeof(void*));
+    if (!blocks) return;
+
+    BenchResult* result = result_begin(name, alloc_count * 2, 0);
+
+    for (size_t it = 0; it < iterations; it++) {
+        BraggiRegionHandle region = braggi_rt_region_create(alloc_count * block, regime);
+        if (!region) {
+            fprintf(stderr, "Failed to create runtime region for %s\n", name);
+            break;
+        }
+
+        double start = now_ns();
+        for (size_t i = 0; i < alloc_count; i++) {
+            blocks[i] = braggi_rt_region_alloc(region, block, (uint32_t)i, "bench");
+        }
+
+        // Release in the order the regime expects
+        if (regime == BRAGGI_REGIME_FILO) {
+            for (size_t i = alloc_count; i > 0; i--) {
+                braggi_rt_region_free(region, blocks[i - 1]);
+            }
+        } else {
+            for (size_t i = 0; i < alloc_count; i++) {
+                braggi_rt_region_free(region, blocks[i]);
+            }
+        }
+        double elapsed = now_ns() - start;
+
+        result_add(result, elapsed);
+        braggi_rt_region_destroy(region);
+    }
+
+    free(blocks);
+}
+
+static void bench_rt_regions(void) {
+    if (selected("rt_alloc_free_fifo")) bench_rt_regime("rt_alloc_free_fifo", BRAGGI_REGIME_FIFO);
+    if (selected("rt_alloc_free_filo")) bench_rt_regime("rt_alloc_free_filo", BRAGGI_REGIME_FILO);
+    if (selected("rt_alloc_free_seq")) bench_rt_regime("rt_alloc_free_seq", BRAGGI_REGIME_SEQ);
+    if (selected("rt_alloc_free_rand")) bench_rt_regime("rt_alloc_free_rand", BRAGGI_REGIME_RAND);
+}
+
+/* ---------------------------------------------------------------------
+ * Numeric array kernels
+ * ------------------------------------------------------------------- */
+
+static void bench_math(void) {
+    if (!selected("math_fma_f64") && !selected("math_dot_f64") && !selected("math_max_f64")) {
+        return;
+    }
+
+    size_t n = math_elements;
+    double* a = (double*)malloc(n * sizeof(double));
+    double* b = (double*)malloc(n * sizeof(double));
+    double* out = (double*)malloc(n * sizeof(double));
+    if (!a || !b || !out) {
+        free(a);
+        free(b);
+        free(out);
+        return;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        a[i] = (double)(i % 1000) * 0.25;
+        b[i] = (double)(i % 17) - 8.0;
+    }
+
+    // Keep the reductions' results live so they aren't optimized away
+    volatile double sink = 0.0;
+
+    if (selected("math_fma_f64")) {
+        BenchResult* result = result_begin("math_fma_f64", n, n * 3 * sizeof(double));
+        for (size_t it = 0; it < iterations; it++) {
+            double start = now_ns();
+            braggi_kernel_fma_f64(out, a, b, a, n);
+            result_add(result, now_ns() - start);
+        }
+    }
+
+    if (selected("math_dot_f64")) {
+        BenchResult* result = result_begin("math_dot_f64", n, n * 2 * sizeof(double));
+        for (size_t it = 0; it < iterations; it++) {
+            double start = now_ns();
+            sink += braggi_kernel_dot_f64(a, b, n);
+            result_add(result, now_ns() - start);
+        }
+    }
+
+    if (selected("math_max_f64")) {
+        BenchResult* result = result_begin("math_max_f64", n, n * sizeof(double));
+        for (size_t it = 0; it < iterations; it++) {
+            double start = now_ns();
+            sink += braggi_kernel_max_f64(b, n);
+            result_add(result, now_ns() - start);
+        }
+    }
+
+    (void)sink;
+    free(a);
+    free(b);
+    free(out);
+}
+
+/* ---------------------------------------------------------------------
+ * End-to-end compile
+ * ------------------------------------------------------------------- */
+
+static void bench_compile(void) {
+    size_t length = 0;
+    char* program = make_program(source_size, &length);
+    if (!program) return;
+
+    BenchResult* result = result_begin("context_compile", 1, length);
+
+    for (size_t it = 0; it < iterations; it++) {
+        srand(BENCH_SEED);
+
+        quiet_begin();
+        double start = now_ns();
+        BraggiContext* context = braggi_context_create();
+        bool ok = context &&
+                  braggi_context_load_string(context, program, "bench_compile.bg") &&
+                  braggi_context_compile(context);
+        if (context) {
+            braggi_context_cleanup(context);
+            braggi_context_destroy(context);
+        }
+        double elapsed = now_ns() - start;
+        quiet_end();
+
+        if (!ok) {
+            fprintf(stderr, "Compilation failed during benchmark (iteration %zu)\n", it);
+        }
+        result_add(result, elapsed);
+    }
+
+    free(program);
+}
+
+/* ---------------------------------------------------------------------
+ * Reporting
+ * ------------------------------------------------------------------- */
+
+static void print_results(void) {
+    printf("%-28s %8s %14s %14s %12s\n", "benchmark", "iters", "mean ms", "ns/op", "MB/s");
+
+    for (size_t i = 0; i < result_count; i++) {
+        BenchResult* r = &results[i];
+        if (r->iterations == 0) continue;
+
+        double mean_ns = r->total_ns / (double)r->iterations;
+        double ns_per_op = r->ops ? mean_ns / (double)r->ops : mean_ns;
+
+        printf("%-28s %8zu %14.3f %14.1f", r->name, r->iterations, mean_ns / 1e6, ns_per_op);
+        if (r->bytes) {
+            printf(" %12.3f", result_mb_per_sec(r));
+        }
+        printf("\n");
+    }
+}
+
+static bool write_json(const char* path) {
+    FILE* out = strcmp(path, "-") == 0 ? stdout : fopen(path, "w");
+    if (!out) {
+        fprintf(stderr, "Failed to open JSON output: %s\n", path);
+        return false;
+    }
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"config\": {\"iterations\": %zu, \"cells\": %zu, \"ambiguity\": %zu, "
+                 "\"source_size\": %zu, \"entities\": %zu, \"allocs\": %zu, \"seed\": %d},\n",
+            iterations, field_cells, field_ambiguity, source_size, ecs_entities, alloc_count, BENCH_SEED);
+    fprintf(out, "  \"benchmarks\": [\n");
+
+    bool first = true;
+    for (size_t i = 0; i < result_count; i++) {
+        BenchResult* r = &results[i];
+        if (r->iterations == 0) continue;
+
+        double mean_ns = r->total_ns / (double)r->iterations;
+        double ns_per_op = r->ops ? mean_ns / (double)r->ops : mean_ns;
+
+        fprintf(out, "%s    {\"name\": \"%s\", \"iterations\": %zu, \"ops\": %zu, "
+                     "\"mean_ns\": %.1f, \"median_ns\": %.1f, \"min_ns\": %.1f, \"ns_per_op\": %.3f",
+                first ? "" : ",\n", r->name, r->iterations, r->ops,
+                mean_ns, result_median(r), r->min_ns, ns_per_op);
+        if (r->bytes) {
+            fprintf(out, ", \"bytes\": %zu, \"mb_per_sec\": %.3f", r->bytes, result_mb_per_sec(r));
+        }
+        fprintf(out, "}");
+        first = false;
+    }
+
+    fprintf(out, "\n  ]\n}\n");
+
+    if (out != stdout) fclose(out);
+    return true;
+}
+
+/* ---------------------------------------------------------------------
+ * Command line
+ * ------------------------------------------------------------------- */
+
+static size_t parse_size(const char* text) {
+    char* end = NULL;
+    unsigned long long value = strtoull(text, &end, 10);
+    if (end && (*end == 'k' || *end == 'K')) value *= 1024ULL;
+    if (end && (*end == 'm' || *end == 'M')) value *= 1024ULL * 1024ULL;
+    return (size_t)value;
+}
+
+int parse_args(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--json=", 7) == 0) {
+            json_path = argv[i] + 7;
+        } else if (strcmp(argv[i], "--json") == 0) {
+            json_path = "-";
+        } else if (strncmp(argv[i], "--only=", 7) == 0) {
+            only_filter = argv[i] + 7;
+        } else if (strncmp(argv[i], "--iterations=", 13) == 0) {
+            iterations = parse_size(argv[i] + 13);
+        } else if (strncmp(argv[i], "--cells=", 8) == 0) {
+            field_cells = parse_size(argv[i] + 8);
+        } else if (strncmp(argv[i], "--ambiguity=", 12) == 0) {
+            field_ambiguity = parse_size(argv[i] + 12);
+        } else if (strncmp(argv[i], "--size=", 7) == 0) {
+            source_size = parse_size(argv[i] + 7);
+        } else if (strncmp(argv[i], "--entities=", 11) == 0) {
+            ecs_entities = parse_size(argv[i] + 11);
+        } else if (strncmp(argv[i], "--allocs=", 9) == 0) {
+            alloc_count = parse_size(argv[i] + 9);
+        } else if (strncmp(argv[i], "--elements=", 11) == 0) {
+            math_elements = parse_size(argv[i] + 11);
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            verbose = true;
+        } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+            return -1;
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    if (iterations == 0 || field_cells == 0 || ecs_entities == 0 || alloc_count == 0 ||
+        math_elements == 0) {
+        fprintf(stderr, "Counts must be greater than zero\n");
+        return 1;
+    }
+    if (field_ambiguity < 2) {
+        fprintf(stderr, "Ambiguity must be at least 2 states per cell\n");
+        return 1;
+    }
+
+    return 0;
+}
+
+void print_usage(const char* program_name) {
+    printf("Usage: %s [options]\n", program_name);
+    printf("Options:\n");
+    printf("  --json[=FILE]      Write results as JSON (stdout if no file given)\n");
+    printf("  --only=NAME        Only run benchmarks whose name contains NAME\n");
+    printf("  --iterations=N     Timed iterations per benchmark (default: 5)\n");
+    printf("  --cells=N          Entropy field size in cells (default: 512)\n");
+    printf("  --ambiguity=N      States per entropy cell (default: 4)\n");
+    printf("  --size=BYTES       Synthetic source size, accepts K/M suffix (default: 16K)\n");
+    printf("  --entities=N       ECS entity count (default: 100000)\n");
+    printf("  --allocs=N         Allocations per allocator benchmark (default: 10000)\n");
+    printf("  --elements=N       Array length for the math kernels, accepts K/M (default: 1M)\n");
+    printf("  --verbose          Don't mute compiler output while timing\n");
+    printf("  --help             Show this help message\n");
+}
+
+int main(int argc, char** argv) {
+    int parsed = parse_args(argc, argv);
+    if (parsed != 0) {
+        // Asking for help isn't an error; a bad option is
+        print_usage(argv[0]);
+        return parsed < 0 ? 0 : 1;
+    }
+
+    if (selected("tokenize_all")) bench_tokenize();
+    if (selected("entropy_collapse_propagate")) bench_entropy();
+    if (selected("ecs_query_iterate")) bench_ecs();
+    if (selected("region_alloc")) bench_region_alloc();
+    bench_rt_regions();
+    bench_math();
+    if (selected("context_compile")) bench_compile();
+
+    // Keep stdout clean for the JSON when it's going there
+    if (!json_path || strcmp(json_path, "-") != 0) {
+        print_results();
+    }
+
+    bool json_ok = !json_path || write_json(json_path);
+
+    for (size_t i = 0; i < result_count; i++) {
+        free(results[i].samples);
+    }
+
+    return json_ok ? 0 : 1;
+}
@@ -0,0 +1,128 @@
+/*
+ * Braggi - Synthetic Program Generator Tool
+ *
+ * "Ya want a bigger herd? Don't wait on the calves - breed 'em
+ * on demand!" - Texan Ranching Wisdom
+ *
+ * Writes a syntactically valid Braggi program of the requested size,
+ * from a kilobyte up to a gigabyte, for benchmarks and scaling tests.
+ */
+
+#include "program_gen.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Command line arguments
+static const char* output_file = NULL;
+static ProgramGenOptions options;
+
+// Forward declarations
+void print_usage(const char* program_name);
+int parse_args(int argc, char** argv);
+
+// Parse a size with an optional K/M/G suffix
+static size_t parse_size(const char* text) {
+    char* end = NULL;
+    unsigned long long value = strtoull(text, &end, 10);
+
+    if (end) {
+        switch (*end) {
+            case 'k': case 'K': value *= 1024ULL; break;
+            case 'm': case 'M': value *= 1024ULL * 1024ULL; break;
+            case 'g': case 'G': value *= 1024ULL * 1024ULL * 1024ULL; break;
+            default: break;
+        }
+    }
+
+    return (size_t)value;
+}
+
+int parse_args(int argc, char** argv) {
+    braggi_progen_default_options(&options);
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--size=", 7) == 0) {
+            options.target_size = parse_size(argv[i] + 7);
+        } else if (strncmp(argv[i], "--seed=", 7) == 0) {
+            options.seed = (uint32_t)strtoul(argv[i] + 7, NULL, 10);
+        } else if (strncmp(argv[i], "--depth=", 8) == 0) {
+            options.max_depth = (unsigned)strtoul(argv[i] + 8, NULL, 10);
+        } else if (strncmp(argv[i], "--ambiguity=", 12) == 0) {
+            options.ambiguity = (unsigned)strtoul(argv[i] + 12, NULL, 10);
+        } else if (strncmp(argv[i], "--functions=", 12) == 0) {
+            options.functions_per_region = (unsigned)strtoul(argv[i] + 12, NULL, 10);
+        } else if (strcmp(argv[i], "--no-regions") == 0) {
+            options.emit_regions = false;
+        } else if (strcmp(argv[i], "--no-periscopes") == 0) {
+            options.emit_periscopes = false;
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output_file = argv[++i];
+        } else if (strncmp(argv[i], "--output=", 9) == 0) {
+            output_file = argv[i] + 9;
+        } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+            return -1;
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    if (options.target_size == 0) {
+        fprintf(stderr, "Size must be greater than zero\n");
+        return 1;
+    }
+    if (options.ambiguity > 100) {
+        fprintf(stderr, "Ambiguity is a percentage (0-100)\n");
+        return 1;
+    }
+
+    return 0;
+}
+
+void print_usage(const char* program_name) {
+    printf("Usage: %s [options]\n", program_name);
+    printf("Options:\n");
+    printf("  --size=BYTES       Approximate program size, accepts K/M/G (default: 16K)\n");
+    printf("  --seed=N           Random seed; same seed gives the same program (default: 42)\n");
+    printf("  --depth=N          Maximum block nesting depth (default: 3)\n");
+    printf("  --ambiguity=PCT    Percent of statements that are superpose/untyped (default: 20)\n");
+    printf("  --functions=N      Functions per region (default: 4)\n");
+    printf("  --no-regions       Emit bare functions without region/regime blocks\n");
+    printf("  --no-periscopes    Don't link regions with periscopes\n");
+    printf("  -o, --output=FILE  Write to FILE instead of stdout\n");
+    printf("  -h, --help         Show this help message\n");
+}
+
+int main(int argc, char** argv) {
+    int parsed = parse_args(argc, argv);
+    if (parsed != 0) {
+        // Asking for help isn't an error; a bad option is
+        print_usage(argv[0]);
+        return parsed < 0 ? 0 : 1;
+    }
+
+    FILE* out = stdout;
+    if (output_file) {
+        out = fopen(output_file, "w");
+        if (!out) {
+            fprintf(stderr, "Failed to open output file: %s\n", output_file);
+            return 1;
+        }
+    }
+
+    size_t written = braggi_progen_write(out, &options);
+
+    if (out != stdout) fclose(out);
+
+    if (written == 0) {
+        fprintf(stderr, "Failed to write generated program\n");
+        return 1;
+    }
+
+    if (output_file) {
+        fprintf(stderr, "Wrote %zu bytes to %s\n", written, output_file);
+    }
+
+    return 0;
+}
@@ -0,0 +1,257 @@
+/*
+ * Braggi - Synthetic Program Generator Implementation
+ *
+ * "Plant enough seeds and ya'll find out right quick whether
+ * the soil can take it." - Irish-Texan Farming Wisdom
+ */
+
+#define _GNU_SOURCE  // For open_memstream
+#include "program_gen.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+
+// Generator state threaded through the emitters
+typedef struct ProgramGen {
+    FILE* out;
+    const ProgramGenOptions* options;
+    size_t written;              // Bytes emitted so far
+    uint64_t rng;                // xorshift state - we don't touch rand()
+    unsigned next_var;           // Unique variable suffix
+    bool failed;                 // Write error seen
+} ProgramGen;
+
+static const char* regimes[] = { "FIFO", "FILO", "SEQ", "RAND" };
+static const char* types[] = { "i32", "i64", "f32", "f64", "bool" };
+static const char* ops[] = { "+", "-", "*" };
+
+// Small deterministic PRNG so output only depends on the seed
+static uint32_t gen_next(ProgramGen* gen) {
+    uint64_t x = gen->rng;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    gen->rng = x;
+    return (uint32_t)(x >> 32);
+}
+
+static unsigned gen_range(ProgramGen* gen, unsigned n) {
+    return n ? gen_next(gen) % n : 0;
+}
+
+// True with the given percent chance
+static bool gen_chance(ProgramGen* gen, unsigned percent) {
+    return gen_range(gen, 100) < percent;
+}
+
+static void emit(ProgramGen* gen, const char* fmt, ...) {
+    if (gen->failed) return;
+
+    va_list args;
+    va_start(args, fmt);
+    int n = vfprintf(gen->out, fmt, args);
+    va_end(args);
+
+    if (n < 0) {
+        gen->failed = true;
+        return;
+    }
+    gen->written += (size_t)n;
+}
+
+static void emit_indent(ProgramGen* gen, unsigned level) {
+    for (unsigned i = 0; i < level; i++) {
+        emit(gen, "    ");
+    }
+}
+
+static bool gen_done(ProgramGen* gen) {
+    return gen->failed || gen->written >= gen->options->target_size;
+}
+
+/*
+ * A simple arithmetic expression over names already in scope
+ */
+static void emit_expression(ProgramGen* gen, unsigned var_base, unsigned var_count) {
+    unsigned terms = 1 + gen_range(gen, 3);
+
+    for (unsigned i = 0; i < terms; i++) {
+        if (i > 0) emit(gen, " %s ", ops[gen_range(gen, 3)]);
+
+        if (var_count > 0 && gen_chance(gen, 60)) {
+            emit(gen, "v%u", var_base + gen_range(gen, var_count));
+        } else {
+            emit(gen, "%u", gen_range(gen, 1000));
+        }
+    }
+}
+
+/*
+ * Emit a block of statements, recursing into nested blocks up to max_depth
+ */
+static void emit_block(ProgramGen* gen, unsigned indent, unsigned depth,
+                       unsigned var_base, unsigned var_count) {
+    const ProgramGenOptions* opt = gen->options;
+    unsigned statements = 2 + gen_range(gen, 4);
+
+    for (unsigned s = 0; s < statements; s++) {
+        unsigned v = gen->next_var;
+        unsigned roll = gen_range(gen, 100);
+
+        emit_indent(gen, indent);
+
+        if (gen_chance(gen, opt->ambiguity)) {
+            // Leave somethin' for the wave function to chew on
+            if (gen_chance(gen, 50)) {
+                gen->next_var++;
+                emit(gen, "superpose v%u = [", v);
+                emit_expression(gen, var_base, var_count);
+                emit(gen, ", ");
+                emit_expression(gen, var_base, var_count);
+                emit(gen, ", %u];\n", gen_range(gen, 100));
+                emit_indent(gen, indent);
+                emit(gen, "collapse v%u;\n", v);
+                if (v == var_base + var_count) var_count++;
+            } else {
+                gen->next_var++;
+                emit(gen, "var v%u = ", v);
+                emit_expression(gen, var_base, var_count);
+                emit(gen, ";\n");
+                if (v == var_base + var_count) var_count++;
+            }
+        } else if (depth < opt->max_depth && roll < 30) {
+            emit(gen, "if ");
+            emit_expression(gen, var_base, var_count);
+            emit(gen, " > %u {\n", gen_range(gen, 500));
+            emit_block(gen, indent + 1, depth + 1, var_base, var_count);
+            emit_indent(gen, indent);
+            if (gen_chance(gen, 40)) {
+                emit(gen, "} else {\n");
+                emit_block(gen, indent + 1, depth + 1, var_base, var_count);
+                emit_indent(gen, indent);
+            }
+            emit(gen, "}\n");
+        } else if (depth < opt->max_depth && roll < 45) {
+            emit(gen, "while ");
+            emit_expression(gen, var_base, var_count);
+            emit(gen, " < %u {\n", gen_range(gen, 500));
+            emit_block(gen, indent + 1, depth + 1, var_base, var_count);
+            emit_indent(gen, indent);
+            emit(gen, "}\n");
+        } else if (var_count > 0 && roll < 60) {
+            emit(gen, "v%u = ", var_base + gen_range(gen, var_count));
+            emit_expression(gen, var_base, var_count);
+            emit(gen, ";\n");
+        } else {
+            gen->next_var++;
+            emit(gen, "var v%u: %s = ", v, types[gen_range(gen, 2)]);
+            emit_expression(gen, var_base, var_count);
+            emit(gen, ";\n");
+            if (v == var_base + var_count) var_count++;
+        }
+    }
+}
+
+static void emit_function(ProgramGen* gen, unsigned indent, unsigned region, unsigned index) {
+    unsigned params = gen_range(gen, 4);
+    unsigned var_base = gen->next_var;
+
+    emit_indent(gen, indent);
+    emit(gen, "fn r%u_f%u(", region, index);
+    for (unsigned p = 0; p < params; p++) {
+        emit(gen, "%sv%u: %s", p ? ", " : "", gen->next_var++, types[gen_range(gen, 5)]);
+    }
+    emit(gen, ") -> i32 {\n");
+
+    emit_block(gen, indent + 1, 0, var_base, params);
+
+    emit_indent(gen, indent + 1);
+    emit(gen, "return ");
+    emit_expression(gen, var_base, params);
+    emit(gen, ";\n");
+    emit_indent(gen, indent);
+    emit(gen, "}\n\n");
+}
+
+void braggi_progen_default_options(ProgramGenOptions* options) {
+    if (!options) return;
+
+    options->target_size = 16 * 1024;
+    options->seed = 42;
+    options->max_depth = 3;
+    options->ambiguity = 20;
+    options->functions_per_region = 4;
+    options->emit_regions = true;
+    options->emit_periscopes = true;
+}
+
+size_t braggi_progen_write(FILE* out, const ProgramGenOptions* options) {
+    if (!out || !options) return 0;
+
+    ProgramGen gen;
+    memset(&gen, 0, sizeof(gen));
+    gen.out = out;
+    gen.options = options;
+    gen.rng = ((uint64_t)options->seed << 32) | 0x9E3779B9u;
+
+    unsigned per_region = options->functions_per_region ? options->functions_per_region : 1;
+
+    emit(&gen, "// Generated by braggi_gen (seed=%u, depth=%u, ambiguity=%u%%)\n\n",
+         options->seed, options->max_depth, options->ambiguity);
+
+    unsigned region = 0;
+    for (; !gen_done(&gen); region++) {
+        unsigned indent = 0;
+
+        if (options->emit_regions) {
+            emit(&gen, "region Region%u regime %s {\n", region, regimes[gen_range(&gen, 4)]);
+            indent = 1;
+
+            emit_indent(&gen, indent);
+            emit(&gen, "var shared%u = %u;\n\n", region, gen_range(&gen, 1000));
+        }
+
+        for (unsigned f = 0; f < per_region && !gen_done(&gen); f++) {
+            emit_function(&gen, indent, region, f);
+        }
+
+        if (options->emit_regions) {
+            if (options->emit_periscopes) {
+                emit_indent(&gen, indent);
+                emit(&gen, "periscope shared%u to Region%u {\n", region, region + 1);
+                emit_indent(&gen, indent + 1);
+                emit(&gen, "var seen%u = shared%u;\n", region, region);
+                emit_indent(&gen, indent);
+                emit(&gen, "}\n");
+            }
+            emit(&gen, "}\n\n");
+        }
+    }
+
+    // The last periscope points one region past the end; give it somewhere to land
+    if (options->emit_regions && options->emit_periscopes) {
+        emit(&gen, "region Region%u regime SEQ {\n}\n", region);
+    }
+
+    fflush(out);
+    return gen.failed ? 0 : gen.written;
+}
+
+char* braggi_progen_generate(const ProgramGenOptions* options, size_t* out_length) {
+    char* buffer = NULL;
+    size_t length = 0;
+
+    FILE* stream = open_memstream(&buffer, &length);
+    if (!stream) return NULL;
+
+    size_t written = braggi_progen_write(stream, options);
+    fclose(stream);
+
+    if (written == 0) {
+        free(buffer);
+        return NULL;
+    }
+
+    if (out_length) *out_length = length;
+    return buffer;
+}
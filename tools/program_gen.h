@@ -0,0 +1,52 @@
+/*
+ * Braggi - Synthetic Program Generator
+ *
+ * "If ya want to know how the bridge holds up, ya drive the whole
+ * herd across it - not just the one calf!" - Texan Load Testing Wisdom
+ */
+
+#ifndef BRAGGI_PROGRAM_GEN_H
+#define BRAGGI_PROGRAM_GEN_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Knobs for the shape of a generated program
+typedef struct ProgramGenOptions {
+    size_t target_size;          // Stop once at least this many bytes are out
+    uint32_t seed;               // Same seed, same program
+    unsigned max_depth;          // Deepest block nesting inside a function
+    unsigned ambiguity;          // Percent of statements left for the solver (superpose/untyped)
+    unsigned functions_per_region; // Functions declared inside each region
+    bool emit_regions;           // Wrap functions in region/regime blocks
+    bool emit_periscopes;        // Link neighbouring regions with periscopes
+} ProgramGenOptions;
+
+/**
+ * Fill in sensible defaults (16 KB, depth 3, 20% ambiguity)
+ *
+ * @param options Options to initialize
+ */
+void braggi_progen_default_options(ProgramGenOptions* options);
+
+/**
+ * Stream a generated program to a file
+ *
+ * @param out Destination stream
+ * @param options Generator options
+ * @return Number of bytes written, 0 on error
+ */
+size_t braggi_progen_write(FILE* out, const ProgramGenOptions* options);
+
+/**
+ * Generate a program into a heap buffer
+ *
+ * @param options Generator options
+ * @param out_length Receives the length of the program (may be NULL)
+ * @return NUL-terminated program text, caller frees; NULL on error
+ */
+char* braggi_progen_generate(const ProgramGenOptions* options, size_t* out_length);
+
+#endif /* BRAGGI_PROGRAM_GEN_H */